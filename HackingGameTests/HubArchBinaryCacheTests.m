@@ -0,0 +1,202 @@
+/*
+ *  Copyright (c) 2022, Stefan Johnson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list
+ *     of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this
+ *     list of conditions and the following disclaimer in the documentation and/or other
+ *     materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <XCTest/XCTest.h>
+#import "HubArchAssembly.h"
+#import "HubArchBinaryCache.h"
+
+#define HKHubArchAssemblyPrintError(err) if (Errors) { HKHubArchAssemblyPrintError(err); CCCollectionDestroy(err); err = NULL; }
+
+@interface HubArchBinaryCacheTests : XCTestCase
+
+@end
+
+@implementation HubArchBinaryCacheTests
+{
+    FSPath prevCachePath;
+}
+
+static HKHubArchBinary CreateBinary(const char *Source)
+{
+    CCOrderedCollection AST = HKHubArchAssemblyParse(Source);
+    
+    CCOrderedCollection Errors = NULL;
+    HKHubArchBinary Binary = HKHubArchAssemblyCreateBinary(CC_STD_ALLOCATOR, AST, &Errors); HKHubArchAssemblyPrintError(Errors);
+    CCCollectionDestroy(AST);
+    
+    return Binary;
+}
+
+static FSPath CreateTemporaryPath(const char *Name)
+{
+    return FSPathCreateFromSystemPath([[NSTemporaryDirectory() stringByAppendingPathComponent: [NSString stringWithUTF8String: Name]] UTF8String]);
+}
+
+-(void) setUp
+{
+    [super setUp];
+    
+    prevCachePath = HKHubArchBinaryCachePath;
+    
+    HKHubArchBinaryCachePath = CreateTemporaryPath("HubArchBinaryCacheTests.hkbin");
+    if (FSManagerExists(HKHubArchBinaryCachePath)) FSManagerRemove(HKHubArchBinaryCachePath);
+    
+    HKHubArchBinaryCacheLoad();
+}
+
+-(void) tearDown
+{
+    if (FSManagerExists(HKHubArchBinaryCachePath)) FSManagerRemove(HKHubArchBinaryCachePath);
+    FSPathDestroy(HKHubArchBinaryCachePath);
+    
+    HKHubArchBinaryCachePath = prevCachePath;
+    HKHubArchBinaryCacheLoad();
+    
+    [super tearDown];
+}
+
+-(void) testRoundTrip
+{
+    const char *Source =
+        "data: .byte 2\n"
+        ".entrypoint\n"
+        "mov r0, [data]\n"
+        "hlt\n"
+    ;
+    
+    HKHubArchBinary Binary = CreateBinary(Source);
+    CCArrayAppendElement(Binary->presetBreakpoints, &(uint8_t){ 1 });
+    CCCollectionInsertElement(Binary->namedPorts, &(HKHubArchBinaryNamedPort){ .name = CC_STRING("port"), .start = 2, .count = 3 });
+    
+    HKHubArchBinaryCacheSet(Source, Binary, NULL);
+    HKHubArchBinaryCacheSave();
+    HKHubArchBinaryCacheLoad();
+    
+    HKHubArchBinary Cached = HKHubArchBinaryCacheGet(Source);
+    XCTAssertNotEqual(Cached, NULL, @"Should load the binary from the cache file");
+    XCTAssertEqual(Cached->entrypoint, Binary->entrypoint, @"Should have the same entrypoint");
+    XCTAssertTrue(!memcmp(Cached->data, Binary->data, sizeof(Binary->data)), @"Should have the same data");
+    XCTAssertEqual(CCArrayGetCount(Cached->presetBreakpoints), 1, @"Should have the same breakpoints");
+    XCTAssertEqual(*(uint8_t*)CCArrayGetElementAtIndex(Cached->presetBreakpoints, 0), 1, @"Should have the same breakpoints");
+    XCTAssertEqual(CCCollectionGetCount(Cached->namedPorts), 1, @"Should have the same named ports");
+    
+    CC_COLLECTION_FOREACH_PTR(HKHubArchBinaryNamedPort, NamedPort, Cached->namedPorts)
+    {
+        XCTAssertTrue(CCStringEqual(NamedPort->name, CC_STRING("port")), @"Should have the same named ports");
+        XCTAssertEqual(NamedPort->start, 2, @"Should have the same named ports");
+        XCTAssertEqual(NamedPort->count, 3, @"Should have the same named ports");
+    }
+    
+    HKHubArchBinaryDestroy(Cached);
+    
+    //Same length as the cached source so it can only be rejected by the hash of the source
+    XCTAssertEqual(HKHubArchBinaryCacheGet(
+        "data: .byte 3\n"
+        ".entrypoint\n"
+        "mov r0, [data]\n"
+        "hlt\n"
+    ), NULL, @"Should not return a binary for a different source");
+    
+    HKHubArchBinaryDestroy(Binary);
+}
+
+-(void) testIncludeInvalidation
+{
+    const char *Source = ".include \"HubArchBinaryCacheTests\"\n";
+    
+    FSPath IncludePath = CreateTemporaryPath("HubArchBinaryCacheTests.hs");
+    NSString *IncludeSystemPath = [NSString stringWithUTF8String: FSPathGetPathString(IncludePath)];
+    [@"hlt\n" writeToFile: IncludeSystemPath atomically: NO encoding: NSUTF8StringEncoding error: NULL];
+    
+    CCOrderedCollection(FSPath) Includes = CCCollectionCreate(CC_STD_ALLOCATOR, CCCollectionHintOrdered, sizeof(FSPath), FSPathComponentDestructorForCollection);
+    CCOrderedCollectionAppendElement(Includes, &(FSPath){ FSPathCopy(IncludePath) });
+    
+    HKHubArchBinary Binary = CreateBinary("hlt\n");
+    HKHubArchBinaryCacheSet(Source, Binary, Includes);
+    HKHubArchBinaryDestroy(Binary);
+    CCCollectionDestroy(Includes);
+    
+    HKHubArchBinaryCacheSave();
+    HKHubArchBinaryCacheLoad();
+    
+    Binary = HKHubArchBinaryCacheGet(Source);
+    XCTAssertNotEqual(Binary, NULL, @"Should return the binary while the include is unchanged");
+    if (Binary) HKHubArchBinaryDestroy(Binary);
+    
+    [@"nop\nhlt\n" writeToFile: IncludeSystemPath atomically: NO encoding: NSUTF8StringEncoding error: NULL];
+    
+    HKHubArchBinaryCacheLoad();
+    
+    XCTAssertEqual(HKHubArchBinaryCacheGet(Source), NULL, @"Should not return the binary once the include has changed");
+    
+    FSManagerRemove(IncludePath);
+    FSPathDestroy(IncludePath);
+}
+
+-(void) testLeastRecentlyUsedEviction
+{
+    const char *Sources[3] = {
+        ".entrypoint\nhlt\n",
+        ".entrypoint\nnop\nhlt\n",
+        ".entrypoint\nnop\nnop\nhlt\n"
+    };
+    
+    const size_t PrevMaxEntries = HKHubArchBinaryCacheMaxEntries;
+    HKHubArchBinaryCacheMaxEntries = 2;
+    
+    for (size_t Loop = 0; Loop < 2; Loop++)
+    {
+        HKHubArchBinary Binary = CreateBinary(Sources[Loop]);
+        HKHubArchBinaryCacheSet(Sources[Loop], Binary, NULL);
+        HKHubArchBinaryDestroy(Binary);
+    }
+    
+    HKHubArchBinaryCacheSave();
+    HKHubArchBinaryCacheLoad();
+    
+    HKHubArchBinary Binary = HKHubArchBinaryCacheGet(Sources[0]);
+    XCTAssertNotEqual(Binary, NULL, @"Should load the binary from the cache file");
+    if (Binary) HKHubArchBinaryDestroy(Binary);
+    
+    Binary = CreateBinary(Sources[2]);
+    HKHubArchBinaryCacheSet(Sources[2], Binary, NULL);
+    HKHubArchBinaryDestroy(Binary);
+    
+    HKHubArchBinaryCacheSave();
+    HKHubArchBinaryCacheLoad();
+    
+    XCTAssertEqual(HKHubArchBinaryCacheGet(Sources[1]), NULL, @"Should drop the least recently used binary");
+    
+    for (size_t Loop = 0; Loop < 3; Loop += 2)
+    {
+        Binary = HKHubArchBinaryCacheGet(Sources[Loop]);
+        XCTAssertNotEqual(Binary, NULL, @"Should keep the most recently used binaries");
+        if (Binary) HKHubArchBinaryDestroy(Binary);
+    }
+    
+    HKHubArchBinaryCacheMaxEntries = PrevMaxEntries;
+}
+
+@end
@@ -34,6 +34,16 @@
 
 @end
 
+static uint16_t HKHubArchExecutionGraphNextNode(HKHubArchExecutionGraph Graph, uint16_t Node)
+{
+    if (Node == HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE) return HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE;
+    
+    const HKHubArchExecutionGraphInstruction *Instruction = CCArrayGetElementAtIndex(Graph->instruction, Node);
+    const HKHubArchExecutionGraphBlock *Block = CCArrayGetElementAtIndex(Graph->block, Graph->location[Instruction->offset].block);
+    
+    return (Node + 1) < (Block->index + Block->count) ? Node + 1 : HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE;
+}
+
 @implementation HubArchCacheTests
 
 -(void) testSimpleFlow
@@ -74,63 +84,63 @@
     
     XCTAssertEqual(CCArrayGetCount(Processor->cache.graph->block), 2, @"Should have the correct number of execution paths");
     
-    CCLinkedListNode *Node = *(CCLinkedListNode**)CCArrayGetElementAtIndex(Processor->cache.graph->block, 0);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
+    uint16_t Node = ((HKHubArchExecutionGraphBlock*)CCArrayGetElementAtIndex(Processor->cache.graph->block, 0))->index;
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
     {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
         XCTAssertEqual(GraphNode->offset, 1, @"Should have the correct offset");
-        XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+        XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
         
         CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
         XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("mov r0,[0x00]")), @"Should have the correct instruction");
         CCStringDestroy(Instruction);
     }
     
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
     {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
         XCTAssertEqual(GraphNode->offset, 4, @"Should have the correct offset");
-        XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+        XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
         
         CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
         XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("add r0,0x02")), @"Should have the correct instruction");
         CCStringDestroy(Instruction);
     }
     
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
     {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
         XCTAssertEqual(GraphNode->offset, 7, @"Should have the correct offset");
-        XCTAssertNotEqual(GraphNode->jump, NULL, @"Should jump to another node");
+        XCTAssertNotEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should jump to another node");
         
         CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
         XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("jmp 0x05")), @"Should have the correct instruction");
         CCStringDestroy(Instruction);
         
         {
-            CCLinkedListNode *Node = GraphNode->jump, *Skip = GraphNode->jump;
-            XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-            if (Node)
+            uint16_t Node = GraphNode->jump, Skip = GraphNode->jump;
+            XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+            if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
             {
-                const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+                const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
                 XCTAssertEqual(GraphNode->offset, 12, @"Should have the correct offset");
-                XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+                XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
                 
                 CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
                 XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("sub [0x00],0x01")), @"Should have the correct instruction");
                 CCStringDestroy(Instruction);
             }
             
-            Node = CCLinkedListEnumerateNext(Node);
-            XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-            if (Node)
+            Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+            XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+            if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
             {
-                const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+                const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
                 XCTAssertEqual(GraphNode->offset, 16, @"Should have the correct offset");
                 XCTAssertEqual(GraphNode->jump, Skip, @"Should jump to another node");
                 
@@ -139,39 +149,39 @@
                 CCStringDestroy(Instruction);
             }
             
-            Node = CCLinkedListEnumerateNext(Node);
-            XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-            if (Node)
+            Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+            XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+            if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
             {
-                const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+                const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
                 XCTAssertEqual(GraphNode->offset, 18, @"Should have the correct offset");
-                XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+                XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
                 
                 CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
                 XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("nop")), @"Should have the correct instruction");
                 CCStringDestroy(Instruction);
             }
             
-            Node = CCLinkedListEnumerateNext(Node);
-            XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-            if (Node)
+            Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+            XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+            if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
             {
-                const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+                const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
                 XCTAssertEqual(GraphNode->offset, 19, @"Should have the correct offset");
-                XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+                XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
                 
                 CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
                 XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("hlt")), @"Should have the correct instruction");
                 CCStringDestroy(Instruction);
             }
             
-            Node = CCLinkedListEnumerateNext(Node);
-            XCTAssertEqual(Node, NULL, @"Should not have another graph node");
+            Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+            XCTAssertEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not have another graph node");
         }
     }
     
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertEqual(Node, NULL, @"Should not have another graph node");
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not have another graph node");
     
     HKHubArchBinaryDestroy(Binary);
     HKHubArchProcessorDestroy(Processor);
@@ -210,51 +220,51 @@
     
     XCTAssertEqual(CCArrayGetCount(Processor->cache.graph->block), 2, @"Should have the correct number of execution paths");
     
-    CCLinkedListNode *Node = *(CCLinkedListNode**)CCArrayGetElementAtIndex(Processor->cache.graph->block, 0);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
+    uint16_t Node = ((HKHubArchExecutionGraphBlock*)CCArrayGetElementAtIndex(Processor->cache.graph->block, 0))->index;
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
     {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
         XCTAssertEqual(GraphNode->offset, 0, @"Should have the correct offset");
-        XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+        XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
         
         CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
         XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("add r0,r1")), @"Should have the correct instruction");
         CCStringDestroy(Instruction);
     }
     
-    CCLinkedListNode *A = Node;
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
+    uint16_t A = Node;
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
     {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
         XCTAssertEqual(GraphNode->offset, 2, @"Should have the correct offset");
-        XCTAssertNotEqual(GraphNode->jump, NULL, @"Should jump to another node");
+        XCTAssertNotEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should jump to another node");
         
         CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
         XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("jmp 0x02")), @"Should have the correct instruction");
         CCStringDestroy(Instruction);
         
         {
-            CCLinkedListNode *Node = GraphNode->jump;
-            XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-            if (Node)
+            uint16_t Node = GraphNode->jump;
+            XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+            if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
             {
-                const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+                const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
                 XCTAssertEqual(GraphNode->offset, 4, @"Should have the correct offset");
-                XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+                XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
                 
                 CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
                 XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("sub r0,r1")), @"Should have the correct instruction");
                 CCStringDestroy(Instruction);
             }
             
-            Node = CCLinkedListEnumerateNext(Node);
-            XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-            if (Node)
+            Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+            XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+            if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
             {
-                const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+                const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
                 XCTAssertEqual(GraphNode->offset, 6, @"Should have the correct offset");
                 XCTAssertEqual(GraphNode->jump, A, @"Should jump to another node");
                 
@@ -263,13 +273,13 @@
                 CCStringDestroy(Instruction);
             }
             
-            Node = CCLinkedListEnumerateNext(Node);
-            XCTAssertEqual(Node, NULL, @"Should not have another graph node");
+            Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+            XCTAssertEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not have another graph node");
         }
     }
     
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertEqual(Node, NULL, @"Should not have another graph node");
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not have another graph node");
     
     HKHubArchBinaryDestroy(Binary);
     HKHubArchProcessorDestroy(Processor);
@@ -309,51 +319,51 @@
     
     XCTAssertEqual(CCArrayGetCount(Processor->cache.graph->block), 2, @"Should have the correct number of execution paths");
     
-    CCLinkedListNode *Node = *(CCLinkedListNode**)CCArrayGetElementAtIndex(Processor->cache.graph->block, 0);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
+    uint16_t Node = ((HKHubArchExecutionGraphBlock*)CCArrayGetElementAtIndex(Processor->cache.graph->block, 0))->index;
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
     {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
         XCTAssertEqual(GraphNode->offset, 0, @"Should have the correct offset");
-        XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+        XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
         
         CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
         XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("add r0,r1")), @"Should have the correct instruction");
         CCStringDestroy(Instruction);
     }
     
-    CCLinkedListNode *A = Node;
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
+    uint16_t A = Node;
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
     {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
         XCTAssertEqual(GraphNode->offset, 2, @"Should have the correct offset");
-        XCTAssertNotEqual(GraphNode->jump, NULL, @"Should jump to another node");
+        XCTAssertNotEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should jump to another node");
         
         CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
         XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("jmp 0x02")), @"Should have the correct instruction");
         CCStringDestroy(Instruction);
         
         {
-            CCLinkedListNode *Node = GraphNode->jump;
-            XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-            if (Node)
+            uint16_t Node = GraphNode->jump;
+            XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+            if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
             {
-                const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+                const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
                 XCTAssertEqual(GraphNode->offset, 4, @"Should have the correct offset");
-                XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+                XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
                 
                 CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
                 XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("sub r0,r1")), @"Should have the correct instruction");
                 CCStringDestroy(Instruction);
             }
             
-            Node = CCLinkedListEnumerateNext(Node);
-            XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-            if (Node)
+            Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+            XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+            if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
             {
-                const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+                const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
                 XCTAssertEqual(GraphNode->offset, 6, @"Should have the correct offset");
                 XCTAssertEqual(GraphNode->jump, A, @"Should jump to another node");
                 
@@ -362,13 +372,13 @@
                 CCStringDestroy(Instruction);
             }
             
-            Node = CCLinkedListEnumerateNext(Node);
-            XCTAssertEqual(Node, NULL, @"Should not have another graph node");
+            Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+            XCTAssertEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not have another graph node");
         }
     }
     
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertEqual(Node, NULL, @"Should not have another graph node");
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not have another graph node");
     
     HKHubArchBinaryDestroy(Binary);
     HKHubArchProcessorDestroy(Processor);
@@ -402,38 +412,38 @@
     
     XCTAssertEqual(CCArrayGetCount(Processor->cache.graph->block), 1, @"Should have the correct number of execution paths");
     
-    CCLinkedListNode *Node = *(CCLinkedListNode**)CCArrayGetElementAtIndex(Processor->cache.graph->block, 0);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
+    uint16_t Node = ((HKHubArchExecutionGraphBlock*)CCArrayGetElementAtIndex(Processor->cache.graph->block, 0))->index;
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
     {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
         XCTAssertEqual(GraphNode->offset, 0, @"Should have the correct offset");
-        XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+        XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
         
         CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
         XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("add r0,r1")), @"Should have the correct instruction");
         CCStringDestroy(Instruction);
     }
     
-    CCLinkedListNode *Start = Node;
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
+    uint16_t Start = Node;
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
     {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
         XCTAssertEqual(GraphNode->offset, 2, @"Should have the correct offset");
-        XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+        XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
         
         CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
         XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("sub r0,r1")), @"Should have the correct instruction");
         CCStringDestroy(Instruction);
     }
     
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
     {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
         XCTAssertEqual(GraphNode->offset, 4, @"Should have the correct offset");
         XCTAssertEqual(GraphNode->jump, Start, @"Should jump to another node");
         
@@ -442,8 +452,8 @@
         CCStringDestroy(Instruction);
     }
     
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertEqual(Node, NULL, @"Should not have another graph node");
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not have another graph node");
     
     HKHubArchBinaryDestroy(Binary);
     HKHubArchProcessorDestroy(Processor);
@@ -493,38 +503,38 @@
     
     XCTAssertEqual(CCArrayGetCount(Processor->cache.graph->block), 1, @"Should have the correct number of execution paths");
     
-    CCLinkedListNode *Node = *(CCLinkedListNode**)CCArrayGetElementAtIndex(Processor->cache.graph->block, 0);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
+    uint16_t Node = ((HKHubArchExecutionGraphBlock*)CCArrayGetElementAtIndex(Processor->cache.graph->block, 0))->index;
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
     {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
         XCTAssertEqual(GraphNode->offset, 254, @"Should have the correct offset");
-        XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+        XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
         
         CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
         XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("sub r0,r1")), @"Should have the correct instruction");
         CCStringDestroy(Instruction);
     }
     
-    CCLinkedListNode *Start = Node;
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
+    uint16_t Start = Node;
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
     {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
         XCTAssertEqual(GraphNode->offset, 0, @"Should have the correct offset");
-        XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+        XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
         
         CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
         XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("add r0,r1")), @"Should have the correct instruction");
         CCStringDestroy(Instruction);
     }
     
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
     {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
         XCTAssertEqual(GraphNode->offset, 2, @"Should have the correct offset");
         XCTAssertEqual(GraphNode->jump, Start, @"Should jump to another node");
         
@@ -533,8 +543,8 @@
         CCStringDestroy(Instruction);
     }
     
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertEqual(Node, NULL, @"Should not have another graph node");
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not have another graph node");
     
     HKHubArchBinaryDestroy(Binary);
     HKHubArchProcessorDestroy(Processor);
@@ -583,38 +593,38 @@
     
     XCTAssertEqual(CCArrayGetCount(Processor->cache.graph->block), 1, @"Should have the correct number of execution paths");
     
-    CCLinkedListNode *Node = *(CCLinkedListNode**)CCArrayGetElementAtIndex(Processor->cache.graph->block, 0);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
+    uint16_t Node = ((HKHubArchExecutionGraphBlock*)CCArrayGetElementAtIndex(Processor->cache.graph->block, 0))->index;
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
     {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
         XCTAssertEqual(GraphNode->offset, 254, @"Should have the correct offset");
-        XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+        XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
         
         CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
         XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("sub r0,r1")), @"Should have the correct instruction");
         CCStringDestroy(Instruction);
     }
     
-    CCLinkedListNode *Start = Node;
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
+    uint16_t Start = Node;
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
     {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
         XCTAssertEqual(GraphNode->offset, 0, @"Should have the correct offset");
-        XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+        XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
         
         CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
         XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("add r0,r1")), @"Should have the correct instruction");
         CCStringDestroy(Instruction);
     }
     
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
     {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
         XCTAssertEqual(GraphNode->offset, 2, @"Should have the correct offset");
         XCTAssertEqual(GraphNode->jump, Start, @"Should jump to another node");
         
@@ -623,8 +633,8 @@
         CCStringDestroy(Instruction);
     }
     
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertEqual(Node, NULL, @"Should not have another graph node");
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not have another graph node");
     
     HKHubArchBinaryDestroy(Binary);
     HKHubArchProcessorDestroy(Processor);
@@ -674,38 +684,38 @@
     
     XCTAssertEqual(CCArrayGetCount(Processor->cache.graph->block), 1, @"Should have the correct number of execution paths");
     
-    CCLinkedListNode *Node = *(CCLinkedListNode**)CCArrayGetElementAtIndex(Processor->cache.graph->block, 0);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
+    uint16_t Node = ((HKHubArchExecutionGraphBlock*)CCArrayGetElementAtIndex(Processor->cache.graph->block, 0))->index;
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
     {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
         XCTAssertEqual(GraphNode->offset, 254, @"Should have the correct offset");
-        XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+        XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
         
         CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
         XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("sub r0,r1")), @"Should have the correct instruction");
         CCStringDestroy(Instruction);
     }
     
-    CCLinkedListNode *Start = Node;
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
+    uint16_t Start = Node;
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
     {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
         XCTAssertEqual(GraphNode->offset, 0, @"Should have the correct offset");
-        XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+        XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
         
         CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
         XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("add r0,r1")), @"Should have the correct instruction");
         CCStringDestroy(Instruction);
     }
     
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
     {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
         XCTAssertEqual(GraphNode->offset, 2, @"Should have the correct offset");
         XCTAssertEqual(GraphNode->jump, Start, @"Should jump to another node");
         
@@ -716,13 +726,13 @@
     
     for (size_t Loop = 0; Loop < 250; Loop++)
     {
-        Node = CCLinkedListEnumerateNext(Node);
-        XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-        if (Node)
+        Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+        XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+        if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
         {
-            const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+            const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
             XCTAssertEqual(GraphNode->offset, 4 + Loop, @"Should have the correct offset");
-            XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+            XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
             
             CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
             XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("nop")), @"Should have the correct instruction");
@@ -730,8 +740,8 @@
         }
     }
     
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertEqual(Node, NULL, @"Should not have another graph node");
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not have another graph node");
     
     HKHubArchBinaryDestroy(Binary);
     HKHubArchProcessorDestroy(Processor);
@@ -775,45 +785,31 @@
     XCTAssertEqual(CCArrayGetCount(Processor->cache.graph->range), 1, @"Should have the correct number of execution ranges");
     
     HKHubArchExecutionGraphRange *Range = CCArrayGetElementAtIndex(Processor->cache.graph->range, 0);
-    XCTAssertEqual(Range->start, 254, @"Should have the correct start");
+    XCTAssertEqual(Range->start, 0, @"Should have the correct start");
     XCTAssertEqual(Range->count, 255, @"Should have the correct count");
     
     XCTAssertEqual(CCArrayGetCount(Processor->cache.graph->block), 1, @"Should have the correct number of execution paths");
     
-    CCLinkedListNode *Node = *(CCLinkedListNode**)CCArrayGetElementAtIndex(Processor->cache.graph->block, 0);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
+    uint16_t Node = ((HKHubArchExecutionGraphBlock*)CCArrayGetElementAtIndex(Processor->cache.graph->block, 0))->index;
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
     {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
-        XCTAssertEqual(GraphNode->offset, 254, @"Should have the correct offset");
-        XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
-        
-        CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
-        XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("sub r0,r1")), @"Should have the correct instruction");
-        CCStringDestroy(Instruction);
-    }
-    
-    CCLinkedListNode *Start = Node;
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
-    {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
         XCTAssertEqual(GraphNode->offset, 0, @"Should have the correct offset");
-        XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+        XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
         
         CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
         XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("add r0,r1")), @"Should have the correct instruction");
         CCStringDestroy(Instruction);
     }
     
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
     {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
         XCTAssertEqual(GraphNode->offset, 2, @"Should have the correct offset");
-        XCTAssertEqual(GraphNode->jump, Start, @"Should jump to another node");
+        XCTAssertEqual(GraphNode->jump, Processor->cache.graph->location[254].index, @"Should jump to another node");
         
         CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
         XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("jz 0xfc")), @"Should have the correct instruction");
@@ -822,13 +818,13 @@
     
     for (size_t Loop = 0; Loop < 250; Loop++)
     {
-        Node = CCLinkedListEnumerateNext(Node);
-        XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-        if (Node)
+        Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+        XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+        if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
         {
-            const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+            const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
             XCTAssertEqual(GraphNode->offset, 4 + Loop, @"Should have the correct offset");
-            XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+            XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
             
             CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
             XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("nop")), @"Should have the correct instruction");
@@ -836,8 +832,21 @@
         }
     }
     
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertEqual(Node, NULL, @"Should not have another graph node");
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
+    {
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
+        XCTAssertEqual(GraphNode->offset, 254, @"Should have the correct offset");
+        XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
+        
+        CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
+        XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("sub r0,r1")), @"Should have the correct instruction");
+        CCStringDestroy(Instruction);
+    }
+    
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not have another graph node");
     
     HKHubArchBinaryDestroy(Binary);
     HKHubArchProcessorDestroy(Processor);
@@ -886,39 +895,39 @@
     
     XCTAssertEqual(CCArrayGetCount(Processor->cache.graph->block), 1, @"Should have the correct number of execution paths");
     
-    CCLinkedListNode *Node = *(CCLinkedListNode**)CCArrayGetElementAtIndex(Processor->cache.graph->block, 0);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
+    uint16_t Node = ((HKHubArchExecutionGraphBlock*)CCArrayGetElementAtIndex(Processor->cache.graph->block, 0))->index;
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
     {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
         XCTAssertEqual(GraphNode->offset, 254, @"Should have the correct offset");
-        XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+        XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
         
         CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
         XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("sub r0,r1")), @"Should have the correct instruction");
         CCStringDestroy(Instruction);
     }
     
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
     {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
         XCTAssertEqual(GraphNode->offset, 0, @"Should have the correct offset");
-        XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+        XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
         
         CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
         XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("add r0,r1")), @"Should have the correct instruction");
         CCStringDestroy(Instruction);
     }
     
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
     {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
         XCTAssertEqual(GraphNode->offset, 2, @"Should have the correct offset");
-        XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+        XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
         
         CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
         XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("xor r0,r1")), @"Should have the correct instruction");
@@ -927,13 +936,13 @@
     
     for (size_t Loop = 0; Loop < 250; Loop++)
     {
-        Node = CCLinkedListEnumerateNext(Node);
-        XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-        if (Node)
+        Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+        XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+        if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
         {
-            const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+            const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
             XCTAssertEqual(GraphNode->offset, 4 + Loop, @"Should have the correct offset");
-            XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+            XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
             
             CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
             XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("nop")), @"Should have the correct instruction");
@@ -941,8 +950,8 @@
         }
     }
     
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertEqual(Node, NULL, @"Should not have another graph node");
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not have another graph node");
     
     HKHubArchBinaryDestroy(Binary);
     HKHubArchProcessorDestroy(Processor);
@@ -990,26 +999,26 @@
     
     XCTAssertEqual(CCArrayGetCount(Processor->cache.graph->block), 1, @"Should have the correct number of execution paths");
     
-    CCLinkedListNode *Node = *(CCLinkedListNode**)CCArrayGetElementAtIndex(Processor->cache.graph->block, 0);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
+    uint16_t Node = ((HKHubArchExecutionGraphBlock*)CCArrayGetElementAtIndex(Processor->cache.graph->block, 0))->index;
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
     {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
         XCTAssertEqual(GraphNode->offset, 0, @"Should have the correct offset");
-        XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+        XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
         
         CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
         XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("add r0,r1")), @"Should have the correct instruction");
         CCStringDestroy(Instruction);
     }
     
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
     {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
         XCTAssertEqual(GraphNode->offset, 2, @"Should have the correct offset");
-        XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+        XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
         
         CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
         XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("xor r0,r1")), @"Should have the correct instruction");
@@ -1018,13 +1027,13 @@
     
     for (size_t Loop = 0; Loop < 250; Loop++)
     {
-        Node = CCLinkedListEnumerateNext(Node);
-        XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-        if (Node)
+        Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+        XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+        if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
         {
-            const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+            const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
             XCTAssertEqual(GraphNode->offset, 4 + Loop, @"Should have the correct offset");
-            XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+            XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
             
             CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
             XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("nop")), @"Should have the correct instruction");
@@ -1032,21 +1041,21 @@
         }
     }
     
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
     {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
         XCTAssertEqual(GraphNode->offset, 254, @"Should have the correct offset");
-        XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+        XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
         
         CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
         XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("sub r0,r1")), @"Should have the correct instruction");
         CCStringDestroy(Instruction);
     }
     
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertEqual(Node, NULL, @"Should not have another graph node");
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not have another graph node");
     
     HKHubArchBinaryDestroy(Binary);
     HKHubArchProcessorDestroy(Processor);
@@ -1085,145 +1094,206 @@
 //    XCTAssertEqual(Range->start, 0, @"Should have the correct start");
 //    XCTAssertEqual(Range->count, 255, @"Should have the correct count");
     
-    XCTAssertEqual(CCArrayGetCount(Processor->cache.graph->block), 1, @"Should have the correct number of execution paths");
+    XCTAssertEqual(CCArrayGetCount(Processor->cache.graph->block), 4, @"Should have the correct number of execution paths");
     
-    CCLinkedListNode *Node = *(CCLinkedListNode**)CCArrayGetElementAtIndex(Processor->cache.graph->block, 0);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
+    uint16_t Node = ((HKHubArchExecutionGraphBlock*)CCArrayGetElementAtIndex(Processor->cache.graph->block, 0))->index;
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
     {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
         XCTAssertEqual(GraphNode->offset, 0, @"Should have the correct offset");
-        XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+        XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
         
         CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
         XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("mov r1,0x01")), @"Should have the correct instruction");
         CCStringDestroy(Instruction);
     }
     
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
     {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
         XCTAssertEqual(GraphNode->offset, 3, @"Should have the correct offset");
-        XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+        XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
         
         CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
         XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("add r1,r1")), @"Should have the correct instruction");
         CCStringDestroy(Instruction);
     }
     
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-    if (Node)
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
     {
-        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
         XCTAssertEqual(GraphNode->offset, 5, @"Should have the correct offset");
-        XCTAssertNotEqual(GraphNode->jump, NULL, @"Should jump to another node");
+        XCTAssertNotEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should jump to another node");
         
         CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
         XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("jmp 0xff")), @"Should have the correct instruction");
         CCStringDestroy(Instruction);
         
         {
-            CCLinkedListNode *Node = GraphNode->jump;
-            XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-            if (Node)
+            uint16_t Node = GraphNode->jump;
+            XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+            if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
             {
-                const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+                const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
                 XCTAssertEqual(GraphNode->offset, 4, @"Should have the correct offset");
-                XCTAssertNotEqual(GraphNode->jump, NULL, @"Should jump to another node");
+                XCTAssertNotEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should jump to another node");
                 
                 CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
                 XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("jsl 0x3f")), @"Should have the correct instruction");
                 CCStringDestroy(Instruction);
                 
                 {
-                    CCLinkedListNode *Node = GraphNode->jump;
-                    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-                    if (Node)
+                    uint16_t Node = GraphNode->jump;
+                    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+                    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
                     {
-                        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+                        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
                         XCTAssertEqual(GraphNode->offset, 0x43, @"Should have the correct offset");
-                        XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+                        XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
                         
                         CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
                         XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("mov r2,0x03")), @"Should have the correct instruction");
                         CCStringDestroy(Instruction);
                     }
                     
-                    Node = CCLinkedListEnumerateNext(Node);
-                    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-                    if (Node)
+                    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+                    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+                    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
                     {
-                        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+                        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
                         XCTAssertEqual(GraphNode->offset, 0x46, @"Should have the correct offset");
-                        XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+                        XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
                         
                         CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
                         XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("hlt")), @"Should have the correct instruction");
                         CCStringDestroy(Instruction);
                     }
                     
-                    Node = CCLinkedListEnumerateNext(Node);
-                    XCTAssertEqual(Node, NULL, @"Should not have another graph node");
+                    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+                    XCTAssertEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not have another graph node");
                 }
             }
             
-            Node = CCLinkedListEnumerateNext(Node);
-            XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-            if (Node)
+            Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+            XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+            if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
             {
-                const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+                const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
                 XCTAssertEqual(GraphNode->offset, 6, @"Should have the correct offset");
-                XCTAssertNotEqual(GraphNode->jump, NULL, @"Should jump to another node");
+                XCTAssertNotEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should jump to another node");
                 
                 CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
                 XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("jmp 0x02")), @"Should have the correct instruction");
                 CCStringDestroy(Instruction);
                 
                 {
-                    CCLinkedListNode *Node = GraphNode->jump;
-                    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-                    if (Node)
+                    uint16_t Node = GraphNode->jump;
+                    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+                    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
                     {
-                        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+                        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
                         XCTAssertEqual(GraphNode->offset, 8, @"Should have the correct offset");
-                        XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+                        XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
                         
                         CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
                         XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("mov r2,0x02")), @"Should have the correct instruction");
                         CCStringDestroy(Instruction);
                     }
                     
-                    Node = CCLinkedListEnumerateNext(Node);
-                    XCTAssertNotEqual(Node, NULL, @"Should have the correct graph node");
-                    if (Node)
+                    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+                    XCTAssertNotEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should have the correct graph node");
+                    if (Node != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
                     {
-                        const HKHubArchExecutionGraphInstruction *GraphNode = CCLinkedListGetNodeData(Node);
+                        const HKHubArchExecutionGraphInstruction *GraphNode = CCArrayGetElementAtIndex(Processor->cache.graph->instruction, Node);
                         XCTAssertEqual(GraphNode->offset, 0x0b, @"Should have the correct offset");
-                        XCTAssertEqual(GraphNode->jump, NULL, @"Should not jump to another node");
+                        XCTAssertEqual(GraphNode->jump, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not jump to another node");
                         
                         CCString Instruction = HKHubArchInstructionDisassemble(&GraphNode->state);
                         XCTAssertTrue(CCStringEqual(Instruction, CC_STRING("hlt")), @"Should have the correct instruction");
                         CCStringDestroy(Instruction);
                     }
                     
-                    Node = CCLinkedListEnumerateNext(Node);
-                    XCTAssertEqual(Node, NULL, @"Should not have another graph node");
+                    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+                    XCTAssertEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not have another graph node");
                 }
             }
             
-            Node = CCLinkedListEnumerateNext(Node);
-            XCTAssertEqual(Node, NULL, @"Should not have another graph node");
+            Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+            XCTAssertEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not have another graph node");
         }
     }
     
-    Node = CCLinkedListEnumerateNext(Node);
-    XCTAssertEqual(Node, NULL, @"Should not have another graph node");
+    Node = HKHubArchExecutionGraphNextNode(Processor->cache.graph, Node);
+    XCTAssertEqual(Node, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, @"Should not have another graph node");
     
     HKHubArchBinaryDestroy(Binary);
     HKHubArchProcessorDestroy(Processor);
 }
 
+-(void) testSharedCache
+{
+    const char *Source =
+        "mov r0, 2\n"
+        "repeat:\n"
+        "add r0, 1\n"
+        "jmp repeat\n"
+    ;
+    
+    CCOrderedCollection AST = HKHubArchAssemblyParse(Source);
+    
+    CCOrderedCollection Errors = NULL;
+    HKHubArchBinary Binary = HKHubArchAssemblyCreateBinary(CC_STD_ALLOCATOR, AST, &Errors); HKHubArchAssemblyPrintError(Errors);
+    CCCollectionDestroy(AST);
+    
+    HKHubArchProcessor ProcessorA = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, Binary), ProcessorB = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, Binary);
+    
+    HKHubArchProcessorCache(ProcessorA, 0);
+    HKHubArchProcessorCache(ProcessorB, 0);
+    
+    XCTAssertEqual(ProcessorA->cache.graph, ProcessorB->cache.graph, @"Should share the execution graph");
+    XCTAssertEqual(ProcessorA->cache.jit, ProcessorB->cache.jit, @"Should share the JIT");
+    
+    HKHubArchProcessorCache(ProcessorA, HKHubArchJITOptionsWatchMemory);
+    HKHubArchProcessorCache(ProcessorB, HKHubArchJITOptionsWatchMemory);
+    
+    XCTAssertEqual(ProcessorA->cache.graph, ProcessorB->cache.graph, @"Should share the execution graph");
+    if (ProcessorA->cache.jit) XCTAssertNotEqual(ProcessorA->cache.jit, ProcessorB->cache.jit, @"Should not share a JIT that can be modified");
+    
+    HKHubArchExecutionGraph Graph = ProcessorA->cache.graph;
+    HKHubArchProcessorCache(ProcessorA, HKHubArchJITOptionsDebug);
+    HKHubArchProcessorCache(ProcessorB, HKHubArchJITOptionsCache);
+    
+    XCTAssertEqual(ProcessorA->cache.graph, Graph, @"Should share the execution graph regardless of the options");
+    XCTAssertEqual(ProcessorB->cache.graph, Graph, @"Should share the execution graph regardless of the options");
+    if (ProcessorA->cache.jit) XCTAssertNotEqual(ProcessorA->cache.jit, ProcessorB->cache.jit, @"Should not share a JIT that can be modified");
+    
+    ProcessorB->memory[0] ^= 0xff;
+    HKHubArchProcessorCache(ProcessorB, 0);
+    HKHubArchProcessorCache(ProcessorA, 0);
+    
+    XCTAssertNotEqual(ProcessorA->cache.graph, ProcessorB->cache.graph, @"Should not share the cache of different programs");
+    
+    HKHubArchProcessor Processor = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, Binary);
+    
+    HKHubArchProcessorSetCycles(Processor, 100);
+    HKHubArchProcessorRun(Processor);
+    
+    HKHubArchProcessorSetCycles(ProcessorA, 100);
+    HKHubArchProcessorRun(ProcessorA);
+    
+    XCTAssertEqual(ProcessorA->state.r[0], Processor->state.r[0], @"Should run the shared cache");
+    XCTAssertEqual(ProcessorA->state.pc, Processor->state.pc, @"Should run the shared cache");
+    XCTAssertEqual(ProcessorA->cycles, Processor->cycles, @"Should run the shared cache");
+    
+    HKHubArchProcessorDestroy(Processor);
+    HKHubArchProcessorDestroy(ProcessorA);
+    HKHubArchProcessorDestroy(ProcessorB);
+    HKHubArchBinaryDestroy(Binary);
+}
+
 @end
@@ -293,4 +293,94 @@
     HKHubArchSchedulerDestroy(Scheduler);
 }
 
+-(void) testModifiedInstructions
+{
+    CCOrderedCollection AST = HKHubArchAssemblyParse(".entrypoint\nstart:\nadd r0, 1\njmp start\n");
+    
+    CCOrderedCollection Errors = NULL;
+    HKHubArchBinary Binary = HKHubArchAssemblyCreateBinary(CC_STD_ALLOCATOR, AST, &Errors); HKHubArchAssemblyPrintError(Errors);
+    CCCollectionDestroy(AST);
+    
+    AST = HKHubArchAssemblyParse(".entrypoint\nstart:\nadd r0, 3\njmp start\n");
+    
+    HKHubArchBinary ModifiedBinary = HKHubArchAssemblyCreateBinary(CC_STD_ALLOCATOR, AST, &Errors); HKHubArchAssemblyPrintError(Errors);
+    CCCollectionDestroy(AST);
+    
+    HKHubArchProcessor Processor = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, Binary);
+    
+    HKHubArchProcessorSetCycles(Processor, 100);
+    HKHubArchProcessorSetDebugMode(Processor, HKHubArchProcessorDebugModePause);
+    
+    HKHubArchProcessorStep(Processor, 2);
+    HKHubArchProcessorRun(Processor);
+    XCTAssertEqual(Processor->state.r[0], 1, "Should execute the original instruction");
+    
+    HKHubArchProcessorStep(Processor, 2);
+    HKHubArchProcessorRun(Processor);
+    XCTAssertEqual(Processor->state.r[0], 2, "Should execute the original instruction");
+    
+    memcpy(Processor->memory, ModifiedBinary->data, sizeof(Processor->memory));
+    
+    HKHubArchProcessorStep(Processor, 2);
+    HKHubArchProcessorRun(Processor);
+    XCTAssertEqual(Processor->state.r[0], 5, "Should execute the modified instruction");
+    
+    HKHubArchBinaryDestroy(Binary);
+    HKHubArchBinaryDestroy(ModifiedBinary);
+    HKHubArchProcessorDestroy(Processor);
+}
+
+-(void) testBreakpointRanges
+{
+    CCOrderedCollection AST = HKHubArchAssemblyParse(".entrypoint\nadd r0, 2\nhlt\n");
+    
+    CCOrderedCollection Errors = NULL;
+    HKHubArchBinary Binary = HKHubArchAssemblyCreateBinary(CC_STD_ALLOCATOR, AST, &Errors); HKHubArchAssemblyPrintError(Errors);
+    CCCollectionDestroy(AST);
+    
+    HKHubArchProcessor Processor = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, Binary);
+    
+    XCTAssertFalse(HKHubArchProcessorHasBreakpoints(Processor), "Should not have any breakpoints");
+    
+    const uint8_t Starts[] = { 62, 254 };
+    for (size_t Loop = 0; Loop < sizeof(Starts) / sizeof(*Starts); Loop++)
+    {
+        const uint8_t Start = Starts[Loop];
+        
+        HKHubArchProcessorReset(Processor, Binary);
+        HKHubArchProcessorSetDebugMode(Processor, HKHubArchProcessorDebugModeContinue);
+        memset(Processor->memory, 0, sizeof(Processor->memory));
+        for (uint8_t Offset = 0; Offset < 4; Offset++) Processor->memory[(uint8_t)(Start + Offset)] = Binary->data[Offset];
+        Processor->state.pc = Start;
+        
+        HKHubArchProcessorSetBreakpoint(Processor, HKHubArchProcessorDebugBreakpointRead, Start + 2);
+        
+        XCTAssertTrue(HKHubArchProcessorHasBreakpoints(Processor), "Should have breakpoints");
+        XCTAssertEqual(HKHubArchProcessorGetBreakpoint(Processor, Start + 2), HKHubArchProcessorDebugBreakpointRead, "Should have the breakpoint");
+        XCTAssertEqual(HKHubArchProcessorGetBreakpoint(Processor, Start + 3), HKHubArchProcessorDebugBreakpointNone, "Should not have the breakpoint");
+        
+        HKHubArchProcessorSetCycles(Processor, 100);
+        HKHubArchProcessorRun(Processor);
+        XCTAssertEqual(Processor->state.pc, Start, "Should break on the last byte of the instruction");
+        XCTAssertEqual(Processor->state.debug.mode, HKHubArchProcessorDebugModePause, "Should break at the correct location");
+        
+        HKHubArchProcessorSetBreakpoint(Processor, HKHubArchProcessorDebugBreakpointNone, Start + 2);
+        HKHubArchProcessorSetBreakpoint(Processor, HKHubArchProcessorDebugBreakpointRead | HKHubArchProcessorDebugBreakpointWrite, Start + 3);
+        
+        XCTAssertEqual(HKHubArchProcessorGetBreakpoint(Processor, Start + 3), HKHubArchProcessorDebugBreakpointRead | HKHubArchProcessorDebugBreakpointWrite, "Should have the breakpoint");
+        
+        HKHubArchProcessorSetDebugMode(Processor, HKHubArchProcessorDebugModeContinue);
+        HKHubArchProcessorRun(Processor);
+        XCTAssertEqual(Processor->state.pc, (uint8_t)(Start + 3), "Should break at the following instruction");
+        XCTAssertEqual(Processor->state.r[0], 2, "Should have executed the instruction");
+        XCTAssertEqual(Processor->state.debug.mode, HKHubArchProcessorDebugModePause, "Should break at the correct location");
+        
+        HKHubArchProcessorClearBreakpoints(Processor);
+        XCTAssertFalse(HKHubArchProcessorHasBreakpoints(Processor), "Should not have any breakpoints");
+    }
+    
+    HKHubArchBinaryDestroy(Binary);
+    HKHubArchProcessorDestroy(Processor);
+}
+
 @end
@@ -1625,6 +1625,92 @@ static HKHubArchPortResponse TestAccumulationSequence(HKHubArchPortConnection Co
     HKHubArchProcessorDestroy(Checker);
 }
 
+-(void) testParallelScheduling
+{
+    const char *Source =
+        "data: .byte 0\n"
+        ".entrypoint\n"
+        "repeat: add [data], 1\n"
+        "send 0, 1, [data]\n"
+        "jmp repeat\n"
+    ;
+    
+    CCOrderedCollection AST = HKHubArchAssemblyParse(Source);
+    
+    CCOrderedCollection Errors = NULL;
+    HKHubArchBinary SenderBinary = HKHubArchAssemblyCreateBinary(CC_STD_ALLOCATOR, AST, &Errors); HKHubArchAssemblyPrintError(Errors);
+    CCCollectionDestroy(AST);
+    
+    
+    Source =
+        "data: .byte 0\n"
+        ".entrypoint\n"
+        "repeat: recv 1, [data]\n"
+        "add r0, [data]\n"
+        "jmp repeat\n"
+    ;
+    
+    AST = HKHubArchAssemblyParse(Source);
+    
+    Errors = NULL;
+    HKHubArchBinary ReceiverBinary = HKHubArchAssemblyCreateBinary(CC_STD_ALLOCATOR, AST, &Errors); HKHubArchAssemblyPrintError(Errors);
+    CCCollectionDestroy(AST);
+    
+    
+    HKHubArchScheduler Scheduler[2] = { HKHubArchSchedulerCreate(CC_STD_ALLOCATOR), HKHubArchSchedulerCreate(CC_STD_ALLOCATOR) };
+    HKHubArchSchedulerSetMode(Scheduler[1], HKHubArchSchedulerModeParallel);
+    HKHubArchSchedulerSetWorkerCount(Scheduler[1], 4);
+    XCTAssertEqual(HKHubArchSchedulerGetMode(Scheduler[0]), HKHubArchSchedulerModeSerial, @"Should default to serial");
+    XCTAssertEqual(HKHubArchSchedulerGetMode(Scheduler[1]), HKHubArchSchedulerModeParallel, @"Should be parallel");
+    
+    HKHubArchProcessor Senders[2][8], Receivers[2][8];
+    for (size_t Loop = 0; Loop < 2; Loop++)
+    {
+        for (size_t Loop2 = 0; Loop2 < 8; Loop2++)
+        {
+            Senders[Loop][Loop2] = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, SenderBinary);
+            Receivers[Loop][Loop2] = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, ReceiverBinary);
+            
+            HKHubArchPortConnection Conn = HKHubArchPortConnectionCreate(CC_STD_ALLOCATOR, HKHubArchProcessorGetPort(Senders[Loop][Loop2], 0), HKHubArchProcessorGetPort(Receivers[Loop][Loop2], 1));
+            HKHubArchProcessorConnect(Senders[Loop][Loop2], 0, Conn);
+            HKHubArchProcessorConnect(Receivers[Loop][Loop2], 1, Conn);
+            HKHubArchPortConnectionDestroy(Conn);
+            
+            HKHubArchProcessorSetCycles(Senders[Loop][Loop2], 100 + (Loop2 * 50));
+            HKHubArchProcessorSetCycles(Receivers[Loop][Loop2], 100 + (Loop2 * 50));
+            
+            HKHubArchSchedulerAddProcessor(Scheduler[Loop], Senders[Loop][Loop2]);
+            HKHubArchSchedulerAddProcessor(Scheduler[Loop], Receivers[Loop][Loop2]);
+        }
+        
+        HKHubArchSchedulerRun(Scheduler[Loop], 0.0);
+    }
+    
+    XCTAssertEqual(HKHubArchSchedulerGetTimestamp(Scheduler[0]), HKHubArchSchedulerGetTimestamp(Scheduler[1]), @"Should have the same timestamp");
+    
+    for (size_t Loop = 0; Loop < 8; Loop++)
+    {
+        XCTAssertEqual(Senders[0][Loop]->state.pc, Senders[1][Loop]->state.pc, @"Should run the same as the serial scheduler");
+        XCTAssertEqual(Senders[0][Loop]->cycles, Senders[1][Loop]->cycles, @"Should run the same as the serial scheduler");
+        XCTAssertEqual(Senders[0][Loop]->memory[0], Senders[1][Loop]->memory[0], @"Should run the same as the serial scheduler");
+        XCTAssertEqual(Receivers[0][Loop]->state.pc, Receivers[1][Loop]->state.pc, @"Should run the same as the serial scheduler");
+        XCTAssertEqual(Receivers[0][Loop]->state.r[0], Receivers[1][Loop]->state.r[0], @"Should run the same as the serial scheduler");
+        XCTAssertEqual(Receivers[0][Loop]->cycles, Receivers[1][Loop]->cycles, @"Should run the same as the serial scheduler");
+        XCTAssertNotEqual(Receivers[1][Loop]->state.r[0], 0, @"Should have received data");
+        
+        for (size_t Loop2 = 0; Loop2 < 2; Loop2++)
+        {
+            HKHubArchProcessorDestroy(Senders[Loop2][Loop]);
+            HKHubArchProcessorDestroy(Receivers[Loop2][Loop]);
+        }
+    }
+    
+    HKHubArchSchedulerDestroy(Scheduler[0]);
+    HKHubArchSchedulerDestroy(Scheduler[1]);
+    HKHubArchBinaryDestroy(SenderBinary);
+    HKHubArchBinaryDestroy(ReceiverBinary);
+}
+
 -(void) testHalting
 {
     const char *Source = ".byte 0xa8\n"; //invalid opcode
@@ -6039,4 +6125,56 @@ static HKHubArchPortResponse TestAccumulationSequence(HKHubArchPortConnection Co
     HKHubArchProcessorDestroy(Processor);
 }
 
+-(void) testLoweredInstructions
+{
+    const char *Source =
+        ".entrypoint\n"
+        "mov r0, 240\n"
+        "mov r1, 3\n"
+        "loop:\n"
+        "add r0, r1\n"
+        "sub r2, 1\n"
+        "xor r3, r2\n"
+        "or r3, 1\n"
+        "and r3, r0\n"
+        "cmp r0, 20\n"
+        "jug loop\n"
+        "mov [0], r3\n"
+        "hlt\n"
+    ;
+    
+    CCOrderedCollection AST = HKHubArchAssemblyParse(Source);
+    
+    CCOrderedCollection Errors = NULL;
+    HKHubArchBinary Binary = HKHubArchAssemblyCreateBinary(CC_STD_ALLOCATOR, AST, &Errors); HKHubArchAssemblyPrintError(Errors);
+    CCCollectionDestroy(AST);
+    
+    HKHubArchProcessor Lowered = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, Binary);
+    HKHubArchProcessor Stepped = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, Binary);
+    HKHubArchProcessorSetDebugMode(Stepped, HKHubArchProcessorDebugModePause);
+    
+    for (size_t Cycles = 1; Cycles < 100; Cycles += 7)
+    {
+        HKHubArchProcessorSetCycles(Lowered, Cycles);
+        HKHubArchProcessorRun(Lowered);
+        
+        HKHubArchProcessorSetCycles(Stepped, Cycles);
+        HKHubArchProcessorStep(Stepped, SIZE_MAX);
+        HKHubArchProcessorRun(Stepped);
+        
+        XCTAssertEqual(Lowered->cycles, Stepped->cycles, @"Should consume the same cycles");
+        XCTAssertEqual(Lowered->status, Stepped->status, @"Should have the same status");
+        XCTAssertEqual(Lowered->state.pc, Stepped->state.pc, @"Should have the same state");
+        XCTAssertEqual(Lowered->state.flags, Stepped->state.flags, @"Should have the same state");
+        XCTAssertTrue(!memcmp(Lowered->state.r, Stepped->state.r, sizeof(Lowered->state.r)), @"Should have the same state");
+        XCTAssertTrue(!memcmp(Lowered->memory, Stepped->memory, sizeof(Lowered->memory)), @"Should have the same state");
+    }
+    
+    XCTAssertEqual(Lowered->status, HKHubArchProcessorStatusIdle, @"Should complete");
+    
+    HKHubArchBinaryDestroy(Binary);
+    HKHubArchProcessorDestroy(Lowered);
+    HKHubArchProcessorDestroy(Stepped);
+}
+
 @end
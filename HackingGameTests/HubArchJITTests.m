@@ -33,6 +33,12 @@
 
 void HKHubArchJITCall(HKHubArchJIT JIT, HKHubArchProcessor Processor);
 
+static size_t TraceCycles = 0;
+static void TraceJIT(HKHubArchProcessor Processor, uint8_t Entry, uint8_t Exit, size_t Cycles)
+{
+    TraceCycles += Cycles;
+}
+
 @interface HubArchJITTests : XCTestCase
 
 @end
@@ -54,6 +60,8 @@ void HKHubArchJITCall(HKHubArchJIT JIT, HKHubArchProcessor Processor);
     HKHubArchJIT JIT = HKHubArchJITCreate(CC_STD_ALLOCATOR, Graph, 0);
     HKHubArchExecutionGraphDestroy(Graph);
     
+    XCTAssertNotEqual(JIT, NULL, "Should have an executable memory backend for the platform");
+    
     HKHubArchProcessorSetCycles(Processor, 1000);
     for (size_t PrevCycles = 0; PrevCycles != Processor->cycles; )
     {
@@ -2487,6 +2495,56 @@ void HKHubArchJITCall(HKHubArchJIT JIT, HKHubArchProcessor Processor);
     for (size_t Loop = 0; Loop < sizeof(Sources) / sizeof(typeof(*Sources)); Loop++) [self run: Sources[Loop]];
 }
 
+-(void) testBlockLinking
+{
+    const char *Source =
+        "mov r0, 2\n"
+        "repeat:\n"
+        "add r0, 1\n"
+        "jmp skip\n"
+        "mov r1, 3\n"
+        "skip:\n"
+        "add r1, 2\n"
+        "jmp repeat\n";
+    
+    CCOrderedCollection AST = HKHubArchAssemblyParse(Source);
+    
+    CCOrderedCollection Errors = NULL;
+    HKHubArchBinary Binary = HKHubArchAssemblyCreateBinary(CC_STD_ALLOCATOR, AST, &Errors); HKHubArchAssemblyPrintError(Errors);
+    CCCollectionDestroy(AST);
+    
+    HKHubArchExecutionGraph Graph = HKHubArchExecutionGraphCreate(CC_STD_ALLOCATOR, Binary->data, Binary->entrypoint);
+    HKHubArchProcessor Processor = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, Binary), ProcessorLoop = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, Binary);
+    HKHubArchBinaryDestroy(Binary);
+    
+    XCTAssertGreaterThan(CCArrayGetCount(Graph->block), 1, "Should span multiple blocks");
+    
+    HKHubArchJIT JIT = HKHubArchJITCreate(CC_STD_ALLOCATOR, Graph, 0);
+    HKHubArchExecutionGraphDestroy(Graph);
+    
+    XCTAssertGreaterThan(CCArrayGetCount(JIT->links), 0, "Should link the block exits");
+    
+    HKHubArchProcessorSetCycles(Processor, 1000);
+    HKHubArchJITCall(JIT, Processor);
+    
+    HKHubArchProcessorSetCycles(ProcessorLoop, 1000);
+    for (size_t PrevCycles = 0; PrevCycles != ProcessorLoop->cycles; )
+    {
+        PrevCycles = ProcessorLoop->cycles;
+        HKHubArchJITCall(JIT, ProcessorLoop);
+    }
+    
+    HKHubArchJITDestroy(JIT);
+    
+    XCTAssertEqual(Processor->state.r[0], ProcessorLoop->state.r[0], "Should stay in native code until the cycles run out");
+    XCTAssertEqual(Processor->state.r[1], ProcessorLoop->state.r[1], "Should stay in native code until the cycles run out");
+    XCTAssertEqual(Processor->state.pc, ProcessorLoop->state.pc, "Should stay in native code until the cycles run out");
+    XCTAssertEqual(Processor->cycles, ProcessorLoop->cycles, "Should stay in native code until the cycles run out");
+    
+    HKHubArchProcessorDestroy(Processor);
+    HKHubArchProcessorDestroy(ProcessorLoop);
+}
+
 -(void) testJump
 {
     const char *Sources[] = {
@@ -5045,6 +5103,24 @@ void HKHubArchJITCall(HKHubArchJIT JIT, HKHubArchProcessor Processor);
     for (size_t Loop = 0; Loop < sizeof(Sources) / sizeof(typeof(*Sources)); Loop++) [self run: Sources[Loop]];
 }
 
+-(void) testLargeBlocks
+{
+    char Source[1024] = "";
+    
+    //A straight-line block of 256 instructions
+    for (size_t Loop = 0; Loop < 255; Loop++) strcat(Source, "nop\n");
+    strcat(Source, "hlt\n");
+    
+    [self run: Source];
+    
+    //A straight-line block of the largest instructions
+    strcpy(Source, "mov r0, 3\n");
+    for (size_t Loop = 0; Loop < 80; Loop++) strcat(Source, Loop % 2 ? "smod r1, r0\n" : "sdiv r1, r0\n");
+    strcat(Source, "hlt\n");
+    
+    [self run: Source];
+}
+
 -(void) testPartials
 {
     const char *Sources[] = {
@@ -5359,4 +5435,364 @@ void HKHubArchJITCall(HKHubArchJIT JIT, HKHubArchProcessor Processor);
     HKHubArchBinaryDestroy(Binary);
 }
 
+-(void) testFusedInstructions
+{
+    const char *Source =
+        ".entrypoint\n"
+        "mov r0, 5\n"
+        "loop:\n"
+        "sub r0, 1\n"
+        "jnz loop\n"
+        "cmp r1, 0\n"
+        "jz done\n"
+        "mov r2, 1\n"
+        "done:\n"
+        "hlt\n"
+    ;
+    
+    CCOrderedCollection AST = HKHubArchAssemblyParse(Source);
+    
+    CCOrderedCollection Errors = NULL;
+    HKHubArchBinary Binary = HKHubArchAssemblyCreateBinary(CC_STD_ALLOCATOR, AST, &Errors); HKHubArchAssemblyPrintError(Errors);
+    CCCollectionDestroy(AST);
+    
+    HKHubArchExecutionGraph Graph = HKHubArchExecutionGraphCreate(CC_STD_ALLOCATOR, Binary->data, Binary->entrypoint);
+    
+    size_t Fused = 0;
+    for (size_t Loop = 0, Count = CCArrayGetCount(Graph->instruction); Loop < Count; Loop++)
+    {
+        if (((HKHubArchExecutionGraphInstruction*)CCArrayGetElementAtIndex(Graph->instruction, Loop))->fusion & HKHubArchExecutionGraphFusionFollower) Fused++;
+    }
+    
+    HKHubArchExecutionGraphDestroy(Graph);
+    
+    XCTAssertEqual(Fused, 2, @"Should fuse the sub+jnz and cmp+jz pairs");
+    
+    HKHubArchProcessor JIT = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, Binary);
+    HKHubArchProcessorCache(JIT, 0);
+    
+    HKHubArchProcessor Lowered = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, Binary);
+    
+    HKHubArchProcessor Stepped = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, Binary);
+    HKHubArchProcessorSetDebugMode(Stepped, HKHubArchProcessorDebugModePause);
+    
+    HKHubArchBinaryDestroy(Binary);
+    
+    for (size_t Cycles = 1; Cycles < 20; Cycles++)
+    {
+        HKHubArchProcessorSetCycles(JIT, Cycles);
+        HKHubArchProcessorRun(JIT);
+        
+        HKHubArchProcessorSetCycles(Lowered, Cycles);
+        HKHubArchProcessorRun(Lowered);
+        
+        HKHubArchProcessorSetCycles(Stepped, Cycles);
+        HKHubArchProcessorStep(Stepped, SIZE_MAX);
+        HKHubArchProcessorRun(Stepped);
+        
+        XCTAssertEqual(JIT->cycles, Stepped->cycles, @"Should consume the same cycles");
+        XCTAssertEqual(JIT->status, Stepped->status, @"Should have the same status");
+        XCTAssertEqual(JIT->state.pc, Stepped->state.pc, @"Should have the same state");
+        XCTAssertEqual(JIT->state.flags, Stepped->state.flags, @"Should have the same state");
+        XCTAssertTrue(!memcmp(JIT->state.r, Stepped->state.r, sizeof(JIT->state.r)), @"Should have the same state");
+        
+        XCTAssertEqual(Lowered->cycles, Stepped->cycles, @"Should consume the same cycles");
+        XCTAssertEqual(Lowered->status, Stepped->status, @"Should have the same status");
+        XCTAssertEqual(Lowered->state.pc, Stepped->state.pc, @"Should have the same state");
+        XCTAssertEqual(Lowered->state.flags, Stepped->state.flags, @"Should have the same state");
+        XCTAssertTrue(!memcmp(Lowered->state.r, Stepped->state.r, sizeof(Lowered->state.r)), @"Should have the same state");
+    }
+    
+    XCTAssertEqual(JIT->status, HKHubArchProcessorStatusIdle, @"Should complete");
+    XCTAssertEqual(JIT->state.r[0], 0, @"Should have the correct value");
+    XCTAssertEqual(JIT->state.r[2], 0, @"Should have the correct value");
+    
+    HKHubArchProcessorDestroy(JIT);
+    HKHubArchProcessorDestroy(Lowered);
+    HKHubArchProcessorDestroy(Stepped);
+}
+
+
+-(void) testFlagLiveness
+{
+    const char *Source =
+        ".entrypoint\n"
+        "mov r0, 0x35\n"
+        "mov r1, 7\n"
+        "loop:\n"
+        "add r0, r1\n"
+        "xor r0, 0x5a\n"
+        "mov r2, r0\n"
+        "and r2, 0x0f\n"
+        "or r3, r2\n"
+        "sub r1, 1\n"
+        "jnz loop\n"
+        "hlt\n"
+    ;
+    
+    CCOrderedCollection AST = HKHubArchAssemblyParse(Source);
+    
+    CCOrderedCollection Errors = NULL;
+    HKHubArchBinary Binary = HKHubArchAssemblyCreateBinary(CC_STD_ALLOCATOR, AST, &Errors); HKHubArchAssemblyPrintError(Errors);
+    CCCollectionDestroy(AST);
+    
+    HKHubArchExecutionGraph Graph = HKHubArchExecutionGraphCreate(CC_STD_ALLOCATOR, Binary->data, Binary->entrypoint);
+    
+    size_t Elided = 0, Fused = 0;
+    for (size_t Loop = 0, Count = CCArrayGetCount(Graph->instruction); Loop < Count; Loop++)
+    {
+        const HKHubArchExecutionGraphInstruction *Instruction = CCArrayGetElementAtIndex(Graph->instruction, Loop);
+        const HKHubArchProcessorFlags Write = HKHubArchInstructionWriteFlags(&Instruction->state);
+        
+        if ((Write) && (!(Instruction->live & Write))) Elided++;
+        if (Instruction->fusion & HKHubArchExecutionGraphFusionFollower) Fused++;
+        
+        if (HKHubArchInstructionReadFlags(&Instruction->state))
+        {
+            XCTAssertEqual(((HKHubArchExecutionGraphInstruction*)CCArrayGetElementAtIndex(Graph->instruction, Loop - 1))->live, HKHubArchProcessorFlagsMask, @"Should keep the flags read by the branch");
+        }
+    }
+    
+    HKHubArchExecutionGraphDestroy(Graph);
+    
+    XCTAssertEqual(Elided, 4, @"Should elide the flags overwritten by the following instructions");
+    XCTAssertEqual(Fused, 6, @"Should fuse the loop body into one operation");
+    
+    HKHubArchProcessor JIT = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, Binary);
+    HKHubArchProcessorCache(JIT, 0);
+    
+    HKHubArchProcessor Stepped = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, Binary);
+    HKHubArchProcessorSetDebugMode(Stepped, HKHubArchProcessorDebugModePause);
+    
+    HKHubArchBinaryDestroy(Binary);
+    
+    for (size_t Cycles = 1; Cycles < 30; Cycles++)
+    {
+        HKHubArchProcessorSetCycles(JIT, Cycles);
+        HKHubArchProcessorRun(JIT);
+        
+        HKHubArchProcessorSetCycles(Stepped, Cycles);
+        HKHubArchProcessorStep(Stepped, SIZE_MAX);
+        HKHubArchProcessorRun(Stepped);
+        
+        XCTAssertEqual(JIT->cycles, Stepped->cycles, @"Should consume the same cycles");
+        XCTAssertEqual(JIT->status, Stepped->status, @"Should have the same status");
+        XCTAssertEqual(JIT->state.pc, Stepped->state.pc, @"Should have the same state");
+        XCTAssertEqual(JIT->state.flags, Stepped->state.flags, @"Should have the same state");
+        XCTAssertTrue(!memcmp(JIT->state.r, Stepped->state.r, sizeof(JIT->state.r)), @"Should have the same state");
+    }
+    
+    XCTAssertEqual(JIT->status, HKHubArchProcessorStatusIdle, @"Should complete");
+    XCTAssertEqual(JIT->state.r[0], 0x1b, @"Should have the correct value");
+    XCTAssertEqual(JIT->state.r[1], 0, @"Should have the correct value");
+    XCTAssertEqual(JIT->state.r[2], 0x0b, @"Should have the correct value");
+    XCTAssertEqual(JIT->state.r[3], 0x0f, @"Should have the correct value");
+    XCTAssertEqual(JIT->state.flags, HKHubArchProcessorFlagsZero, @"Should have the correct flags");
+    
+    HKHubArchProcessorDestroy(JIT);
+    HKHubArchProcessorDestroy(Stepped);
+}
+
+-(void) testBlockBudget
+{
+    const char *Source =
+        ".byte 1\n"
+        ".entrypoint\n"
+        "mov r0, 0\n"
+        "mov r1, 5\n"
+        "loop:\n"
+        "add r0, r1\n"
+        "shl [0], 1\n"
+        "xor r2, r0\n"
+        "sub r1, 1\n"
+        "jnz loop\n"
+        "hlt\n"
+    ;
+    
+    CCOrderedCollection AST = HKHubArchAssemblyParse(Source);
+    
+    CCOrderedCollection Errors = NULL;
+    HKHubArchBinary Binary = HKHubArchAssemblyCreateBinary(CC_STD_ALLOCATOR, AST, &Errors); HKHubArchAssemblyPrintError(Errors);
+    CCCollectionDestroy(AST);
+    
+    HKHubArchProcessor JIT = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, Binary);
+    HKHubArchProcessorCache(JIT, 0);
+    
+    HKHubArchProcessor Stepped = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, Binary);
+    HKHubArchProcessorSetDebugMode(Stepped, HKHubArchProcessorDebugModePause);
+    
+    HKHubArchBinaryDestroy(Binary);
+    
+    for (size_t Cycles = 1; Cycles < 40; Cycles++)
+    {
+        HKHubArchProcessorSetCycles(JIT, Cycles);
+        HKHubArchProcessorRun(JIT);
+        
+        HKHubArchProcessorSetCycles(Stepped, Cycles);
+        HKHubArchProcessorStep(Stepped, SIZE_MAX);
+        HKHubArchProcessorRun(Stepped);
+        
+        XCTAssertEqual(JIT->cycles, Stepped->cycles, @"Should consume the same cycles");
+        XCTAssertEqual(JIT->status, Stepped->status, @"Should have the same status");
+        XCTAssertEqual(JIT->state.pc, Stepped->state.pc, @"Should have the same state");
+        XCTAssertEqual(JIT->state.flags, Stepped->state.flags, @"Should have the same state");
+        XCTAssertTrue(!memcmp(JIT->state.r, Stepped->state.r, sizeof(JIT->state.r)), @"Should have the same state");
+        XCTAssertEqual(JIT->memory[0], Stepped->memory[0], @"Should have the same memory");
+    }
+    
+    XCTAssertEqual(JIT->status, HKHubArchProcessorStatusIdle, @"Should complete");
+    XCTAssertEqual(JIT->state.r[0], 15, @"Should have the correct value");
+    XCTAssertEqual(JIT->state.r[1], 0, @"Should have the correct value");
+    XCTAssertEqual(JIT->state.r[2], 5 ^ 9 ^ 12 ^ 14 ^ 15, @"Should have the correct value");
+    XCTAssertEqual(JIT->memory[0], 1 << 5, @"Should have the correct value");
+    
+    HKHubArchProcessorDestroy(JIT);
+    HKHubArchProcessorDestroy(Stepped);
+}
+
+-(void) testIndirectAutoInvalidation
+{
+    const char *Source =
+        "mov r1, Modify\n"
+        "mov r2, Data\n"
+        "mov r0, 5\n"
+        "add [r2], 1\n"
+        "or [r1], 4 << 2\n"
+        "Modify:\n"
+        "add r0, 1\n"
+        "add r0, 2\n"
+        "hlt\n"
+        "Data: .byte 0\n"
+    ;
+    
+    CCOrderedCollection AST = HKHubArchAssemblyParse(Source);
+    
+    CCOrderedCollection Errors = NULL;
+    HKHubArchBinary Binary = HKHubArchAssemblyCreateBinary(CC_STD_ALLOCATOR, AST, &Errors); HKHubArchAssemblyPrintError(Errors);
+    CCCollectionDestroy(AST);
+    
+    HKHubArchProcessor Interpreted = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, Binary);
+    HKHubArchProcessorSetCycles(Interpreted, 100);
+    HKHubArchProcessorRun(Interpreted);
+    
+    XCTAssertEqual(Interpreted->state.r[0], 6, "Should have the correct value");
+    
+    HKHubArchProcessor Processor = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, Binary);
+    HKHubArchProcessorCache(Processor, HKHubArchJITOptionsWatchMemory);
+    HKHubArchProcessorSetCycles(Processor, 100);
+    HKHubArchProcessorRun(Processor);
+    
+    XCTAssertEqual(Processor->state.pc, Interpreted->state.pc, "Should have the correct value");
+    XCTAssertEqual(Processor->cycles, Interpreted->cycles, "Should have the correct value");
+    XCTAssertEqual(Processor->state.r[0], 6, "Should have the correct value");
+    XCTAssertEqual(memcmp(Processor->memory, Interpreted->memory, sizeof(Processor->memory)), 0, "Should have the correct value");
+    
+    HKHubArchProcessorDestroy(Processor);
+    
+    
+    Processor = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, Binary);
+    HKHubArchProcessorCache(Processor, HKHubArchJITOptionsWatchMemory | HKHubArchJITOptionsCache);
+    HKHubArchProcessorSetCycles(Processor, 100);
+    HKHubArchProcessorRun(Processor);
+    
+    XCTAssertEqual(Processor->state.pc, Interpreted->state.pc, "Should have the correct value");
+    XCTAssertEqual(Processor->cycles, Interpreted->cycles, "Should have the correct value");
+    XCTAssertEqual(Processor->state.r[0], 6, "Should have the correct value");
+    XCTAssertEqual(memcmp(Processor->memory, Interpreted->memory, sizeof(Processor->memory)), 0, "Should have the correct value");
+    
+    HKHubArchProcessorDestroy(Processor);
+    HKHubArchProcessorDestroy(Interpreted);
+    HKHubArchBinaryDestroy(Binary);
+}
+
+-(void) testDebugBreakpoints
+{
+    const char *Source =
+        ".byte 0\n"
+        ".entrypoint\n"
+        "mov r0, 1\n"
+        "mov r1, 0\n"
+        "loop:\n"
+        "add r0, 1\n"
+        "mov [r1], r0\n"
+        "cmp r0, 5\n"
+        "jnz loop\n"
+        "hlt\n"
+    ;
+    
+    CCOrderedCollection AST = HKHubArchAssemblyParse(Source);
+    
+    CCOrderedCollection Errors = NULL;
+    HKHubArchBinary Binary = HKHubArchAssemblyCreateBinary(CC_STD_ALLOCATOR, AST, &Errors); HKHubArchAssemblyPrintError(Errors);
+    CCCollectionDestroy(AST);
+    
+    const uint8_t Data = 0;
+    
+    HKHubArchProcessor JIT = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, Binary);
+    HKHubArchProcessorCache(JIT, HKHubArchJITOptionsDebug);
+    JIT->debug.trace = TraceJIT;
+    
+    HKHubArchProcessor Interpreted = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, Binary);
+    
+    HKHubArchBinaryDestroy(Binary);
+    
+    HKHubArchProcessorSetBreakpoint(JIT, HKHubArchProcessorDebugBreakpointWrite, Data);
+    HKHubArchProcessorSetBreakpoint(Interpreted, HKHubArchProcessorDebugBreakpointWrite, Data);
+    
+    TraceCycles = 0;
+    HKHubArchProcessorSetCycles(JIT, 1000);
+    HKHubArchProcessorSetCycles(Interpreted, 1000);
+    HKHubArchProcessorRun(JIT);
+    HKHubArchProcessorRun(Interpreted);
+    
+    XCTAssertEqual(JIT->state.debug.mode, HKHubArchProcessorDebugModePause, "Should break at the write");
+    XCTAssertEqual(JIT->state.pc, Interpreted->state.pc, "Should have the correct value");
+    XCTAssertEqual(JIT->cycles, Interpreted->cycles, "Should have the correct value");
+    XCTAssertEqual(JIT->state.r[0], 2, "Should have the correct value");
+    XCTAssertEqual(JIT->memory[Data], 0, "Should not have written to memory");
+    XCTAssertNotEqual(TraceCycles, 0, "Should have executed native code");
+    XCTAssertEqual(TraceCycles + JIT->cycles, 1000, "Should trace the cycles used by native code");
+    
+    const uint8_t Store = JIT->state.pc;
+    
+    HKHubArchProcessorSetBreakpoint(JIT, HKHubArchProcessorDebugBreakpointNone, Data);
+    HKHubArchProcessorSetBreakpoint(Interpreted, HKHubArchProcessorDebugBreakpointNone, Data);
+    HKHubArchProcessorSetBreakpoint(JIT, HKHubArchProcessorDebugBreakpointRead, Store);
+    HKHubArchProcessorSetBreakpoint(Interpreted, HKHubArchProcessorDebugBreakpointRead, Store);
+    
+    for (int Loop = 0; Loop < 3; Loop++)
+    {
+        HKHubArchProcessorStep(JIT, 1);
+        HKHubArchProcessorStep(Interpreted, 1);
+        HKHubArchProcessorRun(JIT);
+        HKHubArchProcessorRun(Interpreted);
+        HKHubArchProcessorSetDebugMode(JIT, HKHubArchProcessorDebugModeContinue);
+        HKHubArchProcessorSetDebugMode(Interpreted, HKHubArchProcessorDebugModeContinue);
+        HKHubArchProcessorRun(JIT);
+        HKHubArchProcessorRun(Interpreted);
+        
+        XCTAssertEqual(JIT->state.debug.mode, HKHubArchProcessorDebugModePause, "Should break at the instruction");
+        XCTAssertEqual(JIT->state.pc, Store, "Should have the correct value");
+        XCTAssertEqual(JIT->cycles, Interpreted->cycles, "Should have the correct value");
+        XCTAssertEqual(JIT->state.r[0], Loop + 3, "Should have the correct value");
+        XCTAssertEqual(JIT->memory[Data], Loop + 2, "Should have the correct value");
+    }
+    
+    HKHubArchProcessorClearBreakpoints(JIT);
+    HKHubArchProcessorClearBreakpoints(Interpreted);
+    
+    HKHubArchProcessorSetDebugMode(JIT, HKHubArchProcessorDebugModeContinue);
+    HKHubArchProcessorSetDebugMode(Interpreted, HKHubArchProcessorDebugModeContinue);
+    HKHubArchProcessorRun(JIT);
+    HKHubArchProcessorRun(Interpreted);
+    
+    XCTAssertEqual(JIT->state.pc, Interpreted->state.pc, "Should have the correct value");
+    XCTAssertEqual(JIT->cycles, Interpreted->cycles, "Should have the correct value");
+    XCTAssertEqual(JIT->state.r[0], 5, "Should have the correct value");
+    XCTAssertEqual(JIT->memory[Data], 5, "Should have the correct value");
+    
+    HKHubArchProcessorDestroy(JIT);
+    HKHubArchProcessorDestroy(Interpreted);
+}
+
 @end
@@ -0,0 +1,358 @@
+/*
+ *  Copyright (c) 2022, Stefan Johnson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list
+ *     of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this
+ *     list of conditions and the following disclaimer in the documentation and/or other
+ *     materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#import <XCTest/XCTest.h>
+#import "HubArchProcessor.h"
+#import "HubArchAssembly.h"
+#import "HubArchScheduler.h"
+#import <threads.h>
+
+#define HKHubArchAssemblyPrintError(err) if (Errors) { HKHubArchAssemblyPrintError(err); CCCollectionDestroy(err); err = NULL; }
+
+@interface HubArchSchedulerTests : XCTestCase
+
+@end
+
+@implementation HubArchSchedulerTests
+
+static HKHubArchBinary CreateBinary(const char *Source)
+{
+    CCOrderedCollection AST = HKHubArchAssemblyParse(Source);
+    
+    CCOrderedCollection Errors = NULL;
+    HKHubArchBinary Binary = HKHubArchAssemblyCreateBinary(CC_STD_ALLOCATOR, AST, &Errors); HKHubArchAssemblyPrintError(Errors);
+    CCCollectionDestroy(AST);
+    
+    return Binary;
+}
+
+/*
+ Creates a world of mostly halted or isolated processors, with a pair of chatty processors for every 100 processors.
+ */
+static HKHubArchScheduler CreateWorld(size_t Count)
+{
+    HKHubArchBinary Sender = CreateBinary(
+        "data: .byte 0\n"
+        ".entrypoint\n"
+        "repeat: add [data], 1\n"
+        "send 0, 1, [data]\n"
+        "jmp repeat\n"
+    );
+    
+    HKHubArchBinary Receiver = CreateBinary(
+        "data: .byte 0\n"
+        ".entrypoint\n"
+        "repeat: recv 1, [data]\n"
+        "add r0, [data]\n"
+        "jmp repeat\n"
+    );
+    
+    HKHubArchBinary Idle = CreateBinary(
+        "repeat: add r0, 1\n"
+        "jmp repeat\n"
+    );
+    
+    HKHubArchBinary Halt = CreateBinary("hlt\n");
+    
+    HKHubArchScheduler Scheduler = HKHubArchSchedulerCreate(CC_STD_ALLOCATOR);
+    
+    for (size_t Loop = 0; Loop < Count; Loop++)
+    {
+        if ((Loop % 100) == 0)
+        {
+            HKHubArchProcessor A = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, Sender);
+            HKHubArchProcessor B = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, Receiver);
+            
+            HKHubArchPortConnection Conn = HKHubArchPortConnectionCreate(CC_STD_ALLOCATOR, HKHubArchProcessorGetPort(A, 0), HKHubArchProcessorGetPort(B, 1));
+            HKHubArchProcessorConnect(A, 0, Conn);
+            HKHubArchProcessorConnect(B, 1, Conn);
+            HKHubArchPortConnectionDestroy(Conn);
+            
+            HKHubArchSchedulerAddProcessor(Scheduler, A);
+            HKHubArchSchedulerAddProcessor(Scheduler, B);
+            HKHubArchProcessorDestroy(A);
+            HKHubArchProcessorDestroy(B);
+            
+            Loop++;
+        }
+        
+        else
+        {
+            HKHubArchProcessor Processor = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, Loop % 2 ? Idle : Halt);
+            HKHubArchSchedulerAddProcessor(Scheduler, Processor);
+            HKHubArchProcessorDestroy(Processor);
+        }
+    }
+    
+    HKHubArchBinaryDestroy(Sender);
+    HKHubArchBinaryDestroy(Receiver);
+    HKHubArchBinaryDestroy(Idle);
+    HKHubArchBinaryDestroy(Halt);
+    
+    return Scheduler;
+}
+
+-(void) testStrategies
+{
+    const struct {
+        HKHubArchSchedulerMode mode;
+        HKHubArchSchedulerStrategy strategy;
+    } Configurations[] = {
+        { HKHubArchSchedulerModeSerial, HKHubArchSchedulerStrategyScan },
+        { HKHubArchSchedulerModeSerial, HKHubArchSchedulerStrategyActiveList },
+        { HKHubArchSchedulerModeParallel, HKHubArchSchedulerStrategyScan },
+        { HKHubArchSchedulerModeParallel, HKHubArchSchedulerStrategyActiveList },
+        { HKHubArchSchedulerModeSerial, HKHubArchSchedulerStrategyBatch },
+        { HKHubArchSchedulerModeParallel, HKHubArchSchedulerStrategyBatch }
+    };
+    
+    size_t Timestamps[sizeof(Configurations) / sizeof(*Configurations)][4];
+    for (size_t Loop = 0; Loop < sizeof(Configurations) / sizeof(*Configurations); Loop++)
+    {
+        HKHubArchScheduler Scheduler = CreateWorld(1000);
+        HKHubArchSchedulerSetMode(Scheduler, Configurations[Loop].mode);
+        HKHubArchSchedulerSetStrategy(Scheduler, Configurations[Loop].strategy);
+        XCTAssertEqual(HKHubArchSchedulerGetStrategy(Scheduler), Configurations[Loop].strategy, @"Should use the correct strategy");
+        
+        for (size_t Loop2 = 0; Loop2 < 4; Loop2++)
+        {
+            HKHubArchSchedulerRun(Scheduler, 1.0 / 60.0);
+            Timestamps[Loop][Loop2] = HKHubArchSchedulerGetTimestamp(Scheduler);
+            
+            if (Loop) XCTAssertEqual(Timestamps[Loop][Loop2], Timestamps[0][Loop2], @"Should produce the same timestamp as the scan strategy");
+        }
+        
+        HKHubArchSchedulerDestroy(Scheduler);
+    }
+}
+
+static thrd_t TracedThread;
+static _Bool TracedOtherThread = FALSE;
+static void TraceThread(HKHubArchProcessor Processor, uint8_t Entry, uint8_t Exit, size_t Cycles)
+{
+    if (!thrd_equal(thrd_current(), TracedThread)) TracedOtherThread = TRUE;
+}
+
+-(void) testSharedGroupThread
+{
+    HKHubArchBinary Binary = CreateBinary(
+        "repeat: add r0, 1\n"
+        "jmp repeat\n"
+    );
+    
+    HKHubArchScheduler Scheduler = CreateWorld(1000);
+    HKHubArchSchedulerSetMode(Scheduler, HKHubArchSchedulerModeParallel);
+    HKHubArchSchedulerSetStrategy(Scheduler, HKHubArchSchedulerStrategyBatch);
+    HKHubArchSchedulerSetWorkerCount(Scheduler, 4);
+    
+    HKHubArchProcessor Debugged[8];
+    for (size_t Loop = 0; Loop < 8; Loop++)
+    {
+        Debugged[Loop] = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, Binary);
+        Debugged[Loop]->debug.context = Debugged;
+        Debugged[Loop]->debug.trace = TraceThread;
+        
+        HKHubArchSchedulerAddProcessor(Scheduler, Debugged[Loop]);
+    }
+    
+    TracedThread = thrd_current();
+    TracedOtherThread = FALSE;
+    
+    for (size_t Loop = 0; Loop < 4; Loop++) HKHubArchSchedulerRun(Scheduler, 1.0 / 60.0);
+    
+    XCTAssertFalse(TracedOtherThread, @"Should only run debugged processors on the calling thread");
+    for (size_t Loop = 0; Loop < 8; Loop++)
+    {
+        XCTAssertNotEqual(Debugged[Loop]->state.r[0], 0, @"Should run the debugged processors");
+        
+        Debugged[Loop]->debug.context = NULL;
+        Debugged[Loop]->debug.trace = NULL;
+        HKHubArchProcessorDestroy(Debugged[Loop]);
+    }
+    
+    HKHubArchSchedulerDestroy(Scheduler);
+    HKHubArchBinaryDestroy(Binary);
+}
+
+-(void) testWaitingProcessors
+{
+    HKHubArchBinary SenderBinary = CreateBinary(
+        "data: .byte 5\n"
+        ".entrypoint\n"
+        "send 0, 1, [data]\n"
+        "hlt\n"
+    );
+    
+    HKHubArchBinary ReceiverBinary = CreateBinary(
+        "data: .byte 0\n"
+        ".entrypoint\n"
+        "recv 1, [data]\n"
+        "hlt\n"
+    );
+    
+    HKHubArchProcessor Sender = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, SenderBinary);
+    HKHubArchProcessor Receiver = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, ReceiverBinary);
+    HKHubArchBinaryDestroy(SenderBinary);
+    HKHubArchBinaryDestroy(ReceiverBinary);
+    
+    HKHubArchPortConnection Conn = HKHubArchPortConnectionCreate(CC_STD_ALLOCATOR, HKHubArchProcessorGetPort(Sender, 0), HKHubArchProcessorGetPort(Receiver, 1));
+    HKHubArchProcessorConnect(Sender, 0, Conn);
+    HKHubArchProcessorConnect(Receiver, 1, Conn);
+    XCTAssertTrue(Conn->direct, @"Should connect processors directly");
+    
+    HKHubArchProcessorSetCycles(Sender, 100);
+    HKHubArchProcessorSetCycles(Receiver, 100);
+    
+    HKHubArchProcessorRun(Sender);
+    XCTAssertTrue(Sender->waiting, @"Should be waiting on the receiver");
+    XCTAssertTrue(HKHubArchPortConnectionGetPort(Conn, Sender, 0)->waiting, @"Should be waiting on the connection");
+    XCTAssertFalse(Receiver->waiting, @"Should not be waiting");
+    
+    HKHubArchProcessorRun(Receiver);
+    XCTAssertFalse(Sender->waiting, @"Should be woken by the receiver");
+    XCTAssertFalse(HKHubArchPortConnectionGetPort(Conn, Sender, 0)->waiting, @"Should no longer be waiting on the connection");
+    
+    HKHubArchScheduler Scheduler = HKHubArchSchedulerCreate(CC_STD_ALLOCATOR);
+    HKHubArchSchedulerAddProcessor(Scheduler, Sender);
+    HKHubArchSchedulerAddProcessor(Scheduler, Receiver);
+    HKHubArchSchedulerRun(Scheduler, 0.0);
+    
+    XCTAssertEqual(Receiver->memory[0], 5, @"Should receive the data");
+    XCTAssertEqual(Sender->status, HKHubArchProcessorStatusIdle, @"Should have halted");
+    XCTAssertEqual(Receiver->status, HKHubArchProcessorStatusIdle, @"Should have halted");
+    
+    HKHubArchPortConnection ModuleConn = HKHubArchPortConnectionCreate(CC_STD_ALLOCATOR, HKHubArchProcessorGetPort(Sender, 1), (HKHubArchPort){ .device = NULL, .id = 0 });
+    XCTAssertFalse(HKHubArchPortConnectionWait(ModuleConn, Sender, 1), @"Should not wait on devices that cannot wake it");
+    HKHubArchPortConnectionDestroy(ModuleConn);
+    
+    HKHubArchPortConnectionDestroy(Conn);
+    HKHubArchSchedulerDestroy(Scheduler);
+    HKHubArchProcessorDestroy(Sender);
+    HKHubArchProcessorDestroy(Receiver);
+}
+
+-(void) testBatch
+{
+    HKHubArchBinary Binary = CreateBinary(
+        "data: .byte 0\n"
+        ".entrypoint\n"
+        "repeat: add r1, r0\n"
+        "cmp r1, 100\n"
+        "jsl skip\n"
+        "add [data], 1\n"
+        "skip: xor r2, r1\n"
+        "and r3, 0x3f\n"
+        "or r3, r2\n"
+        "sub r0, 1\n"
+        "jnz repeat\n"
+        "hlt\n"
+    );
+    
+    HKHubArchProcessor Batched[40], Individual[40];
+    for (size_t Loop = 0; Loop < 40; Loop++)
+    {
+        Batched[Loop] = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, Binary);
+        Individual[Loop] = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, Binary);
+        
+        //Most processors start in the same state, while a few will diverge at different points
+        Batched[Loop]->state.r[0] = Individual[Loop]->state.r[0] = (Loop % 8) ? 10 : Loop + 1;
+        
+        const size_t Cycles = (Loop % 5) ? 1000 : 100 + Loop;
+        HKHubArchProcessorSetCycles(Batched[Loop], Cycles);
+        HKHubArchProcessorSetCycles(Individual[Loop], Cycles);
+    }
+    
+    HKHubArchProcessorRunBatch(Batched, 40);
+    for (size_t Loop = 0; Loop < 40; Loop++) HKHubArchProcessorRun(Individual[Loop]);
+    
+    for (size_t Loop = 0; Loop < 40; Loop++)
+    {
+        XCTAssertEqual(Batched[Loop]->status, Individual[Loop]->status, @"Should have the same status");
+        XCTAssertEqual(Batched[Loop]->cycles, Individual[Loop]->cycles, @"Should have the same cycles");
+        XCTAssertEqual(Batched[Loop]->state.pc, Individual[Loop]->state.pc, @"Should have the same pc");
+        XCTAssertEqual(Batched[Loop]->state.flags, Individual[Loop]->state.flags, @"Should have the same flags");
+        XCTAssertTrue(!memcmp(Batched[Loop]->state.r, Individual[Loop]->state.r, sizeof(Batched[Loop]->state.r)), @"Should have the same registers");
+        XCTAssertTrue(!memcmp(Batched[Loop]->memory, Individual[Loop]->memory, sizeof(Batched[Loop]->memory)), @"Should have the same memory");
+        
+        HKHubArchProcessorDestroy(Batched[Loop]);
+        HKHubArchProcessorDestroy(Individual[Loop]);
+    }
+    
+    HKHubArchBinaryDestroy(Binary);
+}
+
+-(void) measureStrategy: (HKHubArchSchedulerStrategy)strategy WithProcessors: (size_t)count
+{
+    HKHubArchScheduler Scheduler = CreateWorld(count);
+    HKHubArchSchedulerSetStrategy(Scheduler, strategy);
+    
+    [self measureBlock: ^{
+        HKHubArchSchedulerRun(Scheduler, 1.0 / 60.0);
+    }];
+    
+    HKHubArchSchedulerDestroy(Scheduler);
+}
+
+-(void) testScanPerformance10
+{
+    [self measureStrategy: HKHubArchSchedulerStrategyScan WithProcessors: 10];
+}
+
+-(void) testActiveListPerformance10
+{
+    [self measureStrategy: HKHubArchSchedulerStrategyActiveList WithProcessors: 10];
+}
+
+-(void) testScanPerformance1000
+{
+    [self measureStrategy: HKHubArchSchedulerStrategyScan WithProcessors: 1000];
+}
+
+-(void) testActiveListPerformance1000
+{
+    [self measureStrategy: HKHubArchSchedulerStrategyActiveList WithProcessors: 1000];
+}
+
+-(void) testScanPerformance100000
+{
+    [self measureStrategy: HKHubArchSchedulerStrategyScan WithProcessors: 100000];
+}
+
+-(void) testActiveListPerformance100000
+{
+    [self measureStrategy: HKHubArchSchedulerStrategyActiveList WithProcessors: 100000];
+}
+
+-(void) testBatchPerformance1000
+{
+    [self measureStrategy: HKHubArchSchedulerStrategyBatch WithProcessors: 1000];
+}
+
+-(void) testBatchPerformance100000
+{
+    [self measureStrategy: HKHubArchSchedulerStrategyBatch WithProcessors: 100000];
+}
+
+@end
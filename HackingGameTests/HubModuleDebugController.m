@@ -29,6 +29,7 @@
 #import "HubArchScheduler.h"
 #import "HubModuleDebugController.h"
 #import "HubModuleKeyboard.h"
+#import "HubProcessorComponent.h"
 
 #define HKHubArchAssemblyPrintError(err) if (Errors) { HKHubArchAssemblyPrintError(err); CCCollectionDestroy(err); err = NULL; }
 
@@ -1412,4 +1413,79 @@
     HKHubArchSchedulerDestroy(Scheduler);
 }
 
+-(void) testComponentJIT
+{
+    HKHubProcessorComponentRegister();
+    
+    const char *Source =
+        ".byte 0\n"
+        ".entrypoint\n"
+        "mov r0, 1\n"
+        "mov r1, 0\n"
+        "loop:\n"
+        "add r0, 1\n"
+        "mov [r1], r0\n"
+        "cmp r0, 5\n"
+        "jnz loop\n"
+        "hlt\n"
+    ;
+    
+    CCOrderedCollection AST = HKHubArchAssemblyParse(Source);
+    
+    CCOrderedCollection Errors = NULL;
+    HKHubArchBinary Binary = HKHubArchAssemblyCreateBinary(CC_STD_ALLOCATOR, AST, &Errors); HKHubArchAssemblyPrintError(Errors);
+    CCCollectionDestroy(AST);
+    
+    CCComponent Component = CCComponentCreate(HK_HUB_PROCESSOR_COMPONENT_ID);
+    HKHubProcessorComponentSetProcessor(Component, HKHubArchProcessorCreate(CC_STD_ALLOCATOR, Binary));
+    HKHubArchBinaryDestroy(Binary);
+    
+    CCExpression Arg = CCExpressionCreateFromSource("(jit: 1)");
+    HKHubProcessorComponentDeserializer(Component, Arg, FALSE);
+    CCExpressionDestroy(Arg);
+    
+    HKHubArchProcessor Processor = HKHubProcessorComponentGetProcessor(Component);
+    
+    XCTAssertTrue(Processor->cache.jit, @"Should have generated a JIT");
+    XCTAssertFalse(Processor->cache.jit->options & HKHubArchJITOptionsDebug, @"Should not generate the JIT for debugging");
+    
+    HKHubModule DebugController = HKHubModuleDebugControllerCreate(CC_STD_ALLOCATOR);
+    HKHubModuleDebugControllerConnectProcessor(DebugController, Processor, CC_STRING("hub"));
+    
+    XCTAssertTrue(Processor->cache.jit, @"Should have generated a JIT");
+    XCTAssertTrue(Processor->cache.jit->options & HKHubArchJITOptionsDebug, @"Should generate the JIT for debugging once debugged");
+    
+    HKHubArchProcessorSetBreakpoint(Processor, HKHubArchProcessorDebugBreakpointWrite, 0);
+    HKHubArchProcessorSetDebugMode(Processor, HKHubArchProcessorDebugModeContinue);
+    HKHubArchProcessorSetCycles(Processor, 1000);
+    HKHubArchProcessorRun(Processor);
+    
+    XCTAssertEqual(Processor->state.debug.mode, HKHubArchProcessorDebugModePause, @"Should break at the write");
+    XCTAssertEqual(Processor->state.r[0], 2, @"Should have the correct value");
+    XCTAssertEqual(Processor->memory[0], 0, @"Should not have written to memory");
+    XCTAssertTrue(Processor->cache.jit->options & HKHubArchJITOptionsDebug, @"Should keep the JIT generated for debugging");
+    
+    HKHubModuleDebugControllerDisconnectProcessor(DebugController, Processor);
+    
+    XCTAssertTrue(Processor->cache.jit->options & HKHubArchJITOptionsDebug, @"Should keep the JIT generated for debugging while breakpoints remain");
+    
+    HKHubArchProcessorClearBreakpoints(Processor);
+    HKHubModuleDebugControllerConnectProcessor(DebugController, Processor, CC_STRING("hub"));
+    HKHubModuleDebugControllerDisconnectProcessor(DebugController, Processor);
+    
+    XCTAssertTrue(Processor->cache.jit, @"Should have generated a JIT");
+    XCTAssertFalse(Processor->cache.jit->options & HKHubArchJITOptionsDebug, @"Should not generate the JIT for debugging once no longer debugged");
+    
+    HKHubArchProcessorRun(Processor);
+    
+    XCTAssertEqual(Processor->status, HKHubArchProcessorStatusIdle, @"Should have finished");
+    XCTAssertEqual(Processor->state.r[0], 5, @"Should have the correct value");
+    XCTAssertEqual(Processor->memory[0], 5, @"Should have the correct value");
+    
+    HKHubModuleDestroy(DebugController);
+    CCComponentDestroy(Component);
+    
+    HKHubProcessorComponentDeregister();
+}
+
 @end
@@ -1746,4 +1746,37 @@ static const uint8_t Glyph1x1[] = {
     HKHubModuleDestroy(Adapter);
 }
 
+-(void) testBlitAnimatedTiles
+{
+    HKHubModule Adapter = HKHubModuleGraphicsAdapterCreate(CC_STD_ALLOCATOR);
+    
+    HKHubModuleGraphicsAdapterSetViewport(Adapter, 0, 0, 0, 1, 0);
+    
+    HKHubModuleGraphicsAdapterSetCursor(Adapter, 0, 0, 0);
+    HKHubModuleGraphicsAdapterSetCursorVisibility(Adapter, 0, 0);
+    HKHubModuleGraphicsAdapterSetCursorOrigin(Adapter, 0, 0, 0);
+    
+    uint8_t Bitmap[(1 + (HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL * HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL)) * 2];
+    Bitmap[0] = 0xf0;
+    memset(&Bitmap[1], 1, HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL * HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL);
+    Bitmap[1 + (HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL * HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL)] = 0x0f;
+    memset(&Bitmap[2 + (HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL * HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL)], 2, HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL * HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL);
+    
+    HKHubModuleGraphicsAdapterSetGlyphBitmap(Adapter, 'x', 0, 0, 7, Bitmap, 2);
+    [self drawChars: "xx" AtLayer: 0 ForAdapter: Adapter];
+    
+    uint8_t Framebuffer[HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL * HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL * 2];
+    HKHubModuleGraphicsAdapterBlit(Adapter, 0, Framebuffer, sizeof(Framebuffer));
+    
+    for (size_t Loop = 0; Loop < sizeof(Framebuffer); Loop++) XCTAssertEqual(Framebuffer[Loop], 1, @"Should match pixel (%zu)", Loop);
+    
+    for (size_t Loop = 0; Loop < 4; Loop++) HKHubModuleGraphicsAdapterNextFrame(Adapter);
+    
+    HKHubModuleGraphicsAdapterBlit(Adapter, 0, Framebuffer, sizeof(Framebuffer));
+    
+    for (size_t Loop = 0; Loop < sizeof(Framebuffer); Loop++) XCTAssertEqual(Framebuffer[Loop], 2, @"Should use the glyph for the current frame at pixel (%zu)", Loop);
+    
+    HKHubModuleDestroy(Adapter);
+}
+
 @end
@@ -125,6 +125,59 @@
     HKHubModuleDestroy(Transceiver);
 }
 
+-(void) testShiftingPackets
+{
+    HKHubModuleWirelessTransceiverPacketLifetime = 4;
+    
+    HKHubModule Transceiver = HKHubModuleWirelessTransceiverCreate(CC_STD_ALLOCATOR);
+    
+    HKHubModuleWirelessTransceiverReceivePacket(Transceiver, (HKHubModuleWirelessTransceiverPacket){
+        .sig = { .timestamp = 4, .channel = 12 },
+        .data = 1
+    });
+    
+    HKHubModuleWirelessTransceiverReceivePacket(Transceiver, (HKHubModuleWirelessTransceiverPacket){
+        .sig = { .timestamp = 8, .channel = 12 },
+        .data = 2
+    });
+    
+    HKHubModuleWirelessTransceiverShiftTimestamps(Transceiver, 8);
+    HKHubModuleWirelessTransceiverShiftTimestamps(Transceiver, 4);
+    
+    XCTAssertFalse(HKHubModuleWirelessTransceiverInspectPacket(Transceiver, (HKHubModuleWirelessTransceiverPacketSignature){ .timestamp = 4, .channel = 12 }, NULL), @"Should not contain a packet");
+    XCTAssertFalse(HKHubModuleWirelessTransceiverInspectPacket(Transceiver, (HKHubModuleWirelessTransceiverPacketSignature){ .timestamp = 8, .channel = 12 }, NULL), @"Should not contain a packet");
+    
+    uint8_t Data = 0;
+    XCTAssertTrue(HKHubModuleWirelessTransceiverInspectPacket(Transceiver, (HKHubModuleWirelessTransceiverPacketSignature){ .timestamp = 17, .channel = 12 }, &Data), @"Should contain a packet");
+    XCTAssertEqual(Data, 1, @"Packet should contain the expected data");
+    
+    Data = 0;
+    XCTAssertTrue(HKHubModuleWirelessTransceiverInspectPacket(Transceiver, (HKHubModuleWirelessTransceiverPacketSignature){ .timestamp = 20, .channel = 12 }, &Data), @"Should contain a packet");
+    XCTAssertEqual(Data, 2, @"Packet should contain the expected data");
+    
+    HKHubModuleWirelessTransceiverReceivePacket(Transceiver, (HKHubModuleWirelessTransceiverPacket){
+        .sig = { .timestamp = 18, .channel = 12 },
+        .data = 4
+    });
+    
+    Data = 0;
+    XCTAssertTrue(HKHubModuleWirelessTransceiverInspectPacket(Transceiver, (HKHubModuleWirelessTransceiverPacketSignature){ .timestamp = 16, .channel = 12 }, &Data), @"Should contain a packet");
+    XCTAssertEqual(Data, 1 ^ 4, @"Packet should contain the expected data");
+    
+    XCTAssertEqual(CCDataGetSize(HKHubModuleGetMemory(Transceiver)), 2, @"Should be the correct size");
+    
+    HKHubModuleWirelessTransceiverPacketPurge(Transceiver, 20);
+    
+    XCTAssertTrue(HKHubModuleWirelessTransceiverInspectPacket(Transceiver, (HKHubModuleWirelessTransceiverPacketSignature){ .timestamp = 16, .channel = 12 }, NULL), @"Should contain a packet");
+    XCTAssertFalse(HKHubModuleWirelessTransceiverInspectPacket(Transceiver, (HKHubModuleWirelessTransceiverPacketSignature){ .timestamp = 20, .channel = 12 }, NULL), @"Should not contain a packet");
+    
+    HKHubModuleWirelessTransceiverPacketPurge(Transceiver, 0);
+    
+    XCTAssertFalse(HKHubModuleWirelessTransceiverInspectPacket(Transceiver, (HKHubModuleWirelessTransceiverPacketSignature){ .timestamp = 16, .channel = 12 }, NULL), @"Should not contain a packet");
+    
+    HKHubModuleDestroy(Transceiver);
+}
+
 static HKHubArchScheduler Scheduler;
 
 static HKHubArchScheduler GetScheduler(HKHubModule Module)
@@ -445,4 +498,193 @@ static void Broadcast(HKHubModule Transmitter, HKHubModuleWirelessTransceiverPac
     for (size_t Loop = 0; Loop < sizeof(Transceivers) / sizeof(typeof(*Transceivers)); Loop++) HKHubModuleDestroy(Transceivers[Loop]);
 }
 
+-(void) testBusCommunication
+{
+    HKHubModuleWirelessTransceiverPacketLifetime = 1;
+    
+    Scheduler = HKHubArchSchedulerCreate(CC_STD_ALLOCATOR);
+    HKHubModuleWirelessTransceiverGetScheduler = GetScheduler;
+    HKHubModuleWirelessTransceiverBroadcast = NULL;
+    
+    HKHubModuleWirelessTransceiverBus Bus = HKHubModuleWirelessTransceiverBusCreate(CC_STD_ALLOCATOR);
+    
+    HKHubModule BusTransceivers[3];
+    for (size_t Loop = 0; Loop < 3; Loop++)
+    {
+        BusTransceivers[Loop] = HKHubModuleWirelessTransceiverCreate(CC_STD_ALLOCATOR);
+        HKHubModuleWirelessTransceiverSetBus(BusTransceivers[Loop], Bus);
+    }
+    
+    const char *Sources[3] = {
+        ".define channel0, 0\n"
+        "packet: .byte 1\n"
+        ".entrypoint\n"
+        "send channel0, 1, [packet]\n" //cycles(14) = read(5) + instruction(4) + read(1) + transfer<1>(4)
+        "hlt\n",
+        
+        ".define channel0, 0\n"
+        "packet: .byte 3\n"
+        ".entrypoint\n"
+        "send channel0, 1, [packet]\n" //cycles(14) = read(5) + instruction(4) + read(1) + transfer<1>(4)
+        "hlt\n",
+        
+        ".define channel0, 0\n"
+        "packet: .byte 0\n"
+        ".entrypoint\n"
+        "nop\n" //cycles(1) = read(1)
+        "nop\n" //cycles(1) = read(1)
+        "nop\n" //cycles(1) = read(1)
+        "nop\n" //cycles(1) = read(1)
+        "nop\n" //cycles(1) = read(1)
+        "nop\n" //cycles(1) = read(1)
+        "recv channel0, [packet]\n" //cycles(13) = read(4) + instruction(4) + write(1) + transfer<1>(4)
+        "hlt\n"
+    };
+    
+    HKHubArchBinary Binaries[3];
+    HKHubArchProcessor Processors[3];
+    for (size_t Loop = 0; Loop < 3; Loop++)
+    {
+        CCOrderedCollection AST = HKHubArchAssemblyParse(Sources[Loop]);
+        
+        CCOrderedCollection Errors = NULL;
+        Binaries[Loop] = HKHubArchAssemblyCreateBinary(CC_STD_ALLOCATOR, AST, &Errors); HKHubArchAssemblyPrintError(Errors);
+        CCCollectionDestroy(AST);
+        
+        Processors[Loop] = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, Binaries[Loop]);
+        
+        HKHubArchPortConnection Conn = HKHubArchPortConnectionCreate(CC_STD_ALLOCATOR, HKHubArchProcessorGetPort(Processors[Loop], 0), HKHubModuleGetPort(BusTransceivers[Loop], 0));
+        
+        HKHubArchProcessorConnect(Processors[Loop], 0, Conn);
+        HKHubModuleConnect(BusTransceivers[Loop], 0, Conn);
+        HKHubArchPortConnectionDestroy(Conn);
+        
+        HKHubArchSchedulerAddProcessor(Scheduler, Processors[Loop]);
+        HKHubArchProcessorSetCycles(Processors[Loop], 100);
+    }
+    
+    HKHubArchSchedulerRun(Scheduler, 0.0);
+    
+    uint8_t Data = 0;
+    XCTAssertTrue(HKHubModuleWirelessTransceiverInspectPacket(BusTransceivers[0], (HKHubModuleWirelessTransceiverPacketSignature){ .timestamp = 86, .channel = 0 }, &Data), @"Should contain a packet");
+    XCTAssertEqual(Data, 3, @"Should not receive its own transmission");
+    
+    Data = 0;
+    XCTAssertTrue(HKHubModuleWirelessTransceiverInspectPacket(BusTransceivers[1], (HKHubModuleWirelessTransceiverPacketSignature){ .timestamp = 86, .channel = 0 }, &Data), @"Should contain a packet");
+    XCTAssertEqual(Data, 1, @"Should not receive its own transmission");
+    
+    Data = 0;
+    XCTAssertTrue(HKHubModuleWirelessTransceiverInspectPacket(BusTransceivers[2], (HKHubModuleWirelessTransceiverPacketSignature){ .timestamp = 86, .channel = 0 }, &Data), @"Should contain a packet");
+    XCTAssertEqual(Data, 1 ^ 3, @"Packet should contain the expected data");
+    
+    XCTAssertFalse(HKHubModuleWirelessTransceiverInspectPacket(BusTransceivers[2], (HKHubModuleWirelessTransceiverPacketSignature){ .timestamp = 86, .channel = 1 }, NULL), @"Should not contain a packet");
+    XCTAssertFalse(HKHubModuleWirelessTransceiverInspectPacket(BusTransceivers[2], (HKHubModuleWirelessTransceiverPacketSignature){ .timestamp = 85, .channel = 0 }, NULL), @"Should not contain a packet");
+    
+    XCTAssertEqual(Processors[2]->memory[0], 1 ^ 3, @"Should receive the correct packet");
+    
+    CCData Memory = HKHubModuleGetMemory(BusTransceivers[2]);
+    XCTAssertEqual(CCDataGetSize(Memory), 1, @"Should include the packets on the bus");
+    
+    uint8_t RawPacket = 0;
+    CCDataReadBuffer(Memory, 0, sizeof(RawPacket), &RawPacket);
+    XCTAssertEqual(RawPacket, 1 ^ 3, @"Should be the correct packet");
+    
+    Memory = HKHubModuleGetMemory(BusTransceivers[0]);
+    XCTAssertEqual(CCDataGetSize(Memory), 1, @"Should include the packets on the bus");
+    
+    RawPacket = 0;
+    CCDataReadBuffer(Memory, 0, sizeof(RawPacket), &RawPacket);
+    XCTAssertEqual(RawPacket, 3, @"Should not include its own transmission");
+    
+    HKHubModuleWirelessTransceiverBusShiftTimestamps(Bus, 10);
+    for (size_t Loop = 0; Loop < 3; Loop++) HKHubModuleWirelessTransceiverShiftTimestamps(BusTransceivers[Loop], 10);
+    
+    Data = 0;
+    XCTAssertTrue(HKHubModuleWirelessTransceiverInspectPacket(BusTransceivers[0], (HKHubModuleWirelessTransceiverPacketSignature){ .timestamp = 96, .channel = 0 }, &Data), @"Should contain a packet");
+    XCTAssertEqual(Data, 3, @"Should not receive its own transmission");
+    XCTAssertFalse(HKHubModuleWirelessTransceiverInspectPacket(BusTransceivers[0], (HKHubModuleWirelessTransceiverPacketSignature){ .timestamp = 86, .channel = 0 }, NULL), @"Should not contain a packet");
+    
+    HKHubModuleWirelessTransceiverBusPacketPurge(Bus, 0);
+    for (size_t Loop = 0; Loop < 3; Loop++) HKHubModuleWirelessTransceiverPacketPurge(BusTransceivers[Loop], 0);
+    
+    XCTAssertFalse(HKHubModuleWirelessTransceiverInspectPacket(BusTransceivers[2], (HKHubModuleWirelessTransceiverPacketSignature){ .timestamp = 96, .channel = 0 }, NULL), @"Should not contain a packet");
+    
+    for (size_t Loop = 0; Loop < 3; Loop++)
+    {
+        HKHubArchBinaryDestroy(Binaries[Loop]);
+        HKHubArchProcessorDestroy(Processors[Loop]);
+    }
+    
+    HKHubArchSchedulerDestroy(Scheduler);
+    
+    for (size_t Loop = 0; Loop < 3; Loop++) HKHubModuleDestroy(BusTransceivers[Loop]);
+    
+    HKHubModuleWirelessTransceiverBusDestroy(Bus);
+}
+
+-(void) testBusEpochAlignment
+{
+    HKHubModuleWirelessTransceiverPacketLifetime = 4;
+    
+    Scheduler = HKHubArchSchedulerCreate(CC_STD_ALLOCATOR);
+    HKHubModuleWirelessTransceiverGetScheduler = GetScheduler;
+    HKHubModuleWirelessTransceiverBroadcast = NULL;
+    
+    HKHubModuleWirelessTransceiverBus Bus = HKHubModuleWirelessTransceiverBusCreate(CC_STD_ALLOCATOR);
+    
+    HKHubModule BusTransceivers[2];
+    for (size_t Loop = 0; Loop < 2; Loop++) BusTransceivers[Loop] = HKHubModuleWirelessTransceiverCreate(CC_STD_ALLOCATOR);
+    
+    HKHubModuleWirelessTransceiverShiftTimestamps(BusTransceivers[0], 3);
+    
+    for (size_t Loop = 0; Loop < 2; Loop++) HKHubModuleWirelessTransceiverSetBus(BusTransceivers[Loop], Bus);
+    
+    const char *Source =
+        ".define channel0, 0\n"
+        "packet: .byte 1\n"
+        ".entrypoint\n"
+        "send channel0, 1, [packet]\n" //cycles(14) = read(5) + instruction(4) + read(1) + transfer<1>(4)
+        "hlt\n";
+    
+    CCOrderedCollection AST = HKHubArchAssemblyParse(Source);
+    
+    CCOrderedCollection Errors = NULL;
+    HKHubArchBinary Binary = HKHubArchAssemblyCreateBinary(CC_STD_ALLOCATOR, AST, &Errors); HKHubArchAssemblyPrintError(Errors);
+    CCCollectionDestroy(AST);
+    
+    HKHubArchProcessor Processor = HKHubArchProcessorCreate(CC_STD_ALLOCATOR, Binary);
+    
+    HKHubArchPortConnection Conn = HKHubArchPortConnectionCreate(CC_STD_ALLOCATOR, HKHubArchProcessorGetPort(Processor, 0), HKHubModuleGetPort(BusTransceivers[0], 0));
+    
+    HKHubArchProcessorConnect(Processor, 0, Conn);
+    HKHubModuleConnect(BusTransceivers[0], 0, Conn);
+    HKHubArchPortConnectionDestroy(Conn);
+    
+    HKHubArchSchedulerAddProcessor(Scheduler, Processor);
+    HKHubArchProcessorSetCycles(Processor, 100);
+    
+    HKHubArchSchedulerRun(Scheduler, 0.0);
+    
+    XCTAssertFalse(HKHubModuleWirelessTransceiverInspectPacket(BusTransceivers[0], (HKHubModuleWirelessTransceiverPacketSignature){ .timestamp = 86, .channel = 0 }, NULL), @"Should not receive its own transmission");
+    XCTAssertFalse(HKHubModuleWirelessTransceiverInspectPacket(BusTransceivers[0], (HKHubModuleWirelessTransceiverPacketSignature){ .timestamp = 87, .channel = 0 }, NULL), @"Should not receive its own transmission");
+    
+    uint8_t Data = 0;
+    XCTAssertTrue(HKHubModuleWirelessTransceiverInspectPacket(BusTransceivers[1], (HKHubModuleWirelessTransceiverPacketSignature){ .timestamp = 87, .channel = 0 }, &Data), @"Should contain a packet");
+    XCTAssertEqual(Data, 1, @"Should receive the transmission");
+    
+    HKHubModuleWirelessTransceiverPacketPurge(BusTransceivers[0], 84);
+    HKHubModuleWirelessTransceiverBusPacketPurge(Bus, 84);
+    
+    XCTAssertFalse(HKHubModuleWirelessTransceiverInspectPacket(BusTransceivers[1], (HKHubModuleWirelessTransceiverPacketSignature){ .timestamp = 87, .channel = 0 }, NULL), @"Should not contain a packet");
+    
+    HKHubArchBinaryDestroy(Binary);
+    HKHubArchProcessorDestroy(Processor);
+    
+    HKHubArchSchedulerDestroy(Scheduler);
+    
+    for (size_t Loop = 0; Loop < 2; Loop++) HKHubModuleDestroy(BusTransceivers[Loop]);
+    
+    HKHubModuleWirelessTransceiverBusDestroy(Bus);
+}
+
 @end
@@ -2,11 +2,19 @@
 #define CC_CONTAINER_DECLARE_PRESET_CCArray() \
 CC_CONTAINER_DECLARE(CCArray, CCChar); \
 CC_CONTAINER_DECLARE(CCArray, CCFontGlyph); \
-CC_CONTAINER_DECLARE(CCArray, CC_CONTAINER(CCLinkedList, HKHubArchExecutionGraphInstruction)); \
 CC_CONTAINER_DECLARE(CCArray, HKHubArchAssemblyASTType); \
+CC_CONTAINER_DECLARE(CCArray, HKHubArchBinaryCacheEntry); \
+CC_CONTAINER_DECLARE(CCArray, HKHubArchBinaryCacheInclude); \
+CC_CONTAINER_DECLARE(CCArray, HKHubArchExecutionGraphBlock); \
+CC_CONTAINER_DECLARE(CCArray, HKHubArchExecutionGraphInstruction); \
 CC_CONTAINER_DECLARE(CCArray, HKHubArchExecutionGraphRange); \
 CC_CONTAINER_DECLARE(CCArray, HKHubArchInstructionState); \
+CC_CONTAINER_DECLARE(CCArray, HKHubArchJITBlockExit); \
 CC_CONTAINER_DECLARE(CCArray, HKHubArchJITBlockRelativeEntry); \
+CC_CONTAINER_DECLARE(CCArray, HKHubArchJITLink); \
+CC_CONTAINER_DECLARE(CCArray, HKHubArchProcessor); \
+CC_CONTAINER_DECLARE(CCArray, HKHubArchSchedulerGroup); \
+CC_CONTAINER_DECLARE(CCArray, size_t); \
 CC_CONTAINER_DECLARE(CCArray, uint16_t); \
 CC_CONTAINER_DECLARE(CCArray, uint32_t); \
 CC_CONTAINER_DECLARE(CCArray, uint8_t);
@@ -22,6 +30,7 @@ CC_CONTAINER_DECLARE(CCCollection, GFXDrawInputTexture); \
 CC_CONTAINER_DECLARE(CCCollection, GFXDrawInputVertexBuffer); \
 CC_CONTAINER_DECLARE(CCCollection, GUIObject); \
 CC_CONTAINER_DECLARE(CCCollection, HKHubArchBinaryNamedPort); \
+CC_CONTAINER_DECLARE(CCCollection, HKHubArchPortDevice); \
 CC_CONTAINER_DECLARE(CCCollection, HKHubArchProcessor);
 
 #define CC_CONTAINER_DECLARE_PRESET_CCConcurrentBuffer()
@@ -43,17 +52,16 @@ CC_CONTAINER_DECLARE(CCDictionary, CCString, GLShaderUniformInfo); \
 CC_CONTAINER_DECLARE(CCDictionary, CCString, HKHubArchAssemblySymbolExpansionRules); \
 CC_CONTAINER_DECLARE(CCDictionary, CCString, HKHubModuleDisplayBufferConverter); \
 CC_CONTAINER_DECLARE(CCDictionary, CCString, uint8_t); \
+CC_CONTAINER_DECLARE(CCDictionary, HKHubArchPortDevice, size_t); \
 CC_CONTAINER_DECLARE(CCDictionary, HKHubArchPortID, HKHubArchPortConnection); \
 CC_CONTAINER_DECLARE(CCDictionary, HKHubModuleWirelessTransceiverPacketSignature, uint8_t); \
-CC_CONTAINER_DECLARE(CCDictionary, uint8_t, HKHubArchJITBlockReferenceEntry); \
 CC_CONTAINER_DECLARE(CCDictionary, uint8_t, HKHubArchProcessorDebugBreakpoint); \
 CC_CONTAINER_DECLARE(CCDictionary, uint8_t, size_t);
 
 #define CC_CONTAINER_DECLARE_PRESET_CCHashMap()
 
 #define CC_CONTAINER_DECLARE_PRESET_CCLinkedList() \
-CC_CONTAINER_DECLARE(CCLinkedList, CCArray); \
-CC_CONTAINER_DECLARE(CCLinkedList, HKHubArchExecutionGraphInstruction);
+CC_CONTAINER_DECLARE(CCLinkedList, CCArray);
 
 #define CC_CONTAINER_DECLARE_PRESET_CCList() \
 CC_CONTAINER_DECLARE(CCList, uint64_t);
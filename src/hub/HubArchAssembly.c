@@ -80,6 +80,7 @@ typedef struct {
         uint16_t count;
         uint8_t offset;
     } bits;
+    CCOrderedCollection(FSPath) includes;
 } HKHubArchAssemblyCompilationContext;
 
 static size_t HKHubArchAssemblyRecursiveCompile(size_t Offset, HKHubArchBinary Binary, CCOrderedCollection(HKHubArchAssemblyASTNode) AST, HKHubArchAssemblyCompilationContext *Context, int Pass, size_t Depth, HKHubArchAssemblyASTNode *Command);
@@ -617,6 +618,8 @@ static size_t HKHubArchAssemblyCompileInclude(size_t Offset, HKHubArchBinary Bin
                 CCOrderedCollection(HKHubArchAssemblyASTNode) AST = HKHubArchAssemblyParse(Source);
                 CC_SAFE_Free(Source);
                 
+                if (Context->includes) CCOrderedCollectionAppendElement(Context->includes, &(FSPath){ FSPathCopy(Path) });
+                
                 Offset = HKHubArchAssemblyRecursiveCompile(Offset, Binary, AST, Context, !Binary, Depth, Command);
                 
                 if (Command->string) CCStringDestroy(Command->string);
@@ -2241,6 +2244,11 @@ static void HKHubArchAssemblyASTErrorDestructor(void *Container, HKHubArchAssemb
 }
 
 HKHubArchBinary HKHubArchAssemblyCreateBinary(CCAllocatorType Allocator, CCOrderedCollection(HKHubArchAssemblyASTNode) AST, CCOrderedCollection(HKHubArchAssemblyASTError) *Errors)
+{
+    return HKHubArchAssemblyCreateBinaryWithIncludes(Allocator, AST, Errors, NULL);
+}
+
+HKHubArchBinary HKHubArchAssemblyCreateBinaryWithIncludes(CCAllocatorType Allocator, CCOrderedCollection(HKHubArchAssemblyASTNode) AST, CCOrderedCollection(HKHubArchAssemblyASTError) *Errors, CCOrderedCollection(FSPath) Includes)
 {
     CCAssertLog(AST, "AST must not be null");
     
@@ -2257,7 +2265,8 @@ HKHubArchBinary HKHubArchAssemblyCreateBinary(CCAllocatorType Allocator, CCOrder
         .errors = CCCollectionCreate(CC_STD_ALLOCATOR, CCCollectionHintOrdered, sizeof(HKHubArchAssemblyASTError), (CCCollectionElementDestructor)HKHubArchAssemblyASTErrorDestructor),
         .ifBlocks = CCArrayCreate(CC_STD_ALLOCATOR, sizeof(HKHubArchAssemblyIfBlock), 16),
         .saved = { NULL, NULL, NULL },
-        .stop = &(_Bool){ FALSE }
+        .stop = &(_Bool){ FALSE },
+        .includes = Includes
     };
     
     Global.hardErrors = Global.errors;
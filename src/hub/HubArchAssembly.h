@@ -134,6 +134,21 @@ CC_NEW CCOrderedCollection(HKHubArchAssemblyASTNode) HKHubArchAssemblyParse(cons
  */
 CC_NEW HKHubArchBinary HKHubArchAssemblyCreateBinary(CCAllocatorType Allocator, CCOrderedCollection(HKHubArchAssemblyASTNode) AST, CC_NEW CCOrderedCollection(HKHubArchAssemblyASTError) *Errors);
 
+/*!
+ * @brief Create a binary for the given AST, and retrieve the files it included.
+ * @param Allocator The allocator to be used for the binary.
+ * @param AST The AST to validate for any errors.
+ * @param Errors Where to store the errors (collection of @b HKHubArchAssemblyASTError).
+ *        May be null if no errors should be returned to caller. If errors are returned,
+ *        they are owned by the caller and must be destroyed.
+ *
+ * @param Includes The collection to add copies of the @b FSPath paths of any included
+ *        files to. The collection must destroy its elements. May be null.
+ *
+ * @return The executable binary or null on failure. Must be destroyed to free memory.
+ */
+CC_NEW HKHubArchBinary HKHubArchAssemblyCreateBinaryWithIncludes(CCAllocatorType Allocator, CCOrderedCollection(HKHubArchAssemblyASTNode) AST, CC_NEW CCOrderedCollection(HKHubArchAssemblyASTError) *Errors, CCOrderedCollection(FSPath) Includes);
+
 /*!
  * @brief Print the AST for debugging purposes.
  * @param AST The AST to be printed.
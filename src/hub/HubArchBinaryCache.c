@@ -0,0 +1,708 @@
+/*
+ *  Copyright (c) 2022, Stefan Johnson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list
+ *     of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this
+ *     list of conditions and the following disclaimer in the documentation and/or other
+ *     materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "HubArchBinaryCache.h"
+#include <threads.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#if CC_PLATFORM_OS_X || CC_PLATFORM_UNIX || CC_PLATFORM_POSIX_COMPLIANT
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#define HK_HUB_ARCH_BINARY_CACHE_MMAN 1
+#endif
+
+/*
+ The cache file is a header followed by entries. Values are stored in host byte order, the version
+ should be bumped whenever the layout or the binary format changes.
+ 
+ Header: "HKBC" version:u32 count:u32
+ Entry: size:u64 hash:u64[2] data-size:u32 data:u8[data-size]
+ Data: entrypoint:u8 data:u8[256]
+       breakpoint-count:u16 breakpoint:u8[breakpoint-count]
+       port-count:u16 { start:u8 count:u8 name-size:u16 name:char[name-size] }[port-count]
+       include-count:u16 { hash:u64 path-size:u16 path:char[path-size] }[include-count]
+ 
+ Entries are ordered from the most to the least recently used, so the least recently used entries are
+ the ones dropped once there are too many. The file is mapped and only the keys are read when it's
+ loaded, the data of an entry is read the first time it's used.
+ */
+#define HK_HUB_ARCH_BINARY_CACHE_VERSION 3
+
+#define HK_HUB_ARCH_BINARY_CACHE_MAX_ENTRIES 1024
+
+#if DEBUG
+size_t HKHubArchBinaryCacheMaxEntries = HK_HUB_ARCH_BINARY_CACHE_MAX_ENTRIES;
+#undef HK_HUB_ARCH_BINARY_CACHE_MAX_ENTRIES
+#define HK_HUB_ARCH_BINARY_CACHE_MAX_ENTRIES HKHubArchBinaryCacheMaxEntries
+#endif
+
+typedef struct {
+    FSPath path;
+    uint64_t hash;
+} HKHubArchBinaryCacheInclude;
+
+/*
+ Sources are identified by their size and two independent hashes rather than being stored, the includes are
+ then checked against the hashes of the files they were assembled with.
+ */
+typedef struct {
+    uint64_t size;
+    uint64_t hash[2];
+} HKHubArchBinaryCacheKey;
+
+typedef struct {
+    HKHubArchBinaryCacheKey key;
+    /// The data of the entry in the cache file, or NULL if the entry wasn't loaded from the file
+    const uint8_t *data;
+    uint32_t dataSize;
+    /// The binary, or NULL if the data hasn't been read yet
+    HKHubArchBinary binary;
+    CCArray(HKHubArchBinaryCacheInclude) includes;
+    /// When the entry was last used, more recently used entries have a larger value
+    uint64_t used;
+    _Bool validated;
+} HKHubArchBinaryCacheEntry;
+
+FSPath HKHubArchBinaryCachePath = NULL;
+
+static CCArray(HKHubArchBinaryCacheEntry) HKHubArchBinaryCacheEntries = NULL;
+static CCDictionary(HKHubArchBinaryCacheKey, size_t) HKHubArchBinaryCacheIndex = NULL;
+static struct {
+    const uint8_t *data;
+    size_t size;
+    _Bool mapped;
+} HKHubArchBinaryCacheFile = { .data = NULL, .size = 0, .mapped = FALSE };
+static uint64_t HKHubArchBinaryCacheClock = 0;
+static _Bool HKHubArchBinaryCacheLoaded = FALSE;
+static _Bool HKHubArchBinaryCacheModified = FALSE;
+static mtx_t HKHubArchBinaryCacheLock;
+static once_flag HKHubArchBinaryCacheInitialized = ONCE_FLAG_INIT;
+
+static uint64_t HKHubArchBinaryCacheHash(const void *Data, size_t Size)
+{
+    uint64_t Hash = 0xcbf29ce484222325;
+    
+    for (size_t Loop = 0; Loop < Size; Loop++)
+    {
+        Hash ^= ((const uint8_t*)Data)[Loop];
+        Hash *= 0x00000100000001b3;
+    }
+    
+    return Hash;
+}
+
+static HKHubArchBinaryCacheKey HKHubArchBinaryCacheKeyForSource(const char *Source)
+{
+    const size_t Size = strlen(Source);
+    uint64_t Hash = 0x9e3779b97f4a7c15;
+    
+    for (size_t Loop = 0; Loop < Size; Loop++)
+    {
+        Hash = (Hash ^ (uint8_t)Source[Loop]) * 0xff51afd7ed558ccd;
+        Hash ^= Hash >> 32;
+    }
+    
+    return (HKHubArchBinaryCacheKey){
+        .size = Size,
+        .hash = { HKHubArchBinaryCacheHash(Source, Size), Hash }
+    };
+}
+
+static uintmax_t HKHubArchBinaryCacheKeyHasher(const HKHubArchBinaryCacheKey *Key)
+{
+    return (uintmax_t)Key->hash[0];
+}
+
+static CCComparisonResult HKHubArchBinaryCacheKeyComparator(const HKHubArchBinaryCacheKey *a, const HKHubArchBinaryCacheKey *b)
+{
+    return (a->size == b->size) && (a->hash[0] == b->hash[0]) && (a->hash[1] == b->hash[1]) ? CCComparisonResultEqual : CCComparisonResultInvalid;
+}
+
+static _Bool HKHubArchBinaryCacheHashFile(FSPath Path, uint64_t *Hash)
+{
+    FSHandle Handle;
+    if (FSHandleOpen(Path, FSHandleTypeRead, &Handle) != FSOperationSuccess) return FALSE;
+    
+    size_t Size = FSManagerGetSize(Path);
+    uint8_t *Data;
+    CC_SAFE_Malloc(Data, Size + 1,
+                   FSHandleClose(Handle);
+                   return FALSE;
+                   );
+    
+    FSHandleRead(Handle, &Size, Data, FSBehaviourDefault);
+    FSHandleClose(Handle);
+    
+    *Hash = HKHubArchBinaryCacheHash(Data, Size);
+    
+    CC_SAFE_Free(Data);
+    
+    return TRUE;
+}
+
+static void HKHubArchBinaryCacheEntryDestroyData(HKHubArchBinaryCacheEntry *Entry)
+{
+    if (Entry->binary)
+    {
+        HKHubArchBinaryDestroy(Entry->binary);
+        Entry->binary = NULL;
+    }
+    
+    if (Entry->includes)
+    {
+        for (size_t Loop = 0, Count = CCArrayGetCount(Entry->includes); Loop < Count; Loop++)
+        {
+            FSPathDestroy(((HKHubArchBinaryCacheInclude*)CCArrayGetElementAtIndex(Entry->includes, Loop))->path);
+        }
+        
+        CCArrayDestroy(Entry->includes);
+        Entry->includes = NULL;
+    }
+}
+
+static void HKHubArchBinaryCacheWrite(uint8_t *Buffer, size_t *Index, const void *Data, size_t Size)
+{
+    if (Buffer) memcpy(Buffer + *Index, Data, Size);
+    *Index += Size;
+}
+
+static _Bool HKHubArchBinaryCacheRead(const uint8_t *Buffer, size_t BufferSize, size_t *Index, void *Data, size_t Size)
+{
+    if ((BufferSize - *Index) < Size) return FALSE;
+    
+    memcpy(Data, Buffer + *Index, Size);
+    *Index += Size;
+    
+    return TRUE;
+}
+
+static size_t HKHubArchBinaryCacheWriteEntryData(uint8_t *Buffer, size_t Index, const HKHubArchBinaryCacheEntry *Entry)
+{
+    HKHubArchBinaryCacheWrite(Buffer, &Index, &Entry->binary->entrypoint, sizeof(Entry->binary->entrypoint));
+    HKHubArchBinaryCacheWrite(Buffer, &Index, Entry->binary->data, sizeof(Entry->binary->data));
+    
+    const uint16_t BreakpointCount = CCArrayGetCount(Entry->binary->presetBreakpoints);
+    HKHubArchBinaryCacheWrite(Buffer, &Index, &BreakpointCount, sizeof(BreakpointCount));
+    for (size_t Loop = 0; Loop < BreakpointCount; Loop++) HKHubArchBinaryCacheWrite(Buffer, &Index, CCArrayGetElementAtIndex(Entry->binary->presetBreakpoints, Loop), sizeof(uint8_t));
+    
+    const uint16_t PortCount = CCCollectionGetCount(Entry->binary->namedPorts);
+    HKHubArchBinaryCacheWrite(Buffer, &Index, &PortCount, sizeof(PortCount));
+    CC_COLLECTION_FOREACH_PTR(HKHubArchBinaryNamedPort, NamedPort, Entry->binary->namedPorts)
+    {
+        HKHubArchBinaryCacheWrite(Buffer, &Index, &NamedPort->start, sizeof(NamedPort->start));
+        HKHubArchBinaryCacheWrite(Buffer, &Index, &NamedPort->count, sizeof(NamedPort->count));
+        
+        CC_STRING_TEMP_BUFFER(Name, NamedPort->name)
+        {
+            const uint16_t NameSize = strlen(Name);
+            HKHubArchBinaryCacheWrite(Buffer, &Index, &NameSize, sizeof(NameSize));
+            HKHubArchBinaryCacheWrite(Buffer, &Index, Name, NameSize);
+        }
+    }
+    
+    const uint16_t IncludeCount = CCArrayGetCount(Entry->includes);
+    HKHubArchBinaryCacheWrite(Buffer, &Index, &IncludeCount, sizeof(IncludeCount));
+    for (size_t Loop = 0; Loop < IncludeCount; Loop++)
+    {
+        const HKHubArchBinaryCacheInclude *Include = CCArrayGetElementAtIndex(Entry->includes, Loop);
+        const char *Path = FSPathGetPathString(Include->path);
+        const uint16_t PathSize = strlen(Path);
+        
+        HKHubArchBinaryCacheWrite(Buffer, &Index, &Include->hash, sizeof(Include->hash));
+        HKHubArchBinaryCacheWrite(Buffer, &Index, &PathSize, sizeof(PathSize));
+        HKHubArchBinaryCacheWrite(Buffer, &Index, Path, PathSize);
+    }
+    
+    return Index;
+}
+
+static size_t HKHubArchBinaryCacheWriteEntry(uint8_t *Buffer, size_t Index, const HKHubArchBinaryCacheEntry *Entry)
+{
+    HKHubArchBinaryCacheWrite(Buffer, &Index, &Entry->key.size, sizeof(Entry->key.size));
+    HKHubArchBinaryCacheWrite(Buffer, &Index, Entry->key.hash, sizeof(Entry->key.hash));
+    
+    const size_t SizeIndex = Index;
+    Index += sizeof(uint32_t);
+    
+    //Entries that were never read are copied from the previous file as is
+    if (Entry->binary) Index = HKHubArchBinaryCacheWriteEntryData(Buffer, Index, Entry);
+    else HKHubArchBinaryCacheWrite(Buffer, &Index, Entry->data, Entry->dataSize);
+    
+    const uint32_t DataSize = (uint32_t)(Index - (SizeIndex + sizeof(uint32_t)));
+    if (Buffer) memcpy(Buffer + SizeIndex, &DataSize, sizeof(DataSize));
+    
+    return Index;
+}
+
+static _Bool HKHubArchBinaryCacheReadEntryData(HKHubArchBinaryCacheEntry *Entry)
+{
+    char String[UINT16_MAX + 1];
+    const uint8_t *Buffer = Entry->data;
+    const size_t Size = Entry->dataSize;
+    size_t Index = 0;
+    
+    Entry->binary = HKHubArchBinaryCreate(CC_STD_ALLOCATOR);
+    Entry->includes = CCArrayCreate(CC_STD_ALLOCATOR, sizeof(HKHubArchBinaryCacheInclude), 4);
+    
+    if (!Entry->binary) goto Failure;
+    
+    uint16_t Count;
+    if ((!HKHubArchBinaryCacheRead(Buffer, Size, &Index, &Entry->binary->entrypoint, sizeof(Entry->binary->entrypoint))) ||
+        (!HKHubArchBinaryCacheRead(Buffer, Size, &Index, Entry->binary->data, sizeof(Entry->binary->data))) ||
+        (!HKHubArchBinaryCacheRead(Buffer, Size, &Index, &Count, sizeof(Count)))) goto Failure;
+    
+    for (size_t Loop = 0; Loop < Count; Loop++)
+    {
+        uint8_t Offset;
+        if (!HKHubArchBinaryCacheRead(Buffer, Size, &Index, &Offset, sizeof(Offset))) goto Failure;
+        
+        CCArrayAppendElement(Entry->binary->presetBreakpoints, &Offset);
+    }
+    
+    if (!HKHubArchBinaryCacheRead(Buffer, Size, &Index, &Count, sizeof(Count))) goto Failure;
+    
+    for (size_t Loop = 0; Loop < Count; Loop++)
+    {
+        HKHubArchBinaryNamedPort NamedPort;
+        uint16_t NameSize;
+        if ((!HKHubArchBinaryCacheRead(Buffer, Size, &Index, &NamedPort.start, sizeof(NamedPort.start))) ||
+            (!HKHubArchBinaryCacheRead(Buffer, Size, &Index, &NamedPort.count, sizeof(NamedPort.count))) ||
+            (!HKHubArchBinaryCacheRead(Buffer, Size, &Index, &NameSize, sizeof(NameSize))) ||
+            (!HKHubArchBinaryCacheRead(Buffer, Size, &Index, String, NameSize))) goto Failure;
+        
+        NamedPort.name = CCStringCreateWithSize(CC_STD_ALLOCATOR, CCStringHintCopy | CCStringEncodingASCII, String, NameSize);
+        CCCollectionInsertElement(Entry->binary->namedPorts, &NamedPort);
+    }
+    
+    if (!HKHubArchBinaryCacheRead(Buffer, Size, &Index, &Count, sizeof(Count))) goto Failure;
+    
+    for (size_t Loop = 0; Loop < Count; Loop++)
+    {
+        HKHubArchBinaryCacheInclude Include;
+        uint16_t PathSize;
+        if ((!HKHubArchBinaryCacheRead(Buffer, Size, &Index, &Include.hash, sizeof(Include.hash))) ||
+            (!HKHubArchBinaryCacheRead(Buffer, Size, &Index, &PathSize, sizeof(PathSize))) ||
+            (!HKHubArchBinaryCacheRead(Buffer, Size, &Index, String, PathSize))) goto Failure;
+        
+        String[PathSize] = 0;
+        Include.path = FSPathCreate(String);
+        CCArrayAppendElement(Entry->includes, &Include);
+    }
+    
+    return TRUE;
+    
+Failure:
+    CC_LOG_ERROR("Binary cache is corrupt (%s)", HKHubArchBinaryCachePath ? FSPathGetPathString(HKHubArchBinaryCachePath) : "");
+    
+    HKHubArchBinaryCacheEntryDestroyData(Entry);
+    
+    //Corrupt entries are dropped the next time the cache is saved
+    Entry->data = NULL;
+    Entry->dataSize = 0;
+    
+    return FALSE;
+}
+
+static void HKHubArchBinaryCacheCloseFile(void)
+{
+    if (!HKHubArchBinaryCacheFile.data) return;
+    
+    uint8_t *Data = (uint8_t*)HKHubArchBinaryCacheFile.data;
+    
+#if HK_HUB_ARCH_BINARY_CACHE_MMAN
+    if (HKHubArchBinaryCacheFile.mapped) munmap(Data, HKHubArchBinaryCacheFile.size);
+#endif
+    
+    if (!HKHubArchBinaryCacheFile.mapped) CC_SAFE_Free(Data);
+    
+    HKHubArchBinaryCacheFile.data = NULL;
+    HKHubArchBinaryCacheFile.size = 0;
+    HKHubArchBinaryCacheFile.mapped = FALSE;
+}
+
+static _Bool HKHubArchBinaryCacheOpenFile(void)
+{
+    if ((!HKHubArchBinaryCachePath) || (!FSManagerExists(HKHubArchBinaryCachePath))) return FALSE;
+    
+#if HK_HUB_ARCH_BINARY_CACHE_MMAN
+    /*
+     The mapping remains valid after the cache is saved, as saving replaces the file rather than writing
+     to it.
+     */
+    const int File = open(FSPathGetPathString(HKHubArchBinaryCachePath), O_RDONLY);
+    if (File != -1)
+    {
+        struct stat Stat;
+        if ((!fstat(File, &Stat)) && (Stat.st_size > 0))
+        {
+            void *Data = mmap(NULL, (size_t)Stat.st_size, PROT_READ, MAP_PRIVATE, File, 0);
+            if (Data != MAP_FAILED)
+            {
+                HKHubArchBinaryCacheFile.data = Data;
+                HKHubArchBinaryCacheFile.size = (size_t)Stat.st_size;
+                HKHubArchBinaryCacheFile.mapped = TRUE;
+            }
+        }
+        
+        close(File);
+        
+        if (HKHubArchBinaryCacheFile.data) return TRUE;
+    }
+#endif
+    
+    FSHandle Handle;
+    if (FSHandleOpen(HKHubArchBinaryCachePath, FSHandleTypeRead, &Handle) != FSOperationSuccess)
+    {
+        CC_LOG_ERROR("Could not open binary cache (%s)", FSPathGetPathString(HKHubArchBinaryCachePath));
+        return FALSE;
+    }
+    
+    size_t Size = FSManagerGetSize(HKHubArchBinaryCachePath);
+    uint8_t *Buffer;
+    CC_SAFE_Malloc(Buffer, Size + 1,
+                   FSHandleClose(Handle);
+                   return FALSE;
+                   );
+    
+    FSHandleRead(Handle, &Size, Buffer, FSBehaviourDefault);
+    FSHandleClose(Handle);
+    
+    HKHubArchBinaryCacheFile.data = Buffer;
+    HKHubArchBinaryCacheFile.size = Size;
+    HKHubArchBinaryCacheFile.mapped = FALSE;
+    
+    return TRUE;
+}
+
+static void HKHubArchBinaryCacheReadFile(void)
+{
+    HKHubArchBinaryCacheLoaded = TRUE;
+    
+    if (!HKHubArchBinaryCacheOpenFile()) return;
+    
+    const uint8_t *Buffer = HKHubArchBinaryCacheFile.data;
+    const size_t Size = HKHubArchBinaryCacheFile.size;
+    
+    size_t Index = 0;
+    char Magic[4];
+    uint32_t Version, Count;
+    if ((HKHubArchBinaryCacheRead(Buffer, Size, &Index, Magic, sizeof(Magic))) &&
+        (HKHubArchBinaryCacheRead(Buffer, Size, &Index, &Version, sizeof(Version))) &&
+        (HKHubArchBinaryCacheRead(Buffer, Size, &Index, &Count, sizeof(Count))) &&
+        (!memcmp(Magic, "HKBC", sizeof(Magic))) &&
+        (Version == HK_HUB_ARCH_BINARY_CACHE_VERSION))
+    {
+        for (size_t Loop = 0; Loop < Count; Loop++)
+        {
+            HKHubArchBinaryCacheEntry Entry = {
+                .binary = NULL,
+                .includes = NULL,
+                .used = Count - Loop,
+                .validated = FALSE
+            };
+            
+            if ((!HKHubArchBinaryCacheRead(Buffer, Size, &Index, &Entry.key.size, sizeof(Entry.key.size))) ||
+                (!HKHubArchBinaryCacheRead(Buffer, Size, &Index, Entry.key.hash, sizeof(Entry.key.hash))) ||
+                (!HKHubArchBinaryCacheRead(Buffer, Size, &Index, &Entry.dataSize, sizeof(Entry.dataSize))) ||
+                (Entry.dataSize > (Size - Index)))
+            {
+                CC_LOG_ERROR("Binary cache is corrupt (%s)", FSPathGetPathString(HKHubArchBinaryCachePath));
+                break;
+            }
+            
+            Entry.data = Buffer + Index;
+            Index += Entry.dataSize;
+            
+            if (!CCDictionaryGetValue(HKHubArchBinaryCacheIndex, &Entry.key))
+            {
+                const size_t EntryIndex = CCArrayAppendElement(HKHubArchBinaryCacheEntries, &Entry);
+                CCDictionarySetValue(HKHubArchBinaryCacheIndex, &Entry.key, &EntryIndex);
+            }
+        }
+        
+        HKHubArchBinaryCacheClock = Count;
+    }
+}
+
+static int HKHubArchBinaryCacheEntryRecencyComparator(const void *a, const void *b)
+{
+    const uint64_t UsedA = (*(const HKHubArchBinaryCacheEntry**)a)->used, UsedB = (*(const HKHubArchBinaryCacheEntry**)b)->used;
+    
+    return (UsedA < UsedB) - (UsedA > UsedB);
+}
+
+static void HKHubArchBinaryCacheWriteFile(void)
+{
+    if (!HKHubArchBinaryCachePath) return;
+    
+    const size_t EntryCount = CCArrayGetCount(HKHubArchBinaryCacheEntries);
+    HKHubArchBinaryCacheEntry **Entries;
+    CC_TEMP_Malloc(Entries, sizeof(HKHubArchBinaryCacheEntry*) * (EntryCount + 1),
+                   CC_LOG_ERROR("Failed to write binary cache, due to allocation failure (%zu)", sizeof(HKHubArchBinaryCacheEntry*) * (EntryCount + 1));
+                   return;
+                   );
+    
+    uint32_t Count = 0;
+    for (size_t Loop = 0; Loop < EntryCount; Loop++)
+    {
+        HKHubArchBinaryCacheEntry *Entry = CCArrayGetElementAtIndex(HKHubArchBinaryCacheEntries, Loop);
+        if ((Entry->binary) || (Entry->data)) Entries[Count++] = Entry;
+    }
+    
+    qsort(Entries, Count, sizeof(HKHubArchBinaryCacheEntry*), HKHubArchBinaryCacheEntryRecencyComparator);
+    
+    if (Count > HK_HUB_ARCH_BINARY_CACHE_MAX_ENTRIES) Count = (uint32_t)HK_HUB_ARCH_BINARY_CACHE_MAX_ENTRIES;
+    
+    const uint32_t Version = HK_HUB_ARCH_BINARY_CACHE_VERSION;
+    
+    size_t Size = sizeof(char[4]) + sizeof(Version) + sizeof(Count);
+    for (size_t Loop = 0; Loop < Count; Loop++) Size = HKHubArchBinaryCacheWriteEntry(NULL, Size, Entries[Loop]);
+    
+    uint8_t *Buffer;
+    CC_SAFE_Malloc(Buffer, Size,
+                   CC_TEMP_Free(Entries);
+                   CC_LOG_ERROR("Failed to write binary cache, due to allocation failure (%zu)", Size);
+                   return;
+                   );
+    
+    size_t Index = 0;
+    HKHubArchBinaryCacheWrite(Buffer, &Index, "HKBC", sizeof(char[4]));
+    HKHubArchBinaryCacheWrite(Buffer, &Index, &Version, sizeof(Version));
+    HKHubArchBinaryCacheWrite(Buffer, &Index, &Count, sizeof(Count));
+    for (size_t Loop = 0; Loop < Count; Loop++) Index = HKHubArchBinaryCacheWriteEntry(Buffer, Index, Entries[Loop]);
+    
+    CC_TEMP_Free(Entries);
+    
+    /*
+     The cache is written to a temporary file which then replaces the previous cache, so the previous cache is
+     left intact if writing fails part way through.
+     */
+    const char *Path = FSPathGetPathString(HKHubArchBinaryCachePath);
+    const size_t PathSize = strlen(Path);
+    char *TempPathString;
+    CC_TEMP_Malloc(TempPathString, PathSize + sizeof(".tmp"),
+                   CC_SAFE_Free(Buffer);
+                   CC_LOG_ERROR("Failed to write binary cache, due to allocation failure (%zu)", PathSize + sizeof(".tmp"));
+                   return;
+                   );
+    
+    memcpy(TempPathString, Path, PathSize);
+    memcpy(TempPathString + PathSize, ".tmp", sizeof(".tmp"));
+    
+    FSPath TempPath = FSPathCreate(TempPathString);
+    
+    if (FSManagerExists(TempPath)) FSManagerRemove(TempPath);
+    FSManagerCreate(TempPath, TRUE);
+    
+    FSHandle Handle;
+    if (FSHandleOpen(TempPath, FSHandleTypeWrite, &Handle) == FSOperationSuccess)
+    {
+        const FSOperation Result = FSHandleWrite(Handle, Size, Buffer, FSBehaviourDefault);
+        FSHandleClose(Handle);
+        
+        if (Result != FSOperationSuccess)
+        {
+            CC_LOG_ERROR("Could not write binary cache (%s)", TempPathString);
+            FSManagerRemove(TempPath);
+        }
+        
+        else if (rename(TempPathString, Path)) CC_LOG_ERROR("Could not replace binary cache (%s)", Path);
+    }
+    
+    else CC_LOG_ERROR("Could not write binary cache (%s)", TempPathString);
+    
+    FSPathDestroy(TempPath);
+    CC_TEMP_Free(TempPathString);
+    CC_SAFE_Free(Buffer);
+}
+
+static CCDictionary(HKHubArchBinaryCacheKey, size_t) HKHubArchBinaryCacheIndexCreate(void)
+{
+    return CCDictionaryCreate(CC_STD_ALLOCATOR, CCDictionaryHintHeavyFinding | CCDictionaryHintHeavyInserting, sizeof(HKHubArchBinaryCacheKey), sizeof(size_t), &(CCDictionaryCallbacks){
+        .getHash = (CCDictionaryKeyHasher)HKHubArchBinaryCacheKeyHasher,
+        .compareKeys = (CCComparator)HKHubArchBinaryCacheKeyComparator
+    });
+}
+
+static void HKHubArchBinaryCacheInit(void)
+{
+    int err;
+    if ((err = mtx_init(&HKHubArchBinaryCacheLock, mtx_plain)) != thrd_success) CC_LOG_ERROR("Failed to create binary cache lock (%d)", err);
+    
+    HKHubArchBinaryCacheEntries = CCArrayCreate(CC_STD_ALLOCATOR, sizeof(HKHubArchBinaryCacheEntry), 16);
+    HKHubArchBinaryCacheIndex = HKHubArchBinaryCacheIndexCreate();
+}
+
+static void HKHubArchBinaryCacheEnsureLoaded(void)
+{
+    if (!HKHubArchBinaryCacheLoaded) HKHubArchBinaryCacheReadFile();
+}
+
+void HKHubArchBinaryCacheLoad(void)
+{
+    call_once(&HKHubArchBinaryCacheInitialized, HKHubArchBinaryCacheInit);
+    
+    mtx_lock(&HKHubArchBinaryCacheLock);
+    
+    for (size_t Loop = 0, Count = CCArrayGetCount(HKHubArchBinaryCacheEntries); Loop < Count; Loop++)
+    {
+        HKHubArchBinaryCacheEntryDestroyData(CCArrayGetElementAtIndex(HKHubArchBinaryCacheEntries, Loop));
+    }
+    
+    CCArrayRemoveAllElements(HKHubArchBinaryCacheEntries);
+    
+    CCDictionaryDestroy(HKHubArchBinaryCacheIndex);
+    HKHubArchBinaryCacheIndex = HKHubArchBinaryCacheIndexCreate();
+    
+    HKHubArchBinaryCacheCloseFile();
+    HKHubArchBinaryCacheClock = 0;
+    
+    HKHubArchBinaryCacheReadFile();
+    HKHubArchBinaryCacheModified = FALSE;
+    
+    mtx_unlock(&HKHubArchBinaryCacheLock);
+}
+
+void HKHubArchBinaryCacheSave(void)
+{
+    call_once(&HKHubArchBinaryCacheInitialized, HKHubArchBinaryCacheInit);
+    
+    mtx_lock(&HKHubArchBinaryCacheLock);
+    
+    if (HKHubArchBinaryCacheModified)
+    {
+        HKHubArchBinaryCacheWriteFile();
+        HKHubArchBinaryCacheModified = FALSE;
+    }
+    
+    mtx_unlock(&HKHubArchBinaryCacheLock);
+}
+
+static _Bool HKHubArchBinaryCacheValidate(HKHubArchBinaryCacheEntry *Entry)
+{
+    if (Entry->validated) return TRUE;
+    
+    if ((!Entry->binary) && ((!Entry->data) || (!HKHubArchBinaryCacheReadEntryData(Entry)))) return FALSE;
+    
+    for (size_t Loop = 0, Count = CCArrayGetCount(Entry->includes); Loop < Count; Loop++)
+    {
+        const HKHubArchBinaryCacheInclude *Include = CCArrayGetElementAtIndex(Entry->includes, Loop);
+        
+        uint64_t Hash;
+        if ((!HKHubArchBinaryCacheHashFile(Include->path, &Hash)) || (Hash != Include->hash)) return FALSE;
+    }
+    
+    return (Entry->validated = TRUE);
+}
+
+HKHubArchBinary HKHubArchBinaryCacheGet(const char *Source)
+{
+    CCAssertLog(Source, "Source must not be null");
+    
+    call_once(&HKHubArchBinaryCacheInitialized, HKHubArchBinaryCacheInit);
+    
+    const HKHubArchBinaryCacheKey Key = HKHubArchBinaryCacheKeyForSource(Source);
+    HKHubArchBinary Binary = NULL;
+    
+    mtx_lock(&HKHubArchBinaryCacheLock);
+    
+    HKHubArchBinaryCacheEnsureLoaded();
+    
+    const size_t *Index = CCDictionaryGetValue(HKHubArchBinaryCacheIndex, &Key);
+    if (Index)
+    {
+        HKHubArchBinaryCacheEntry *Entry = CCArrayGetElementAtIndex(HKHubArchBinaryCacheEntries, *Index);
+        if (HKHubArchBinaryCacheValidate(Entry))
+        {
+            Binary = CCRetain(Entry->binary);
+            Entry->used = ++HKHubArchBinaryCacheClock;
+        }
+    }
+    
+    mtx_unlock(&HKHubArchBinaryCacheLock);
+    
+    return Binary;
+}
+
+void HKHubArchBinaryCacheSet(const char *Source, HKHubArchBinary Binary, CCOrderedCollection(FSPath) Includes)
+{
+    CCAssertLog(Source, "Source must not be null");
+    CCAssertLog(Binary, "Binary must not be null");
+    
+    call_once(&HKHubArchBinaryCacheInitialized, HKHubArchBinaryCacheInit);
+    
+    HKHubArchBinaryCacheEntry Entry = {
+        .key = HKHubArchBinaryCacheKeyForSource(Source),
+        .data = NULL,
+        .dataSize = 0,
+        .binary = CCRetain(Binary),
+        .includes = CCArrayCreate(CC_STD_ALLOCATOR, sizeof(HKHubArchBinaryCacheInclude), 4),
+        .validated = TRUE
+    };
+    
+    if (Includes)
+    {
+        CC_COLLECTION_FOREACH(FSPath, Path, Includes)
+        {
+            HKHubArchBinaryCacheInclude Include = { .path = FSPathCopy(Path) };
+            if (!HKHubArchBinaryCacheHashFile(Path, &Include.hash))
+            {
+                FSPathDestroy(Include.path);
+                HKHubArchBinaryCacheEntryDestroyData(&Entry);
+                
+                return;
+            }
+            
+            CCArrayAppendElement(Entry.includes, &Include);
+        }
+    }
+    
+    mtx_lock(&HKHubArchBinaryCacheLock);
+    
+    HKHubArchBinaryCacheEnsureLoaded();
+    
+    Entry.used = ++HKHubArchBinaryCacheClock;
+    
+    //An entry for the same source was assembled with different includes, so is replaced
+    const size_t *Index = CCDictionaryGetValue(HKHubArchBinaryCacheIndex, &Entry.key);
+    if (Index)
+    {
+        HKHubArchBinaryCacheEntryDestroyData(CCArrayGetElementAtIndex(HKHubArchBinaryCacheEntries, *Index));
+        CCArrayReplaceElementAtIndex(HKHubArchBinaryCacheEntries, *Index, &Entry);
+    }
+    
+    else
+    {
+        const size_t EntryIndex = CCArrayAppendElement(HKHubArchBinaryCacheEntries, &Entry);
+        CCDictionarySetValue(HKHubArchBinaryCacheIndex, &Entry.key, &EntryIndex);
+    }
+    
+    HKHubArchBinaryCacheModified = TRUE;
+    
+    mtx_unlock(&HKHubArchBinaryCacheLock);
+}
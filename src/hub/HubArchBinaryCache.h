@@ -0,0 +1,85 @@
+/*
+ *  Copyright (c) 2022, Stefan Johnson
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list
+ *     of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this
+ *     list of conditions and the following disclaimer in the documentation and/or other
+ *     materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HackingGame_HubArchBinaryCache_h
+#define HackingGame_HubArchBinaryCache_h
+
+#include "Base.h"
+#include "HubArchBinary.h"
+
+/*!
+ * @brief The path of the persistent binary cache file.
+ * @description Set to NULL to disable the persistent cache. Binaries will then only be
+ *              cached for the lifetime of the process.
+ */
+extern FSPath HKHubArchBinaryCachePath;
+
+#if DEBUG
+extern size_t HKHubArchBinaryCacheMaxEntries;
+#endif
+
+/*!
+ * @brief Get a previously assembled binary for the source.
+ * @description The cache is loaded from @b HKHubArchBinaryCachePath on first use. Binaries are
+ *              looked up by the hash of their source, and are only returned if none of the files
+ *              they included have changed.
+ *
+ * @param Source The assembly source code.
+ * @return The binary or NULL if there is no valid binary cached for the source. Must be
+ *         destroyed to free memory.
+ */
+CC_NEW HKHubArchBinary HKHubArchBinaryCacheGet(const char *Source);
+
+/*!
+ * @brief Add an assembled binary to the cache.
+ * @description The cache will be written to @b HKHubArchBinaryCachePath on the next call to
+ *              @b HKHubArchBinaryCacheSave.
+ *
+ * @param Source The assembly source code the binary was assembled from.
+ * @param Binary The binary.
+ * @param Includes The @b FSPath paths of the files the source included. May be NULL.
+ */
+void HKHubArchBinaryCacheSet(const char *Source, HKHubArchBinary Binary, CCOrderedCollection(FSPath) Includes);
+
+/*!
+ * @brief Write the cache to @b HKHubArchBinaryCachePath.
+ * @description Does nothing if no binaries have been added since it was last saved or loaded. The
+ *              cache is written to a temporary file that then replaces the previous cache, so an
+ *              interrupted save will not lose the previous cache.
+ *
+ *              Only the most recently used binaries are kept, so binaries for sources that are no
+ *              longer used are eventually dropped.
+ */
+void HKHubArchBinaryCacheSave(void);
+
+/*!
+ * @brief Reload the cache from @b HKHubArchBinaryCachePath.
+ * @description Discards any binaries that have not been saved. Should be used after changing
+ *              @b HKHubArchBinaryCachePath. The file is mapped where supported, and binaries are
+ *              only read from it once they're used.
+ */
+void HKHubArchBinaryCacheLoad(void);
+
+#endif
@@ -26,118 +26,247 @@
 #include "HubArchExecutionGraph.h"
 #include "HubArchInstruction.h"
 
-static CCLinkedList(HKHubArchExecutionGraphInstruction) HKHubArchExecutionGraphAddNode(HKHubArchExecutionGraph Graph, CCLinkedList(HKHubArchExecutionGraphInstruction) InstructionGraphTail, HKHubArchInstructionState *Instruction, HKHubArchExecutionGraphRange *Range, uint8_t PC, uint8_t NextPC)
+#define HK_HUB_ARCH_EXECUTION_GRAPH_BIT_TEST(set, pc) ((set)[(pc) / 8] & (1 << ((pc) % 8)))
+#define HK_HUB_ARCH_EXECUTION_GRAPH_BIT_SET(set, pc) ((set)[(pc) / 8] |= (1 << ((pc) % 8)))
+
+typedef struct {
+    HKHubArchInstructionState state[256];
+    uint8_t next[256];
+    uint8_t order[256];
+    size_t count;
+    uint8_t reached[256 / 8];
+    uint8_t continues[256 / 8];
+} HKHubArchExecutionGraphDiscovery;
+
+static void HKHubArchExecutionGraphDiscover(HKHubArchExecutionGraphDiscovery *Discovery, uint8_t Memory[256], uint8_t PC)
+{
+    for ( ; !HK_HUB_ARCH_EXECUTION_GRAPH_BIT_TEST(Discovery->reached, PC); PC = Discovery->next[PC])
+    {
+        HKHubArchInstructionState *Instruction = &Discovery->state[PC];
+        Discovery->next[PC] = HKHubArchInstructionDecode(PC, Memory, Instruction);
+        
+        if (Instruction->opcode == -1) return;
+        
+        HK_HUB_ARCH_EXECUTION_GRAPH_BIT_SET(Discovery->reached, PC);
+        Discovery->order[Discovery->count++] = PC;
+        
+        if (!HKHubArchInstructionPredictableFlow(Instruction))
+        {
+            HKHubArchInstructionControlFlow Flow = HKHubArchInstructionGetControlFlow(Instruction);
+            switch (Flow & HKHubArchInstructionControlFlowEffectMask)
+            {
+                case HKHubArchInstructionControlFlowEffectBranch:
+                    CCAssertLog(Instruction->operand[0].type == HKHubArchInstructionOperandI &&
+                                Instruction->operand[1].type == HKHubArchInstructionOperandNA &&
+                                Instruction->operand[2].type == HKHubArchInstructionOperandNA, "Branch instruction operands have changed");
+                    
+                    HKHubArchExecutionGraphDiscover(Discovery, Memory, PC + Instruction->operand[0].value);
+                    
+                    if ((Flow & HKHubArchInstructionControlFlowEvaluationMask) == HKHubArchInstructionControlFlowEvaluationUnconditional) return;
+                    break;
+                    
+                case HKHubArchInstructionControlFlowEffectPause:
+                    return;
+                    
+                default:
+                    break;
+            }
+        }
+        
+        HK_HUB_ARCH_EXECUTION_GRAPH_BIT_SET(Discovery->continues, PC);
+    }
+}
+
+static void HKHubArchExecutionGraphGenerate(HKHubArchExecutionGraph Graph, uint8_t Memory[256], uint8_t PC)
 {
-    CCLinkedListNode *Node = CCLinkedListCreateNode(CC_STD_ALLOCATOR, sizeof(HKHubArchExecutionGraphInstruction), &(HKHubArchExecutionGraphInstruction){
-        .offset = PC,
-        .state = *Instruction,
-        .jump = NULL
-    });
+    /*
+     Instructions are first discovered in the order they're reached (following branches before continuing), then
+     grouped into blocks of instructions that fall through to one another. A block is ordered by its earliest
+     reached instruction, and begins at an instruction that nothing falls through to (or where a cycle of fall
+     throughs was first entered).
+     */
+    HKHubArchExecutionGraphDiscovery Discovery;
+    Discovery.count = 0;
+    memset(Discovery.reached, 0, sizeof(Discovery.reached));
+    memset(Discovery.continues, 0, sizeof(Discovery.continues));
+    
+    HKHubArchExecutionGraphDiscover(&Discovery, Memory, PC);
     
-    if (!InstructionGraphTail)
+    uint8_t Previous[256], HasPrevious[256 / 8] = {0};
+    for (size_t Loop = 0; Loop < Discovery.count; Loop++)
     {
-        InstructionGraphTail = Node;
-        CCArrayAppendElement(Graph->block, &Node);
+        const uint8_t Current = Discovery.order[Loop], Next = Discovery.next[Current];
+        
+        if ((HK_HUB_ARCH_EXECUTION_GRAPH_BIT_TEST(Discovery.continues, Current)) && (HK_HUB_ARCH_EXECUTION_GRAPH_BIT_TEST(Discovery.reached, Next)))
+        {
+            Previous[Next] = Current;
+            HK_HUB_ARCH_EXECUTION_GRAPH_BIT_SET(HasPrevious, Next);
+        }
     }
     
-    else InstructionGraphTail = CCLinkedListAppend(InstructionGraphTail, Node);
+    const size_t Count = Discovery.count ? Discovery.count : 1;
+    Graph->instruction = CCArrayCreate(CC_STD_ALLOCATOR, sizeof(HKHubArchExecutionGraphInstruction), Count);
+    Graph->block = CCArrayCreate(CC_STD_ALLOCATOR, sizeof(HKHubArchExecutionGraphBlock), Count);
+    Graph->range = CCArrayCreate(CC_STD_ALLOCATOR, sizeof(HKHubArchExecutionGraphRange), Count);
     
-    const uint8_t Count = Range->count + (NextPC - PC);
-    Range->count = Range->count < Count ? Count : UINT8_MAX;
+    for (size_t Loop = 0; Loop < 256; Loop++) Graph->location[Loop] = (HKHubArchExecutionGraphLocation){ .block = HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, .index = HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE };
     
-    return InstructionGraphTail;
-}
-
-static CCLinkedList(HKHubArchExecutionGraphInstruction) HKHubArchExecutionGraphGenerate(HKHubArchExecutionGraph Graph, uint8_t Memory[256], uint8_t PC)
-{
-    for (size_t Loop = 0, Count = CCArrayGetCount(Graph->range); Loop < Count; Loop++)
+    for (size_t Loop = 0; Loop < Discovery.count; Loop++)
     {
-        HKHubArchExecutionGraphRange *Range = CCArrayGetElementAtIndex(Graph->range, Loop);
-        if ((Range->start <= PC) && ((Range->start + Range->count) > PC))
+        const uint8_t First = Discovery.order[Loop];
+        if (Graph->location[First].block != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE) continue;
+        
+        uint8_t Leader = First;
+        while ((HK_HUB_ARCH_EXECUTION_GRAPH_BIT_TEST(HasPrevious, Leader)) && ((Leader = Previous[Leader]) != First));
+        
+        const uint16_t BlockIndex = CCArrayGetCount(Graph->block);
+        HKHubArchExecutionGraphBlock Block = { .index = CCArrayGetCount(Graph->instruction), .count = 0 };
+        HKHubArchExecutionGraphRange Range = { .start = Leader, .count = 0 };
+        
+        for (uint8_t Current = Leader; ; Current = Discovery.next[Current])
+        {
+            Graph->location[Current] = (HKHubArchExecutionGraphLocation){ .block = BlockIndex, .index = Block.index + Block.count++ };
+            
+            CCArrayAppendElement(Graph->instruction, &(HKHubArchExecutionGraphInstruction){
+                .offset = Current,
+                .state = Discovery.state[Current],
+                .jump = HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE,
+                .next = HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE,
+                .fusion = HKHubArchExecutionGraphFusionNone
+            });
+            
+            const uint8_t Size = Range.count + (uint8_t)(Discovery.next[Current] - Current);
+            Range.count = Range.count < Size ? Size : UINT8_MAX;
+            
+            const uint8_t Next = Discovery.next[Current];
+            if ((!HK_HUB_ARCH_EXECUTION_GRAPH_BIT_TEST(Discovery.continues, Current)) || (!HK_HUB_ARCH_EXECUTION_GRAPH_BIT_TEST(Discovery.reached, Next)) || (Graph->location[Next].block != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE) || (Previous[Next] != Current)) break;
+        }
+        
+        CCArrayAppendElement(Graph->block, &Block);
+        CCArrayAppendElement(Graph->range, &Range);
+    }
+    
+    for (size_t Loop = 0, Count = CCArrayGetCount(Graph->instruction); Loop < Count; Loop++)
+    {
+        HKHubArchExecutionGraphInstruction *Instruction = CCArrayGetElementAtIndex(Graph->instruction, Loop);
+        
+        if (HK_HUB_ARCH_EXECUTION_GRAPH_BIT_TEST(Discovery.continues, Instruction->offset)) Instruction->next = Graph->location[Discovery.next[Instruction->offset]].index;
+        
+        if ((HKHubArchInstructionGetControlFlow(&Instruction->state) & HKHubArchInstructionControlFlowEffectMask) == HKHubArchInstructionControlFlowEffectBranch)
         {
-            CCLinkedList(HKHubArchExecutionGraphInstruction) *Instruction = CCArrayGetElementAtIndex(Graph->block, Loop);
-            return *Instruction;
+            Instruction->jump = Graph->location[(uint8_t)(Instruction->offset + Instruction->state.operand[0].value)].index;
         }
     }
+}
+
+static void HKHubArchExecutionGraphFuse(HKHubArchExecutionGraph Graph, uint8_t PC)
+{
+    /*
+     Fuses instructions so they can be executed as a single operation with one cycle check. This is done for:
+     
+     - A flag producing ALU instruction and the conditional branch that follows it (cmp+jz, sub+jnz, etc.).
+     - A flag producing ALU instruction whose flags are overwritten before they can be observed, so it's fused
+       with the instructions up to the one that overwrites them and its flags never need to be materialised.
+     
+     A follower must not be the target of any jump (or the entry point) as it will no longer be independently
+     enterable.
+     */
+    uint8_t Targets[256 / 8] = {0};
+    HK_HUB_ARCH_EXECUTION_GRAPH_BIT_SET(Targets, PC);
     
-    CCLinkedList(HKHubArchExecutionGraphInstruction) InstructionGraphHead = NULL, InstructionGraphTail = NULL;
-    const size_t Index = CCArrayAppendElement(Graph->range, &(HKHubArchExecutionGraphRange){ .start = PC, .count = 0 });
-    HKHubArchExecutionGraphRange *Range = CCArrayGetElementAtIndex(Graph->range, Index);
+    for (size_t Loop = 0, Count = CCArrayGetCount(Graph->instruction); Loop < Count; Loop++)
+    {
+        const HKHubArchExecutionGraphInstruction *Instruction = CCArrayGetElementAtIndex(Graph->instruction, Loop);
+        if (Instruction->jump != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE) HK_HUB_ARCH_EXECUTION_GRAPH_BIT_SET(Targets, ((HKHubArchExecutionGraphInstruction*)CCArrayGetElementAtIndex(Graph->instruction, Instruction->jump))->offset);
+    }
     
-    for (uint8_t NextPC = 0; ; PC = NextPC)
+    for (size_t Loop = 0, Count = CCArrayGetCount(Graph->block); Loop < Count; Loop++)
     {
-        HKHubArchInstructionState Instruction;
-        NextPC = HKHubArchInstructionDecode(PC, Memory, &Instruction);
+        const HKHubArchExecutionGraphBlock *Block = CCArrayGetElementAtIndex(Graph->block, Loop);
+        HKHubArchExecutionGraphInstruction *Instructions = CCArrayGetElementAtIndex(Graph->instruction, Block->index);
+        
+        /*
+         Backwards flag liveness. Leaving the block, or any instruction that could leave it (including the cycle
+         check of an instruction that can't be fused), observes all flags. Distance tracks how many instructions
+         it takes for each flag to be overwritten, so the fused operations can be kept within the limit.
+         */
+        uint16_t Kill[256];
+        uint16_t Distance[4] = { HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE, HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE };
+        HKHubArchProcessorFlags Live = HKHubArchProcessorFlagsMask;
         
-        if (Instruction.opcode != -1)
+        for (size_t Index = Block->count; Index--; )
         {
-            InstructionGraphTail = HKHubArchExecutionGraphAddNode(Graph, InstructionGraphTail, &Instruction, Range, PC, NextPC);
-            if (!InstructionGraphHead) InstructionGraphHead = InstructionGraphTail;
+            HKHubArchExecutionGraphInstruction *Instruction = &Instructions[Index];
+            const HKHubArchProcessorFlags Read = HKHubArchInstructionReadFlags(&Instruction->state), Write = HKHubArchInstructionWriteFlags(&Instruction->state);
+            
+            Instruction->live = Live;
+            Kill[Index] = 0;
+            
+            for (size_t Flag = 0; Flag < 4; Flag++)
+            {
+                if ((Write & (1 << Flag)) && (Distance[Flag] > Kill[Index])) Kill[Index] = Distance[Flag];
+            }
+            
+            HKHubArchInstructionLoweredState Lowered;
+            HKHubArchInstructionLower(&Instruction->state, &Lowered);
             
-            if (!HKHubArchInstructionPredictableFlow(&Instruction))
+            if ((Lowered.handler >= HKHubArchInstructionHandlerMovRR) && (Lowered.handler <= HKHubArchInstructionHandlerAndRI) && (!HK_HUB_ARCH_EXECUTION_GRAPH_BIT_TEST(Targets, Instruction->offset)))
             {
-                HKHubArchInstructionControlFlow Flow = HKHubArchInstructionGetControlFlow(&Instruction);
-                switch (Flow & HKHubArchInstructionControlFlowEffectMask)
+                Live = (Live & ~Write) | Read;
+                
+                for (size_t Flag = 0; Flag < 4; Flag++)
                 {
-                    case HKHubArchInstructionControlFlowEffectBranch:
-                        CCAssertLog(Instruction.operand[0].type == HKHubArchInstructionOperandI &&
-                                    Instruction.operand[1].type == HKHubArchInstructionOperandNA &&
-                                    Instruction.operand[2].type == HKHubArchInstructionOperandNA, "Branch instruction operands have changed");
-                        
-                        ((HKHubArchExecutionGraphInstruction*)CCLinkedListGetNodeData(InstructionGraphTail))->jump = HKHubArchExecutionGraphGenerate(Graph, Memory, PC + Instruction.operand[0].value);
-                        
-                        if ((Flow & HKHubArchInstructionControlFlowEvaluationMask) == HKHubArchInstructionControlFlowEvaluationUnconditional) return InstructionGraphHead;
-                        break;
-                        
-                    case HKHubArchInstructionControlFlowEffectPause:
-                        return InstructionGraphHead;
-                        
-                    default:
-                        break;
+                    if (Read & (1 << Flag)) Distance[Flag] = HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE;
+                    else if (Write & (1 << Flag)) Distance[Flag] = 1;
+                    else if (Distance[Flag] != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE) Distance[Flag]++;
                 }
             }
+            
+            else
+            {
+                Live = HKHubArchProcessorFlagsMask;
+                
+                for (size_t Flag = 0; Flag < 4; Flag++) Distance[Flag] = HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE;
+            }
         }
         
-        else break;
-        
-        for (size_t Loop = 0, Count = CCArrayGetCount(Graph->range); Loop < Count; Loop++)
+        /*
+         Only an ALU instruction's flags are elided, and only if none of them are observed. Otherwise they'll be
+         marked as live so they're materialised.
+         */
+        HKHubArchProcessorFlags Pending = 0;
+        _Bool PrevArithmetic = FALSE;
+        for (size_t Index = 0, Fused = 0; Index < Block->count; Index++)
         {
-            HKHubArchExecutionGraphRange *BlockRange = CCArrayGetElementAtIndex(Graph->range, Loop);
-            if ((BlockRange->start <= NextPC) && ((BlockRange->start + BlockRange->count) > NextPC))
+            HKHubArchExecutionGraphInstruction *Instruction = &Instructions[Index];
+            const HKHubArchProcessorFlags Write = HKHubArchInstructionWriteFlags(&Instruction->state);
+            
+            HKHubArchInstructionLoweredState Lowered;
+            HKHubArchInstructionLower(&Instruction->state, &Lowered);
+            
+            const _Bool Arithmetic = (Lowered.handler >= HKHubArchInstructionHandlerAddRR) && (Lowered.handler <= HKHubArchInstructionHandlerAndRI);
+            
+            if ((Pending) || ((PrevArithmetic) && (Lowered.handler == HKHubArchInstructionHandlerBranch) && (Fused < HK_HUB_ARCH_EXECUTION_GRAPH_FUSION_MAX) && (!HK_HUB_ARCH_EXECUTION_GRAPH_BIT_TEST(Targets, Instruction->offset))))
             {
-                if (Count != 1)
-                {
-                    CCLinkedList(HKHubArchExecutionGraphInstruction) *Block = CCArrayGetElementAtIndex(Graph->block, Loop);
-                    CCLinkedListPrepend(*Block, InstructionGraphTail);
-                    *Block = InstructionGraphHead;
-                    
-                    BlockRange->start = Range->start;
-                    BlockRange->count += Range->count;
-                    
-                    CCArrayRemoveElementAtIndex(Graph->range, Index);
-                    CCArrayRemoveElementAtIndex(Graph->block, Index);
-                }
-                
-                return InstructionGraphHead;
+                Instructions[Index - 1].fusion |= HKHubArchExecutionGraphFusionLeader;
+                Instruction->fusion |= HKHubArchExecutionGraphFusionFollower;
+                Pending &= ~Write;
+                Fused++;
             }
+            
+            else Fused = 1;
+            
+            if ((Arithmetic) && (Write) && (!(Write & Instruction->live)) && ((Fused + Kill[Index]) <= HK_HUB_ARCH_EXECUTION_GRAPH_FUSION_MAX)) Pending |= Write;
+            else Instruction->live |= Write;
+            
+            PrevArithmetic = Arithmetic;
         }
     }
-    
-    if (!Range->count) CCArrayRemoveElementAtIndex(Graph->range, CCArrayGetCount(Graph->range) - 1);
-    
-    return InstructionGraphHead;
 }
 
 static void HKHubArchExecutionGraphDestructor(HKHubArchExecutionGraph Graph)
 {
-    CCEnumerable Enumerable;
-    CCArrayGetEnumerable(Graph->block, &Enumerable);
-    
-    for (CCLinkedList(HKHubArchExecutionGraphInstruction) *Node = CCEnumerableGetCurrent(&Enumerable); Node; Node = CCEnumerableNext(&Enumerable))
-    {
-        CCLinkedListDestroy(*Node);
-    }
-    
+    CCArrayDestroy(Graph->instruction);
     CCArrayDestroy(Graph->block);
     CCArrayDestroy(Graph->range);
 }
@@ -150,18 +279,8 @@ HKHubArchExecutionGraph HKHubArchExecutionGraphCreate(CCAllocatorType Allocator,
     
     if (Graph)
     {
-        *Graph = (HKHubArchExecutionGraphInfo){
-            .block = CCArrayCreate(CC_STD_ALLOCATOR, sizeof(CCLinkedList), 4),
-            .range = CCArrayCreate(CC_STD_ALLOCATOR, sizeof(HKHubArchExecutionGraphRange), 4)
-        };
-        
         HKHubArchExecutionGraphGenerate(Graph, Memory, PC);
-        
-        for (size_t Loop = 0, Count = CCArrayGetCount(Graph->block); Loop < Count; Loop++)
-        {
-            CCLinkedList(HKHubArchExecutionGraphInstruction) *Block = CCArrayGetElementAtIndex(Graph->block, Loop);
-            *Block = CCLinkedListGetHead(*Block);
-        }
+        HKHubArchExecutionGraphFuse(Graph, PC);
         
         CCMemorySetDestructor(Graph, (CCMemoryDestructorCallback)HKHubArchExecutionGraphDestructor);
     }
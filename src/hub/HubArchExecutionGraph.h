@@ -29,10 +29,29 @@
 #include "Base.h"
 #include "HubArchInstructionType.h"
 
+typedef CC_FLAG_ENUM(HKHubArchExecutionGraphFusion, uint8_t) {
+    /// Instruction is executed on its own.
+    HKHubArchExecutionGraphFusionNone = 0,
+    /// Instruction is executed as one operation with the next instruction.
+    HKHubArchExecutionGraphFusionLeader = (1 << 0),
+    /// Instruction is executed as part of the previous instruction. It is never the target of a jump.
+    HKHubArchExecutionGraphFusionFollower = (1 << 1)
+};
+
+#define HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE UINT16_MAX
+
+/*!
+ * @brief The maximum number of instructions that may be fused into one operation.
+ */
+#define HK_HUB_ARCH_EXECUTION_GRAPH_FUSION_MAX 8
+
 typedef struct {
     uint8_t offset;
     HKHubArchInstructionState state;
-    CCLinkedList(HKHubArchExecutionGraphInstruction) jump;
+    uint16_t jump; //index of the instruction it branches to, or HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE
+    uint16_t next; //index of the instruction that follows it, or HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE
+    HKHubArchExecutionGraphFusion fusion;
+    uint8_t live; //HKHubArchProcessorFlags that may be observed after the instruction
 } HKHubArchExecutionGraphInstruction;
 
 typedef struct {
@@ -41,8 +60,20 @@ typedef struct {
 } HKHubArchExecutionGraphRange;
 
 typedef struct {
-    CCArray(CCLinkedList(HKHubArchExecutionGraphInstruction)) block;
+    uint16_t index; //index of the first instruction of the block
+    uint16_t count; //number of instructions in the block
+} HKHubArchExecutionGraphBlock;
+
+typedef struct {
+    uint16_t block; //index of the block, or HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE if no instruction starts at that PC
+    uint16_t index; //index of the instruction
+} HKHubArchExecutionGraphLocation;
+
+typedef struct {
+    CCArray(HKHubArchExecutionGraphInstruction) instruction;
+    CCArray(HKHubArchExecutionGraphBlock) block;
     CCArray(HKHubArchExecutionGraphRange) range;
+    HKHubArchExecutionGraphLocation location[256];
 } HKHubArchExecutionGraphInfo;
 
 /*!
@@ -51,8 +82,50 @@ typedef struct {
  */
 typedef HKHubArchExecutionGraphInfo *HKHubArchExecutionGraph;
 
+/*!
+ * @brief Create the execution graph for the program.
+ * @description Instructions are stored contiguously, with each block being a range of the instruction array
+ *              ordered by when it was first reached. Any instruction can be looked up by its PC.
+ *
+ * @param Allocator The allocator to be used.
+ * @param Memory The memory containing the program.
+ * @param PC The entry point of the program.
+ * @return The execution graph. Must be destroyed to free memory.
+ */
 CC_NEW HKHubArchExecutionGraph HKHubArchExecutionGraphCreate(CCAllocatorType Allocator, uint8_t Memory[256], uint8_t PC);
 
+/*!
+ * @brief Destroy the execution graph.
+ * @param Graph The execution graph to be destroyed.
+ */
 void HKHubArchExecutionGraphDestroy(HKHubArchExecutionGraph CC_DESTROY(Graph));
 
+/*!
+ * @brief Get the instructions of a block.
+ * @param Graph The execution graph.
+ * @param Block The index of the block.
+ * @return The first instruction of the block, the remaining instructions of the block follow it.
+ */
+static CC_FORCE_INLINE const HKHubArchExecutionGraphInstruction *HKHubArchExecutionGraphGetBlockInstructions(HKHubArchExecutionGraph Graph, size_t Block);
+
+/*!
+ * @brief Get the instruction that starts at the PC.
+ * @param Graph The execution graph.
+ * @param PC The PC of the instruction.
+ * @return The instruction, or NULL if no instruction starts at that PC.
+ */
+static CC_FORCE_INLINE const HKHubArchExecutionGraphInstruction *HKHubArchExecutionGraphGetInstruction(HKHubArchExecutionGraph Graph, uint8_t PC);
+
+#pragma mark -
+
+static CC_FORCE_INLINE const HKHubArchExecutionGraphInstruction *HKHubArchExecutionGraphGetBlockInstructions(HKHubArchExecutionGraph Graph, size_t Block)
+{
+    return CCArrayGetElementAtIndex(Graph->instruction, ((HKHubArchExecutionGraphBlock*)CCArrayGetElementAtIndex(Graph->block, Block))->index);
+}
+
+static CC_FORCE_INLINE const HKHubArchExecutionGraphInstruction *HKHubArchExecutionGraphGetInstruction(HKHubArchExecutionGraph Graph, uint8_t PC)
+{
+    return Graph->location[PC].block != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE ? CCArrayGetElementAtIndex(Graph->instruction, Graph->location[PC].index) : NULL;
+}
+
 #endif
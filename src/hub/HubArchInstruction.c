@@ -1079,6 +1079,111 @@ HKHubArchInstructionOperationResult HKHubArchInstructionExecute(HKHubArchProcess
     return Instructions[State->opcode].operation(Processor, State);
 }
 
+static _Bool HKHubArchInstructionBranchTaken(HKHubArchInstructionOperation Operation, HKHubArchProcessorFlags Flags)
+{
+    const _Bool Zero = Flags & HKHubArchProcessorFlagsZero;
+    const _Bool Carry = Flags & HKHubArchProcessorFlagsCarry;
+    const _Bool Sign = Flags & HKHubArchProcessorFlagsSign;
+    const _Bool Overflow = Flags & HKHubArchProcessorFlagsOverflow;
+    
+    if (Operation == HKHubArchInstructionOperationJZ) return Zero;
+    else if (Operation == HKHubArchInstructionOperationJNZ) return !Zero;
+    else if (Operation == HKHubArchInstructionOperationJS) return Sign;
+    else if (Operation == HKHubArchInstructionOperationJNS) return !Sign;
+    else if (Operation == HKHubArchInstructionOperationJO) return Overflow;
+    else if (Operation == HKHubArchInstructionOperationJNO) return !Overflow;
+    else if (Operation == HKHubArchInstructionOperationJSL) return Sign != Overflow;
+    else if (Operation == HKHubArchInstructionOperationJSGE) return Sign == Overflow;
+    else if (Operation == HKHubArchInstructionOperationJSLE) return (Zero) || (Sign != Overflow);
+    else if (Operation == HKHubArchInstructionOperationJSG) return (!Zero) && (Sign == Overflow);
+    else if (Operation == HKHubArchInstructionOperationJUL) return Carry;
+    else if (Operation == HKHubArchInstructionOperationJUGE) return !Carry;
+    else if (Operation == HKHubArchInstructionOperationJULE) return (Carry) || (Zero);
+    else if (Operation == HKHubArchInstructionOperationJUG) return (!Carry) && (!Zero);
+    
+    CCAssertLog(0, "Should be a conditional branch");
+    
+    return FALSE;
+}
+
+void HKHubArchInstructionLower(const HKHubArchInstructionState *State, HKHubArchInstructionLoweredState *Lowered)
+{
+    CCAssertLog(State, "State must not be null");
+    CCAssertLog(Lowered, "Lowered must not be null");
+    
+    *Lowered = (HKHubArchInstructionLoweredState){ .handler = HKHubArchInstructionHandlerGeneric };
+    
+    if (State->opcode == -1) return;
+    
+    const HKHubArchInstructionOperation Operation = Instructions[State->opcode].operation;
+    
+    if ((Instructions[State->opcode].control & HKHubArchInstructionControlFlowEffectMask) == HKHubArchInstructionControlFlowEffectBranch)
+    {
+        Lowered->src = State->operand[0].value;
+        
+        if ((Instructions[State->opcode].control & HKHubArchInstructionControlFlowEvaluationMask) == HKHubArchInstructionControlFlowEvaluationUnconditional)
+        {
+            Lowered->handler = HKHubArchInstructionHandlerJump;
+        }
+        
+        else
+        {
+            Lowered->handler = HKHubArchInstructionHandlerBranch;
+            
+            for (HKHubArchProcessorFlags Flags = 0; Flags <= HKHubArchProcessorFlagsMask; Flags++)
+            {
+                if (HKHubArchInstructionBranchTaken(Operation, Flags)) Lowered->condition |= (1 << Flags);
+            }
+        }
+        
+        return;
+    }
+    
+    if ((State->operand[0].type != HKHubArchInstructionOperandR) || (!HKHubArchInstructionRegisterIsGeneralPurpose(State->operand[0].reg))) return;
+    
+    _Bool Immediate;
+    switch (State->operand[1].type)
+    {
+        case HKHubArchInstructionOperandI:
+            Immediate = TRUE;
+            Lowered->src = State->operand[1].value;
+            break;
+            
+        case HKHubArchInstructionOperandR:
+            if (!HKHubArchInstructionRegisterIsGeneralPurpose(State->operand[1].reg)) return;
+            
+            Immediate = FALSE;
+            Lowered->src = State->operand[1].reg & HKHubArchInstructionRegisterGeneralPurposeIndexMask;
+            break;
+            
+        default:
+            return;
+    }
+    
+    static const struct {
+        HKHubArchInstructionOperation operation;
+        HKHubArchInstructionHandler handler[2];
+    } Handlers[] = {
+        { HKHubArchInstructionOperationMOV, { HKHubArchInstructionHandlerMovRR, HKHubArchInstructionHandlerMovRI } },
+        { HKHubArchInstructionOperationADD, { HKHubArchInstructionHandlerAddRR, HKHubArchInstructionHandlerAddRI } },
+        { HKHubArchInstructionOperationSUB, { HKHubArchInstructionHandlerSubRR, HKHubArchInstructionHandlerSubRI } },
+        { HKHubArchInstructionOperationCMP, { HKHubArchInstructionHandlerCmpRR, HKHubArchInstructionHandlerCmpRI } },
+        { HKHubArchInstructionOperationXOR, { HKHubArchInstructionHandlerXorRR, HKHubArchInstructionHandlerXorRI } },
+        { HKHubArchInstructionOperationOR, { HKHubArchInstructionHandlerOrRR, HKHubArchInstructionHandlerOrRI } },
+        { HKHubArchInstructionOperationAND, { HKHubArchInstructionHandlerAndRR, HKHubArchInstructionHandlerAndRI } }
+    };
+    
+    for (size_t Loop = 0; Loop < sizeof(Handlers) / sizeof(*Handlers); Loop++)
+    {
+        if (Handlers[Loop].operation == Operation)
+        {
+            Lowered->handler = Handlers[Loop].handler[Immediate];
+            Lowered->dest = State->operand[0].reg & HKHubArchInstructionRegisterGeneralPurposeIndexMask;
+            break;
+        }
+    }
+}
+
 #pragma mark - Instruction Operations
 
 static inline uint8_t *HKHubArchInstructionOperandStateValue(HKHubArchProcessor Processor, const HKHubArchInstructionOperandValue *Operand, _Bool ModifyDebug)
@@ -1184,13 +1289,10 @@ static HKHubArchInstructionOperationResult HKHubArchInstructionOperationADD(HKHu
     const uint8_t *Src = HKHubArchInstructionOperandSourceValue(Processor, &State->operand[1]);
     
     const uint8_t Result = *Dest + *Src;
-    const HKHubArchProcessorFlags Zero = (Result == 0 ? HKHubArchProcessorFlagsZero : 0);
-    const HKHubArchProcessorFlags Carry = (Result < *Dest ? HKHubArchProcessorFlagsCarry : 0);
-    const HKHubArchProcessorFlags Sign = (Result & 0x80 ? HKHubArchProcessorFlagsSign : 0);
-    const HKHubArchProcessorFlags Overflow = ((*Dest ^ *Src) & 0x80) ? 0 : (((*Dest ^ Result) & 0x80) ? HKHubArchProcessorFlagsOverflow : 0);
+    const HKHubArchProcessorFlags Flags = HKHubArchInstructionAdditionFlags(*Dest, *Src, Result);
     
     *Dest = Result;
-    Processor->state.flags = (Processor->state.flags & ~HKHubArchProcessorFlagsMask) | Zero | Carry | Sign | Overflow;
+    Processor->state.flags = (Processor->state.flags & ~HKHubArchProcessorFlagsMask) | Flags;
     
     return HKHubArchInstructionOperationResultSuccess | (Dest == &Processor->state.pc ? HKHubArchInstructionOperationResultFlagSkipPC : 0);
 }
@@ -1206,13 +1308,10 @@ static HKHubArchInstructionOperationResult HKHubArchInstructionOperationSUB(HKHu
     const uint8_t *Src = HKHubArchInstructionOperandSourceValue(Processor, &State->operand[1]);
     
     const uint8_t Result = *Dest - *Src;
-    const HKHubArchProcessorFlags Zero = (Result == 0 ? HKHubArchProcessorFlagsZero : 0);
-    const HKHubArchProcessorFlags Carry = (Result > *Dest ? HKHubArchProcessorFlagsCarry : 0);
-    const HKHubArchProcessorFlags Sign = (Result & 0x80 ? HKHubArchProcessorFlagsSign : 0);
-    const HKHubArchProcessorFlags Overflow = ((*Dest ^ *Src) & 0x80) ? (((*Dest ^ Result) & 0x80) ? HKHubArchProcessorFlagsOverflow : 0) : 0;
+    const HKHubArchProcessorFlags Flags = HKHubArchInstructionSubtractionFlags(*Dest, *Src, Result);
     
     *Dest = Result;
-    Processor->state.flags = (Processor->state.flags & ~HKHubArchProcessorFlagsMask) | Zero | Carry | Sign | Overflow;
+    Processor->state.flags = (Processor->state.flags & ~HKHubArchProcessorFlagsMask) | Flags;
     
     return HKHubArchInstructionOperationResultSuccess | (Dest == &Processor->state.pc ? HKHubArchInstructionOperationResultFlagSkipPC : 0);
 }
@@ -1335,12 +1434,9 @@ static HKHubArchInstructionOperationResult HKHubArchInstructionOperationCMP(HKHu
     const uint8_t *Src = HKHubArchInstructionOperandSourceValue(Processor, &State->operand[1]);
     
     const uint8_t Result = *Dest - *Src;
-    const HKHubArchProcessorFlags Zero = (Result == 0 ? HKHubArchProcessorFlagsZero : 0);
-    const HKHubArchProcessorFlags Carry = (Result > *Dest ? HKHubArchProcessorFlagsCarry : 0);
-    const HKHubArchProcessorFlags Sign = (Result & 0x80 ? HKHubArchProcessorFlagsSign : 0);
-    const HKHubArchProcessorFlags Overflow = ((*Dest ^ *Src) & 0x80) ? (((*Dest ^ Result) & 0x80) ? HKHubArchProcessorFlagsOverflow : 0) : 0;
+    const HKHubArchProcessorFlags Flags = HKHubArchInstructionSubtractionFlags(*Dest, *Src, Result);
     
-    Processor->state.flags = (Processor->state.flags & ~HKHubArchProcessorFlagsMask) | Zero | Carry | Sign | Overflow;
+    Processor->state.flags = (Processor->state.flags & ~HKHubArchProcessorFlagsMask) | Flags;
         
     return HKHubArchInstructionOperationResultSuccess;
 }
@@ -1400,11 +1496,9 @@ static HKHubArchInstructionOperationResult HKHubArchInstructionOperationXOR(HKHu
     const uint8_t *Src = HKHubArchInstructionOperandSourceValue(Processor, &State->operand[1]);
     
     const uint8_t Result = *Dest ^ *Src;
-    const HKHubArchProcessorFlags Zero = (Result == 0 ? HKHubArchProcessorFlagsZero : 0);
-    const HKHubArchProcessorFlags Sign = (Result & 0x80 ? HKHubArchProcessorFlagsSign : 0);
     
     *Dest = Result;
-    Processor->state.flags = (Processor->state.flags & ~HKHubArchProcessorFlagsMask) | Zero | Sign;
+    Processor->state.flags = (Processor->state.flags & ~HKHubArchProcessorFlagsMask) | HKHubArchInstructionLogicalFlags(Result);
     
     return HKHubArchInstructionOperationResultSuccess | (Dest == &Processor->state.pc ? HKHubArchInstructionOperationResultFlagSkipPC : 0);
 }
@@ -1420,11 +1514,9 @@ static HKHubArchInstructionOperationResult HKHubArchInstructionOperationOR(HKHub
     const uint8_t *Src = HKHubArchInstructionOperandSourceValue(Processor, &State->operand[1]);
     
     const uint8_t Result = *Dest | *Src;
-    const HKHubArchProcessorFlags Zero = (Result == 0 ? HKHubArchProcessorFlagsZero : 0);
-    const HKHubArchProcessorFlags Sign = (Result & 0x80 ? HKHubArchProcessorFlagsSign : 0);
     
     *Dest = Result;
-    Processor->state.flags = (Processor->state.flags & ~HKHubArchProcessorFlagsMask) | Zero | Sign;
+    Processor->state.flags = (Processor->state.flags & ~HKHubArchProcessorFlagsMask) | HKHubArchInstructionLogicalFlags(Result);
     
     return HKHubArchInstructionOperationResultSuccess | (Dest == &Processor->state.pc ? HKHubArchInstructionOperationResultFlagSkipPC : 0);
 }
@@ -1440,11 +1532,9 @@ static HKHubArchInstructionOperationResult HKHubArchInstructionOperationAND(HKHu
     const uint8_t *Src = HKHubArchInstructionOperandSourceValue(Processor, &State->operand[1]);
     
     const uint8_t Result = *Dest & *Src;
-    const HKHubArchProcessorFlags Zero = (Result == 0 ? HKHubArchProcessorFlagsZero : 0);
-    const HKHubArchProcessorFlags Sign = (Result & 0x80 ? HKHubArchProcessorFlagsSign : 0);
     
     *Dest = Result;
-    Processor->state.flags = (Processor->state.flags & ~HKHubArchProcessorFlagsMask) | Zero | Sign;
+    Processor->state.flags = (Processor->state.flags & ~HKHubArchProcessorFlagsMask) | HKHubArchInstructionLogicalFlags(Result);
     
     return HKHubArchInstructionOperationResultSuccess | (Dest == &Processor->state.pc ? HKHubArchInstructionOperationResultFlagSkipPC : 0);
 }
@@ -1508,7 +1598,7 @@ static HKHubArchInstructionOperationResult HKHubArchInstructionOperationSEND(HKH
     
     HKHubArchInstructionOperationResult Result = HKHubArchInstructionOperationResultSuccess;
     HKHubArchPortID Port = *(const uint8_t*)HKHubArchInstructionOperandSourceValue(Processor, &State->operand[0]);
-    HKHubArchPortConnection *Conn = CCDictionaryGetValue(Processor->ports, &Port);
+    HKHubArchPortConnection Conn = HKHubArchPortTableGetConnection(&Processor->ports, Port);
     _Bool Success = FALSE;
     
     if (Processor->message.type == HKHubArchProcessorMessageComplete)
@@ -1534,9 +1624,11 @@ static HKHubArchInstructionOperationResult HKHubArchInstructionOperationSEND(HKH
             .memory = Processor->memory
         };
         
-        const HKHubArchPort *Interface = HKHubArchPortConnectionGetOppositePort(*Conn, Processor, Port);
+        const HKHubArchPort *Interface = HKHubArchPortConnectionGetOppositePort(Conn, Processor, Port);
         
-        HKHubArchPortResponse Response = Interface->receiver ? Interface->receiver(*Conn, Interface->device, Interface->id, &Processor->message.data, Processor, Processor->message.timestamp, &Processor->message.wait) : HKHubArchPortResponseTimeout;
+        HKHubArchPortResponse Response;
+        if (Conn->direct) Response = HKHubArchProcessorChannelReceive(Conn, Interface->device, Interface->id, &Processor->message.data, Processor, Processor->message.timestamp, &Processor->message.wait);
+        else Response = Interface->receiver ? Interface->receiver(Conn, Interface->device, Interface->id, &Processor->message.data, Processor, Processor->message.timestamp, &Processor->message.wait) : HKHubArchPortResponseTimeout;
         
         switch (Response)
         {
@@ -1555,6 +1647,7 @@ static HKHubArchInstructionOperationResult HKHubArchInstructionOperationSEND(HKH
                 break;
                 
             case HKHubArchPortResponseRetry:
+                Processor->waiting = HKHubArchPortConnectionWait(Conn, Processor, Port);
                 return HKHubArchInstructionOperationResultFailure | HKHubArchInstructionOperationResultFlagPipelineStall;
                 
             case HKHubArchPortResponseDefer:
@@ -1579,7 +1672,7 @@ static HKHubArchInstructionOperationResult HKHubArchInstructionOperationRECV(HKH
     
     HKHubArchInstructionOperationResult Result = HKHubArchInstructionOperationResultSuccess;
     HKHubArchPortID Port = *(const uint8_t*)HKHubArchInstructionOperandSourceValue(Processor, &State->operand[0]);
-    HKHubArchPortConnection *Conn = CCDictionaryGetValue(Processor->ports, &Port);
+    HKHubArchPortConnection Conn = HKHubArchPortTableGetConnection(&Processor->ports, Port);
     _Bool Success = FALSE;
     
     if (Processor->message.type == HKHubArchProcessorMessageComplete)
@@ -1603,9 +1696,11 @@ static HKHubArchInstructionOperationResult HKHubArchInstructionOperationRECV(HKH
         Processor->message.port = Port;
         Processor->message.type = HKHubArchProcessorMessageReceive;
         
-        const HKHubArchPort *Interface = HKHubArchPortConnectionGetOppositePort(*Conn, Processor, Port);
+        const HKHubArchPort *Interface = HKHubArchPortConnectionGetOppositePort(Conn, Processor, Port);
         
-        HKHubArchPortResponse Response = Interface->sender ? Interface->sender(*Conn, Interface->device, Interface->id, &Processor->message.data, Processor, Processor->message.timestamp, &Processor->message.wait) : HKHubArchPortResponseTimeout;
+        HKHubArchPortResponse Response;
+        if (Conn->direct) Response = HKHubArchProcessorChannelSend(Conn, Interface->device, Interface->id, &Processor->message.data, Processor, Processor->message.timestamp, &Processor->message.wait);
+        else Response = Interface->sender ? Interface->sender(Conn, Interface->device, Interface->id, &Processor->message.data, Processor, Processor->message.timestamp, &Processor->message.wait) : HKHubArchPortResponseTimeout;
         
         switch (Response)
         {
@@ -1633,6 +1728,7 @@ static HKHubArchInstructionOperationResult HKHubArchInstructionOperationRECV(HKH
                 break;
                 
             case HKHubArchPortResponseRetry:
+                Processor->waiting = HKHubArchPortConnectionWait(Conn, Processor, Port);
                 return HKHubArchInstructionOperationResultFailure | HKHubArchInstructionOperationResultFlagPipelineStall;
                 
             case HKHubArchPortResponseDefer:
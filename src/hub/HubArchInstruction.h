@@ -143,4 +143,67 @@ CC_NEW CCString HKHubArchInstructionDisassemble(const HKHubArchInstructionState
  */
 HKHubArchInstructionOperationResult HKHubArchInstructionExecute(HKHubArchProcessor Processor, const HKHubArchInstructionState *State);
 
+/*!
+ * @brief Lower an instruction to an operand specialised handler.
+ * @description Instructions that have no specialised handler are lowered to @b HKHubArchInstructionHandlerGeneric.
+ * @param State The state for the instruction.
+ * @param Lowered The pointer to store the lowered state.
+ */
+void HKHubArchInstructionLower(const HKHubArchInstructionState *State, HKHubArchInstructionLoweredState *Lowered);
+
+/*!
+ * @brief Get the flags resulting from an addition.
+ * @param Dest The destination value.
+ * @param Src The source value.
+ * @param Result The result of the addition.
+ * @return The flags.
+ */
+static CC_FORCE_INLINE HKHubArchProcessorFlags HKHubArchInstructionAdditionFlags(uint8_t Dest, uint8_t Src, uint8_t Result);
+
+/*!
+ * @brief Get the flags resulting from a subtraction.
+ * @param Dest The destination value.
+ * @param Src The source value.
+ * @param Result The result of the subtraction.
+ * @return The flags.
+ */
+static CC_FORCE_INLINE HKHubArchProcessorFlags HKHubArchInstructionSubtractionFlags(uint8_t Dest, uint8_t Src, uint8_t Result);
+
+/*!
+ * @brief Get the flags resulting from a logical operation.
+ * @param Result The result of the operation.
+ * @return The flags.
+ */
+static CC_FORCE_INLINE HKHubArchProcessorFlags HKHubArchInstructionLogicalFlags(uint8_t Result);
+
+#pragma mark -
+
+static CC_FORCE_INLINE HKHubArchProcessorFlags HKHubArchInstructionAdditionFlags(uint8_t Dest, uint8_t Src, uint8_t Result)
+{
+    const HKHubArchProcessorFlags Zero = (Result == 0 ? HKHubArchProcessorFlagsZero : 0);
+    const HKHubArchProcessorFlags Carry = (Result < Dest ? HKHubArchProcessorFlagsCarry : 0);
+    const HKHubArchProcessorFlags Sign = (Result & 0x80 ? HKHubArchProcessorFlagsSign : 0);
+    const HKHubArchProcessorFlags Overflow = ((Dest ^ Src) & 0x80) ? 0 : (((Dest ^ Result) & 0x80) ? HKHubArchProcessorFlagsOverflow : 0);
+    
+    return Zero | Carry | Sign | Overflow;
+}
+
+static CC_FORCE_INLINE HKHubArchProcessorFlags HKHubArchInstructionSubtractionFlags(uint8_t Dest, uint8_t Src, uint8_t Result)
+{
+    const HKHubArchProcessorFlags Zero = (Result == 0 ? HKHubArchProcessorFlagsZero : 0);
+    const HKHubArchProcessorFlags Carry = (Result > Dest ? HKHubArchProcessorFlagsCarry : 0);
+    const HKHubArchProcessorFlags Sign = (Result & 0x80 ? HKHubArchProcessorFlagsSign : 0);
+    const HKHubArchProcessorFlags Overflow = ((Dest ^ Src) & 0x80) ? (((Dest ^ Result) & 0x80) ? HKHubArchProcessorFlagsOverflow : 0) : 0;
+    
+    return Zero | Carry | Sign | Overflow;
+}
+
+static CC_FORCE_INLINE HKHubArchProcessorFlags HKHubArchInstructionLogicalFlags(uint8_t Result)
+{
+    const HKHubArchProcessorFlags Zero = (Result == 0 ? HKHubArchProcessorFlagsZero : 0);
+    const HKHubArchProcessorFlags Sign = (Result & 0x80 ? HKHubArchProcessorFlagsSign : 0);
+    
+    return Zero | Sign;
+}
+
 #endif
@@ -164,6 +164,36 @@ typedef enum {
     HKHubArchInstructionOperationResultFlagInvalidOp = (1 << 3)
 } HKHubArchInstructionOperationResult;
 
+typedef CC_ENUM(HKHubArchInstructionHandler, uint8_t) {
+    /// Executed through @b HKHubArchInstructionExecute
+    HKHubArchInstructionHandlerGeneric,
+    HKHubArchInstructionHandlerMovRR,
+    HKHubArchInstructionHandlerMovRI,
+    HKHubArchInstructionHandlerAddRR,
+    HKHubArchInstructionHandlerAddRI,
+    HKHubArchInstructionHandlerSubRR,
+    HKHubArchInstructionHandlerSubRI,
+    HKHubArchInstructionHandlerCmpRR,
+    HKHubArchInstructionHandlerCmpRI,
+    HKHubArchInstructionHandlerXorRR,
+    HKHubArchInstructionHandlerXorRI,
+    HKHubArchInstructionHandlerOrRR,
+    HKHubArchInstructionHandlerOrRI,
+    HKHubArchInstructionHandlerAndRR,
+    HKHubArchInstructionHandlerAndRI,
+    HKHubArchInstructionHandlerJump,
+    HKHubArchInstructionHandlerBranch,
+    
+    HKHubArchInstructionHandlerCount
+};
+
+typedef struct {
+    HKHubArchInstructionHandler handler;
+    uint8_t dest; //general purpose register index
+    uint8_t src; //general purpose register index (RR), immediate value (RI), or relative offset (Jump, Branch)
+    uint16_t condition; //handler = HKHubArchInstructionHandlerBranch, bit (1 << flags) is set if the branch is taken
+} HKHubArchInstructionLoweredState;
+
 /*!
  * @brief Check if the register is a general purpose register.
  * @param Register The register.
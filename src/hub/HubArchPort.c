@@ -30,6 +30,8 @@ static void HKHubArchPortConnectionContainerElementDestructor(void *Container, H
 const CCCollectionElementDestructor HKHubArchPortConnectionDestructorForCollection = (CCCollectionElementDestructor)HKHubArchPortConnectionContainerElementDestructor;
 const CCDictionaryElementDestructor HKHubArchPortConnectionDestructorForDictionary = (CCDictionaryElementDestructor)HKHubArchPortConnectionContainerElementDestructor;
 
+size_t HKHubArchPortTableGeneration = 0;
+
 static void HKHubArchPortConnectionContainerElementDestructor(void *Container, HKHubArchPortConnection *Element)
 {
     HKHubArchPortConnectionDestroy(*Element);
@@ -75,6 +77,15 @@ void HKHubArchPortConnectionDisconnect(HKHubArchPortConnection Connection)
     Connection->port[0].disconnect = NULL;
     Connection->port[1].disconnect = NULL;
     
+    for (int Loop = 0; Loop < 2; Loop++)
+    {
+        if (Connection->port[Loop].waiting)
+        {
+            Connection->port[Loop].waiting = FALSE;
+            Connection->port[Loop].wake(Connection->port[Loop].device, Connection->port[Loop].id);
+        }
+    }
+    
     if (Disconnect[0]) Disconnect[0](Connection->port[0].device, Connection->port[0].id);
     if (Disconnect[1]) Disconnect[1](Connection->port[1].device, Connection->port[1].id);
 }
@@ -91,14 +102,39 @@ HKHubArchPort *HKHubArchPortConnectionGetPort(HKHubArchPortConnection Connection
     return NULL;
 }
 
-HKHubArchPort *HKHubArchPortConnectionGetOppositePort(HKHubArchPortConnection Connection, HKHubArchPortDevice Device, HKHubArchPortID Port)
+_Bool HKHubArchPortConnectionWait(HKHubArchPortConnection Connection, HKHubArchPortDevice Device, HKHubArchPortID Port)
 {
     CCAssertLog(Connection, "Connection must not be null");
     
-    for (int Loop = 0; Loop < 2; Loop++)
+    HKHubArchPort *Interface = HKHubArchPortConnectionGetPort(Connection, Device, Port);
+    const HKHubArchPort *OppositeInterface = HKHubArchPortConnectionGetOppositePort(Connection, Device, Port);
+    
+    if ((!Interface->wake) || (!OppositeInterface->wake)) return FALSE;
+    
+    Interface->waiting = TRUE;
+    
+    return TRUE;
+}
+
+void HKHubArchPortConnectionNotify(HKHubArchPortConnection Connection, HKHubArchPortDevice Device, HKHubArchPortID Port)
+{
+    CCAssertLog(Connection, "Connection must not be null");
+    
+    HKHubArchPort *OppositeInterface = HKHubArchPortConnectionGetOppositePort(Connection, Device, Port);
+    
+    if (OppositeInterface->waiting)
     {
-        if ((Connection->port[Loop].device != Device) || (Connection->port[Loop].id != Port)) return &Connection->port[Loop];
+        OppositeInterface->waiting = FALSE;
+        OppositeInterface->wake(OppositeInterface->device, OppositeInterface->id);
     }
+}
+
+void HKHubArchPortTableClear(HKHubArchPortTable *Table)
+{
+    CCAssertLog(Table, "Table must not be null");
     
-    return NULL;
+    HK_HUB_ARCH_PORT_TABLE_FOREACH(Port, Table)
+    {
+        HKHubArchPortTableSetConnection(Table, (HKHubArchPortID)Port, NULL);
+    }
 }
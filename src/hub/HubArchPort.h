@@ -83,12 +83,30 @@ typedef _Bool (*HKHubArchPortReady)(HKHubArchPortDevice Device, HKHubArchPortID
  */
 typedef void (*HKHubArchPortDisconnect)(HKHubArchPortDevice Device, HKHubArchPortID Port);
 
+/*!
+ * @brief Wake the device at the given port.
+ * @description Called when the opposite device has changed after the device had waited on the connection.
+ * @param Device The device the port belongs to.
+ * @param Port The port that was waiting.
+ */
+typedef void (*HKHubArchPortWake)(HKHubArchPortDevice Device, HKHubArchPortID Port);
+
 /*!
  * @brief Destructor to destroy the device.
  * @param Device The device to be destroyed.
  */
 typedef void (*HKHubArchPortDeviceDestructor)(HKHubArchPortDevice Device);
 
+/*!
+ * @brief The port connections of a device, indexed by port.
+ * @description Ports with a connection are also set in @b occupied, so the connections can be enumerated
+ *              without visiting every port.
+ */
+typedef struct {
+    uint64_t occupied[256 / 64];
+    HKHubArchPortConnection connection[256];
+} HKHubArchPortTable;
+
 typedef struct {
     HKHubArchPortTransmit sender;
     HKHubArchPortTransmit receiver;
@@ -96,13 +114,33 @@ typedef struct {
     HKHubArchPortDevice device;
     HKHubArchPortDeviceDestructor destructor;
     HKHubArchPortDisconnect disconnect;
+    HKHubArchPortWake wake;
+    /// The connections of the device, so devices reachable through it can be found. May be NULL.
+    const HKHubArchPortTable *ports;
     HKHubArchPortID id;
+    _Bool waiting;
 } HKHubArchPort;
 
 typedef struct HKHubArchPortConnectionInfo {
     HKHubArchPort port[2];
+    /// Both ports belong to processors, so transfers may bypass the port interfaces
+    _Bool direct;
 } HKHubArchPortConnectionInfo;
 
+/*!
+ * @brief Iterate over the connected ports of a port table.
+ * @description Connections may be removed while iterating.
+ * @param port The name of the port variable.
+ * @param table The pointer to the port table.
+ */
+#define HK_HUB_ARCH_PORT_TABLE_FOREACH(port, table) for (int port = HKHubArchPortTableNext(table, -1); port != -1; port = HKHubArchPortTableNext(table, port))
+
+/*!
+ * @brief Incremented whenever a connection is added to or removed from any port table.
+ * @description Allows the topology of connected devices to be cached until it changes.
+ */
+extern size_t HKHubArchPortTableGeneration;
+
 extern const CCCollectionElementDestructor HKHubArchPortConnectionDestructorForCollection;
 extern const CCDictionaryElementDestructor HKHubArchPortConnectionDestructorForDictionary;
 
@@ -145,7 +183,29 @@ HKHubArchPort *HKHubArchPortConnectionGetPort(HKHubArchPortConnection Connection
  * @param Port The port of the device.
  * @return The port interface for the other device/port.
  */
-HKHubArchPort *HKHubArchPortConnectionGetOppositePort(HKHubArchPortConnection Connection, HKHubArchPortDevice Device, HKHubArchPortID Port);
+static inline HKHubArchPort *HKHubArchPortConnectionGetOppositePort(HKHubArchPortConnection Connection, HKHubArchPortDevice Device, HKHubArchPortID Port);
+
+/*!
+ * @brief Wait on the opposite device of the connection to change.
+ * @description Waiting is only possible if both devices provide a wake callback. A device that provides a
+ *              wake callback must notify the connection of any changes to its state that could affect the
+ *              response of its transmit callbacks using @b HKHubArchPortConnectionNotify.
+ *
+ * @param Connection The port connection to wait on.
+ * @param Device The device that is waiting.
+ * @param Port The port of the device that is waiting.
+ * @return Whether the device will be woken. If FALSE the device must continue polling the connection.
+ */
+_Bool HKHubArchPortConnectionWait(HKHubArchPortConnection Connection, HKHubArchPortDevice Device, HKHubArchPortID Port);
+
+/*!
+ * @brief Notify the connection that the device has changed.
+ * @description Wakes the opposite device if it was waiting.
+ * @param Connection The port connection to notify.
+ * @param Device The device that has changed.
+ * @param Port The port of the device that has changed.
+ */
+void HKHubArchPortConnectionNotify(HKHubArchPortConnection Connection, HKHubArchPortDevice Device, HKHubArchPortID Port);
 
 /*!
  * @brief Check if the port is ready for the operation.
@@ -154,12 +214,94 @@ HKHubArchPort *HKHubArchPortConnectionGetOppositePort(HKHubArchPortConnection Co
  */
 static inline _Bool HKHubArchPortIsReady(const HKHubArchPort *Port);
 
+/*!
+ * @brief Initialise an empty port table.
+ * @param Table The port table to be initialised.
+ */
+static inline void HKHubArchPortTableInit(HKHubArchPortTable *Table);
+
+/*!
+ * @brief Destroy all the connections in a port table.
+ * @param Table The port table to be cleared.
+ */
+void HKHubArchPortTableClear(HKHubArchPortTable *Table);
+
+/*!
+ * @brief Get the connection for a port.
+ * @param Table The port table.
+ * @param Port The port to get the connection of.
+ * @return The connection or NULL if the port is not connected.
+ */
+static inline HKHubArchPortConnection HKHubArchPortTableGetConnection(const HKHubArchPortTable *Table, HKHubArchPortID Port);
+
+/*!
+ * @brief Set the connection for a port.
+ * @description Any previous connection for the port is destroyed.
+ * @param Table The port table.
+ * @param Port The port to set the connection of.
+ * @param Connection The connection, the table takes ownership of it. Or NULL to remove the connection.
+ */
+static inline void HKHubArchPortTableSetConnection(HKHubArchPortTable *Table, HKHubArchPortID Port, HKHubArchPortConnection CC_OWN(Connection));
+
+/*!
+ * @brief Get the next connected port.
+ * @param Table The port table.
+ * @param Port The port to start searching after, or -1 to search from the first port.
+ * @return The next connected port, or -1 if there are no more connected ports.
+ */
+static inline int HKHubArchPortTableNext(const HKHubArchPortTable *Table, int Port);
+
 
 #pragma mark -
 
+static inline HKHubArchPort *HKHubArchPortConnectionGetOppositePort(HKHubArchPortConnection Connection, HKHubArchPortDevice Device, HKHubArchPortID Port)
+{
+    CCAssertLog(Connection, "Connection must not be null");
+    
+    return &Connection->port[(Connection->port[0].device == Device) && (Connection->port[0].id == Port)];
+}
+
 static inline _Bool HKHubArchPortIsReady(const HKHubArchPort *Port)
 {
     return !Port->ready || Port->ready(Port->device, Port->id);
 }
 
+static inline void HKHubArchPortTableInit(HKHubArchPortTable *Table)
+{
+    memset(Table, 0, sizeof(*Table));
+}
+
+static inline HKHubArchPortConnection HKHubArchPortTableGetConnection(const HKHubArchPortTable *Table, HKHubArchPortID Port)
+{
+    return Table->connection[Port];
+}
+
+static inline void HKHubArchPortTableSetConnection(HKHubArchPortTable *Table, HKHubArchPortID Port, HKHubArchPortConnection Connection)
+{
+    HKHubArchPortConnection PrevConnection = Table->connection[Port];
+    
+    Table->connection[Port] = Connection;
+    
+    if (Connection) Table->occupied[Port / 64] |= (uint64_t)1 << (Port % 64);
+    else Table->occupied[Port / 64] &= ~((uint64_t)1 << (Port % 64));
+    
+    if (PrevConnection != Connection) HKHubArchPortTableGeneration++;
+    
+    if (PrevConnection) HKHubArchPortConnectionDestroy(PrevConnection);
+}
+
+static inline int HKHubArchPortTableNext(const HKHubArchPortTable *Table, int Port)
+{
+    for (int Next = Port + 1; Next < 256; )
+    {
+        const uint64_t Occupied = Table->occupied[Next / 64] >> (Next % 64);
+        
+        if (!Occupied) Next = (Next + 64) & ~63;
+        else if (Occupied & 1) return Next;
+        else Next++;
+    }
+    
+    return -1;
+}
+
 #endif
@@ -25,21 +25,19 @@
 
 #include "HubArchProcessor.h"
 #include "HubArchInstruction.h"
+#include <threads.h>
 
 const double HKHubArchProcessorHertz = 400.0;
 const size_t HKHubArchProcessorSpeedMemoryRead = 1;
 const size_t HKHubArchProcessorSpeedMemoryWrite = 1;
 const size_t HKHubArchProcessorSpeedPortTransmission = 4;
 
-static uintmax_t HKHubArchProcessorPortHasher(HKHubArchPortID *Key)
-{
-    return *Key;
-}
-
 static void HKHubArchProcessorDestructor(HKHubArchProcessor Processor)
 {
-    CC_DICTIONARY_FOREACH_VALUE(HKHubArchPortConnection, Connection, Processor->ports)
+    HK_HUB_ARCH_PORT_TABLE_FOREACH(Port, &Processor->ports)
     {
+        HKHubArchPortConnection Connection = HKHubArchPortTableGetConnection(&Processor->ports, Port);
+        
         for (int Loop = 0; Loop < 2; Loop++)
         {
             if (Connection->port[Loop].device == Processor) Connection->port[Loop].disconnect = NULL;
@@ -48,11 +46,11 @@ static void HKHubArchProcessorDestructor(HKHubArchProcessor Processor)
         HKHubArchPortConnectionDisconnect(Connection);
     }
     
-    CCDictionaryDestroy(Processor->ports);
+    HKHubArchPortTableClear(&Processor->ports);
     
-    if (Processor->state.debug.breakpoints) CCDictionaryDestroy(Processor->state.debug.breakpoints);
     if (Processor->cache.graph) HKHubArchExecutionGraphDestroy(Processor->cache.graph);
     if (Processor->cache.jit) HKHubArchJITDestroy(Processor->cache.jit);
+    if (Processor->cache.decoded) CCFree(Processor->cache.decoded);
 }
 
 HKHubArchProcessor HKHubArchProcessorCreate(CCAllocatorType Allocator, HKHubArchBinary Binary)
@@ -63,12 +61,10 @@ HKHubArchProcessor HKHubArchProcessorCreate(CCAllocatorType Allocator, HKHubArch
     
     if (Processor)
     {
-        Processor->ports = CCDictionaryCreate(Allocator, CCDictionaryHintHeavyFinding, sizeof(HKHubArchPortID), sizeof(HKHubArchPortConnection), &(CCDictionaryCallbacks){
-            .getHash = (CCDictionaryKeyHasher)HKHubArchProcessorPortHasher,
-            .valueDestructor = HKHubArchPortConnectionDestructorForDictionary
-        });
+        HKHubArchPortTableInit(&Processor->ports);
         
         Processor->message.type = HKHubArchProcessorMessageClear;
+        Processor->waiting = FALSE;
         Processor->state.r[0] = 0;
         Processor->state.r[1] = 0;
         Processor->state.r[2] = 0;
@@ -77,17 +73,19 @@ HKHubArchProcessor HKHubArchProcessorCreate(CCAllocatorType Allocator, HKHubArch
         Processor->state.flags = 0;
         Processor->state.debug.mode = HKHubArchProcessorDebugModeContinue;
         Processor->state.debug.step = 0;
-        Processor->state.debug.breakpoints = NULL;
+        memset(&Processor->state.debug.breakpoints, 0, sizeof(Processor->state.debug.breakpoints));
         Processor->state.debug.modified.reg = 0;
         Processor->state.debug.modified.size = 0;
-        Processor->state.debug.operation = NULL;
-        Processor->state.debug.portConnectionChange = NULL;
-        Processor->state.debug.breakpointChange = NULL;
-        Processor->state.debug.debugModeChange = NULL;
-        Processor->state.debug.context = NULL;
-        Processor->state.debug.extra = 0;
+        Processor->debug.operation = NULL;
+        Processor->debug.trace = NULL;
+        Processor->debug.portConnectionChange = NULL;
+        Processor->debug.breakpointChange = NULL;
+        Processor->debug.debugModeChange = NULL;
+        Processor->debug.context = NULL;
+        Processor->debug.extra = 0;
         Processor->cache.graph = NULL;
         Processor->cache.jit = NULL;
+        Processor->cache.decoded = NULL;
         Processor->cycles = 0;
         Processor->unusedTime = 0.0;
         Processor->status = HKHubArchProcessorStatusRunning;
@@ -115,6 +113,20 @@ void HKHubArchProcessorDestroy(HKHubArchProcessor Processor)
     CCFree(Processor);
 }
 
+static void HKHubArchProcessorNotifyPorts(HKHubArchProcessor Processor)
+{
+    HK_HUB_ARCH_PORT_TABLE_FOREACH(Port, &Processor->ports)
+    {
+        HKHubArchPortConnectionNotify(HKHubArchPortTableGetConnection(&Processor->ports, Port), Processor, Port);
+    }
+}
+
+static void HKHubArchProcessorWake(HKHubArchProcessor Processor)
+{
+    Processor->waiting = FALSE;
+    HKHubArchProcessorNotifyPorts(Processor);
+}
+
 void HKHubArchProcessorReset(HKHubArchProcessor Processor, HKHubArchBinary Binary)
 {
     CCAssertLog(Processor, "Processor must not be null");
@@ -143,6 +155,34 @@ void HKHubArchProcessorReset(HKHubArchProcessor Processor, HKHubArchBinary Binar
     }
 }
 
+static void HKHubArchProcessorCacheBreakpoints(HKHubArchProcessor Processor)
+{
+    if ((!Processor->cache.jit) || (!(Processor->cache.jit->options & HKHubArchJITOptionsDebug))) return;
+    
+    for (size_t Offset = 0; Offset < 256; Offset++)
+    {
+        const HKHubArchProcessorDebugBreakpoint Breakpoint = HKHubArchProcessorGetBreakpoint(Processor, (uint8_t)Offset);
+        
+        if (Breakpoint) HKHubArchJITSetBreakpoint(Processor->cache.jit, (uint8_t)Offset, Breakpoint & HKHubArchProcessorDebugBreakpointRead, Breakpoint & HKHubArchProcessorDebugBreakpointWrite);
+    }
+}
+
+static void HKHubArchProcessorCacheRegenerate(HKHubArchProcessor Processor)
+{
+    if ((!Processor->cache.jit) || (!(Processor->cache.jit->options & HKHubArchJITOptionsDebug))) return;
+    
+    /*
+     Read breakpoints exit by invalidating the instructions they cover, which can't be restored. So when one is
+     removed the JIT is generated again with the remaining breakpoints.
+     */
+    const HKHubArchJITOptions Options = Processor->cache.jit->options;
+    
+    HKHubArchJITDestroy(Processor->cache.jit);
+    Processor->cache.jit = HKHubArchJITCreate(CC_STD_ALLOCATOR, Processor->cache.graph, Options);
+    
+    HKHubArchProcessorCacheBreakpoints(Processor);
+}
+
 void HKHubArchProcessorDebugReset(HKHubArchProcessor Processor)
 {
     CCAssertLog(Processor, "Processor must not be null");
@@ -151,30 +191,16 @@ void HKHubArchProcessorDebugReset(HKHubArchProcessor Processor)
     Processor->state.debug.step = 0;
     Processor->state.debug.modified.reg = 0;
     Processor->state.debug.modified.size = 0;
-    Processor->state.debug.operation = NULL;
-    Processor->state.debug.context = NULL;
-    Processor->state.debug.extra = 0;
+    Processor->debug.operation = NULL;
+    Processor->debug.trace = NULL;
+    Processor->debug.context = NULL;
+    Processor->debug.extra = 0;
     
-    if (Processor->state.debug.breakpoints)
-    {
-        if (Processor->state.debug.breakpointChange)
-        {
-            CC_DICTIONARY_FOREACH_KEY(uint8_t, Offset, Processor->state.debug.breakpoints)
-            {
-                HKHubArchProcessorDebugBreakpoint *Bp = CCDictionaryGetValue(Processor->state.debug.breakpoints, &Offset);
-                
-                if (Bp != HKHubArchProcessorDebugBreakpointNone)
-                {
-                    Processor->state.debug.breakpointChange(Processor, HKHubArchProcessorDebugBreakpointNone, Offset);
-                }
-            }
-        }
-        
-        CCDictionaryDestroy(Processor->state.debug.breakpoints);
-        Processor->state.debug.breakpoints = NULL;
-    }
+    HKHubArchProcessorClearBreakpoints(Processor);
+    
+    HKHubArchProcessorWake(Processor);
     
-    if (Processor->state.debug.debugModeChange) Processor->state.debug.debugModeChange(Processor);
+    if (Processor->debug.debugModeChange) Processor->debug.debugModeChange(Processor);
 }
 
 void HKHubArchProcessorCacheReset(HKHubArchProcessor Processor)
@@ -201,6 +227,8 @@ void HKHubArchProcessorSetCycles(HKHubArchProcessor Processor, size_t Cycles)
     Processor->cycles = Cycles;
     Processor->unusedTime = 0.0;
     if (Processor->status & HKHubArchProcessorStatusResumable) Processor->status = HKHubArchProcessorStatusRunning;
+    
+    HKHubArchProcessorWake(Processor);
 }
 
 void HKHubArchProcessorAddProcessingTime(HKHubArchProcessor Processor, double Seconds)
@@ -211,16 +239,53 @@ void HKHubArchProcessorAddProcessingTime(HKHubArchProcessor Processor, double Se
     Processor->cycles += Cycles;
     Processor->unusedTime = Cycles - (size_t)Cycles;
     if (Processor->status & HKHubArchProcessorStatusResumable) Processor->status = HKHubArchProcessorStatusRunning;
+    
+    HKHubArchProcessorWake(Processor);
 }
 
 static void HKHubArchProcessorDisconnectPort(HKHubArchProcessor Processor, HKHubArchPortID Port)
 {
-    CCDictionaryRemoveValue(Processor->ports, &Port);
+    HKHubArchPortTableSetConnection(&Processor->ports, Port, NULL);
     
-    if (Processor->state.debug.portConnectionChange) Processor->state.debug.portConnectionChange(Processor, Port);
+    if (Processor->debug.portConnectionChange) Processor->debug.portConnectionChange(Processor, Port);
 }
 
-static HKHubArchPortResponse HKHubArchProcessorPortSend(HKHubArchPortConnection Connection, HKHubArchProcessor Device, HKHubArchPortID Port, HKHubArchPortMessage *Message, HKHubArchPortDevice ConnectedDevice, size_t Timestamp, size_t *Wait)
+static CC_FORCE_INLINE _Bool HKHubArchProcessorMessageReady(HKHubArchProcessor Device)
+{
+    size_t Cycles = Device->message.wait + (Device->message.data.size * HKHubArchProcessorSpeedPortTransmission);
+    
+    switch (Device->message.type)
+    {
+        case HKHubArchProcessorMessageSend:
+            Cycles += Device->message.data.size * HKHubArchProcessorSpeedMemoryRead;
+            break;
+            
+        case HKHubArchProcessorMessageReceive:
+            Cycles += Device->message.data.size * HKHubArchProcessorSpeedMemoryWrite;
+            break;
+            
+        default:
+            CCAssertLog(0, "Should not be called unless operation is possible");
+            break;
+    }
+    
+    return Cycles <= Device->message.timestamp;
+}
+
+_Bool HKHubArchProcessorPortReady(HKHubArchProcessor Device, HKHubArchPortID Port)
+{
+    return HKHubArchProcessorMessageReady(Device);
+}
+
+static CC_FORCE_INLINE _Bool HKHubArchProcessorPortIsReady(HKHubArchPortConnection Connection, HKHubArchProcessor Device, HKHubArchPortID Port, HKHubArchPortDevice ConnectedDevice, _Bool Direct)
+{
+    //Both ends of a direct connection are known to be processors, so their ports don't need to be looked up
+    if (Direct) return (HKHubArchProcessorMessageReady(Device)) && (HKHubArchProcessorMessageReady(ConnectedDevice));
+    
+    return (HKHubArchPortIsReady(HKHubArchPortConnectionGetPort(Connection, Device, Port))) && (HKHubArchPortIsReady(HKHubArchPortConnectionGetOppositePort(Connection, Device, Port)));
+}
+
+static CC_FORCE_INLINE HKHubArchPortResponse HKHubArchProcessorPortSendMessage(HKHubArchPortConnection Connection, HKHubArchProcessor Device, HKHubArchPortID Port, HKHubArchPortMessage *Message, HKHubArchPortDevice ConnectedDevice, size_t Timestamp, size_t *Wait, _Bool Direct)
 {
     /*
      Timestamp is the beginning of the 8 cycle wait period. While 6 cycles is the min a send/recv can consume to reach its timestamp.
@@ -239,9 +304,10 @@ static HKHubArchPortResponse HKHubArchProcessorPortSend(HKHubArchPortConnection
         Device->message.wait = Device->message.timestamp > Timestamp ? Device->message.timestamp - Timestamp : 0;
         *Wait = Device->message.timestamp < Timestamp ? Timestamp - Device->message.timestamp : 0;
         
-        if ((!HKHubArchPortIsReady(HKHubArchPortConnectionGetPort(Connection, Device, Port))) || (!HKHubArchPortIsReady(HKHubArchPortConnectionGetOppositePort(Connection, Device, Port)))) return HKHubArchPortResponseDefer;
+        if (!HKHubArchProcessorPortIsReady(Connection, Device, Port, ConnectedDevice, Direct)) return HKHubArchPortResponseDefer;
         
         Device->message.type = HKHubArchProcessorMessageComplete;
+        HKHubArchProcessorWake(Device);
         
         return HKHubArchPortResponseSuccess;
     }
@@ -253,7 +319,7 @@ static HKHubArchPortResponse HKHubArchProcessorPortSend(HKHubArchPortConnection
     return HKHubArchProcessorIsRunning(Device) ? HKHubArchPortResponseRetry : HKHubArchPortResponseDefer;
 }
 
-static HKHubArchPortResponse HKHubArchProcessorPortReceive(HKHubArchPortConnection Connection, HKHubArchProcessor Device, HKHubArchPortID Port, HKHubArchPortMessage *Message, HKHubArchPortDevice ConnectedDevice, size_t Timestamp, size_t *Wait)
+static CC_FORCE_INLINE HKHubArchPortResponse HKHubArchProcessorPortReceiveMessage(HKHubArchPortConnection Connection, HKHubArchProcessor Device, HKHubArchPortID Port, HKHubArchPortMessage *Message, HKHubArchPortDevice ConnectedDevice, size_t Timestamp, size_t *Wait, _Bool Direct)
 {
     /*
      Timestamp is the beginning of the 8 cycle wait period. While 6 cycles is the min a send/recv can consume to reach its timestamp. 
@@ -270,7 +336,7 @@ static HKHubArchPortResponse HKHubArchProcessorPortReceive(HKHubArchPortConnecti
         Device->message.wait = Device->message.timestamp > Timestamp ? Device->message.timestamp - Timestamp : 0;
         *Wait = Device->message.timestamp < Timestamp ? Timestamp - Device->message.timestamp : 0;
         
-        if ((!HKHubArchPortIsReady(HKHubArchPortConnectionGetPort(Connection, Device, Port))) || (!HKHubArchPortIsReady(HKHubArchPortConnectionGetOppositePort(Connection, Device, Port)))) return HKHubArchPortResponseDefer;
+        if (!HKHubArchProcessorPortIsReady(Connection, Device, Port, ConnectedDevice, Direct)) return HKHubArchPortResponseDefer;
         
         const uint8_t Offset = Device->message.offset;
         for (size_t Loop = 0; Loop < Message->size; Loop++)
@@ -284,6 +350,8 @@ static HKHubArchPortResponse HKHubArchProcessorPortReceive(HKHubArchPortConnecti
         Device->state.debug.modified.offset = Offset;
         Device->state.debug.modified.size = Message->size;
         
+        HKHubArchProcessorWake(Device);
+        
         return HKHubArchPortResponseSuccess;
     }
     
@@ -294,26 +362,29 @@ static HKHubArchPortResponse HKHubArchProcessorPortReceive(HKHubArchPortConnecti
     return HKHubArchProcessorIsRunning(Device) ? HKHubArchPortResponseRetry : HKHubArchPortResponseDefer;
 }
 
-_Bool HKHubArchProcessorPortReady(HKHubArchProcessor Device, HKHubArchPortID Port)
+static HKHubArchPortResponse HKHubArchProcessorPortSend(HKHubArchPortConnection Connection, HKHubArchProcessor Device, HKHubArchPortID Port, HKHubArchPortMessage *Message, HKHubArchPortDevice ConnectedDevice, size_t Timestamp, size_t *Wait)
 {
-    size_t Cycles = Device->message.wait + (Device->message.data.size * HKHubArchProcessorSpeedPortTransmission);
-    
-    switch (Device->message.type)
-    {
-        case HKHubArchProcessorMessageSend:
-            Cycles += Device->message.data.size * HKHubArchProcessorSpeedMemoryRead;
-            break;
-            
-        case HKHubArchProcessorMessageReceive:
-            Cycles += Device->message.data.size * HKHubArchProcessorSpeedMemoryWrite;
-            break;
-            
-        default:
-            CCAssertLog(0, "Should not be called unless operation is possible");
-            break;
-    }
-    
-    return Cycles <= Device->message.timestamp;
+    return HKHubArchProcessorPortSendMessage(Connection, Device, Port, Message, ConnectedDevice, Timestamp, Wait, FALSE);
+}
+
+static HKHubArchPortResponse HKHubArchProcessorPortReceive(HKHubArchPortConnection Connection, HKHubArchProcessor Device, HKHubArchPortID Port, HKHubArchPortMessage *Message, HKHubArchPortDevice ConnectedDevice, size_t Timestamp, size_t *Wait)
+{
+    return HKHubArchProcessorPortReceiveMessage(Connection, Device, Port, Message, ConnectedDevice, Timestamp, Wait, FALSE);
+}
+
+HKHubArchPortResponse HKHubArchProcessorChannelSend(HKHubArchPortConnection Connection, HKHubArchProcessor Device, HKHubArchPortID Port, HKHubArchPortMessage *Message, HKHubArchProcessor ConnectedDevice, size_t Timestamp, size_t *Wait)
+{
+    return HKHubArchProcessorPortSendMessage(Connection, Device, Port, Message, ConnectedDevice, Timestamp, Wait, TRUE);
+}
+
+HKHubArchPortResponse HKHubArchProcessorChannelReceive(HKHubArchPortConnection Connection, HKHubArchProcessor Device, HKHubArchPortID Port, HKHubArchPortMessage *Message, HKHubArchProcessor ConnectedDevice, size_t Timestamp, size_t *Wait)
+{
+    return HKHubArchProcessorPortReceiveMessage(Connection, Device, Port, Message, ConnectedDevice, Timestamp, Wait, TRUE);
+}
+
+static void HKHubArchProcessorPortWake(HKHubArchProcessor Device, HKHubArchPortID Port)
+{
+    Device->waiting = FALSE;
 }
 
 HKHubArchPort HKHubArchProcessorGetPort(HKHubArchProcessor Processor, HKHubArchPortID Port)
@@ -326,7 +397,9 @@ HKHubArchPort HKHubArchProcessorGetPort(HKHubArchProcessor Processor, HKHubArchP
         .disconnect = NULL,
         .sender = (HKHubArchPortTransmit)HKHubArchProcessorPortSend,
         .receiver = (HKHubArchPortTransmit)HKHubArchProcessorPortReceive,
-        .ready = (HKHubArchPortReady)HKHubArchProcessorPortReady
+        .ready = (HKHubArchPortReady)HKHubArchProcessorPortReady,
+        .wake = (HKHubArchPortWake)HKHubArchProcessorPortWake,
+        .ports = &Processor->ports
     };
 }
 
@@ -334,9 +407,7 @@ HKHubArchPortConnection HKHubArchProcessorGetPortConnection(HKHubArchProcessor P
 {
     CCAssertLog(Processor, "Processor must not be null");
     
-    HKHubArchPortConnection *Connection = CCDictionaryGetValue(Processor->ports, &Port);
-    
-    return Connection ? *Connection : NULL;
+    return HKHubArchPortTableGetConnection(&Processor->ports, Port);
 }
 
 static inline void HKHubArchProcessorSetConnectionDisconnectCallback(HKHubArchProcessor Processor, HKHubArchPortID Port, HKHubArchPortConnection Connection, HKHubArchPortDisconnect Disconnect)
@@ -355,76 +426,387 @@ void HKHubArchProcessorConnect(HKHubArchProcessor Processor, HKHubArchPortID Por
     CCAssertLog(Processor, "Processor must not be null");
     CCAssertLog(Connection, "Connection must not be null");
     
-    CCDictionaryEntry Entry = CCDictionaryEntryForKey(Processor->ports, &Port);
+    HKHubArchPortConnection OldConnection = HKHubArchPortTableGetConnection(&Processor->ports, Port);
     
-    if (CCDictionaryEntryIsInitialized(Processor->ports, Entry))
+    if (OldConnection)
     {
-        HKHubArchPortConnection OldConnection = *(HKHubArchPortConnection*)CCDictionaryGetEntry(Processor->ports, Entry);
         HKHubArchProcessorSetConnectionDisconnectCallback(Processor, Port, OldConnection, NULL);
         HKHubArchPortConnectionDisconnect(OldConnection);
     }
     
     HKHubArchProcessorSetConnectionDisconnectCallback(Processor, Port, Connection, (HKHubArchPortDisconnect)HKHubArchProcessorDisconnectPort);
     
-    CCDictionarySetEntry(Processor->ports, Entry, &(HKHubArchPortConnection){ CCRetain(Connection) });
+    Connection->direct = (Connection->port[0].sender == (HKHubArchPortTransmit)HKHubArchProcessorPortSend) && (Connection->port[1].sender == (HKHubArchPortTransmit)HKHubArchProcessorPortSend);
     
-    if (Processor->state.debug.portConnectionChange) Processor->state.debug.portConnectionChange(Processor, Port);
+    HKHubArchPortTableSetConnection(&Processor->ports, Port, CCRetain(Connection));
+    
+    if (Processor->debug.portConnectionChange) Processor->debug.portConnectionChange(Processor, Port);
 }
 
 void HKHubArchProcessorDisconnect(HKHubArchProcessor Processor, HKHubArchPortID Port)
 {
     CCAssertLog(Processor, "Processor must not be null");
     
-    HKHubArchPortConnection *Connection = CCDictionaryGetValue(Processor->ports, &Port);
+    HKHubArchPortConnection Connection = HKHubArchPortTableGetConnection(&Processor->ports, Port);
     
-    if (Connection) HKHubArchPortConnectionDisconnect(*Connection);
+    if (Connection) HKHubArchPortConnectionDisconnect(Connection);
 }
 
-static HKHubArchProcessorDebugBreakpoint HKHubArchProcessorGetBreakpoint(HKHubArchProcessor Processor, uint8_t Offset)
+static CC_FORCE_INLINE uint64_t HKHubArchProcessorGetBreakpointWord(HKHubArchProcessor Processor, size_t Word, HKHubArchProcessorDebugBreakpoint Breakpoint)
 {
-    HKHubArchProcessorDebugBreakpoint *Breakpoint = CCDictionaryGetValue(Processor->state.debug.breakpoints, &Offset);
-    
-    return Breakpoint ? *Breakpoint : HKHubArchProcessorDebugBreakpointNone;
+    return ((Breakpoint & HKHubArchProcessorDebugBreakpointRead) ? Processor->state.debug.breakpoints.read[Word] : 0) | ((Breakpoint & HKHubArchProcessorDebugBreakpointWrite) ? Processor->state.debug.breakpoints.write[Word] : 0);
 }
 
 static _Bool HKHubArchProcessorShouldBreakForRange(HKHubArchProcessor Processor, uint8_t From, uint8_t Till, HKHubArchProcessorDebugBreakpoint Breakpoint)
 {
-    for ( ; From != Till; From++)
-    {
-        if (HKHubArchProcessorGetBreakpoint(Processor, From) & Breakpoint) return TRUE;
-    }
+    /*
+     The range is at most the size of an instruction, so it can only span the word it starts in and the one that
+     follows (wrapping around to the start of memory).
+     */
+    const size_t Count = (uint8_t)(Till - From), Bit = From % 64, Word = From / 64;
+    
+    CCAssertLog(Count < 64, "Range must be smaller than a word");
+    
+    const uint64_t Mask = (UINT64_C(1) << Count) - 1;
+    
+    if (HKHubArchProcessorGetBreakpointWord(Processor, Word, Breakpoint) & (Mask << Bit)) return TRUE;
+    if ((Bit + Count > 64) && (HKHubArchProcessorGetBreakpointWord(Processor, (Word + 1) % (256 / 64), Breakpoint) & (Mask >> (64 - Bit)))) return TRUE;
     
     return FALSE;
 }
 
 void HKHubArchJITCall(HKHubArchJIT JIT, HKHubArchProcessor Processor);
 
+static _Bool HKHubArchProcessorDecodedCacheCreate(HKHubArchProcessor Processor)
+{
+    if (!Processor->cache.decoded)
+    {
+        Processor->cache.decoded = CCMalloc(CC_STD_ALLOCATOR, sizeof(HKHubArchProcessorDecodedInstruction) * 256, NULL, CC_DEFAULT_ERROR_CALLBACK);
+        
+        if (!Processor->cache.decoded) return FALSE;
+        
+        for (size_t Loop = 0; Loop < 256; Loop++) Processor->cache.decoded[Loop].size = 0;
+    }
+    
+    return TRUE;
+}
+
+static HKHubArchProcessorDecodedInstruction *HKHubArchProcessorDecodeCached(HKHubArchProcessor Processor)
+{
+    const uint8_t PC = Processor->state.pc;
+    HKHubArchProcessorDecodedInstruction *Decoded = &Processor->cache.decoded[PC];
+    
+    uint8_t Loop = 0;
+    for (uint8_t Offset = PC; (Loop < Decoded->size) && (Decoded->encoding[Loop] == Processor->memory[Offset]); Loop++, Offset++);
+    
+    if ((!Decoded->size) || (Loop != Decoded->size))
+    {
+        const uint8_t NextPC = HKHubArchInstructionDecode(PC, Processor->memory, &Decoded->state);
+        
+        Decoded->size = Decoded->state.opcode != -1 ? (uint8_t)(NextPC - PC) : 0;
+        
+        CCAssertLog(Decoded->size <= sizeof(Decoded->encoding), "Instruction encoding exceeds 5 bytes");
+        
+        for (uint8_t Index = 0, Offset = PC; Index < Decoded->size; Index++, Offset++) Decoded->encoding[Index] = Processor->memory[Offset];
+        
+        HKHubArchInstructionLower(&Decoded->state, &Decoded->lowered);
+    }
+    
+    return Decoded;
+}
+
+static uint8_t HKHubArchProcessorDecode(HKHubArchProcessor Processor, HKHubArchInstructionState *Instruction)
+{
+    if (!HKHubArchProcessorDecodedCacheCreate(Processor)) return HKHubArchInstructionDecode(Processor->state.pc, Processor->memory, Instruction);
+    
+    const HKHubArchProcessorDecodedInstruction *Decoded = HKHubArchProcessorDecodeCached(Processor);
+    *Instruction = Decoded->state;
+    
+    return Processor->state.pc + Decoded->size;
+}
+
+#if defined(__GNUC__)
+#define HK_HUB_ARCH_PROCESSOR_COMPUTED_GOTO 1
+#endif
+
+#if HK_HUB_ARCH_PROCESSOR_COMPUTED_GOTO
+#define HK_HUB_ARCH_PROCESSOR_DISPATCH(handler) goto *Handlers[handler];
+#define HK_HUB_ARCH_PROCESSOR_HANDLER(handler) Handler##handler
+#else
+#define HK_HUB_ARCH_PROCESSOR_DISPATCH(handler) switch (handler)
+#define HK_HUB_ARCH_PROCESSOR_HANDLER(handler) case HKHubArchInstructionHandler##handler
+#endif
+
+/*!
+ * @brief Run the processor using the lowered instructions.
+ * @description Only valid when the processor is not being debugged. Specialised handlers are executed without
+ *              leaving the dispatch loop, any other instruction is executed normally and then returns to the caller.
+ *
+ * @param Processor The processor to run.
+ * @return Whether the processor can continue running, or FALSE if the pipeline stalled.
+ */
+static _Bool HKHubArchProcessorRunThreaded(HKHubArchProcessor Processor)
+{
+#if HK_HUB_ARCH_PROCESSOR_COMPUTED_GOTO
+    static const void *Handlers[HKHubArchInstructionHandlerCount] = {
+        [HKHubArchInstructionHandlerGeneric] = &&HandlerGeneric,
+        [HKHubArchInstructionHandlerMovRR] = &&HandlerMovRR,
+        [HKHubArchInstructionHandlerMovRI] = &&HandlerMovRI,
+        [HKHubArchInstructionHandlerAddRR] = &&HandlerAddRR,
+        [HKHubArchInstructionHandlerAddRI] = &&HandlerAddRI,
+        [HKHubArchInstructionHandlerSubRR] = &&HandlerSubRR,
+        [HKHubArchInstructionHandlerSubRI] = &&HandlerSubRI,
+        [HKHubArchInstructionHandlerCmpRR] = &&HandlerCmpRR,
+        [HKHubArchInstructionHandlerCmpRI] = &&HandlerCmpRI,
+        [HKHubArchInstructionHandlerXorRR] = &&HandlerXorRR,
+        [HKHubArchInstructionHandlerXorRI] = &&HandlerXorRI,
+        [HKHubArchInstructionHandlerOrRR] = &&HandlerOrRR,
+        [HKHubArchInstructionHandlerOrRI] = &&HandlerOrRI,
+        [HKHubArchInstructionHandlerAndRR] = &&HandlerAndRR,
+        [HKHubArchInstructionHandlerAndRI] = &&HandlerAndRI,
+        [HKHubArchInstructionHandlerJump] = &&HandlerJump,
+        [HKHubArchInstructionHandlerBranch] = &&HandlerBranch
+    };
+#endif
+    
+    uint8_t * const R = Processor->state.r;
+    const HKHubArchProcessorDecodedInstruction *Decoded;
+    size_t Cycles;
+    uint8_t Dest, Src, Result;
+    
+Next:
+    if ((Processor->status != HKHubArchProcessorStatusRunning) || (!Processor->cycles)) return TRUE;
+    
+    Decoded = HKHubArchProcessorDecodeCached(Processor);
+    
+Fetch:
+    if (Decoded->state.opcode == -1)
+    {
+        Processor->status = HKHubArchProcessorStatusTrap;
+        return TRUE;
+    }
+    
+    Cycles = Decoded->size * HKHubArchProcessorSpeedMemoryRead;
+    if (Cycles >= Processor->cycles)
+    {
+        Processor->status = HKHubArchProcessorStatusInsufficientCycles | HKHubArchProcessorStatusResumable;
+        return TRUE;
+    }
+    
+    Processor->cycles -= Cycles;
+    
+    Dest = Decoded->lowered.dest;
+    Src = Decoded->lowered.src;
+    
+    HK_HUB_ARCH_PROCESSOR_DISPATCH(Decoded->lowered.handler)
+    {
+        HK_HUB_ARCH_PROCESSOR_HANDLER(MovRR):
+            Src = R[Src];
+        HK_HUB_ARCH_PROCESSOR_HANDLER(MovRI):
+            if (Processor->cycles < 1) goto Stall;
+            
+            Processor->cycles -= 1;
+            R[Dest] = Src;
+            goto Advance;
+            
+        HK_HUB_ARCH_PROCESSOR_HANDLER(AddRR):
+            Src = R[Src];
+        HK_HUB_ARCH_PROCESSOR_HANDLER(AddRI):
+            if (Processor->cycles < 2) goto Stall;
+            
+            Processor->cycles -= 2;
+            Result = R[Dest] + Src;
+            Processor->state.flags = (Processor->state.flags & ~HKHubArchProcessorFlagsMask) | HKHubArchInstructionAdditionFlags(R[Dest], Src, Result);
+            R[Dest] = Result;
+            goto Fuse;
+            
+        HK_HUB_ARCH_PROCESSOR_HANDLER(SubRR):
+            Src = R[Src];
+        HK_HUB_ARCH_PROCESSOR_HANDLER(SubRI):
+            if (Processor->cycles < 2) goto Stall;
+            
+            Processor->cycles -= 2;
+            Result = R[Dest] - Src;
+            Processor->state.flags = (Processor->state.flags & ~HKHubArchProcessorFlagsMask) | HKHubArchInstructionSubtractionFlags(R[Dest], Src, Result);
+            R[Dest] = Result;
+            goto Fuse;
+            
+        HK_HUB_ARCH_PROCESSOR_HANDLER(CmpRR):
+            Src = R[Src];
+        HK_HUB_ARCH_PROCESSOR_HANDLER(CmpRI):
+            if (Processor->cycles < 2) goto Stall;
+            
+            Processor->cycles -= 2;
+            Result = R[Dest] - Src;
+            Processor->state.flags = (Processor->state.flags & ~HKHubArchProcessorFlagsMask) | HKHubArchInstructionSubtractionFlags(R[Dest], Src, Result);
+            goto Fuse;
+            
+        HK_HUB_ARCH_PROCESSOR_HANDLER(XorRR):
+            Src = R[Src];
+        HK_HUB_ARCH_PROCESSOR_HANDLER(XorRI):
+            if (Processor->cycles < 1) goto Stall;
+            
+            Processor->cycles -= 1;
+            Result = R[Dest] ^ Src;
+            goto Logical;
+            
+        HK_HUB_ARCH_PROCESSOR_HANDLER(OrRR):
+            Src = R[Src];
+        HK_HUB_ARCH_PROCESSOR_HANDLER(OrRI):
+            if (Processor->cycles < 1) goto Stall;
+            
+            Processor->cycles -= 1;
+            Result = R[Dest] | Src;
+            goto Logical;
+            
+        HK_HUB_ARCH_PROCESSOR_HANDLER(AndRR):
+            Src = R[Src];
+        HK_HUB_ARCH_PROCESSOR_HANDLER(AndRI):
+            if (Processor->cycles < 1) goto Stall;
+            
+            Processor->cycles -= 1;
+            Result = R[Dest] & Src;
+            goto Logical;
+            
+        HK_HUB_ARCH_PROCESSOR_HANDLER(Jump):
+            if (Processor->cycles < 1) goto Stall;
+            
+            Processor->cycles -= 1;
+            Processor->state.pc += Src;
+            goto Next;
+            
+        HK_HUB_ARCH_PROCESSOR_HANDLER(Branch):
+            if (Processor->cycles < 1) goto Stall;
+            
+            Processor->cycles -= 1;
+            
+            if ((Decoded->lowered.condition >> (Processor->state.flags & HKHubArchProcessorFlagsMask)) & 1)
+            {
+                Processor->state.pc += Src;
+                goto Next;
+            }
+            
+            goto Advance;
+            
+        HK_HUB_ARCH_PROCESSOR_HANDLER(Generic):
+        {
+            HKHubArchInstructionOperationResult OperationResult;
+            if (((OperationResult = HKHubArchInstructionExecute(Processor, &Decoded->state)) & HKHubArchInstructionOperationResultMask) == HKHubArchInstructionOperationResultFailure)
+            {
+                Processor->cycles += Cycles;
+                
+                if (OperationResult & HKHubArchInstructionOperationResultFlagPipelineStall) return FALSE;
+                
+                Processor->status = OperationResult & HKHubArchInstructionOperationResultFlagInvalidOp ? HKHubArchProcessorStatusTrap : (HKHubArchProcessorStatusInsufficientCycles | HKHubArchProcessorStatusResumable);
+            }
+            
+            else
+            {
+                if (!(OperationResult & HKHubArchInstructionOperationResultFlagSkipPC)) Processor->state.pc += Decoded->size;
+                
+                Processor->state.debug.modified.reg = 0;
+                Processor->state.debug.modified.size = 0;
+            }
+            
+            return TRUE;
+        }
+            
+#if !HK_HUB_ARCH_PROCESSOR_COMPUTED_GOTO
+        default:
+            CCAssertLog(0, "Unknown instruction handler");
+            return TRUE;
+#endif
+    }
+    
+Logical:
+    Processor->state.flags = (Processor->state.flags & ~HKHubArchProcessorFlagsMask) | HKHubArchInstructionLogicalFlags(Result);
+    R[Dest] = Result;
+    
+Fuse:
+    /*
+     Flag producing instructions are commonly followed by a conditional branch (cmp+jz, sub+jnz, etc.), so the
+     branch is executed directly with a single cycle check for its fetch and operation. Failing that check is
+     the same as failing either one individually.
+     */
+    Processor->state.pc += Decoded->size;
+    
+    if (!Processor->cycles) return TRUE;
+    
+    Decoded = HKHubArchProcessorDecodeCached(Processor);
+    
+    if (Decoded->lowered.handler != HKHubArchInstructionHandlerBranch) goto Fetch;
+    
+    Cycles = (Decoded->size * HKHubArchProcessorSpeedMemoryRead) + 1;
+    if (Cycles > Processor->cycles)
+    {
+        Processor->status = HKHubArchProcessorStatusInsufficientCycles | HKHubArchProcessorStatusResumable;
+        return TRUE;
+    }
+    
+    Processor->cycles -= Cycles;
+    Processor->state.pc += (Decoded->lowered.condition >> (Processor->state.flags & HKHubArchProcessorFlagsMask)) & 1 ? Decoded->lowered.src : Decoded->size;
+    goto Next;
+    
+Advance:
+    Processor->state.pc += Decoded->size;
+    goto Next;
+    
+Stall:
+    Processor->cycles += Cycles;
+    Processor->status = HKHubArchProcessorStatusInsufficientCycles | HKHubArchProcessorStatusResumable;
+    
+    return TRUE;
+}
+
 void HKHubArchProcessorRun(HKHubArchProcessor Processor)
 {
     CCAssertLog(Processor, "Processor must not be null");
     
+    Processor->waiting = FALSE;
+    
+    const size_t PrevCycles = Processor->cycles;
+    const HKHubArchProcessorStatus PrevStatus = Processor->status;
+    const HKHubArchProcessorDebugMode PrevMode = Processor->state.debug.mode;
+    const int PrevMessageType = Processor->message.type;
+    
     while (HKHubArchProcessorIsRunning(Processor))
     {
-        if ((Processor->cache.jit) && (!Processor->state.debug.context) && (!Processor->state.debug.breakpoints) && (Processor->state.debug.mode == HKHubArchProcessorDebugModeContinue))
+        /*
+         A JIT generated for debugging exits before any breakpoint, leaving the interpreter to trigger it. The operation
+         callback needs each instruction, so it's only supported by the interpreter. Debuggers should use the trace
+         callback instead, which both the JIT and interpreter report.
+         */
+        if ((Processor->cache.jit) && (!Processor->debug.operation) && ((Processor->cache.jit->options & HKHubArchJITOptionsDebug) || (!HKHubArchProcessorHasBreakpoints(Processor))) && (Processor->state.debug.mode == HKHubArchProcessorDebugModeContinue))
         {
             for (size_t PrevCycles = 0; PrevCycles != Processor->cycles; )
             {
                 PrevCycles = Processor->cycles;
+                
+                const uint8_t Entry = Processor->state.pc;
                 HKHubArchJITCall(Processor->cache.jit, Processor);
+                
+                if ((Processor->debug.trace) && (PrevCycles != Processor->cycles)) Processor->debug.trace(Processor, Entry, Processor->state.pc, PrevCycles - Processor->cycles);
             }
         }
         
+        else if ((!Processor->cache.jit) && (!Processor->debug.context) && (!HKHubArchProcessorHasBreakpoints(Processor)) && (!Processor->debug.operation) && (Processor->state.debug.mode == HKHubArchProcessorDebugModeContinue) && (HKHubArchProcessorDecodedCacheCreate(Processor)))
+        {
+            if (HKHubArchProcessorRunThreaded(Processor)) continue;
+            
+            break;
+        }
+        
         HKHubArchInstructionState Instruction;
-        uint8_t NextPC = HKHubArchInstructionDecode(Processor->state.pc, Processor->memory, &Instruction);
+        uint8_t NextPC = HKHubArchProcessorDecode(Processor, &Instruction);
         
         if (Instruction.opcode != -1)
         {
-            if ((Processor->state.debug.breakpoints) && (Processor->state.debug.step == 0))
+            if ((Processor->state.debug.step == 0) && (HKHubArchProcessorHasBreakpoints(Processor)))
             {
                 if (HKHubArchProcessorShouldBreakForRange(Processor, Processor->state.pc, NextPC, HKHubArchProcessorDebugBreakpointRead))
                 {
                     Processor->state.debug.mode = HKHubArchProcessorDebugModePause;
-                    if (Processor->state.debug.debugModeChange) Processor->state.debug.debugModeChange(Processor);
+                    if (Processor->debug.debugModeChange) Processor->debug.debugModeChange(Processor);
                     continue;
                 }
                 
@@ -472,7 +854,7 @@ void HKHubArchProcessorRun(HKHubArchProcessor Processor)
                         if (HKHubArchProcessorShouldBreakForRange(Processor, Offset, Offset + 1, Breakpoint[(MemoryOp >> (Loop * 2)) & HKHubArchInstructionMemoryOperationMask]))
                         {
                             Processor->state.debug.mode = HKHubArchProcessorDebugModePause;
-                            if (Processor->state.debug.debugModeChange) Processor->state.debug.debugModeChange(Processor);
+                            if (Processor->debug.debugModeChange) Processor->debug.debugModeChange(Processor);
                             
                             TriggeredBP = TRUE;
                             break;
@@ -487,13 +869,14 @@ void HKHubArchProcessorRun(HKHubArchProcessor Processor)
             if (Cycles < Processor->cycles)
             {
                 uint8_t Encoding[5] = { 0, 0, 0, 0, 0 };
-                if (Processor->state.debug.operation)
+                if (Processor->debug.operation)
                 {
                     CCAssertLog(NextPC - Processor->state.pc <= 5, "Instruction encoding exceeds 5 bytes");
                     
                     for (uint8_t Loop = 0, Offset = Processor->state.pc; Offset != NextPC; Offset++, Loop++) Encoding[Loop] = Processor->memory[Offset];
                 }
                 
+                const uint8_t Entry = Processor->state.pc;
                 Processor->cycles -= Cycles;
                 
                 HKHubArchInstructionOperationResult Result;
@@ -510,7 +893,8 @@ void HKHubArchProcessorRun(HKHubArchProcessor Processor)
                 {
                     if (!(Result & HKHubArchInstructionOperationResultFlagSkipPC)) Processor->state.pc = NextPC;
                     
-                    if (Processor->state.debug.operation) Processor->state.debug.operation(Processor, &Instruction, Encoding);
+                    if (Processor->debug.operation) Processor->debug.operation(Processor, &Instruction, Encoding);
+                    if (Processor->debug.trace) Processor->debug.trace(Processor, Entry, Processor->state.pc, Cycles);
                     
                     Processor->state.debug.modified.reg = 0;
                     Processor->state.debug.modified.size = 0;
@@ -524,6 +908,493 @@ void HKHubArchProcessorRun(HKHubArchProcessor Processor)
         
         else Processor->status = HKHubArchProcessorStatusTrap;
     }
+    
+    if ((PrevCycles != Processor->cycles) || (PrevStatus != Processor->status) || (PrevMode != Processor->state.debug.mode) || (PrevMessageType != Processor->message.type)) HKHubArchProcessorNotifyPorts(Processor);
+}
+
+#define HK_HUB_ARCH_PROCESSOR_BATCH_LANES 32
+#define HK_HUB_ARCH_PROCESSOR_BATCH_OPEN_MAX 8
+
+/*
+ Lane state is stored structure-of-arrays so the lowered register operations are simple loops over each lane
+ that the compiler is free to vectorise. The PC is shared by every lane in the batch.
+ */
+typedef struct {
+    HKHubArchProcessor processor[HK_HUB_ARCH_PROCESSOR_BATCH_LANES];
+    uint8_t r[4][HK_HUB_ARCH_PROCESSOR_BATCH_LANES];
+    uint8_t flags[HK_HUB_ARCH_PROCESSOR_BATCH_LANES];
+    size_t cycles[HK_HUB_ARCH_PROCESSOR_BATCH_LANES];
+    size_t count;
+    uint8_t pc;
+} HKHubArchProcessorBatch;
+
+static const uint8_t HKHubArchProcessorBatchOperationCycles[HKHubArchInstructionHandlerCount] = {
+    [HKHubArchInstructionHandlerMovRR] = 1,
+    [HKHubArchInstructionHandlerMovRI] = 1,
+    [HKHubArchInstructionHandlerAddRR] = 2,
+    [HKHubArchInstructionHandlerAddRI] = 2,
+    [HKHubArchInstructionHandlerSubRR] = 2,
+    [HKHubArchInstructionHandlerSubRI] = 2,
+    [HKHubArchInstructionHandlerCmpRR] = 2,
+    [HKHubArchInstructionHandlerCmpRI] = 2,
+    [HKHubArchInstructionHandlerXorRR] = 1,
+    [HKHubArchInstructionHandlerXorRI] = 1,
+    [HKHubArchInstructionHandlerOrRR] = 1,
+    [HKHubArchInstructionHandlerOrRI] = 1,
+    [HKHubArchInstructionHandlerAndRR] = 1,
+    [HKHubArchInstructionHandlerAndRI] = 1,
+    [HKHubArchInstructionHandlerJump] = 1,
+    [HKHubArchInstructionHandlerBranch] = 1
+};
+
+static CC_FORCE_INLINE _Bool HKHubArchProcessorBatchEligible(HKHubArchProcessor Processor)
+{
+    return (!Processor->cache.jit) && (!Processor->debug.context) && (!HKHubArchProcessorHasBreakpoints(Processor)) && (!Processor->debug.operation) && (!Processor->debug.trace) && (!Processor->state.debug.step) && (Processor->state.debug.mode == HKHubArchProcessorDebugModeContinue) && (HKHubArchProcessorIsRunning(Processor));
+}
+
+static void HKHubArchProcessorBatchLoad(HKHubArchProcessorBatch *Batch, size_t Lane)
+{
+    HKHubArchProcessor Processor = Batch->processor[Lane];
+    
+    for (size_t Loop = 0; Loop < 4; Loop++) Batch->r[Loop][Lane] = Processor->state.r[Loop];
+    Batch->flags[Lane] = Processor->state.flags;
+    Batch->cycles[Lane] = Processor->cycles;
+}
+
+static void HKHubArchProcessorBatchStore(HKHubArchProcessorBatch *Batch, size_t Lane, uint8_t PC)
+{
+    HKHubArchProcessor Processor = Batch->processor[Lane];
+    
+    for (size_t Loop = 0; Loop < 4; Loop++) Processor->state.r[Loop] = Batch->r[Loop][Lane];
+    Processor->state.flags = Batch->flags[Lane];
+    Processor->state.pc = PC;
+    Processor->cycles = Batch->cycles[Lane];
+}
+
+static void HKHubArchProcessorBatchRemove(HKHubArchProcessorBatch *Batch, size_t Lane)
+{
+    const size_t Last = --Batch->count;
+    
+    Batch->processor[Lane] = Batch->processor[Last];
+    for (size_t Loop = 0; Loop < 4; Loop++) Batch->r[Loop][Lane] = Batch->r[Loop][Last];
+    Batch->flags[Lane] = Batch->flags[Last];
+    Batch->cycles[Lane] = Batch->cycles[Last];
+}
+
+static size_t HKHubArchProcessorBatchMinimumCycles(const HKHubArchProcessorBatch *Batch)
+{
+    size_t Minimum = SIZE_MAX;
+    for (size_t Lane = 0; Lane < Batch->count; Lane++) Minimum = CCMin(Minimum, Batch->cycles[Lane]);
+    
+    return Minimum;
+}
+
+static _Bool HKHubArchProcessorBatchMemoryMatches(HKHubArchProcessor a, HKHubArchProcessor b, uint8_t Offset, uint8_t Size)
+{
+    for (uint8_t Loop = 0; Loop < Size; Loop++, Offset++)
+    {
+        if (a->memory[Offset] != b->memory[Offset]) return FALSE;
+    }
+    
+    return TRUE;
+}
+
+/*!
+ * @brief Execute a generic instruction on every lane of the batch.
+ * @description Lanes that can no longer run are removed from the batch, and any that no longer match the rest of
+ *              the batch (different PC or memory) are removed and added to the diverged processors.
+ *
+ * @param Batch The batch to execute the instruction on.
+ * @param Decoded The decoded instruction.
+ * @param Diverged The processors that must finish running individually.
+ * @param DivergedCount The number of diverged processors.
+ */
+static void HKHubArchProcessorBatchExecuteGeneric(HKHubArchProcessorBatch *Batch, const HKHubArchProcessorDecodedInstruction *Decoded, HKHubArchProcessor *Diverged, size_t *DivergedCount)
+{
+    const HKHubArchInstructionState State = Decoded->state;
+    const size_t Cycles = Decoded->size * HKHubArchProcessorSpeedMemoryRead;
+    
+    struct {
+        uint8_t offset;
+        uint8_t size;
+    } Modified[HK_HUB_ARCH_PROCESSOR_BATCH_LANES];
+    
+    for (size_t Lane = Batch->count; Lane--; )
+    {
+        HKHubArchProcessorBatchStore(Batch, Lane, Batch->pc);
+        
+        HKHubArchProcessor Processor = Batch->processor[Lane];
+        Modified[Lane].size = 0;
+        
+        if (Cycles >= Processor->cycles)
+        {
+            Processor->status = HKHubArchProcessorStatusInsufficientCycles | HKHubArchProcessorStatusResumable;
+            HKHubArchProcessorBatchRemove(Batch, Lane);
+            Modified[Lane] = Modified[Batch->count];
+            continue;
+        }
+        
+        Processor->cycles -= Cycles;
+        
+        HKHubArchInstructionOperationResult OperationResult;
+        if (((OperationResult = HKHubArchInstructionExecute(Processor, &State)) & HKHubArchInstructionOperationResultMask) == HKHubArchInstructionOperationResultFailure)
+        {
+            Processor->cycles += Cycles;
+            
+            //A stalled pipeline ends the run the same as it would when run individually
+            if (!(OperationResult & HKHubArchInstructionOperationResultFlagPipelineStall)) Processor->status = OperationResult & HKHubArchInstructionOperationResultFlagInvalidOp ? HKHubArchProcessorStatusTrap : (HKHubArchProcessorStatusInsufficientCycles | HKHubArchProcessorStatusResumable);
+            
+            HKHubArchProcessorBatchRemove(Batch, Lane);
+            Modified[Lane] = Modified[Batch->count];
+            continue;
+        }
+        
+        if (!(OperationResult & HKHubArchInstructionOperationResultFlagSkipPC)) Processor->state.pc += Decoded->size;
+        
+        Modified[Lane].offset = Processor->state.debug.modified.offset;
+        Modified[Lane].size = Processor->state.debug.modified.size;
+        
+        Processor->state.debug.modified.reg = 0;
+        Processor->state.debug.modified.size = 0;
+        
+        if (!HKHubArchProcessorIsRunning(Processor))
+        {
+            HKHubArchProcessorBatchRemove(Batch, Lane);
+            Modified[Lane] = Modified[Batch->count];
+        }
+    }
+    
+    if (!Batch->count) return;
+    
+    /*
+     Every lane started from the same memory, so they will only diverge if a lane wrote something different to the
+     first lane, or branched somewhere else.
+     */
+    HKHubArchProcessor Reference = Batch->processor[0];
+    Batch->pc = Reference->state.pc;
+    
+    for (size_t Lane = Batch->count; Lane-- > 1; )
+    {
+        HKHubArchProcessor Processor = Batch->processor[Lane];
+        
+        if ((Processor->state.pc != Batch->pc) || (!HKHubArchProcessorBatchMemoryMatches(Reference, Processor, Modified[0].offset, Modified[0].size)) || (!HKHubArchProcessorBatchMemoryMatches(Reference, Processor, Modified[Lane].offset, Modified[Lane].size)))
+        {
+            Diverged[(*DivergedCount)++] = Processor;
+            HKHubArchProcessorBatchRemove(Batch, Lane);
+            Modified[Lane] = Modified[Batch->count];
+        }
+    }
+    
+    for (size_t Lane = 0; Lane < Batch->count; Lane++) HKHubArchProcessorBatchLoad(Batch, Lane);
+}
+
+/*!
+ * @brief Run the processors of a batch in lockstep.
+ * @description All processors must be eligible, have identical memory, and the same PC. Execution continues in
+ *              lockstep until only a single lane remains, which is then run individually along with any lanes
+ *              that diverged.
+ *
+ * @param Batch The batch to be run.
+ */
+static void HKHubArchProcessorBatchRun(HKHubArchProcessorBatch *Batch)
+{
+    struct {
+        HKHubArchProcessor processor;
+        size_t cycles;
+        HKHubArchProcessorStatus status;
+        int messageType;
+    } Prev[HK_HUB_ARCH_PROCESSOR_BATCH_LANES];
+    
+    HKHubArchProcessor Diverged[HK_HUB_ARCH_PROCESSOR_BATCH_LANES];
+    size_t DivergedCount = 0;
+    
+    const size_t Count = Batch->count;
+    for (size_t Lane = 0; Lane < Count; Lane++)
+    {
+        HKHubArchProcessor Processor = Batch->processor[Lane];
+        Processor->waiting = FALSE;
+        
+        Prev[Lane].processor = Processor;
+        Prev[Lane].cycles = Processor->cycles;
+        Prev[Lane].status = Processor->status;
+        Prev[Lane].messageType = Processor->message.type;
+        
+        HKHubArchProcessorBatchLoad(Batch, Lane);
+    }
+    
+    Batch->pc = Batch->processor[0]->state.pc;
+    
+    uint8_t Operand[HK_HUB_ARCH_PROCESSOR_BATCH_LANES], Taken[HK_HUB_ARCH_PROCESSOR_BATCH_LANES];
+    size_t Minimum = HKHubArchProcessorBatchMinimumCycles(Batch);
+    
+    while (Batch->count > 1)
+    {
+        //Memory is identical across lanes, so any lane's decoded cache can be used
+        HKHubArchProcessor Leader = Batch->processor[0];
+        if (!HKHubArchProcessorDecodedCacheCreate(Leader)) break;
+        
+        Leader->state.pc = Batch->pc;
+        const HKHubArchProcessorDecodedInstruction *Decoded = HKHubArchProcessorDecodeCached(Leader);
+        
+        if (Decoded->state.opcode == -1)
+        {
+            for (size_t Lane = Batch->count; Lane--; )
+            {
+                HKHubArchProcessorBatchStore(Batch, Lane, Batch->pc);
+                Batch->processor[Lane]->status = HKHubArchProcessorStatusTrap;
+            }
+            
+            Batch->count = 0;
+            break;
+        }
+        
+        const HKHubArchInstructionHandler Handler = Decoded->lowered.handler;
+        if (Handler == HKHubArchInstructionHandlerGeneric)
+        {
+            HKHubArchProcessorBatchExecuteGeneric(Batch, Decoded, Diverged, &DivergedCount);
+            Minimum = HKHubArchProcessorBatchMinimumCycles(Batch);
+            continue;
+        }
+        
+        const size_t Cycles = (Decoded->size * HKHubArchProcessorSpeedMemoryRead) + HKHubArchProcessorBatchOperationCycles[Handler];
+        if (Cycles > Minimum)
+        {
+            for (size_t Lane = Batch->count; Lane--; )
+            {
+                if (Cycles > Batch->cycles[Lane])
+                {
+                    HKHubArchProcessorBatchStore(Batch, Lane, Batch->pc);
+                    Batch->processor[Lane]->status = HKHubArchProcessorStatusInsufficientCycles | HKHubArchProcessorStatusResumable;
+                    HKHubArchProcessorBatchRemove(Batch, Lane);
+                }
+            }
+            
+            Minimum = HKHubArchProcessorBatchMinimumCycles(Batch);
+            continue;
+        }
+        
+        const size_t Lanes = Batch->count;
+        const uint8_t Dest = Decoded->lowered.dest, Src = Decoded->lowered.src;
+        
+        switch (Handler)
+        {
+            case HKHubArchInstructionHandlerMovRR:
+            case HKHubArchInstructionHandlerAddRR:
+            case HKHubArchInstructionHandlerSubRR:
+            case HKHubArchInstructionHandlerCmpRR:
+            case HKHubArchInstructionHandlerXorRR:
+            case HKHubArchInstructionHandlerOrRR:
+            case HKHubArchInstructionHandlerAndRR:
+                memcpy(Operand, Batch->r[Src], Lanes);
+                break;
+                
+            default:
+                memset(Operand, Src, Lanes);
+                break;
+        }
+        
+        uint8_t * const R = Batch->r[Dest];
+        uint8_t * const Flags = Batch->flags;
+        
+        switch (Handler)
+        {
+            case HKHubArchInstructionHandlerMovRR:
+            case HKHubArchInstructionHandlerMovRI:
+                memcpy(R, Operand, Lanes);
+                break;
+                
+            case HKHubArchInstructionHandlerAddRR:
+            case HKHubArchInstructionHandlerAddRI:
+                for (size_t Lane = 0; Lane < Lanes; Lane++)
+                {
+                    const uint8_t Result = R[Lane] + Operand[Lane];
+                    Flags[Lane] = (Flags[Lane] & ~HKHubArchProcessorFlagsMask) | HKHubArchInstructionAdditionFlags(R[Lane], Operand[Lane], Result);
+                    R[Lane] = Result;
+                }
+                break;
+                
+            case HKHubArchInstructionHandlerSubRR:
+            case HKHubArchInstructionHandlerSubRI:
+                for (size_t Lane = 0; Lane < Lanes; Lane++)
+                {
+                    const uint8_t Result = R[Lane] - Operand[Lane];
+                    Flags[Lane] = (Flags[Lane] & ~HKHubArchProcessorFlagsMask) | HKHubArchInstructionSubtractionFlags(R[Lane], Operand[Lane], Result);
+                    R[Lane] = Result;
+                }
+                break;
+                
+            case HKHubArchInstructionHandlerCmpRR:
+            case HKHubArchInstructionHandlerCmpRI:
+                for (size_t Lane = 0; Lane < Lanes; Lane++)
+                {
+                    const uint8_t Result = R[Lane] - Operand[Lane];
+                    Flags[Lane] = (Flags[Lane] & ~HKHubArchProcessorFlagsMask) | HKHubArchInstructionSubtractionFlags(R[Lane], Operand[Lane], Result);
+                }
+                break;
+                
+            case HKHubArchInstructionHandlerXorRR:
+            case HKHubArchInstructionHandlerXorRI:
+                for (size_t Lane = 0; Lane < Lanes; Lane++)
+                {
+                    const uint8_t Result = R[Lane] ^ Operand[Lane];
+                    Flags[Lane] = (Flags[Lane] & ~HKHubArchProcessorFlagsMask) | HKHubArchInstructionLogicalFlags(Result);
+                    R[Lane] = Result;
+                }
+                break;
+                
+            case HKHubArchInstructionHandlerOrRR:
+            case HKHubArchInstructionHandlerOrRI:
+                for (size_t Lane = 0; Lane < Lanes; Lane++)
+                {
+                    const uint8_t Result = R[Lane] | Operand[Lane];
+                    Flags[Lane] = (Flags[Lane] & ~HKHubArchProcessorFlagsMask) | HKHubArchInstructionLogicalFlags(Result);
+                    R[Lane] = Result;
+                }
+                break;
+                
+            case HKHubArchInstructionHandlerAndRR:
+            case HKHubArchInstructionHandlerAndRI:
+                for (size_t Lane = 0; Lane < Lanes; Lane++)
+                {
+                    const uint8_t Result = R[Lane] & Operand[Lane];
+                    Flags[Lane] = (Flags[Lane] & ~HKHubArchProcessorFlagsMask) | HKHubArchInstructionLogicalFlags(Result);
+                    R[Lane] = Result;
+                }
+                break;
+                
+            case HKHubArchInstructionHandlerJump:
+            case HKHubArchInstructionHandlerBranch:
+                break;
+                
+            default:
+                CCAssertLog(0, "Unknown instruction handler");
+                break;
+        }
+        
+        for (size_t Lane = 0; Lane < Lanes; Lane++) Batch->cycles[Lane] -= Cycles;
+        Minimum -= Cycles;
+        
+        if (Handler == HKHubArchInstructionHandlerJump) Batch->pc += Src;
+        else if (Handler == HKHubArchInstructionHandlerBranch)
+        {
+            const uint16_t Condition = Decoded->lowered.condition;
+            
+            size_t TakenCount = 0;
+            for (size_t Lane = 0; Lane < Lanes; Lane++) TakenCount += (Taken[Lane] = (Condition >> (Flags[Lane] & HKHubArchProcessorFlagsMask)) & 1);
+            
+            /*
+             When lanes disagree on the branch, the majority continue in lockstep and the rest are split out to be
+             run individually.
+             */
+            const uint8_t Majority = (TakenCount * 2) >= Lanes;
+            const uint8_t Target = Batch->pc + Src, Next = Batch->pc + Decoded->size;
+            
+            if ((TakenCount) && (TakenCount != Lanes))
+            {
+                for (size_t Lane = Lanes; Lane--; )
+                {
+                    if (Taken[Lane] != Majority)
+                    {
+                        HKHubArchProcessorBatchStore(Batch, Lane, Taken[Lane] ? Target : Next);
+                        Diverged[DivergedCount++] = Batch->processor[Lane];
+                        HKHubArchProcessorBatchRemove(Batch, Lane);
+                        Taken[Lane] = Taken[Batch->count];
+                    }
+                }
+                
+                Minimum = HKHubArchProcessorBatchMinimumCycles(Batch);
+            }
+            
+            Batch->pc = Majority ? Target : Next;
+        }
+        
+        else Batch->pc += Decoded->size;
+    }
+    
+    for (size_t Lane = 0; Lane < Batch->count; Lane++)
+    {
+        HKHubArchProcessorBatchStore(Batch, Lane, Batch->pc);
+        Diverged[DivergedCount++] = Batch->processor[Lane];
+    }
+    
+    Batch->count = 0;
+    
+    for (size_t Loop = 0; Loop < Count; Loop++)
+    {
+        HKHubArchProcessor Processor = Prev[Loop].processor;
+        if ((Prev[Loop].cycles != Processor->cycles) || (Prev[Loop].status != Processor->status) || (Prev[Loop].messageType != Processor->message.type)) HKHubArchProcessorNotifyPorts(Processor);
+    }
+    
+    for (size_t Loop = 0; Loop < DivergedCount; Loop++) HKHubArchProcessorRun(Diverged[Loop]);
+}
+
+void HKHubArchProcessorRunBatch(HKHubArchProcessor *Processors, size_t Count)
+{
+    CCAssertLog(Processors || !Count, "Processors must not be null");
+    
+    /*
+     Processors running the same program from the same state are gathered into a small number of open batches.
+     Anything that can't join a batch is run individually straight away.
+     */
+    HKHubArchProcessorBatch Batch;
+    struct {
+        HKHubArchProcessor processor[HK_HUB_ARCH_PROCESSOR_BATCH_LANES];
+        size_t count;
+    } Open[HK_HUB_ARCH_PROCESSOR_BATCH_OPEN_MAX];
+    size_t OpenCount = 0;
+    
+    for (size_t Loop = 0; Loop < Count; Loop++)
+    {
+        HKHubArchProcessor Processor = Processors[Loop];
+        CCAssertLog(Processor, "Processor must not be null");
+        
+        if (!HKHubArchProcessorBatchEligible(Processor))
+        {
+            HKHubArchProcessorRun(Processor);
+            continue;
+        }
+        
+        size_t Index = 0;
+        for ( ; Index < OpenCount; Index++)
+        {
+            HKHubArchProcessor Leader = Open[Index].processor[0];
+            if ((Leader->state.pc == Processor->state.pc) && (!memcmp(Leader->memory, Processor->memory, sizeof(Processor->memory)))) break;
+        }
+        
+        if (Index == OpenCount)
+        {
+            if (OpenCount == HK_HUB_ARCH_PROCESSOR_BATCH_OPEN_MAX)
+            {
+                HKHubArchProcessorRun(Processor);
+                continue;
+            }
+            
+            Open[OpenCount++].count = 0;
+        }
+        
+        Open[Index].processor[Open[Index].count++] = Processor;
+        
+        if (Open[Index].count == HK_HUB_ARCH_PROCESSOR_BATCH_LANES)
+        {
+            memcpy(Batch.processor, Open[Index].processor, sizeof(Batch.processor));
+            Batch.count = HK_HUB_ARCH_PROCESSOR_BATCH_LANES;
+            Open[Index] = Open[--OpenCount];
+            
+            HKHubArchProcessorBatchRun(&Batch);
+        }
+    }
+    
+    for (size_t Index = 0; Index < OpenCount; Index++)
+    {
+        if (Open[Index].count == 1) HKHubArchProcessorRun(Open[Index].processor[0]);
+        else if (Open[Index].count)
+        {
+            memcpy(Batch.processor, Open[Index].processor, sizeof(HKHubArchProcessor) * Open[Index].count);
+            Batch.count = Open[Index].count;
+            
+            HKHubArchProcessorBatchRun(&Batch);
+        }
+    }
 }
 
 void HKHubArchProcessorStep(HKHubArchProcessor Processor, size_t Count)
@@ -531,6 +1402,8 @@ void HKHubArchProcessorStep(HKHubArchProcessor Processor, size_t Count)
     CCAssertLog(Processor, "Processor must not be null");
     
     Processor->state.debug.step = Count;
+    
+    HKHubArchProcessorWake(Processor);
 }
 
 void HKHubArchProcessorSetDebugMode(HKHubArchProcessor Processor, HKHubArchProcessorDebugMode Mode)
@@ -539,50 +1412,234 @@ void HKHubArchProcessorSetDebugMode(HKHubArchProcessor Processor, HKHubArchProce
     
     Processor->state.debug.mode = Mode;
     
-    if (Processor->state.debug.debugModeChange) Processor->state.debug.debugModeChange(Processor);
+    HKHubArchProcessorWake(Processor);
+    
+    if (Processor->debug.debugModeChange) Processor->debug.debugModeChange(Processor);
 }
 
 void HKHubArchProcessorSetBreakpoint(HKHubArchProcessor Processor, HKHubArchProcessorDebugBreakpoint Breakpoint, uint8_t Offset)
 {
     CCAssertLog(Processor, "Processor must not be null");
     
-    if (!Processor->state.debug.breakpoints) Processor->state.debug.breakpoints = CCDictionaryCreate(CC_STD_ALLOCATOR, CCDictionaryHintHeavyEnumerating | CCDictionaryHintHeavyFinding | CCCollectionHintHeavyInserting | CCCollectionHintHeavyDeleting, sizeof(uint8_t), sizeof(HKHubArchProcessorDebugBreakpoint), NULL);
+    const HKHubArchProcessorDebugBreakpoint Prev = HKHubArchProcessorGetBreakpoint(Processor, Offset);
+    const uint64_t Mask = UINT64_C(1) << (Offset % 64);
+    
+    if (Breakpoint & HKHubArchProcessorDebugBreakpointRead) Processor->state.debug.breakpoints.read[Offset / 64] |= Mask;
+    else Processor->state.debug.breakpoints.read[Offset / 64] &= ~Mask;
+    
+    if (Breakpoint & HKHubArchProcessorDebugBreakpointWrite) Processor->state.debug.breakpoints.write[Offset / 64] |= Mask;
+    else Processor->state.debug.breakpoints.write[Offset / 64] &= ~Mask;
     
-    CCDictionarySetValue(Processor->state.debug.breakpoints, &Offset, &Breakpoint);
+    if ((Breakpoint) && (Processor->cache.jit) && !(Processor->cache.jit->options & HKHubArchJITOptionsDebug)) HKHubArchProcessorCacheDebug(Processor, TRUE);
+    else if ((Prev & HKHubArchProcessorDebugBreakpointRead) && !(Breakpoint & HKHubArchProcessorDebugBreakpointRead)) HKHubArchProcessorCacheRegenerate(Processor);
+    else if ((Processor->cache.jit) && (Processor->cache.jit->options & HKHubArchJITOptionsDebug)) HKHubArchJITSetBreakpoint(Processor->cache.jit, Offset, Breakpoint & HKHubArchProcessorDebugBreakpointRead, Breakpoint & HKHubArchProcessorDebugBreakpointWrite);
     
-    if (Processor->state.debug.breakpointChange) Processor->state.debug.breakpointChange(Processor, Breakpoint, Offset);
+    if (Processor->debug.breakpointChange) Processor->debug.breakpointChange(Processor, Breakpoint, Offset);
 }
 
 void HKHubArchProcessorClearBreakpoints(HKHubArchProcessor Processor)
 {
     CCAssertLog(Processor, "Processor must not be null");
     
-    if (Processor->state.debug.breakpoints)
+    if (HKHubArchProcessorHasBreakpoints(Processor))
     {
-        if (Processor->state.debug.breakpointChange)
+        if (Processor->debug.breakpointChange)
         {
-            CC_DICTIONARY_FOREACH_KEY(uint8_t, Offset, Processor->state.debug.breakpoints)
+            for (size_t Offset = 0; Offset < 256; Offset++)
             {
-                HKHubArchProcessorDebugBreakpoint *Bp = CCDictionaryGetValue(Processor->state.debug.breakpoints, &Offset);
-                
-                if (Bp != HKHubArchProcessorDebugBreakpointNone)
+                if (HKHubArchProcessorGetBreakpoint(Processor, (uint8_t)Offset) != HKHubArchProcessorDebugBreakpointNone)
                 {
-                    Processor->state.debug.breakpointChange(Processor, HKHubArchProcessorDebugBreakpointNone, Offset);
+                    Processor->debug.breakpointChange(Processor, HKHubArchProcessorDebugBreakpointNone, (uint8_t)Offset);
                 }
             }
         }
         
-        CCDictionaryDestroy(Processor->state.debug.breakpoints);
-        Processor->state.debug.breakpoints = NULL;
+        memset(&Processor->state.debug.breakpoints, 0, sizeof(Processor->state.debug.breakpoints));
+        
+        HKHubArchProcessorCacheRegenerate(Processor);
     }
 }
 
+typedef struct {
+    uint64_t hash[2];
+    uint8_t pc;
+} HKHubArchProcessorCacheKey;
+
+typedef struct {
+    HKHubArchExecutionGraph graph;
+    /// The shared JITs, indexed by whether they were generated with @b HKHubArchJITOptionsCache
+    HKHubArchJIT jit[2];
+} HKHubArchProcessorCacheEntry;
+
+static void HKHubArchProcessorCacheKeyDestructor(HKHubArchProcessorCacheKey *Key)
+{
+}
+
+static uintmax_t HKHubArchProcessorCacheKeyHasher(const HKHubArchProcessorCacheKey *Key)
+{
+    return (uintmax_t)(Key->hash[0] ^ Key->pc);
+}
+
+static CCComparisonResult HKHubArchProcessorCacheKeyComparator(const HKHubArchProcessorCacheKey *a, const HKHubArchProcessorCacheKey *b)
+{
+    return ((a->pc == b->pc) && (a->hash[0] == b->hash[0]) && (a->hash[1] == b->hash[1])) ? CCComparisonResultEqual : CCComparisonResultInvalid;
+}
+
+static HKHubArchProcessorCacheKey HKHubArchProcessorCacheKeyCreate(HKHubArchProcessor Processor)
+{
+    //Two independent hashes of the memory, so a collision between different programs is practically impossible
+    uint64_t HashA = 0xcbf29ce484222325, HashB = 0x9e3779b97f4a7c15;
+    for (size_t Loop = 0; Loop < sizeof(Processor->memory); Loop++)
+    {
+        HashA ^= Processor->memory[Loop];
+        HashA *= 0x00000100000001b3;
+        
+        HashB = (HashB ^ Processor->memory[Loop]) * 0xff51afd7ed558ccd;
+        HashB ^= HashB >> 32;
+    }
+    
+    return (HKHubArchProcessorCacheKey){ .hash = { HashA, HashB }, .pc = Processor->state.pc };
+}
+
+const CCDictionaryElementDestructor HKHubArchProcessorCacheKeyDestructorForDictionary = (CCDictionaryElementDestructor)HKHubArchProcessorCacheKeyDestructor;
+const CCDictionaryKeyHasher HKHubArchProcessorCacheKeyHasherForDictionary = (CCDictionaryKeyHasher)HKHubArchProcessorCacheKeyHasher;
+const CCComparator HKHubArchProcessorCacheKeyComparatorForDictionary = (CCComparator)HKHubArchProcessorCacheKeyComparator;
+
+const CCAssetManagerInterface HKHubArchProcessorCacheAssetInterface = {
+    .identifier = {
+        .destructor = &HKHubArchProcessorCacheKeyDestructorForDictionary,
+        .hasher = &HKHubArchProcessorCacheKeyHasherForDictionary,
+        .comparator = &HKHubArchProcessorCacheKeyComparatorForDictionary,
+        .size = sizeof(HKHubArchProcessorCacheKey)
+    }
+};
+
+static CCAssetManager HKHubArchProcessorCacheManager = CC_ASSET_MANAGER_INIT(&HKHubArchProcessorCacheAssetInterface);
+
+#define HK_HUB_ARCH_PROCESSOR_CACHE_MAX_ENTRIES 64
+
+/*
+ The keys of the registered cache entries in the order they were registered, once full the oldest entry is evicted
+ from the manager. Processors retain their own references to the graph and JIT, so evicting an entry only stops it
+ being shared with processors cached later. The lock is held for the whole lookup, so processors caching the same
+ program at the same time will only generate it once.
+ */
+static struct {
+    HKHubArchProcessorCacheKey keys[HK_HUB_ARCH_PROCESSOR_CACHE_MAX_ENTRIES];
+    size_t count;
+    size_t next;
+    mtx_t lock;
+} HKHubArchProcessorCacheHistory = { .count = 0, .next = 0 };
+
+static once_flag HKHubArchProcessorCacheHistoryInitialized = ONCE_FLAG_INIT;
+
+static void HKHubArchProcessorCacheHistoryInit(void)
+{
+    int err;
+    if ((err = mtx_init(&HKHubArchProcessorCacheHistory.lock, mtx_plain)) != thrd_success) CC_LOG_ERROR("Failed to create processor cache lock (%d)", err);
+}
+
+static void HKHubArchProcessorCacheRegister(const HKHubArchProcessorCacheKey *Key, HKHubArchProcessorCacheEntry *Entry)
+{
+    HKHubArchProcessorCacheKey *Oldest = &HKHubArchProcessorCacheHistory.keys[HKHubArchProcessorCacheHistory.next];
+    
+    if (HKHubArchProcessorCacheHistory.count == HK_HUB_ARCH_PROCESSOR_CACHE_MAX_ENTRIES) CCAssetManagerDeregister(&HKHubArchProcessorCacheManager, Oldest);
+    else HKHubArchProcessorCacheHistory.count++;
+    
+    *Oldest = *Key;
+    HKHubArchProcessorCacheHistory.next = (HKHubArchProcessorCacheHistory.next + 1) % HK_HUB_ARCH_PROCESSOR_CACHE_MAX_ENTRIES;
+    
+    CCAssetManagerRegister(&HKHubArchProcessorCacheManager, Key, Entry);
+}
+
+static void HKHubArchProcessorCacheEntryDestructor(HKHubArchProcessorCacheEntry *Entry)
+{
+    HKHubArchExecutionGraphDestroy(Entry->graph);
+    if (Entry->jit[0]) HKHubArchJITDestroy(Entry->jit[0]);
+    if (Entry->jit[1]) HKHubArchJITDestroy(Entry->jit[1]);
+}
+
 void HKHubArchProcessorCache(HKHubArchProcessor Processor, HKHubArchJITOptions Options)
 {
     CCAssertLog(Processor, "Processor must not be null");
     
     HKHubArchProcessorCacheReset(Processor);
     
-    Processor->cache.graph = HKHubArchExecutionGraphCreate(CC_STD_ALLOCATOR, Processor->memory, Processor->state.pc);
-    Processor->cache.jit = HKHubArchJITCreate(CC_STD_ALLOCATOR, Processor->cache.graph, Options);
+    /*
+     Processors running the same program share the execution graph (regardless of the options), and the JIT when
+     it won't be modified (it's only modified by invalidations when watching memory, and by breakpoints when
+     debugging). Any later modifications to processor memory result in a different key, so will never be given a
+     stale cache.
+     */
+    const HKHubArchProcessorCacheKey Key = HKHubArchProcessorCacheKeyCreate(Processor);
+    
+    const _Bool SharedJIT = !(Options & (HKHubArchJITOptionsWatchMemory | HKHubArchJITOptionsDebug));
+    const size_t Index = (Options & HKHubArchJITOptionsCache) ? 1 : 0;
+    
+    call_once(&HKHubArchProcessorCacheHistoryInitialized, HKHubArchProcessorCacheHistoryInit);
+    
+    mtx_lock(&HKHubArchProcessorCacheHistory.lock);
+    
+    HKHubArchProcessorCacheEntry *Entry = CCAssetManagerCreate(&HKHubArchProcessorCacheManager, &Key);
+    if (Entry)
+    {
+        Processor->cache.graph = CCRetain(Entry->graph);
+        
+        if (SharedJIT)
+        {
+            if (!Entry->jit[Index]) Entry->jit[Index] = HKHubArchJITCreate(CC_STD_ALLOCATOR, Processor->cache.graph, Options);
+            
+            Processor->cache.jit = Entry->jit[Index] ? CCRetain(Entry->jit[Index]) : NULL;
+        }
+        
+        CCFree(Entry);
+    }
+    
+    else
+    {
+        Processor->cache.graph = HKHubArchExecutionGraphCreate(CC_STD_ALLOCATOR, Processor->memory, Processor->state.pc);
+        
+        if (Processor->cache.graph)
+        {
+            if (SharedJIT) Processor->cache.jit = HKHubArchJITCreate(CC_STD_ALLOCATOR, Processor->cache.graph, Options);
+            
+            Entry = CCMalloc(CC_STD_ALLOCATOR, sizeof(HKHubArchProcessorCacheEntry), NULL, CC_DEFAULT_ERROR_CALLBACK);
+            if (Entry)
+            {
+                *Entry = (HKHubArchProcessorCacheEntry){ .graph = CCRetain(Processor->cache.graph) };
+                
+                if (Processor->cache.jit) Entry->jit[Index] = CCRetain(Processor->cache.jit);
+                
+                CCMemorySetDestructor(Entry, (CCMemoryDestructorCallback)HKHubArchProcessorCacheEntryDestructor);
+                
+                HKHubArchProcessorCacheRegister(&Key, Entry);
+                CCFree(Entry);
+            }
+            
+            else CC_LOG_ERROR("Failed to create the processor cache entry, due to allocation failure (%zu)", sizeof(HKHubArchProcessorCacheEntry));
+        }
+    }
+    
+    mtx_unlock(&HKHubArchProcessorCacheHistory.lock);
+    
+    //Modifiable JITs are private to the processor, so are generated outside of the lock
+    if ((!SharedJIT) && (Processor->cache.graph)) Processor->cache.jit = HKHubArchJITCreate(CC_STD_ALLOCATOR, Processor->cache.graph, Options);
+    
+    HKHubArchProcessorCacheBreakpoints(Processor);
+}
+
+void HKHubArchProcessorCacheDebug(HKHubArchProcessor Processor, _Bool Debug)
+{
+    CCAssertLog(Processor, "Processor must not be null");
+    
+    if (!Processor->cache.jit) return;
+    
+    const HKHubArchJITOptions Options = Processor->cache.jit->options;
+    
+    if (Debug == !!(Options & HKHubArchJITOptionsDebug)) return;
+    
+    //Any remaining breakpoints would prevent a JIT that isn't generated for debugging from being used
+    if ((!Debug) && (HKHubArchProcessorHasBreakpoints(Processor))) return;
+    
+    HKHubArchProcessorCache(Processor, Debug ? (Options | HKHubArchJITOptionsDebug) : (Options & ~HKHubArchJITOptionsDebug));
 }
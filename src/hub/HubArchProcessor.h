@@ -66,6 +66,19 @@ typedef struct HKHubArchProcessorInfo *HKHubArchProcessor;
  */
 typedef void (*HKHubArchProcessorDebugOperationCallback)(HKHubArchProcessor Processor, const HKHubArchInstructionState *Instruction, const uint8_t Encoding[5]);
 
+/*!
+ * @brief Get a compact trace of the code executed.
+ * @description The interpreter reports each executed instruction (with the modified debug state still set), while
+ *              the JIT doesn't report each executed instruction, so instead reports each run of native code. Unlike
+ *              the operation callback this doesn't prevent the JIT from being used.
+ *
+ * @param Processor The processor that was executed.
+ * @param Entry The PC the code was entered at.
+ * @param Exit The PC the code returned at.
+ * @param Cycles The number of cycles that were used.
+ */
+typedef void (*HKHubArchProcessorDebugTraceCallback)(HKHubArchProcessor Processor, uint8_t Entry, uint8_t Exit, size_t Cycles);
+
 /*!
  * @brief Callback to hook any port connection changes.
  * @param Processor The processor that was executed.
@@ -87,21 +100,30 @@ typedef void (*HKHubArchProcessorDebugBreakpointChangeCallback)(HKHubArchProcess
  */
 typedef void (*HKHubArchProcessorDebugModeChangeCallback)(HKHubArchProcessor Processor);
 
+/*!
+ * @brief A previously decoded instruction.
+ * @description Entries are validated against the bytes they were decoded from before they're used, so
+ *              any changes to memory (from the processor itself or externally) will never result in a
+ *              stale instruction.
+ */
+typedef struct {
+    HKHubArchInstructionState state;
+    HKHubArchInstructionLoweredState lowered;
+    uint8_t encoding[5];
+    uint8_t size; //0 = empty
+} HKHubArchProcessorDecodedInstruction;
+
 typedef struct HKHubArchProcessorInfo {
-    CCDictionary(HKHubArchPortID, HKHubArchPortConnection) ports;
-    struct {
-        HKHubArchPortID port;
-        HKHubArchPortMessage data;
-        uint8_t offset;
-        enum {
-            HKHubArchProcessorMessageClear,
-            HKHubArchProcessorMessageComplete,
-            HKHubArchProcessorMessageSend,
-            HKHubArchProcessorMessageReceive
-        } type;
-        size_t timestamp;
-        size_t wait;
-    } message;
+    /*
+     Ordered by how often the fields are accessed. The state polled whenever the processor is scheduled or run
+     (status, waiting, cycles, registers, debug mode and step) fills the first cache line, followed by the
+     breakpoints and caches used by each run. The debug callbacks, port state and timing are only touched on
+     slower paths so come last.
+     */
+    HKHubArchProcessorStatus status;
+    /// Whether the processor is waiting on a port connection to wake it
+    _Bool waiting;
+    size_t cycles;
     struct {
         uint8_t r[4];
         uint8_t pc;
@@ -109,30 +131,47 @@ typedef struct HKHubArchProcessorInfo {
         struct {
             HKHubArchProcessorDebugMode mode;
             size_t step;
-            CCDictionary(uint8_t, HKHubArchProcessorDebugBreakpoint) breakpoints;
             struct {
                 HKHubArchInstructionRegister reg;
                 uint8_t offset;
                 uint8_t size;
             } modified;
             struct {
-                void *context;
-                uintptr_t extra;
-                HKHubArchProcessorDebugOperationCallback operation;
-                HKHubArchProcessorDebugPortConnectionChangeCallback portConnectionChange;
-                HKHubArchProcessorDebugBreakpointChangeCallback breakpointChange;
-                HKHubArchProcessorDebugModeChangeCallback debugModeChange;
-            };
+                uint64_t read[256 / 64];
+                uint64_t write[256 / 64];
+            } breakpoints;
         } debug;
     } state;
     struct {
-        HKHubArchExecutionGraph graph;
+        HKHubArchProcessorDecodedInstruction *decoded;
         HKHubArchJIT jit;
+        HKHubArchExecutionGraph graph;
     } cache;
-    size_t cycles;
+    struct {
+        HKHubArchPortID port;
+        uint8_t offset;
+        enum {
+            HKHubArchProcessorMessageClear,
+            HKHubArchProcessorMessageComplete,
+            HKHubArchProcessorMessageSend,
+            HKHubArchProcessorMessageReceive
+        } type;
+        HKHubArchPortMessage data;
+        size_t timestamp;
+        size_t wait;
+    } message;
+    struct {
+        void *context;
+        uintptr_t extra;
+        HKHubArchProcessorDebugOperationCallback operation;
+        HKHubArchProcessorDebugTraceCallback trace;
+        HKHubArchProcessorDebugPortConnectionChangeCallback portConnectionChange;
+        HKHubArchProcessorDebugBreakpointChangeCallback breakpointChange;
+        HKHubArchProcessorDebugModeChangeCallback debugModeChange;
+    } debug;
     double unusedTime;
-    HKHubArchProcessorStatus status;
     uint8_t memory[256];
+    HKHubArchPortTable ports;
 } HKHubArchProcessorInfo;
 
 typedef enum {
@@ -245,12 +284,68 @@ HKHubArchPort HKHubArchProcessorGetPort(HKHubArchProcessor Processor, HKHubArchP
  */
 HKHubArchPortConnection HKHubArchProcessorGetPortConnection(HKHubArchProcessor Processor, HKHubArchPortID Port);
 
+/*!
+ * @brief Check if the processor's port is ready for a transfer.
+ * @param Device The processor.
+ * @param Port The port of the processor.
+ * @return Whether the port is ready or not.
+ */
+_Bool HKHubArchProcessorPortReady(HKHubArchProcessor Device, HKHubArchPortID Port);
+
+/*!
+ * @brief Send a message from the processor over a direct connection.
+ * @description Equivalent to calling the port's sender but without going through the port interfaces. Only valid
+ *              for direct connections, where both ends are known to be processors.
+ *
+ * @param Connection The direct connection.
+ * @param Device The processor that is sending the message.
+ * @param Port The port of the sending processor.
+ * @param Message The message to be written too.
+ * @param ConnectedDevice The processor that will receive the message.
+ * @param Timestamp The cycle timestamp the event originated at.
+ * @param Wait The amount of cycles the caller must wait for.
+ * @return The response of the transfer.
+ */
+HKHubArchPortResponse HKHubArchProcessorChannelSend(HKHubArchPortConnection Connection, HKHubArchProcessor Device, HKHubArchPortID Port, HKHubArchPortMessage *Message, HKHubArchProcessor ConnectedDevice, size_t Timestamp, size_t *Wait);
+
+/*!
+ * @brief Receive a message into the processor over a direct connection.
+ * @description Equivalent to calling the port's receiver but without going through the port interfaces. Only valid
+ *              for direct connections, where both ends are known to be processors.
+ *
+ * @param Connection The direct connection.
+ * @param Device The processor that is receiving the message.
+ * @param Port The port of the receiving processor.
+ * @param Message The message that is being sent.
+ * @param ConnectedDevice The processor that sent the message.
+ * @param Timestamp The cycle timestamp the event originated at.
+ * @param Wait The amount of cycles the caller must wait for.
+ * @return The response of the transfer.
+ */
+HKHubArchPortResponse HKHubArchProcessorChannelReceive(HKHubArchPortConnection Connection, HKHubArchProcessor Device, HKHubArchPortID Port, HKHubArchPortMessage *Message, HKHubArchProcessor ConnectedDevice, size_t Timestamp, size_t *Wait);
+
 /*!
  * @brief Run the processor.
  * @param Processor The processor to be run.
  */
 void HKHubArchProcessorRun(HKHubArchProcessor Processor);
 
+/*!
+ * @brief Run a set of processors.
+ * @description Produces the same result as calling @b HKHubArchProcessorRun on each processor, however processors
+ *              that are running the same program from the same state (same PC and memory) are run in lockstep.
+ *              Register operations are then applied to all processors in the batch at once, while any that
+ *              diverge (branch elsewhere, write different memory, stall on a port, or run out of cycles) are
+ *              split out and run individually.
+ *
+ *              Processors that have a JIT cache or are being debugged are always run individually. A JIT cache
+ *              already runs the program natively, so is expected to outperform interpreting it in lockstep.
+ *
+ * @param Processors The processors to be run.
+ * @param Count The number of processors.
+ */
+void HKHubArchProcessorRunBatch(HKHubArchProcessor *Processors, size_t Count);
+
 /*!
  * @brief Set the number of instructions the processor should step in debug mode.
  * @param Processor The processor to step.
@@ -276,6 +371,21 @@ void HKHubArchProcessorSetDebugMode(HKHubArchProcessor Processor, HKHubArchProce
  */
 void HKHubArchProcessorSetBreakpoint(HKHubArchProcessor Processor, HKHubArchProcessorDebugBreakpoint Breakpoint, uint8_t Offset);
 
+/*!
+ * @brief Get the breakpoint set in the processor.
+ * @param Processor The processor to get the breakpoint of.
+ * @param Offset The offset of the breakpoint.
+ * @return The type of breakpoint at the given offset.
+ */
+static inline HKHubArchProcessorDebugBreakpoint HKHubArchProcessorGetBreakpoint(HKHubArchProcessor Processor, uint8_t Offset);
+
+/*!
+ * @brief Whether the processor has any breakpoints set.
+ * @param Processor The processor to check for breakpoints.
+ * @return TRUE if any breakpoints are set, otherwise FALSE.
+ */
+static inline _Bool HKHubArchProcessorHasBreakpoints(HKHubArchProcessor Processor);
+
 /*!
  * @brief Remove all breakpoints in the processor.
  * @param Processor The processor to remove the breakpoints of.
@@ -284,11 +394,33 @@ void HKHubArchProcessorClearBreakpoints(HKHubArchProcessor Processor);
 
 /*!
  * @brief Generate the execution cache for the processor.
+ * @description A JIT generated with @b HKHubArchJITOptionsDebug continues to be used while breakpoints are set,
+ *              and is only bypassed when there is an operation callback or the processor is paused.
+ *
+ *              Caches are shared between processors running the same program (the same memory and entry point),
+ *              only the most recently generated caches are kept available for sharing. The execution graph is
+ *              always shared, while a JIT generated with @b HKHubArchJITOptionsWatchMemory or
+ *              @b HKHubArchJITOptionsDebug is private to the processor.
+ *
  * @param Processor The processor to create the execution cache of.
  * @param Options The options to control how the JIT should be generated.
  */
 void HKHubArchProcessorCache(HKHubArchProcessor Processor, HKHubArchJITOptions Options);
 
+/*!
+ * @brief Change whether the JIT of the processor is generated for debugging.
+ * @description Debuggers should enable this when they're attached, so the JIT continues to be used while
+ *              they set breakpoints. Setting a breakpoint will also enable it. It won't be disabled while
+ *              any breakpoints remain.
+ *
+ *              The JIT is generated again from the current memory, so this does nothing if the processor
+ *              doesn't have a JIT.
+ *
+ * @param Processor The processor to change the JIT of.
+ * @param Debug Whether the JIT should be generated with @b HKHubArchJITOptionsDebug.
+ */
+void HKHubArchProcessorCacheDebug(HKHubArchProcessor Processor, _Bool Debug);
+
 /*!
  * @brief Whether the processor can continue to be executed or not.
  * @param Processor The processor to check has finished.
@@ -297,6 +429,21 @@ static inline _Bool HKHubArchProcessorIsRunning(HKHubArchProcessor Processor);
 
 #pragma mark -
 
+static inline HKHubArchProcessorDebugBreakpoint HKHubArchProcessorGetBreakpoint(HKHubArchProcessor Processor, uint8_t Offset)
+{
+    const uint64_t Mask = UINT64_C(1) << (Offset % 64);
+    
+    return ((Processor->state.debug.breakpoints.read[Offset / 64] & Mask) ? HKHubArchProcessorDebugBreakpointRead : HKHubArchProcessorDebugBreakpointNone) | ((Processor->state.debug.breakpoints.write[Offset / 64] & Mask) ? HKHubArchProcessorDebugBreakpointWrite : HKHubArchProcessorDebugBreakpointNone);
+}
+
+static inline _Bool HKHubArchProcessorHasBreakpoints(HKHubArchProcessor Processor)
+{
+    uint64_t Breakpoints = 0;
+    for (size_t Loop = 0; Loop < 256 / 64; Loop++) Breakpoints |= Processor->state.debug.breakpoints.read[Loop] | Processor->state.debug.breakpoints.write[Loop];
+    
+    return Breakpoints;
+}
+
 static inline _Bool HKHubArchProcessorIsRunning(HKHubArchProcessor Processor)
 {
     return (Processor->status == HKHubArchProcessorStatusRunning) && (Processor->cycles) && (((Processor->state.debug.mode != HKHubArchProcessorDebugModePause) || (Processor->state.debug.step)));
@@ -24,13 +24,60 @@
  */
 
 #include "HubArchScheduler.h"
+#include <threads.h>
+#include <stdatomic.h>
+
+#define HK_HUB_ARCH_SCHEDULER_DEFAULT_WORKER_COUNT 4
+#define HK_HUB_ARCH_SCHEDULER_MAX_WORKER_COUNT 64
+#define HK_HUB_ARCH_SCHEDULER_BATCH_GROUP_SIZE 32
+
+typedef struct {
+    size_t start;
+    size_t count;
+    size_t timestamp;
+    _Bool shared;
+} HKHubArchSchedulerGroup;
+
+typedef struct {
+    HKHubArchPortDevice device;
+    const HKHubArchPortTable *ports;
+    size_t node;
+} HKHubArchSchedulerDevice;
 
 typedef struct HKHubArchSchedulerInfo {
     CCCollection(HKHubArchProcessor) hubs;
     size_t timestamp;
+    HKHubArchSchedulerMode mode;
+    HKHubArchSchedulerStrategy strategy;
+    CCCollection(HKHubArchPortDevice) shared;
+    CCArray(HKHubArchProcessor) active[2];
+    struct {
+        size_t workers;
+        CCArray(HKHubArchProcessor) processors;
+        CCArray(HKHubArchSchedulerGroup) groups;
+        size_t sharedGroup;
+        CCArray(size_t) nodes;
+        CCArray(HKHubArchSchedulerDevice) pending;
+        size_t generation;
+        _Bool dirty;
+        atomic_size_t next;
+        struct {
+            thrd_t threads[HK_HUB_ARCH_SCHEDULER_MAX_WORKER_COUNT - 1];
+            size_t count;
+            mtx_t lock;
+            cnd_t start;
+            cnd_t done;
+            size_t generation;
+            size_t pending;
+            _Bool exit;
+            _Bool available;
+        } pool;
+    } parallel;
 } HKHubArchSchedulerInfo;
 
 
+static void HKHubArchSchedulerPoolStop(HKHubArchScheduler Scheduler);
+
 static void HKHubArchSchedulerProcessorElementDestructor(CCCollection(HKHubArchProcessor) Collection, HKHubArchProcessor *Element)
 {
     HKHubArchProcessorDestroy(*Element);
@@ -38,7 +85,23 @@ static void HKHubArchSchedulerProcessorElementDestructor(CCCollection(HKHubArchP
 
 static void HKHubArchSchedulerDestructor(HKHubArchScheduler Scheduler)
 {
+    if (Scheduler->parallel.pool.available)
+    {
+        HKHubArchSchedulerPoolStop(Scheduler);
+        
+        mtx_destroy(&Scheduler->parallel.pool.lock);
+        cnd_destroy(&Scheduler->parallel.pool.start);
+        cnd_destroy(&Scheduler->parallel.pool.done);
+    }
+    
     CCCollectionDestroy(Scheduler->hubs);
+    CCCollectionDestroy(Scheduler->shared);
+    CCArrayDestroy(Scheduler->active[0]);
+    CCArrayDestroy(Scheduler->active[1]);
+    CCArrayDestroy(Scheduler->parallel.processors);
+    CCArrayDestroy(Scheduler->parallel.groups);
+    CCArrayDestroy(Scheduler->parallel.nodes);
+    CCArrayDestroy(Scheduler->parallel.pending);
 }
 
 HKHubArchScheduler HKHubArchSchedulerCreate(CCAllocatorType Allocator)
@@ -47,7 +110,42 @@ HKHubArchScheduler HKHubArchSchedulerCreate(CCAllocatorType Allocator)
     
     if (Scheduler)
     {
-        *Scheduler = (HKHubArchSchedulerInfo){ .hubs = CCCollectionCreate(Allocator, CCCollectionHintHeavyEnumerating, sizeof(HKHubArchProcessor), (CCCollectionElementDestructor)HKHubArchSchedulerProcessorElementDestructor) };
+        *Scheduler = (HKHubArchSchedulerInfo){
+            .hubs = CCCollectionCreate(Allocator, CCCollectionHintHeavyEnumerating, sizeof(HKHubArchProcessor), (CCCollectionElementDestructor)HKHubArchSchedulerProcessorElementDestructor),
+            .timestamp = 0,
+            .mode = HKHubArchSchedulerModeSerial,
+            .strategy = HKHubArchSchedulerStrategyScan,
+            .shared = CCCollectionCreate(Allocator, CCCollectionHintSizeSmall, sizeof(HKHubArchPortDevice), NULL),
+            .active = {
+                CCArrayCreate(Allocator, sizeof(HKHubArchProcessor), 64),
+                CCArrayCreate(Allocator, sizeof(HKHubArchProcessor), 64)
+            },
+            .parallel = {
+                .workers = HK_HUB_ARCH_SCHEDULER_DEFAULT_WORKER_COUNT,
+                .processors = CCArrayCreate(Allocator, sizeof(HKHubArchProcessor), 64),
+                .groups = CCArrayCreate(Allocator, sizeof(HKHubArchSchedulerGroup), 16),
+                .nodes = CCArrayCreate(Allocator, sizeof(size_t), 64),
+                .pending = CCArrayCreate(Allocator, sizeof(HKHubArchSchedulerDevice), 16),
+                .generation = 0,
+                .sharedGroup = SIZE_MAX,
+                .dirty = TRUE,
+                .pool = { .count = 0, .available = FALSE }
+            }
+        };
+        
+        int err;
+        if ((err = mtx_init(&Scheduler->parallel.pool.lock, mtx_plain)) == thrd_success)
+        {
+            if ((err = cnd_init(&Scheduler->parallel.pool.start)) == thrd_success)
+            {
+                if ((err = cnd_init(&Scheduler->parallel.pool.done)) == thrd_success) Scheduler->parallel.pool.available = TRUE;
+                else cnd_destroy(&Scheduler->parallel.pool.start);
+            }
+            
+            if (!Scheduler->parallel.pool.available) mtx_destroy(&Scheduler->parallel.pool.lock);
+        }
+        
+        if (!Scheduler->parallel.pool.available) CC_LOG_ERROR("Failed to create scheduler worker pool, parallel mode will only use the calling thread (%d)", err);
         
         CCMemorySetDestructor(Scheduler, (CCMemoryDestructorCallback)HKHubArchSchedulerDestructor);
     }
@@ -64,12 +162,75 @@ void HKHubArchSchedulerDestroy(HKHubArchScheduler Scheduler)
     CCFree(Scheduler);
 }
 
+void HKHubArchSchedulerSetMode(HKHubArchScheduler Scheduler, HKHubArchSchedulerMode Mode)
+{
+    CCAssertLog(Scheduler, "Scheduler must not be null");
+    
+    Scheduler->mode = Mode;
+}
+
+HKHubArchSchedulerMode HKHubArchSchedulerGetMode(HKHubArchScheduler Scheduler)
+{
+    CCAssertLog(Scheduler, "Scheduler must not be null");
+    
+    return Scheduler->mode;
+}
+
+void HKHubArchSchedulerSetStrategy(HKHubArchScheduler Scheduler, HKHubArchSchedulerStrategy Strategy)
+{
+    CCAssertLog(Scheduler, "Scheduler must not be null");
+    
+    Scheduler->strategy = Strategy;
+    Scheduler->parallel.dirty = TRUE;
+}
+
+HKHubArchSchedulerStrategy HKHubArchSchedulerGetStrategy(HKHubArchScheduler Scheduler)
+{
+    CCAssertLog(Scheduler, "Scheduler must not be null");
+    
+    return Scheduler->strategy;
+}
+
+void HKHubArchSchedulerSetWorkerCount(HKHubArchScheduler Scheduler, size_t Count)
+{
+    CCAssertLog(Scheduler, "Scheduler must not be null");
+    CCAssertLog(Count, "Count must be at least 1");
+    
+    Scheduler->parallel.workers = Count;
+}
+
+void HKHubArchSchedulerAddSharedDevice(HKHubArchScheduler Scheduler, HKHubArchPortDevice Device)
+{
+    CCAssertLog(Scheduler, "Scheduler must not be null");
+    CCAssertLog(Device, "Device must not be null");
+    
+    CCCollectionInsertElement(Scheduler->shared, &Device);
+    
+    Scheduler->parallel.dirty = TRUE;
+}
+
+void HKHubArchSchedulerRemoveSharedDevice(HKHubArchScheduler Scheduler, HKHubArchPortDevice Device)
+{
+    CCAssertLog(Scheduler, "Scheduler must not be null");
+    CCAssertLog(Device, "Device must not be null");
+    
+    CCCollectionEntry Entry = CCCollectionFindElement(Scheduler->shared, &Device, NULL);
+    if (Entry)
+    {
+        CCCollectionRemoveElement(Scheduler->shared, Entry);
+        
+        Scheduler->parallel.dirty = TRUE;
+    }
+}
+
 void HKHubArchSchedulerAddProcessor(HKHubArchScheduler Scheduler, HKHubArchProcessor Processor)
 {
     CCAssertLog(Scheduler, "Scheduler must not be null");
     CCAssertLog(Processor, "Processor must not be null");
     
     CCCollectionInsertElement(Scheduler->hubs, &(HKHubArchProcessor){ CCRetain(Processor) });
+    
+    Scheduler->parallel.dirty = TRUE;
 }
 
 void HKHubArchSchedulerRemoveProcessor(HKHubArchScheduler Scheduler, HKHubArchProcessor Processor)
@@ -80,8 +241,10 @@ void HKHubArchSchedulerRemoveProcessor(HKHubArchScheduler Scheduler, HKHubArchPr
     CCCollectionEntry Entry = CCCollectionFindElement(Scheduler->hubs, &Processor, NULL);
     if (Entry)
     {
-        CC_DICTIONARY_FOREACH_VALUE(HKHubArchPortConnection, Connection, Processor->ports)
+        HK_HUB_ARCH_PORT_TABLE_FOREACH(Port, &Processor->ports)
         {
+            HKHubArchPortConnection Connection = HKHubArchPortTableGetConnection(&Processor->ports, Port);
+            
             for (int Loop = 0; Loop < 2; Loop++)
             {
                 if (Connection->port[Loop].device == Processor) Connection->port[Loop].disconnect = NULL;
@@ -91,7 +254,503 @@ void HKHubArchSchedulerRemoveProcessor(HKHubArchScheduler Scheduler, HKHubArchPr
         }
         
         CCCollectionRemoveElement(Scheduler->hubs, Entry);
+        
+        Scheduler->parallel.dirty = TRUE;
+    }
+}
+
+static size_t HKHubArchSchedulerNodeRoot(CCArray(size_t) Nodes, size_t Index)
+{
+    for (size_t *Parent; *(Parent = CCArrayGetElementAtIndex(Nodes, Index)) != Index; )
+    {
+        *Parent = *(size_t*)CCArrayGetElementAtIndex(Nodes, *Parent);
+        Index = *Parent;
+    }
+    
+    return Index;
+}
+
+static void HKHubArchSchedulerNodeMerge(CCArray(size_t) Nodes, size_t A, size_t B)
+{
+    A = HKHubArchSchedulerNodeRoot(Nodes, A);
+    B = HKHubArchSchedulerNodeRoot(Nodes, B);
+    
+    //The lowest index is always used as the root, so a processor will always be the root of its group
+    if (A < B) CCArrayReplaceElementAtIndex(Nodes, B, &A);
+    else if (B < A) CCArrayReplaceElementAtIndex(Nodes, A, &B);
+}
+
+static size_t HKHubArchSchedulerNodeForDevice(CCDictionary(HKHubArchPortDevice, size_t) Devices, CCArray(size_t) Nodes, HKHubArchPortDevice Device)
+{
+    const size_t *Node = CCDictionaryGetValue(Devices, &Device);
+    if (Node) return *Node;
+    
+    const size_t Index = CCArrayGetCount(Nodes);
+    CCArrayAppendElement(Nodes, &Index);
+    CCDictionarySetValue(Devices, &Device, &Index);
+    
+    return Index;
+}
+
+static void HKHubArchSchedulerMergeConnections(CCDictionary(HKHubArchPortDevice, size_t) Devices, CCArray(size_t) Nodes, CCArray(HKHubArchSchedulerDevice) Pending, const HKHubArchSchedulerDevice *Device)
+{
+    HK_HUB_ARCH_PORT_TABLE_FOREACH(Port, Device->ports)
+    {
+        HKHubArchPortConnection Connection = HKHubArchPortTableGetConnection(Device->ports, Port);
+        
+        for (int Loop = 0; Loop < 2; Loop++)
+        {
+            const HKHubArchPort *ConnectedPort = &Connection->port[Loop];
+            if (ConnectedPort->device != Device->device)
+            {
+                const size_t Count = CCArrayGetCount(Nodes);
+                const size_t Node = HKHubArchSchedulerNodeForDevice(Devices, Nodes, ConnectedPort->device);
+                
+                HKHubArchSchedulerNodeMerge(Nodes, Device->node, Node);
+                
+                /*
+                 Processors are all visited by the partition, but any other device (such as a module) is only found
+                 through its connections. As it may be connected to further devices whose state could then be reached
+                 from more than one group, its own connections must also be followed.
+                 */
+                if ((Node == Count) && (ConnectedPort->ports)) CCArrayAppendElement(Pending, &(HKHubArchSchedulerDevice){ .device = ConnectedPort->device, .ports = ConnectedPort->ports, .node = Node });
+            }
+        }
+    }
+}
+
+static void HKHubArchSchedulerPartition(HKHubArchScheduler Scheduler)
+{
+    CCArray(HKHubArchProcessor) Processors = Scheduler->parallel.processors;
+    CCArray(HKHubArchSchedulerGroup) Groups = Scheduler->parallel.groups;
+    CCArray(size_t) Nodes = Scheduler->parallel.nodes;
+    CCArray(HKHubArchSchedulerDevice) Pending = Scheduler->parallel.pending;
+    
+    Scheduler->parallel.dirty = FALSE;
+    Scheduler->parallel.generation = HKHubArchPortTableGeneration;
+    
+    CCArrayRemoveAllElements(Processors);
+    CCArrayRemoveAllElements(Groups);
+    CCArrayRemoveAllElements(Nodes);
+    
+    CCDictionary(HKHubArchPortDevice, size_t) Devices = CCDictionaryCreate(CC_STD_ALLOCATOR, CCDictionaryHintHeavyFinding | CCDictionaryHintHeavyInserting, sizeof(HKHubArchPortDevice), sizeof(size_t), NULL);
+    
+    size_t Count = 0;
+    CC_COLLECTION_FOREACH(HKHubArchProcessor, Processor, Scheduler->hubs)
+    {
+        CCDictionarySetValue(Devices, &Processor, &Count);
+        CCArrayAppendElement(Nodes, &Count);
+        CCArrayAppendElement(Processors, &Processor);
+        Count++;
+    }
+    
+    const size_t Shared = Count;
+    CCArrayAppendElement(Nodes, &Shared);
+    
+    for (size_t Loop = 0; Loop < Count; Loop++)
+    {
+        HKHubArchProcessor Processor = *(HKHubArchProcessor*)CCArrayGetElementAtIndex(Processors, Loop);
+        
+        HKHubArchSchedulerMergeConnections(Devices, Nodes, Pending, &(HKHubArchSchedulerDevice){ .device = Processor, .ports = &Processor->ports, .node = Loop });
+        
+        for (size_t PendingCount; (PendingCount = CCArrayGetCount(Pending)); )
+        {
+            const HKHubArchSchedulerDevice Device = *(HKHubArchSchedulerDevice*)CCArrayGetElementAtIndex(Pending, PendingCount - 1);
+            CCArrayRemoveElementAtIndex(Pending, PendingCount - 1);
+            
+            HKHubArchSchedulerMergeConnections(Devices, Nodes, Pending, &Device);
+        }
+        
+        if (Processor->debug.context) HKHubArchSchedulerNodeMerge(Nodes, Loop, Shared);
+    }
+    
+    CC_COLLECTION_FOREACH(HKHubArchPortDevice, Device, Scheduler->shared)
+    {
+        const size_t *Node = CCDictionaryGetValue(Devices, &Device);
+        if (Node) HKHubArchSchedulerNodeMerge(Nodes, *Node, Shared);
+    }
+    
+    CCDictionaryDestroy(Devices);
+    
+    const size_t SharedRoot = HKHubArchSchedulerNodeRoot(Nodes, Shared);
+    
+    /*
+     Once every processor node points directly to its root (the lowest processor index in the group), the roots
+     can be reused to store their group index as they will be visited before any other processor in their group.
+     */
+    for (size_t Loop = 0; Loop < Count; Loop++)
+    {
+        const size_t Root = HKHubArchSchedulerNodeRoot(Nodes, Loop);
+        CCArrayReplaceElementAtIndex(Nodes, Loop, &Root);
+    }
+    
+    for (size_t Loop = 0; Loop < Count; Loop++)
+    {
+        size_t Index = *(size_t*)CCArrayGetElementAtIndex(Nodes, Loop);
+        if (Index == Loop)
+        {
+            const _Bool IsShared = Loop == SharedRoot;
+            Index = CCArrayAppendElement(Groups, &(HKHubArchSchedulerGroup){ .start = 0, .count = 0, .timestamp = 0, .shared = IsShared });
+        }
+        
+        else Index = *(size_t*)CCArrayGetElementAtIndex(Nodes, Index);
+        
+        CCArrayReplaceElementAtIndex(Nodes, Loop, &Index);
+        ((HKHubArchSchedulerGroup*)CCArrayGetElementAtIndex(Groups, Index))->count++;
+    }
+    
+    /*
+     Unconnected processors are each in their own group, so there would be nothing for the batch strategy to run
+     together. Groups never interact, so small independent groups are combined (up to a batch) to be run as one. The
+     end of the nodes array is reused to store where each group was moved to.
+     */
+    if (Scheduler->strategy == HKHubArchSchedulerStrategyBatch)
+    {
+        const size_t Moved = CCArrayGetCount(Nodes);
+        size_t Merged = 0, Target = SIZE_MAX;
+        
+        for (size_t Loop = 0, GroupCount = CCArrayGetCount(Groups); Loop < GroupCount; Loop++)
+        {
+            const HKHubArchSchedulerGroup Group = *(HKHubArchSchedulerGroup*)CCArrayGetElementAtIndex(Groups, Loop);
+            
+            if ((!Group.shared) && (Target != SIZE_MAX) && ((((HKHubArchSchedulerGroup*)CCArrayGetElementAtIndex(Groups, Target))->count + Group.count) <= HK_HUB_ARCH_SCHEDULER_BATCH_GROUP_SIZE))
+            {
+                ((HKHubArchSchedulerGroup*)CCArrayGetElementAtIndex(Groups, Target))->count += Group.count;
+                CCArrayAppendElement(Nodes, &Target);
+            }
+            
+            else
+            {
+                if ((!Group.shared) && (Group.count < HK_HUB_ARCH_SCHEDULER_BATCH_GROUP_SIZE)) Target = Merged;
+                
+                CCArrayReplaceElementAtIndex(Groups, Merged, &Group);
+                CCArrayAppendElement(Nodes, &Merged);
+                Merged++;
+            }
+        }
+        
+        for (size_t GroupCount; (GroupCount = CCArrayGetCount(Groups)) > Merged; ) CCArrayRemoveElementAtIndex(Groups, GroupCount - 1);
+        
+        for (size_t Loop = 0; Loop < Count; Loop++)
+        {
+            const size_t Index = *(size_t*)CCArrayGetElementAtIndex(Nodes, Moved + *(size_t*)CCArrayGetElementAtIndex(Nodes, Loop));
+            CCArrayReplaceElementAtIndex(Nodes, Loop, &Index);
+        }
+    }
+    
+    Scheduler->parallel.sharedGroup = SIZE_MAX;
+    
+    for (size_t Loop = 0, Start = 0, GroupCount = CCArrayGetCount(Groups); Loop < GroupCount; Loop++)
+    {
+        HKHubArchSchedulerGroup *Group = CCArrayGetElementAtIndex(Groups, Loop);
+        if (Group->shared) Scheduler->parallel.sharedGroup = Loop;
+        
+        Group->start = Start;
+        Start += Group->count;
+        Group->count = 0;
+    }
+    
+    size_t Index = 0;
+    CC_COLLECTION_FOREACH(HKHubArchProcessor, Processor, Scheduler->hubs)
+    {
+        HKHubArchSchedulerGroup *Group = CCArrayGetElementAtIndex(Groups, *(size_t*)CCArrayGetElementAtIndex(Nodes, Index++));
+        CCArrayReplaceElementAtIndex(Processors, Group->start + Group->count++, &Processor);
+    }
+}
+
+static CC_FORCE_INLINE _Bool HKHubArchSchedulerUpdateProcessor(HKHubArchProcessor Processor, size_t *Timestamp)
+{
+    const _Bool Running = HKHubArchProcessorIsRunning(Processor);
+    
+    if (Processor->state.debug.mode == HKHubArchProcessorDebugModePause) HKHubArchProcessorSetCycles(Processor, 0);
+    if ((*Timestamp < Processor->cycles) && (Processor->status & HKHubArchProcessorStatusResumable)) *Timestamp = Processor->cycles;
+    
+    return Running;
+}
+
+static CC_FORCE_INLINE _Bool HKHubArchSchedulerRunProcessor(HKHubArchProcessor Processor, size_t *Timestamp, _Bool *Ran)
+{
+    //Processors waiting on a port connection will be woken once the device they're waiting on changes, until then running them will have no effect
+    if (!Processor->waiting)
+    {
+        HKHubArchProcessorRun(Processor);
+        *Ran = TRUE;
+    }
+    
+    return HKHubArchSchedulerUpdateProcessor(Processor, Timestamp);
+}
+
+static void HKHubArchSchedulerWakeProcessors(HKHubArchProcessor *Processors, size_t Count)
+{
+    /*
+     Only reachable if every running processor is waiting on a device that will not be run (not managed by this scheduler),
+     so fallback to polling them.
+     */
+    for (size_t Loop = 0; Loop < Count; Loop++) Processors[Loop]->waiting = FALSE;
+}
+
+static void HKHubArchSchedulerRunScan(HKHubArchProcessor *Processors, size_t Count, size_t *Timestamp)
+{
+    for (_Bool Complete = FALSE; !Complete; )
+    {
+        size_t PrevTimestamp = 0;
+        _Bool Ran = FALSE;
+        
+        Complete = TRUE;
+        for (size_t Loop = 0; Loop < Count; Loop++) Complete &= !HKHubArchSchedulerRunProcessor(Processors[Loop], &PrevTimestamp, &Ran);
+        
+        if ((!Complete) && (!Ran)) HKHubArchSchedulerWakeProcessors(Processors, Count);
+        
+        *Timestamp = PrevTimestamp;
+    }
+}
+
+static void HKHubArchSchedulerRunActiveList(HKHubArchProcessor *Processors, size_t Count, size_t *Timestamp, CCArray(HKHubArchProcessor) Active[2])
+{
+    /*
+     Processors cannot resume once they've completed (only adding cycles will allow them to resume), so the timestamp of
+     completed processors is fixed and only needs to be tracked once rather than re-evaluated every pass.
+     */
+    size_t CompletedTimestamp = 0;
+    
+    for (size_t Current = 0; Count; Current = !Current)
+    {
+        CCArray(HKHubArchProcessor) Next = Active[!Current];
+        CCArrayRemoveAllElements(Next);
+        
+        size_t PrevTimestamp = 0;
+        _Bool Ran = FALSE;
+        for (size_t Loop = 0; Loop < Count; Loop++)
+        {
+            size_t ProcessorTimestamp = 0;
+            if (HKHubArchSchedulerRunProcessor(Processors[Loop], &ProcessorTimestamp, &Ran))
+            {
+                CCArrayAppendElement(Next, &Processors[Loop]);
+                if (PrevTimestamp < ProcessorTimestamp) PrevTimestamp = ProcessorTimestamp;
+            }
+            
+            else if (CompletedTimestamp < ProcessorTimestamp) CompletedTimestamp = ProcessorTimestamp;
+        }
+        
+        *Timestamp = CCMax(PrevTimestamp, CompletedTimestamp);
+        
+        Count = CCArrayGetCount(Next);
+        if (Count)
+        {
+            Processors = CCArrayGetElementAtIndex(Next, 0);
+            
+            if (!Ran) HKHubArchSchedulerWakeProcessors(Processors, Count);
+        }
+    }
+}
+
+static void HKHubArchSchedulerRunBatch(HKHubArchProcessor *Processors, size_t Count, size_t *Timestamp, CCArray(HKHubArchProcessor) Runnable)
+{
+    for (_Bool Complete = FALSE; !Complete; )
+    {
+        CCArrayRemoveAllElements(Runnable);
+        
+        for (size_t Loop = 0; Loop < Count; Loop++)
+        {
+            if (!Processors[Loop]->waiting) CCArrayAppendElement(Runnable, &Processors[Loop]);
+        }
+        
+        const size_t RunCount = CCArrayGetCount(Runnable);
+        if (RunCount) HKHubArchProcessorRunBatch(CCArrayGetElementAtIndex(Runnable, 0), RunCount);
+        
+        size_t PrevTimestamp = 0;
+        
+        Complete = TRUE;
+        for (size_t Loop = 0; Loop < Count; Loop++) Complete &= !HKHubArchSchedulerUpdateProcessor(Processors[Loop], &PrevTimestamp);
+        
+        if ((!Complete) && (!RunCount)) HKHubArchSchedulerWakeProcessors(Processors, Count);
+        
+        *Timestamp = PrevTimestamp;
+    }
+}
+
+static void HKHubArchSchedulerRunProcessors(HKHubArchSchedulerStrategy Strategy, HKHubArchProcessor *Processors, size_t Count, size_t *Timestamp, CCArray(HKHubArchProcessor) Active[2])
+{
+    switch (Strategy)
+    {
+        case HKHubArchSchedulerStrategyScan:
+            HKHubArchSchedulerRunScan(Processors, Count, Timestamp);
+            break;
+            
+        case HKHubArchSchedulerStrategyActiveList:
+            HKHubArchSchedulerRunActiveList(Processors, Count, Timestamp, Active);
+            break;
+            
+        case HKHubArchSchedulerStrategyBatch:
+            HKHubArchSchedulerRunBatch(Processors, Count, Timestamp, Active[0]);
+            break;
+    }
+}
+
+static _Bool HKHubArchSchedulerPartitionIsValid(HKHubArchScheduler Scheduler)
+{
+    if ((Scheduler->parallel.dirty) || (Scheduler->parallel.generation != HKHubArchPortTableGeneration)) return FALSE;
+    
+    //Attaching a debugger does not change any connections, but requires the processor to be moved into the shared group
+    for (size_t Loop = 0, Count = CCArrayGetCount(Scheduler->parallel.groups); Loop < Count; Loop++)
+    {
+        const HKHubArchSchedulerGroup *Group = CCArrayGetElementAtIndex(Scheduler->parallel.groups, Loop);
+        if (!Group->shared)
+        {
+            HKHubArchProcessor *Processors = CCArrayGetElementAtIndex(Scheduler->parallel.processors, Group->start);
+            for (size_t Index = 0; Index < Group->count; Index++)
+            {
+                if (Processors[Index]->debug.context) return FALSE;
+            }
+        }
+    }
+    
+    return TRUE;
+}
+
+static void HKHubArchSchedulerRunGroups(HKHubArchScheduler Scheduler, CCArray(HKHubArchProcessor) Active[2])
+{
+    /*
+     Groups are claimed from a shared index, so any worker that finishes its group early will steal the next
+     unclaimed group rather than sitting idle. The shared group is skipped, as it's only run by the calling thread.
+     */
+    const size_t Count = CCArrayGetCount(Scheduler->parallel.groups);
+    for (size_t Index; (Index = atomic_fetch_add_explicit(&Scheduler->parallel.next, 1, memory_order_relaxed)) < Count; )
+    {
+        if (Index == Scheduler->parallel.sharedGroup) continue;
+        
+        HKHubArchSchedulerGroup *Group = CCArrayGetElementAtIndex(Scheduler->parallel.groups, Index);
+        HKHubArchSchedulerRunProcessors(Scheduler->strategy, CCArrayGetElementAtIndex(Scheduler->parallel.processors, Group->start), Group->count, &Group->timestamp, Active);
+    }
+}
+
+static void HKHubArchSchedulerRunSharedGroup(HKHubArchScheduler Scheduler)
+{
+    if (Scheduler->parallel.sharedGroup == SIZE_MAX) return;
+    
+    HKHubArchSchedulerGroup *Group = CCArrayGetElementAtIndex(Scheduler->parallel.groups, Scheduler->parallel.sharedGroup);
+    
+    //Only the shared group may update the scheduler's timestamp while running, as shared devices will be reading it
+    HKHubArchSchedulerRunProcessors(Scheduler->strategy, CCArrayGetElementAtIndex(Scheduler->parallel.processors, Group->start), Group->count, &Scheduler->timestamp, Scheduler->active);
+}
+
+static int HKHubArchSchedulerWorker(HKHubArchScheduler Scheduler)
+{
+    CCArray(HKHubArchProcessor) Active[2] = {
+        CCArrayCreate(CC_STD_ALLOCATOR, sizeof(HKHubArchProcessor), 64),
+        CCArrayCreate(CC_STD_ALLOCATOR, sizeof(HKHubArchProcessor), 64)
+    };
+    
+    //The pool's generation always starts at 0, so a run dispatched before this worker first waits will not be missed
+    mtx_lock(&Scheduler->parallel.pool.lock);
+    for (size_t Generation = 0; ; )
+    {
+        while ((!Scheduler->parallel.pool.exit) && (Scheduler->parallel.pool.generation == Generation)) cnd_wait(&Scheduler->parallel.pool.start, &Scheduler->parallel.pool.lock);
+        
+        if (Scheduler->parallel.pool.exit) break;
+        
+        Generation = Scheduler->parallel.pool.generation;
+        mtx_unlock(&Scheduler->parallel.pool.lock);
+        
+        HKHubArchSchedulerRunGroups(Scheduler, Active);
+        
+        mtx_lock(&Scheduler->parallel.pool.lock);
+        if (!--Scheduler->parallel.pool.pending) cnd_signal(&Scheduler->parallel.pool.done);
+    }
+    mtx_unlock(&Scheduler->parallel.pool.lock);
+    
+    CCArrayDestroy(Active[0]);
+    CCArrayDestroy(Active[1]);
+    
+    return 0;
+}
+
+static void HKHubArchSchedulerPoolStart(HKHubArchScheduler Scheduler, size_t Count)
+{
+    Scheduler->parallel.pool.generation = 0;
+    Scheduler->parallel.pool.pending = 0;
+    Scheduler->parallel.pool.exit = FALSE;
+    
+    for (Scheduler->parallel.pool.count = 0; Scheduler->parallel.pool.count < Count; Scheduler->parallel.pool.count++)
+    {
+        int err;
+        if ((err = thrd_create(&Scheduler->parallel.pool.threads[Scheduler->parallel.pool.count], (thrd_start_t)HKHubArchSchedulerWorker, Scheduler)) != thrd_success)
+        {
+            CC_LOG_ERROR("Failed to create scheduler worker (%d)", err);
+            break;
+        }
+    }
+}
+
+static void HKHubArchSchedulerPoolStop(HKHubArchScheduler Scheduler)
+{
+    mtx_lock(&Scheduler->parallel.pool.lock);
+    Scheduler->parallel.pool.exit = TRUE;
+    cnd_broadcast(&Scheduler->parallel.pool.start);
+    mtx_unlock(&Scheduler->parallel.pool.lock);
+    
+    for (size_t Loop = 0; Loop < Scheduler->parallel.pool.count; Loop++)
+    {
+        int err;
+        if ((err = thrd_join(Scheduler->parallel.pool.threads[Loop], NULL)) != thrd_success)
+        {
+            CC_LOG_ERROR("Failed to join scheduler worker (%d)", err);
+        }
+    }
+    
+    Scheduler->parallel.pool.count = 0;
+}
+
+static void HKHubArchSchedulerRunParallel(HKHubArchScheduler Scheduler)
+{
+    if (!HKHubArchSchedulerPartitionIsValid(Scheduler)) HKHubArchSchedulerPartition(Scheduler);
+    
+    const size_t GroupCount = CCArrayGetCount(Scheduler->parallel.groups);
+    atomic_store_explicit(&Scheduler->parallel.next, 0, memory_order_relaxed);
+    
+    /*
+     The worker threads persist between runs and sleep until the next run is dispatched. The pool is only
+     restarted if the worker count has changed.
+     */
+    const size_t WorkerCount = CCMin(Scheduler->parallel.workers, HK_HUB_ARCH_SCHEDULER_MAX_WORKER_COUNT) - 1;
+    if ((Scheduler->parallel.pool.available) && (GroupCount > 1) && (WorkerCount))
+    {
+        if (Scheduler->parallel.pool.count != WorkerCount)
+        {
+            HKHubArchSchedulerPoolStop(Scheduler);
+            HKHubArchSchedulerPoolStart(Scheduler, WorkerCount);
+        }
+        
+        mtx_lock(&Scheduler->parallel.pool.lock);
+        Scheduler->parallel.pool.pending = Scheduler->parallel.pool.count;
+        Scheduler->parallel.pool.generation++;
+        cnd_broadcast(&Scheduler->parallel.pool.start);
+        mtx_unlock(&Scheduler->parallel.pool.lock);
+        
+        HKHubArchSchedulerRunSharedGroup(Scheduler);
+        HKHubArchSchedulerRunGroups(Scheduler, Scheduler->active);
+        
+        mtx_lock(&Scheduler->parallel.pool.lock);
+        while (Scheduler->parallel.pool.pending) cnd_wait(&Scheduler->parallel.pool.done, &Scheduler->parallel.pool.lock);
+        mtx_unlock(&Scheduler->parallel.pool.lock);
     }
+    
+    else
+    {
+        HKHubArchSchedulerRunSharedGroup(Scheduler);
+        HKHubArchSchedulerRunGroups(Scheduler, Scheduler->active);
+    }
+    
+    size_t Timestamp = 0;
+    for (size_t Loop = 0; Loop < GroupCount; Loop++)
+    {
+        const HKHubArchSchedulerGroup *Group = CCArrayGetElementAtIndex(Scheduler->parallel.groups, Loop);
+        const size_t GroupTimestamp = Group->shared ? Scheduler->timestamp : Group->timestamp;
+        
+        if (Timestamp < GroupTimestamp) Timestamp = GroupTimestamp;
+    }
+    
+    Scheduler->timestamp = Timestamp;
 }
 
 void HKHubArchSchedulerRun(HKHubArchScheduler Scheduler, double Seconds)
@@ -110,27 +769,47 @@ void HKHubArchSchedulerRun(HKHubArchScheduler Scheduler, double Seconds)
     
     Scheduler->timestamp = PrevTimestamp;
     
-    /*
-     TODO: Test a ping pong approach. Where there's two arrays, one is the active list that will be iterated (all
-     processors in the active list are yet to be complete). While running the processors, if they have not completed
-     add them to the other array. After the active list has finished being iterated, set the other array to be the
-     new active list. Keep repeating until the list is empty.
-     
-     Avoids iterating over processors that have already completed. This will most likely perform better on very large
-     lists, but worse on small lists.
-     */
+    if (Scheduler->mode == HKHubArchSchedulerModeParallel)
+    {
+        HKHubArchSchedulerRunParallel(Scheduler);
+        return;
+    }
+    
+    if ((Scheduler->strategy == HKHubArchSchedulerStrategyActiveList) || (Scheduler->strategy == HKHubArchSchedulerStrategyBatch))
+    {
+        CCArray(HKHubArchProcessor) Processors = Scheduler->parallel.processors;
+        CCArrayRemoveAllElements(Processors);
+        
+        Scheduler->parallel.dirty = TRUE;
+        
+        CC_COLLECTION_FOREACH(HKHubArchProcessor, Processor, Scheduler->hubs)
+        {
+            CCArrayAppendElement(Processors, &Processor);
+        }
+        
+        if (CCArrayGetCount(Processors)) HKHubArchSchedulerRunProcessors(Scheduler->strategy, CCArrayGetElementAtIndex(Processors, 0), CCArrayGetCount(Processors), &Scheduler->timestamp, Scheduler->active);
+        else Scheduler->timestamp = 0;
+        
+        return;
+    }
+    
     for (_Bool Complete = FALSE; !Complete; )
     {
         PrevTimestamp = 0;
+        _Bool Ran = FALSE;
         
         Complete = TRUE;
         CC_COLLECTION_FOREACH(HKHubArchProcessor, Processor, Scheduler->hubs)
         {
-            HKHubArchProcessorRun(Processor);
-            Complete &= !HKHubArchProcessorIsRunning(Processor);
-            
-            if (Processor->state.debug.mode == HKHubArchProcessorDebugModePause) HKHubArchProcessorSetCycles(Processor, 0);
-            if ((PrevTimestamp < Processor->cycles) && (Processor->status & HKHubArchProcessorStatusResumable)) PrevTimestamp = Processor->cycles;
+            Complete &= !HKHubArchSchedulerRunProcessor(Processor, &PrevTimestamp, &Ran);
+        }
+        
+        if ((!Complete) && (!Ran))
+        {
+            CC_COLLECTION_FOREACH(HKHubArchProcessor, Processor, Scheduler->hubs)
+            {
+                Processor->waiting = FALSE;
+            }
         }
         
         Scheduler->timestamp = PrevTimestamp;
@@ -34,6 +34,22 @@
  */
 typedef struct HKHubArchSchedulerInfo *HKHubArchScheduler;
 
+typedef enum {
+    /// Run all processors on the calling thread
+    HKHubArchSchedulerModeSerial,
+    /// Run independent groups of connected processors concurrently
+    HKHubArchSchedulerModeParallel
+} HKHubArchSchedulerMode;
+
+typedef enum {
+    /// Every pass iterates all processors until none are left running
+    HKHubArchSchedulerStrategyScan,
+    /// Every pass only iterates the processors that were still running after the previous pass
+    HKHubArchSchedulerStrategyActiveList,
+    /// Every pass iterates all processors, running those executing the same program in lockstep
+    HKHubArchSchedulerStrategyBatch
+} HKHubArchSchedulerStrategy;
+
 
 /*!
  * @brief Create a scheduler.
@@ -63,6 +79,77 @@ void HKHubArchSchedulerAddProcessor(HKHubArchScheduler Scheduler, HKHubArchProce
  */
 void HKHubArchSchedulerRemoveProcessor(HKHubArchScheduler Scheduler, HKHubArchProcessor CC_DESTROY(Processor));
 
+/*!
+ * @brief Set the mode the scheduler should run in.
+ * @description When running in parallel mode the processors are partitioned into groups, where a group is all
+ *              the processors reachable through their port connections. Each group is then run independently
+ *              by a pool of worker threads. Any processor with a debug context, or that is connected to a
+ *              shared device will belong to the same shared group. The shared group is always run on the
+ *              calling thread, so debug callbacks and shared devices are never used from a worker thread.
+ *
+ * @param Scheduler The scheduler to set the mode of.
+ * @param Mode The mode to be used.
+ */
+void HKHubArchSchedulerSetMode(HKHubArchScheduler Scheduler, HKHubArchSchedulerMode Mode);
+
+/*!
+ * @brief Get the mode the scheduler is running in.
+ * @param Scheduler The scheduler to get the mode of.
+ * @return The mode.
+ */
+HKHubArchSchedulerMode HKHubArchSchedulerGetMode(HKHubArchScheduler Scheduler);
+
+/*!
+ * @brief Set the strategy used to run the processors.
+ * @description @b HKHubArchSchedulerStrategyActiveList avoids re-iterating processors that have already completed,
+ *              this performs better when only a few processors are busy, while @b HKHubArchSchedulerStrategyScan
+ *              performs better on small sets of processors. @b HKHubArchSchedulerStrategyBatch performs better
+ *              when many processors are running the same program (see @b HKHubArchProcessorRunBatch).
+ *
+ *              In parallel mode processors can only be batched with others in the same group, so independent
+ *              groups (such as unconnected processors) are combined into groups of up to 32 processors. The group
+ *              containing the shared devices is never combined.
+ *
+ * @param Scheduler The scheduler to set the strategy of.
+ * @param Strategy The strategy to be used.
+ */
+void HKHubArchSchedulerSetStrategy(HKHubArchScheduler Scheduler, HKHubArchSchedulerStrategy Strategy);
+
+/*!
+ * @brief Get the strategy used to run the processors.
+ * @param Scheduler The scheduler to get the strategy of.
+ * @return The strategy.
+ */
+HKHubArchSchedulerStrategy HKHubArchSchedulerGetStrategy(HKHubArchScheduler Scheduler);
+
+/*!
+ * @brief Set the number of worker threads to be used in parallel mode.
+ * @description The calling thread counts as one of the workers. The other workers are created by the first
+ *              parallel run and sleep between runs, they're only recreated when the worker count changes.
+ *
+ * @param Scheduler The scheduler to set the worker count of.
+ * @param Count The number of workers. Must be at least 1.
+ */
+void HKHubArchSchedulerSetWorkerCount(HKHubArchScheduler Scheduler, size_t Count);
+
+/*!
+ * @brief Add a device whose state is shared beyond its port connections.
+ * @description All processors connected to a shared device are run in the same group, and that group is
+ *              the only one that will update the scheduler's timestamp while running. Devices such as
+ *              wireless transceivers which rely on @b HKHubArchSchedulerGetTimestamp must be shared.
+ *
+ * @param Scheduler The scheduler to add the device to.
+ * @param Device The shared device.
+ */
+void HKHubArchSchedulerAddSharedDevice(HKHubArchScheduler Scheduler, HKHubArchPortDevice Device);
+
+/*!
+ * @brief Remove a shared device from the scheduler.
+ * @param Scheduler The scheduler to remove the device from.
+ * @param Device The shared device.
+ */
+void HKHubArchSchedulerRemoveSharedDevice(HKHubArchScheduler Scheduler, HKHubArchPortDevice Device);
+
 /*!
  * @brief Run the scheduler.
  * @param Scheduler The scheduler to be run.
@@ -95,12 +95,7 @@ static void HKHubDebuggerComponentMessageHandler(CCComponent Debugger, CCMessage
                     HKHubArchProcessor Target = HKHubProcessorComponentGetProcessor(Component);
                     const HKHubDebuggerComponentMessageBreakpoint *Data = CCMessageGetData(Message);
                     
-                    HKHubArchProcessorDebugBreakpoint CurrentBP = 0;
-                    if (Target->state.debug.breakpoints)
-                    {
-                        HKHubArchProcessorDebugBreakpoint *Breakpoint = CCDictionaryGetValue(Target->state.debug.breakpoints, &Data->offset);
-                        if (Breakpoint) CurrentBP = *Breakpoint;
-                    }
+                    const HKHubArchProcessorDebugBreakpoint CurrentBP = HKHubArchProcessorGetBreakpoint(Target, Data->offset);
                     
                     HKHubArchProcessorSetBreakpoint(Target, CurrentBP ^ Data->breakpoint, Data->offset);
                     break;
@@ -25,6 +25,7 @@
 
 #include "HubProcessorComponent.h"
 #include "HubArchAssembly.h"
+#include "HubArchBinaryCache.h"
 
 const CCString HKHubProcessorComponentName = CC_STRING("hub");
 
@@ -136,11 +137,21 @@ void HKHubProcessorComponentDeserializer(CCComponent Component, CCExpression Arg
                                 
                                 FSHandleClose(Handle);
                                 
-                                CCOrderedCollection(HKHubArchAssemblyASTNode) AST = HKHubArchAssemblyParse(Source);
-                                
                                 CCOrderedCollection(HKHubArchAssemblyASTError) Errors = NULL;
-                                HKHubArchBinary Binary = HKHubArchAssemblyCreateBinary(CC_STD_ALLOCATOR, AST, &Errors);
-                                CCCollectionDestroy(AST);
+                                HKHubArchBinary Binary = HKHubArchBinaryCacheGet(Source);
+                                
+                                if (!Binary)
+                                {
+                                    CCOrderedCollection(HKHubArchAssemblyASTNode) AST = HKHubArchAssemblyParse(Source);
+                                    CCOrderedCollection(FSPath) Includes = CCCollectionCreate(CC_STD_ALLOCATOR, CCCollectionHintOrdered, sizeof(FSPath), FSPathComponentDestructorForCollection);
+                                    
+                                    Binary = HKHubArchAssemblyCreateBinaryWithIncludes(CC_STD_ALLOCATOR, AST, &Errors, Includes);
+                                    CCCollectionDestroy(AST);
+                                    
+                                    if (Binary) HKHubArchBinaryCacheSet(Source, Binary, Includes);
+                                    
+                                    CCCollectionDestroy(Includes);
+                                }
                                 
                                 if (Binary)
                                 {
@@ -396,7 +407,7 @@ void HKHubProcessorComponentDeserializer(CCComponent Component, CCExpression Arg
                             {
                                 if (CCExpressionGetInteger(JITExpr))
                                 {
-                                    HKHubArchProcessorCache(Processor, 0);
+                                    HKHubArchProcessorCache(Processor, ((Processor->debug.context) || (HKHubArchProcessorHasBreakpoints(Processor))) ? HKHubArchJITOptionsDebug : 0);
                                 }
                             }
                             
@@ -23,34 +23,101 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#if defined(__linux__)
+//Needed for memfd_create
+#define _GNU_SOURCE
+#endif
+
 #include "HubArchJIT.h"
 #include "HubArchProcessor.h"
 #include "HubArchInstruction.h"
+#include <threads.h>
+#include <stdatomic.h>
 
 #if CC_PLATFORM_OS_X
 #include <mach/mach.h>
 #include <mach/mach_vm.h>
 
-#if CC_HARDWARE_ARCH_X86_64
-#define HK_HUB_ARCH_JIT 1
+#define HK_HUB_ARCH_JIT_EXECUTABLE_MACH 1
+#elif CC_PLATFORM_UNIX || CC_PLATFORM_POSIX_COMPLIANT
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+#define HK_HUB_ARCH_JIT_EXECUTABLE_MMAN 1
 #endif
+
+#if (HK_HUB_ARCH_JIT_EXECUTABLE_MACH || HK_HUB_ARCH_JIT_EXECUTABLE_MMAN) && CC_HARDWARE_ARCH_X86_64
+#define HK_HUB_ARCH_JIT 1
 #endif
 
-extern _Bool HKHubArchJITGenerateBlock(HKHubArchJIT JIT, HKHubArchJITBlock *JITBlock, void *Ptr, CCLinkedList(HKHubArchExecutionGraphInstruction) Block, HKHubArchJITOptions Options);
+extern size_t HKHubArchJITGenerateBlock(HKHubArchJIT JIT, HKHubArchJITBlock *JITBlock, uint8_t *Ptr, size_t Capacity, const HKHubArchExecutionGraphInstruction *Block, size_t Count, HKHubArchJITOptions Options);
 extern void HKHubArchJITRemoveEntry(void *Entry);
+extern void HKHubArchJITDisableFastPath(void *Check);
+extern _Bool HKHubArchJITLinkExit(void *Exit, uintptr_t Address, uintptr_t Target);
+extern void HKHubArchJITUnlinkExit(void *Exit);
+
+#define HK_HUB_ARCH_JIT_ARENA_CHUNK_SIZE 65536
+#define HK_HUB_ARCH_JIT_ARENA_MIN_SLOT_SIZE 64
+#define HK_HUB_ARCH_JIT_ARENA_MAX_SLOT_SIZE (HK_HUB_ARCH_JIT_ARENA_CHUNK_SIZE / 4)
+#define HK_HUB_ARCH_JIT_ARENA_CLASS_COUNT 9
+
+_Static_assert((HK_HUB_ARCH_JIT_ARENA_MIN_SLOT_SIZE << (HK_HUB_ARCH_JIT_ARENA_CLASS_COUNT - 1)) == HK_HUB_ARCH_JIT_ARENA_MAX_SLOT_SIZE, "Size classes must cover every slot size");
 
-static void *HKHubArchJITAllocateExecutable(size_t Size)
+/*
+ Executable memory is managed as a set of chunks, each of which is split into equal sized slots for one size class
+ (powers of 2 from 64 to 16384 bytes). A bitmap tracks a chunk's free slots, so a released slot is reused by the next
+ allocation of that size class. Chunks that have free slots are kept in a list for their size class, and an empty
+ chunk is released unless it's the only chunk left for its size class.
+ 
+ Chunks are aligned to their size, and the first slot of every chunk holds a pointer to the chunk. So the chunk of
+ any allocation is found by aligning its address down, without taking the lock.
+ 
+ Chunks have two views of the same memory. Code is written through the writable view and run from the executable
+ view, so pages never need to be toggled while other processors (possibly on other threads) are running code from
+ the same chunk. On mach the memory is mapped RWX so both views are the same.
+ */
+typedef struct HKHubArchJITArenaChunk {
+    struct HKHubArchJITArenaChunk *prev;
+    struct HKHubArchJITArenaChunk *next;
+    uint8_t *code;
+    uint8_t *write;
+    size_t sizeClass;
+    size_t allocations;
+    /// The free slots are set
+    uint64_t free[HK_HUB_ARCH_JIT_ARENA_CHUNK_SIZE / HK_HUB_ARCH_JIT_ARENA_MIN_SLOT_SIZE / 64];
+} HKHubArchJITArenaChunk;
+
+static struct {
+    /// The chunks of each size class that have free slots
+    HKHubArchJITArenaChunk *chunks[HK_HUB_ARCH_JIT_ARENA_CLASS_COUNT];
+    mtx_t lock;
+} HKHubArchJITArena = { .chunks = { NULL } };
+
+static once_flag HKHubArchJITArenaInitialized = ONCE_FLAG_INIT;
+
+static void HKHubArchJITArenaInit(void)
 {
-#if CC_PLATFORM_OS_X
-    //TODO: Setup an allocator, then allocate a large chunk and reference check the blocks (so any that can be shared will be).
+    int err;
+    if ((err = mtx_init(&HKHubArchJITArena.lock, mtx_plain)) != thrd_success) CC_LOG_ERROR("Failed to create jit arena lock (%d)", err);
+}
+
+static _Bool HKHubArchJITArenaChunkMap(HKHubArchJITArenaChunk *Chunk, size_t Size)
+{
+#if HK_HUB_ARCH_JIT_EXECUTABLE_MACH
     mach_vm_address_t Address = 0;
-    mach_error_t err = mach_vm_allocate(mach_task_self(), &Address, Size, VM_FLAGS_ANYWHERE);
+    mach_error_t err = mach_vm_map(mach_task_self(), &Address, Size, Size - 1, VM_FLAGS_ANYWHERE, MEMORY_OBJECT_NULL, 0, FALSE, VM_PROT_READ | VM_PROT_WRITE, VM_PROT_ALL, VM_INHERIT_DEFAULT);
     if (err == KERN_SUCCESS)
     {
         err = mach_vm_protect(mach_task_self(), Address, Size, FALSE, VM_PROT_ALL);
         if (err == KERN_SUCCESS)
         {
-            return (void*)Address;
+            Chunk->code = (uint8_t*)Address;
+            Chunk->write = (uint8_t*)Address;
+            
+            return TRUE;
         }
         
         else
@@ -64,50 +131,415 @@ static void *HKHubArchJITAllocateExecutable(size_t Size)
     
     else
     {
-        mach_error("mach_vm_allocate", err);
+        mach_error("mach_vm_map", err);
         CC_LOG_ERROR("Failed to allocate executable memory, due to allocation failure (%zu)", Size);
     }
+#elif HK_HUB_ARCH_JIT_EXECUTABLE_MMAN
+#ifdef MFD_CLOEXEC
+    const int Shm = memfd_create("hk-jit", MFD_CLOEXEC);
+#else
+    static atomic_size_t Counter = 0;
+    
+    char Name[64];
+    snprintf(Name, sizeof(Name), "/hk-jit-%ld-%zu", (long)getpid(), atomic_fetch_add_explicit(&Counter, 1, memory_order_relaxed));
+    
+    const int Shm = shm_open(Name, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+    if (Shm != -1) shm_unlink(Name);
 #endif
     
-    return NULL;
+    if (Shm != -1)
+    {
+        if (!ftruncate(Shm, Size))
+        {
+            //Twice the size is reserved so an aligned range can be mapped within it
+            uint8_t *Reserved = mmap(NULL, Size * 2, PROT_NONE, MAP_PRIVATE | MAP_ANON, -1, 0);
+            if (Reserved != MAP_FAILED)
+            {
+                uint8_t *Aligned = (uint8_t*)(((uintptr_t)Reserved + (Size - 1)) & ~(uintptr_t)(Size - 1));
+                
+                if (Aligned != Reserved) munmap(Reserved, Aligned - Reserved);
+                munmap(Aligned + Size, (Reserved + (Size * 2)) - (Aligned + Size));
+                
+                void *Code = mmap(Aligned, Size, PROT_READ | PROT_EXEC, MAP_SHARED | MAP_FIXED, Shm, 0);
+                if (Code != MAP_FAILED)
+                {
+                    void *Write = mmap(NULL, Size, PROT_READ | PROT_WRITE, MAP_SHARED, Shm, 0);
+                    if (Write != MAP_FAILED)
+                    {
+                        close(Shm);
+                        
+                        Chunk->code = Code;
+                        Chunk->write = Write;
+                        
+                        return TRUE;
+                    }
+                    
+                    else CC_LOG_ERROR("Failed to allocate executable memory, due to allocation failure (%zu) (%d)", Size, errno);
+                    
+                    munmap(Code, Size);
+                }
+                
+                else
+                {
+                    CC_LOG_ERROR("Failed to allocate executable memory, due to memory protection error (%d)", errno);
+                    
+                    munmap(Aligned, Size);
+                }
+            }
+            
+            else CC_LOG_ERROR("Failed to allocate executable memory, due to allocation failure (%zu) (%d)", Size, errno);
+        }
+        
+        else CC_LOG_ERROR("Failed to allocate executable memory, due to allocation failure (%zu) (%d)", Size, errno);
+        
+        close(Shm);
+    }
+    
+    else CC_LOG_ERROR("Failed to allocate executable memory, due to shared memory failure (%d)", errno);
+#endif
+    
+    return FALSE;
 }
 
-static void HKHubArchJITDeallocateExecutable(void *Ptr, size_t Size)
+static void HKHubArchJITArenaChunkUnmap(HKHubArchJITArenaChunk *Chunk, size_t Size)
 {
-#if CC_PLATFORM_OS_X
-    mach_vm_deallocate(mach_task_self(), (mach_vm_address_t)Ptr, Size);
+#if HK_HUB_ARCH_JIT_EXECUTABLE_MACH
+    mach_vm_deallocate(mach_task_self(), (mach_vm_address_t)Chunk->code, Size);
+#elif HK_HUB_ARCH_JIT_EXECUTABLE_MMAN
+    munmap(Chunk->write, Size);
+    munmap(Chunk->code, Size);
 #endif
 }
 
+static CC_FORCE_INLINE HKHubArchJITArenaChunk *HKHubArchJITArenaFindChunk(const void *Ptr)
+{
+    return *(HKHubArchJITArenaChunk**)((uintptr_t)Ptr & ~(uintptr_t)(HK_HUB_ARCH_JIT_ARENA_CHUNK_SIZE - 1));
+}
+
+static CC_FORCE_INLINE size_t HKHubArchJITArenaSlotSize(size_t SizeClass)
+{
+    return HK_HUB_ARCH_JIT_ARENA_MIN_SLOT_SIZE << SizeClass;
+}
+
+static CC_FORCE_INLINE size_t HKHubArchJITArenaSlotCount(size_t SizeClass)
+{
+    //The first slot holds the chunk pointer
+    return (HK_HUB_ARCH_JIT_ARENA_CHUNK_SIZE / HKHubArchJITArenaSlotSize(SizeClass)) - 1;
+}
+
+static void HKHubArchJITArenaListRemove(HKHubArchJITArenaChunk *Chunk)
+{
+    if (Chunk->prev) Chunk->prev->next = Chunk->next;
+    else HKHubArchJITArena.chunks[Chunk->sizeClass] = Chunk->next;
+    
+    if (Chunk->next) Chunk->next->prev = Chunk->prev;
+    
+    Chunk->prev = NULL;
+    Chunk->next = NULL;
+}
+
+static void HKHubArchJITArenaListInsert(HKHubArchJITArenaChunk *Chunk)
+{
+    Chunk->prev = NULL;
+    Chunk->next = HKHubArchJITArena.chunks[Chunk->sizeClass];
+    
+    if (Chunk->next) Chunk->next->prev = Chunk;
+    
+    HKHubArchJITArena.chunks[Chunk->sizeClass] = Chunk;
+}
+
+static HKHubArchJITArenaChunk *HKHubArchJITArenaChunkCreate(size_t SizeClass)
+{
+    HKHubArchJITArenaChunk *Chunk = CCMalloc(CC_STD_ALLOCATOR, sizeof(HKHubArchJITArenaChunk), NULL, CC_DEFAULT_ERROR_CALLBACK);
+    if (!Chunk)
+    {
+        CC_LOG_ERROR("Failed to allocate jit arena chunk, due to allocation failure (%zu)", sizeof(HKHubArchJITArenaChunk));
+        return NULL;
+    }
+    
+    if (!HKHubArchJITArenaChunkMap(Chunk, HK_HUB_ARCH_JIT_ARENA_CHUNK_SIZE))
+    {
+        CCFree(Chunk);
+        return NULL;
+    }
+    
+    Chunk->sizeClass = SizeClass;
+    Chunk->allocations = 0;
+    
+    memset(Chunk->free, 0, sizeof(Chunk->free));
+    for (size_t Slot = 1, Count = HKHubArchJITArenaSlotCount(SizeClass); Slot <= Count; Slot++) Chunk->free[Slot / 64] |= UINT64_C(1) << (Slot % 64);
+    
+    *(HKHubArchJITArenaChunk**)Chunk->write = Chunk;
+    
+    HKHubArchJITArenaListInsert(Chunk);
+    
+    return Chunk;
+}
+
+/*!
+ * @brief Allocate executable memory from the arena.
+ * @param Size The exact size of the code.
+ * @param Writable The writable view of the allocated memory.
+ * @return The executable view of the allocated memory, or NULL on failure. Must be released with
+ *         @b HKHubArchJITArenaRelease.
+ */
+static void *HKHubArchJITArenaAllocate(size_t Size, void **Writable)
+{
+    CCAssertLog(Size <= HK_HUB_ARCH_JIT_ARENA_MAX_SLOT_SIZE, "Size must not exceed the largest slot size");
+    
+    call_once(&HKHubArchJITArenaInitialized, HKHubArchJITArenaInit);
+    
+    size_t SizeClass = 0;
+    while (HKHubArchJITArenaSlotSize(SizeClass) < Size) SizeClass++;
+    
+    mtx_lock(&HKHubArchJITArena.lock);
+    
+    HKHubArchJITArenaChunk *Chunk = HKHubArchJITArena.chunks[SizeClass];
+    if (!Chunk) Chunk = HKHubArchJITArenaChunkCreate(SizeClass);
+    
+    void *Code = NULL;
+    if (Chunk)
+    {
+        size_t Slot = 0;
+        for (size_t Loop = 0; Loop < sizeof(Chunk->free) / sizeof(*Chunk->free); Loop++)
+        {
+            if (Chunk->free[Loop])
+            {
+                Slot = (Loop * 64) + __builtin_ctzll(Chunk->free[Loop]);
+                break;
+            }
+        }
+        
+        Chunk->free[Slot / 64] &= ~(UINT64_C(1) << (Slot % 64));
+        
+        if (++Chunk->allocations == HKHubArchJITArenaSlotCount(SizeClass)) HKHubArchJITArenaListRemove(Chunk);
+        
+        const size_t Offset = Slot * HKHubArchJITArenaSlotSize(SizeClass);
+        
+        Code = Chunk->code + Offset;
+        *Writable = Chunk->write + Offset;
+    }
+    
+    mtx_unlock(&HKHubArchJITArena.lock);
+    
+    return Code;
+}
+
+/*!
+ * @brief Release executable memory back to the arena.
+ * @param Ptr The executable memory returned from @b HKHubArchJITArenaAllocate.
+ */
+static void HKHubArchJITArenaRelease(void *Ptr)
+{
+    HKHubArchJITArenaChunk *Chunk = HKHubArchJITArenaFindChunk(Ptr);
+    CCAssertLog(Chunk, "Ptr must be allocated from the arena");
+    
+    const size_t Slot = ((uint8_t*)Ptr - Chunk->code) / HKHubArchJITArenaSlotSize(Chunk->sizeClass);
+    
+    mtx_lock(&HKHubArchJITArena.lock);
+    
+    Chunk->free[Slot / 64] |= UINT64_C(1) << (Slot % 64);
+    
+    if (Chunk->allocations-- == HKHubArchJITArenaSlotCount(Chunk->sizeClass)) HKHubArchJITArenaListInsert(Chunk);
+    
+    if ((!Chunk->allocations) && ((Chunk->prev) || (Chunk->next)))
+    {
+        HKHubArchJITArenaListRemove(Chunk);
+        HKHubArchJITArenaChunkUnmap(Chunk, HK_HUB_ARCH_JIT_ARENA_CHUNK_SIZE);
+        CCFree(Chunk);
+    }
+    
+    mtx_unlock(&HKHubArchJITArena.lock);
+}
+
+/*!
+ * @brief Get the writable view of some executable memory.
+ * @param Ptr The executable memory returned from @b HKHubArchJITArenaAllocate.
+ * @return The writable view.
+ */
+static void *HKHubArchJITArenaGetWritable(void *Ptr)
+{
+    const HKHubArchJITArenaChunk *Chunk = HKHubArchJITArenaFindChunk(Ptr);
+    CCAssertLog(Chunk, "Ptr must be allocated from the arena");
+    
+    return Chunk->write + ((uint8_t*)Ptr - Chunk->code);
+}
+
+/*!
+ * @brief Copy generated code into executable memory.
+ * @param Block The block to copy the code to. The code and map entries will be relocated to the new memory.
+ * @param Ptr The code.
+ * @param Size The size of the code.
+ * @return Whether the code could be copied or not.
+ */
+static _Bool HKHubArchJITArenaCopy(HKHubArchJITBlock *Block, const void *Ptr, size_t Size)
+{
+    void *Writable;
+    void *Code = HKHubArchJITArenaAllocate(Size, &Writable);
+    if (!Code) return FALSE;
+    
+    memcpy(Writable, Ptr, Size);
+    
+    for (size_t Loop = 0, Count = CCArrayGetCount(Block->map); Loop < Count; Loop++)
+    {
+        HKHubArchJITBlockRelativeEntry *Entry = CCArrayGetElementAtIndex(Block->map, Loop);
+        Entry->entry = (Entry->entry - (uintptr_t)Ptr) + (uintptr_t)Code;
+    }
+    
+    Block->code = (uintptr_t)Code;
+    Block->size = Size;
+    
+    return TRUE;
+}
+
 CC_ARRAY_DECLARE(HKHubArchInstructionState);
 
-static void HKHubArchJITBlockAssetRegister(CCArray(HKHubArchInstructionState) Instructions, HKHubArchJITBlock *CC_RETAIN(Block));
-static CC_NEW HKHubArchJITBlock *HKHubArchJITBlockAssetCreate(CCLinkedList(HKHubArchExecutionGraphInstruction) Instructions);
+static void HKHubArchJITBlockAssetRegister(CCArray(HKHubArchInstructionState) Instructions, HKHubArchJITOptions Options, HKHubArchJITBlock *CC_RETAIN(Block));
+static CC_NEW HKHubArchJITBlock *HKHubArchJITBlockAssetCreate(const HKHubArchExecutionGraphInstruction *Instructions, size_t Count, HKHubArchJITOptions Options);
+
+/*
+ Large enough for a full block of straight-line code along with its fast path. Blocks that would not fit are ended
+ early by the generator, leaving the remaining instructions to the interpreter.
+ */
+#define HK_HUB_ARCH_JIT_MAX_BLOCK_SIZE 16384
 
-#define HK_HUB_ARCH_JIT_BLOCK_SIZE 1024
+_Static_assert(HK_HUB_ARCH_JIT_MAX_BLOCK_SIZE <= HK_HUB_ARCH_JIT_ARENA_MAX_SLOT_SIZE, "Blocks must fit in the largest arena slot");
 
 static void HKHubArchJITBlockDestructor(HKHubArchJITBlock *Block)
 {
     CCArrayDestroy(Block->map);
-    HKHubArchJITDeallocateExecutable((void*)Block->code, HK_HUB_ARCH_JIT_BLOCK_SIZE);
+    if (Block->exits) CCArrayDestroy(Block->exits);
+    CCArrayDestroy(Block->checks);
+    HKHubArchJITArenaRelease((void*)Block->code);
+}
+
+static void HKHubArchJITLinkBlock(HKHubArchJIT JIT, HKHubArchJITBlock *Block)
+{
+    if (Block->cached) return;
+    
+    for (size_t Loop = 0, Count = CCArrayGetCount(Block->exits); Loop < Count; Loop++)
+    {
+        const HKHubArchJITBlockExit *Exit = CCArrayGetElementAtIndex(Block->exits, Loop);
+        const HKHubArchJITBlockReferenceEntry *Target = &JIT->entries[Exit->pc];
+        
+        if (Target->block)
+        {
+            const uintptr_t Address = Block->code + Exit->offset;
+            
+#if CC_HARDWARE_ARCH_X86_64
+            if (HKHubArchJITLinkExit(HKHubArchJITArenaGetWritable((void*)Address), Address, Target->entry))
+            {
+                CCArrayAppendElement(JIT->links, &(HKHubArchJITLink){ .block = CCRetain(Block), .offset = Exit->offset, .pc = Exit->pc });
+            }
+#endif
+        }
+    }
+}
+
+static void HKHubArchJITUnlink(HKHubArchJIT JIT, uint8_t Offset)
+{
+    for (size_t Loop = 0; Loop < CCArrayGetCount(JIT->links); )
+    {
+        HKHubArchJITLink *Link = CCArrayGetElementAtIndex(JIT->links, Loop);
+        if (Link->pc == Offset)
+        {
+#if CC_HARDWARE_ARCH_X86_64
+            HKHubArchJITUnlinkExit(HKHubArchJITArenaGetWritable((void*)(Link->block->code + Link->offset)));
+#endif
+            CCFree(Link->block);
+            
+            const size_t Last = CCArrayGetCount(JIT->links) - 1;
+            if (Loop != Last) CCArrayReplaceElementAtIndex(JIT->links, Loop, CCArrayGetElementAtIndex(JIT->links, Last));
+            CCArrayRemoveElementAtIndex(JIT->links, Last);
+        }
+        
+        else Loop++;
+    }
+}
+
+static void HKHubArchJITClearEntry(HKHubArchJIT JIT, uint8_t Offset)
+{
+    HKHubArchJITBlockReferenceEntry *Entry = &JIT->entries[Offset];
+    
+    HKHubArchJITUnlink(JIT, Offset);
+    
+    const uint8_t Size = Entry->size;
+    for (uint8_t Loop = 0; Loop < Size; Loop++)
+    {
+        const uint8_t Byte = Offset + Loop;
+        if (JIT->start[Byte] == Offset) JIT->start[Byte] = Byte;
+    }
+    
+    CCFree(Entry->block);
+    *Entry = (HKHubArchJITBlockReferenceEntry){ .block = NULL };
+    
+    for (uint8_t Loop = 0; Loop < Size; Loop++)
+    {
+        const uint8_t Byte = Offset + Loop;
+        if ((!JIT->entries[JIT->start[Byte]].block) && (!JIT->entries[Byte].block)) JIT->code[Byte / 8] &= ~(1 << (Byte % 8));
+    }
+}
+
+static void HKHubArchJITSetEntry(HKHubArchJIT JIT, uint8_t Offset, HKHubArchJITBlockReferenceEntry Entry)
+{
+    if (JIT->entries[Offset].block) HKHubArchJITClearEntry(JIT, Offset);
+    
+    JIT->entries[Offset] = Entry;
+    
+    for (uint8_t Loop = 0; Loop < Entry.size; Loop++)
+    {
+        const uint8_t Byte = Offset + Loop;
+        
+        JIT->start[Byte] = Offset;
+        JIT->code[Byte / 8] |= 1 << (Byte % 8);
+    }
+}
+
+static uint8_t HKHubArchJITEntrySize(const HKHubArchExecutionGraphInstruction *Instruction, size_t Count)
+{
+    /*
+     A leader's code may also contain its fused instructions (the followers have no entry of their own), so the
+     entry covers any instructions that could have been fused with it. This is determined from the instructions
+     rather than the graph's fusion, as a cached block may have been fused by another graph.
+     */
+    uint8_t Size = HKHubArchInstructionSizeOfEncoding(&Instruction->state);
+    
+    HKHubArchInstructionLoweredState Lowered;
+    HKHubArchInstructionLower(&Instruction->state, &Lowered);
+    
+    if ((Lowered.handler >= HKHubArchInstructionHandlerAddRR) && (Lowered.handler <= HKHubArchInstructionHandlerAndRI))
+    {
+        for (size_t Loop = 1; (Loop < Count) && (Loop < HK_HUB_ARCH_EXECUTION_GRAPH_FUSION_MAX); Loop++)
+        {
+            HKHubArchInstructionLower(&Instruction[Loop].state, &Lowered);
+            
+            if ((Lowered.handler == HKHubArchInstructionHandlerBranch) || ((Lowered.handler >= HKHubArchInstructionHandlerMovRR) && (Lowered.handler <= HKHubArchInstructionHandlerAndRI))) Size += HKHubArchInstructionSizeOfEncoding(&Instruction[Loop].state);
+            
+            if ((Lowered.handler < HKHubArchInstructionHandlerMovRR) || (Lowered.handler > HKHubArchInstructionHandlerAndRI)) break;
+        }
+    }
+    
+    return Size;
 }
 
 static void HKHubArchJITGenerate(HKHubArchJIT JIT, HKHubArchExecutionGraph Graph, HKHubArchJITOptions Options)
 {
     const _Bool Cache = Options & HKHubArchJITOptionsCache;
+    CCArray(HKHubArchJITBlock *) Generated = CCArrayCreate(CC_STD_ALLOCATOR, sizeof(HKHubArchJITBlock*), 16);
+    
     for (size_t Loop = 0, Count = CCArrayGetCount(Graph->block); Loop < Count; Loop++)
     {
-        CCLinkedList(HKHubArchExecutionGraphInstruction) Instruction = *(CCLinkedList*)CCArrayGetElementAtIndex(Graph->block, Loop);
-        HKHubArchJITBlock *CachedBlock = HKHubArchJITBlockAssetCreate(Instruction);
+        const HKHubArchExecutionGraphInstruction *Instructions = HKHubArchExecutionGraphGetBlockInstructions(Graph, Loop);
+        const size_t InstructionCount = ((HKHubArchExecutionGraphBlock*)CCArrayGetElementAtIndex(Graph->block, Loop))->count;
+        HKHubArchJITBlock *CachedBlock = HKHubArchJITBlockAssetCreate(Instructions, InstructionCount, Options);
         
         if (CachedBlock)
         {
-            for (size_t Loop = 0, Index = 0, Count = CCArrayGetCount(CachedBlock->map); Loop < Count; Loop++)
+            for (size_t Loop = 0, Count = CCArrayGetCount(CachedBlock->map); Loop < Count; Loop++)
             {
                 const HKHubArchJITBlockRelativeEntry *Entry = CCArrayGetElementAtIndex(CachedBlock->map, Loop);
-                for ( ; Entry->index != Index; Index++) Instruction = CCLinkedListEnumerateNext(Instruction);
                 
-                CCDictionarySetValue(JIT->map, &(uint8_t){ ((HKHubArchExecutionGraphInstruction*)CCLinkedListGetNodeData(Instruction))->offset }, &(HKHubArchJITBlockReferenceEntry){ .entry = Entry->entry, .block = CCRetain(CachedBlock), .size = HKHubArchInstructionSizeOfEncoding(&((HKHubArchExecutionGraphInstruction*)CCLinkedListGetNodeData(Instruction))->state) });
+                HKHubArchJITSetEntry(JIT, Instructions[Entry->index].offset, (HKHubArchJITBlockReferenceEntry){ .entry = Entry->entry, .block = CCRetain(CachedBlock), .size = HKHubArchJITEntrySize(&Instructions[Entry->index], InstructionCount - Entry->index) });
             }
             
             CCFree(CachedBlock);
@@ -115,76 +547,106 @@ static void HKHubArchJITGenerate(HKHubArchJIT JIT, HKHubArchExecutionGraph Graph
         
         else
         {
-            const size_t Size = HK_HUB_ARCH_JIT_BLOCK_SIZE; // TODO: calculate size required?
-            void *Ptr = HKHubArchJITAllocateExecutable(Size);
-            if (Ptr)
-            {
-                HKHubArchJITBlock Block = { .code = (uintptr_t)Ptr, .map = CCArrayCreate(CC_STD_ALLOCATOR, sizeof(HKHubArchJITBlockRelativeEntry), 4), .cached = Cache };
-                
+            uint8_t Code[HK_HUB_ARCH_JIT_MAX_BLOCK_SIZE];
+            HKHubArchJITBlock Block = { .code = (uintptr_t)Code, .map = CCArrayCreate(CC_STD_ALLOCATOR, sizeof(HKHubArchJITBlockRelativeEntry), 4), .exits = CCArrayCreate(CC_STD_ALLOCATOR, sizeof(HKHubArchJITBlockExit), 4), .checks = CCArrayCreate(CC_STD_ALLOCATOR, sizeof(size_t), 4), .cached = Cache };
+            
 #if CC_HARDWARE_ARCH_X86_64
-                const _Bool Generated = HKHubArchJITGenerateBlock(JIT, &Block, Ptr, Instruction, Options);
+            const size_t Size = HKHubArchJITGenerateBlock(JIT, &Block, Code, sizeof(Code), Instructions, InstructionCount, Options);
 #endif
+            
+            if ((Size) && (HKHubArchJITArenaCopy(&Block, Code, Size)))
+            {
+                CC_SAFE_Malloc(CachedBlock, sizeof(HKHubArchJITBlock),
+                               CCArrayDestroy(Block.map);
+                               CCArrayDestroy(Block.exits);
+                               CCArrayDestroy(Block.checks);
+                               HKHubArchJITArenaRelease((void*)Block.code);
+                               continue;
+                               );
+                
+                *CachedBlock = Block;
+                
+                CCMemorySetDestructor(CachedBlock, (CCMemoryDestructorCallback)HKHubArchJITBlockDestructor);
                 
-                if (Generated)
+                for (size_t Loop = 0, Count = CCArrayGetCount(Block.map); Loop < Count; Loop++)
                 {
-                    CCArray(HKHubArchInstructionState) Instructions = NULL;
+                    const HKHubArchJITBlockRelativeEntry *Entry = CCArrayGetElementAtIndex(Block.map, Loop);
                     
-                    CC_SAFE_Malloc(CachedBlock, sizeof(HKHubArchJITBlock),
-                                   CCArrayDestroy(Block.map);
-                                   HKHubArchJITDeallocateExecutable(Ptr, Size);
-                                   continue;
-                                   );
-                    
-                    *CachedBlock = Block;
-                    
-                    CCMemorySetDestructor(CachedBlock, (CCMemoryDestructorCallback)HKHubArchJITBlockDestructor);
-                    
-                    if (Cache)
-                    {
-                        Instructions = CCArrayCreate(CC_STD_ALLOCATOR, sizeof(HKHubArchInstructionState), 8);
-                        CCArrayAppendElement(Instructions, &((HKHubArchExecutionGraphInstruction*)CCLinkedListGetNodeData(Instruction))->state);
-                    }
-                    
-                    for (size_t Loop = 0, Index = 0, Count = CCArrayGetCount(Block.map); Loop < Count; Loop++)
-                    {
-                        const HKHubArchJITBlockRelativeEntry *Entry = CCArrayGetElementAtIndex(Block.map, Loop);
-                        for ( ; Entry->index != Index; Index++)
-                        {
-                            Instruction = CCLinkedListEnumerateNext(Instruction);
-                            if (Cache) CCArrayAppendElement(Instructions, &((HKHubArchExecutionGraphInstruction*)CCLinkedListGetNodeData(Instruction))->state);
-                        }
-                        
-                        CCDictionarySetValue(JIT->map, &(uint8_t){ ((HKHubArchExecutionGraphInstruction*)CCLinkedListGetNodeData(Instruction))->offset }, &(HKHubArchJITBlockReferenceEntry){ .entry = Entry->entry, .block = CCRetain(CachedBlock), .size = HKHubArchInstructionSizeOfEncoding(&((HKHubArchExecutionGraphInstruction*)CCLinkedListGetNodeData(Instruction))->state) });
-                    }
+                    HKHubArchJITSetEntry(JIT, Instructions[Entry->index].offset, (HKHubArchJITBlockReferenceEntry){ .entry = Entry->entry, .block = CCRetain(CachedBlock), .size = HKHubArchJITEntrySize(&Instructions[Entry->index], InstructionCount - Entry->index) });
+                }
+                
+                if (Cache)
+                {
+                    CCArray(HKHubArchInstructionState) States = CCArrayCreate(CC_STD_ALLOCATOR, sizeof(HKHubArchInstructionState), InstructionCount);
                     
-                    if (Cache)
-                    {
-                        while ((Instruction = CCLinkedListEnumerateNext(Instruction))) CCArrayAppendElement(Instructions, &((HKHubArchExecutionGraphInstruction*)CCLinkedListGetNodeData(Instruction))->state);
-                        
-                        HKHubArchJITBlockAssetRegister(Instructions, CachedBlock);
-                    }
+                    for (size_t Loop = 0; Loop < InstructionCount; Loop++) CCArrayAppendElement(States, &Instructions[Loop].state);
                     
-                    CCFree(CachedBlock);
+                    HKHubArchJITBlockAssetRegister(States, Options, CachedBlock);
                 }
                 
-                else
+                else CCArrayAppendElement(Generated, &(HKHubArchJITBlock*){ CCRetain(CachedBlock) });
+                
+                CCFree(CachedBlock);
+            }
+            
+            else
+            {
+                CCArrayDestroy(Block.map);
+                CCArrayDestroy(Block.exits);
+                CCArrayDestroy(Block.checks);
+            }
+        }
+    }
+    
+    if (Options & HKHubArchJITOptionsWatchMemory)
+    {
+        /*
+         Stores to a literal address have no check in the generated code, so any code they may write to is
+         invalidated up front.
+         */
+        for (size_t Loop = 0, Count = CCArrayGetCount(Graph->instruction); Loop < Count; Loop++)
+        {
+            const HKHubArchInstructionState *State = &((HKHubArchExecutionGraphInstruction*)CCArrayGetElementAtIndex(Graph->instruction, Loop))->state;
+            const HKHubArchInstructionMemoryOperation MemoryOp = HKHubArchInstructionGetMemoryOperation(State);
+            
+            for (size_t Operand = 0; Operand < 3; Operand++)
+            {
+                if ((((MemoryOp >> (Operand * 2)) & HKHubArchInstructionMemoryOperationDst)) && (State->operand[Operand].type == HKHubArchInstructionOperandM) && (State->operand[Operand].memory.type == HKHubArchInstructionMemoryOffset))
                 {
-                    CCArrayDestroy(Block.map);
-                    HKHubArchJITDeallocateExecutable(Ptr, Size);
+                    HKHubArchJITInvalidateBlocks(JIT, State->operand[Operand].memory.offset, 1);
                 }
             }
         }
     }
+    
+    /*
+     All of the blocks are generated up front, so exits can be linked directly to their target blocks once they
+     have all been generated.
+     */
+    for (size_t Loop = 0, Count = CCArrayGetCount(Generated); Loop < Count; Loop++)
+    {
+        HKHubArchJITBlock *Block = *(HKHubArchJITBlock**)CCArrayGetElementAtIndex(Generated, Loop);
+        
+        HKHubArchJITLinkBlock(JIT, Block);
+        CCFree(Block);
+    }
+    
+    CCArrayDestroy(Generated);
 }
 
 static void HKHubArchJITDestructor(HKHubArchJIT JIT)
 {
-    CCDictionaryDestroy(JIT->map);
-}
-
-void HKHubArchJITBlockReferenceEntryElementDestructor(CCDictionary Dictionary, HKHubArchJITBlockReferenceEntry *Element)
-{
-    CCFree(Element->block);
+    for (size_t Loop = 0, Count = CCArrayGetCount(JIT->links); Loop < Count; Loop++)
+    {
+        CCFree(((HKHubArchJITLink*)CCArrayGetElementAtIndex(JIT->links, Loop))->block);
+    }
+    
+    CCArrayDestroy(JIT->links);
+    
+    for (size_t Loop = 0; Loop < 256; Loop++)
+    {
+        if (JIT->entries[Loop].block) CCFree(JIT->entries[Loop].block);
+    }
 }
 
 HKHubArchJIT HKHubArchJITCreate(CCAllocatorType Allocator, HKHubArchExecutionGraph Graph, HKHubArchJITOptions Options)
@@ -196,11 +658,13 @@ HKHubArchJIT HKHubArchJITCreate(CCAllocatorType Allocator, HKHubArchExecutionGra
     
     if (JIT)
     {
-        *JIT = (HKHubArchJITInfo){
-            .map = CCDictionaryCreate(Allocator, CCDictionaryHintSizeMedium | CCDictionaryHintConstantElements | CCDictionaryHintConstantLength | CCDictionaryHintHeavyFinding, sizeof(uint8_t), sizeof(HKHubArchJITBlockReferenceEntry), &(CCDictionaryCallbacks){
-                .valueDestructor = (CCDictionaryElementDestructor)HKHubArchJITBlockReferenceEntryElementDestructor
-            })
-        };
+        memset(JIT->code, 0, sizeof(JIT->code));
+        memset(JIT->entries, 0, sizeof(JIT->entries));
+        memset(&JIT->breakpoints, 0, sizeof(JIT->breakpoints));
+        for (size_t Loop = 0; Loop < 256; Loop++) JIT->start[Loop] = (uint8_t)Loop;
+        
+        JIT->links = CCArrayCreate(Allocator, sizeof(HKHubArchJITLink), 8);
+        JIT->options = Options;
         
         HKHubArchJITGenerate(JIT, Graph, Options);
         
@@ -222,106 +686,124 @@ void HKHubArchJITDestroy(HKHubArchJIT JIT)
     CCFree(JIT);
 }
 
-void HKHubArchJITInvalidateBlocks(HKHubArchJIT JIT, uint8_t Offset, size_t Size)
+static void HKHubArchJITInvalidateEntry(HKHubArchJIT JIT, uint8_t Offset)
 {
-    for (size_t Loop = 0; Loop < Size; Loop++)
+    HKHubArchJITBlockReferenceEntry *Ref = &JIT->entries[Offset];
+    
+    if (!Ref->block) return;
+    
+    if (Ref->block->cached)
     {
-        CCDictionaryEntry Entry = CCDictionaryFindKey(JIT->map, &(uint8_t){ Offset + Loop });
-        const HKHubArchJITBlockReferenceEntry *Ref = CCDictionaryGetEntry(JIT->map, Entry);
+        const HKHubArchJITBlock *RefBlock = Ref->block;
         
-        /*
-         TODO: Refactor graph and jit lookup
-         */
-        if ((!Loop) && (!Ref))
+        void *Writable;
+        void *Ptr = HKHubArchJITArenaAllocate(RefBlock->size, &Writable);
+        if (Ptr)
         {
-            for (size_t Attempts = 0; Attempts < 5; Attempts++)
+            HKHubArchJITBlock *Block = CCMalloc(CC_DEFAULT_ALLOCATOR, sizeof(HKHubArchJITBlock), NULL, CC_DEFAULT_ERROR_CALLBACK);
+            if (Block)
             {
-                Entry = CCDictionaryFindKey(JIT->map, &(uint8_t){ Offset - Attempts });
-                Ref = CCDictionaryGetEntry(JIT->map, Entry);
-                if ((Ref) && (Offset < (Offset - Attempts) + Ref->size)) break;
+                *Block = (HKHubArchJITBlock){ .code = (uintptr_t)Ptr, .map = CCArrayCreate(CC_STD_ALLOCATOR, sizeof(HKHubArchJITBlockRelativeEntry), 4), .checks = CCArrayCreate(CC_STD_ALLOCATOR, sizeof(size_t), 4), .size = RefBlock->size, .cached = FALSE };
                 
-                Ref = NULL;
-            }
-        }
-        
-        if (!Ref) continue;
-        
-        if (Ref->block->cached)
-        {
-            const HKHubArchJITBlock *RefBlock = Ref->block;
-            
-            const size_t Size = HK_HUB_ARCH_JIT_BLOCK_SIZE;
-            void *Ptr = HKHubArchJITAllocateExecutable(Size);
-            if (Ptr)
-            {
-                HKHubArchJITBlock *Block = CCMalloc(CC_DEFAULT_ALLOCATOR, sizeof(HKHubArchJITBlock), NULL, CC_DEFAULT_ERROR_CALLBACK);
-                if (Block)
-                {
-                    *Block = (HKHubArchJITBlock){ .code = (uintptr_t)Ptr, .map = CCArrayCreate(CC_STD_ALLOCATOR, sizeof(HKHubArchJITBlockRelativeEntry), 4), .cached = FALSE };
-                    
-                    memcpy(Ptr, (const void*)RefBlock->code, Size);
-                    
-                    CCMemorySetDestructor(Block, (CCMemoryDestructorCallback)HKHubArchJITBlockDestructor);
-                    
-                    for (size_t Loop = 0, Count = CCArrayGetCount(RefBlock->map); Loop < Count; Loop++)
-                    {
-                        HKHubArchJITBlockRelativeEntry BlockEntry = *(const HKHubArchJITBlockRelativeEntry*)CCArrayGetElementAtIndex(RefBlock->map, Loop);
-                        BlockEntry.entry = (BlockEntry.entry - RefBlock->code) + Block->code;
-                        CCArrayAppendElement(Block->map, &BlockEntry);
-                    }
-                    
-                    CC_DICTIONARY_FOREACH_VALUE_PTR(HKHubArchJITBlockReferenceEntry, Value, JIT->map)
-                    {
-                        if (Value->block == RefBlock)
-                        {
-                            CCFree(Value->block);
-                            Value->block = CCRetain(Block);
-                            Value->entry = (Value->entry - Ref->block->code) + Block->code;
-                        }
-                    }
-                    
-                    CCFree(Block);
-                }
+                memcpy(Writable, (const void*)RefBlock->code, RefBlock->size);
                 
-                else
+                CCMemorySetDestructor(Block, (CCMemoryDestructorCallback)HKHubArchJITBlockDestructor);
+                
+                for (size_t Loop = 0, Count = CCArrayGetCount(RefBlock->map); Loop < Count; Loop++)
                 {
-                    HKHubArchJITDeallocateExecutable(Ptr, Size);
-                    
-                    goto RemoveBlock;
+                    HKHubArchJITBlockRelativeEntry BlockEntry = *(const HKHubArchJITBlockRelativeEntry*)CCArrayGetElementAtIndex(RefBlock->map, Loop);
+                    BlockEntry.entry = (BlockEntry.entry - RefBlock->code) + Block->code;
+                    CCArrayAppendElement(Block->map, &BlockEntry);
                 }
-            }
-            
-            else
-            {
-            RemoveBlock:;
-                size_t Count = 0;
-                uint8_t Keys[256];
                 
-                CC_DICTIONARY_FOREACH_VALUE_PTR(HKHubArchJITBlockReferenceEntry, Value, JIT->map)
+                for (size_t Loop = 0, Count = CCArrayGetCount(RefBlock->checks); Loop < Count; Loop++) CCArrayAppendElement(Block->checks, CCArrayGetElementAtIndex(RefBlock->checks, Loop));
+                
+                for (size_t Loop = 0; Loop < 256; Loop++)
                 {
+                    HKHubArchJITBlockReferenceEntry *Value = &JIT->entries[Loop];
                     if (Value->block == RefBlock)
                     {
-                        Keys[Count++] = *(uint8_t*)CCDictionaryGetKey(JIT->map, CCDictionaryEnumeratorGetEntry(&CC_DICTIONARY_CURRENT_VALUE_ENUMERATOR));
+                        HKHubArchJITUnlink(JIT, Loop);
+                        
+                        Value->entry = (Value->entry - RefBlock->code) + Block->code;
+                        CCFree(Value->block);
+                        Value->block = CCRetain(Block);
                     }
                 }
                 
-                for (size_t Loop = 0; Loop < Count; Loop++)
-                {
-                    CCDictionaryRemoveValue(JIT->map, &Keys[Loop]);
-                }
+                CCFree(Block);
+            }
+            
+            else
+            {
+                HKHubArchJITArenaRelease(Ptr);
                 
-                continue;
+                goto RemoveBlock;
             }
         }
         
+        else
+        {
+        RemoveBlock:
+            for (size_t Loop = 0; Loop < 256; Loop++)
+            {
+                if (JIT->entries[Loop].block == RefBlock) HKHubArchJITClearEntry(JIT, Loop);
+            }
+            
+            return;
+        }
+    }
+    
 #if CC_HARDWARE_ARCH_X86_64
-        HKHubArchJITRemoveEntry((void*)Ref->entry);
+    /*
+     The fast path has no entries of its own, so it could run past the invalidated instruction. Instead the
+     block's budget checks are disabled so it only runs the per-instruction code.
+     */
+    for (size_t Loop = 0, Count = CCArrayGetCount(Ref->block->checks); Loop < Count; Loop++)
+    {
+        HKHubArchJITDisableFastPath(HKHubArchJITArenaGetWritable((void*)(Ref->block->code + *(size_t*)CCArrayGetElementAtIndex(Ref->block->checks, Loop))));
+    }
+    
+    CCArrayRemoveAllElements(Ref->block->checks);
+    
+    HKHubArchJITRemoveEntry(HKHubArchJITArenaGetWritable((void*)Ref->entry));
 #endif
+    
+    HKHubArchJITClearEntry(JIT, Offset);
+}
+
+void HKHubArchJITInvalidateBlocks(HKHubArchJIT JIT, uint8_t Offset, size_t Size)
+{
+    for (size_t Loop = 0; Loop < Size; Loop++)
+    {
+        const uint8_t Byte = Offset + Loop;
+        
+        if (!(JIT->code[Byte / 8] & (1 << (Byte % 8)))) continue;
         
-        CCDictionaryRemoveEntry(JIT->map, Entry);
+        HKHubArchJITInvalidateEntry(JIT, JIT->start[Byte]);
+        HKHubArchJITInvalidateEntry(JIT, Byte);
     }
 }
 
+void HKHubArchJITSetBreakpoint(HKHubArchJIT JIT, uint8_t Offset, _Bool Read, _Bool Write)
+{
+    CCAssertLog(JIT, "JIT must not be null");
+    
+    const uint8_t Mask = 1 << (Offset % 8);
+    
+    if (Read)
+    {
+        JIT->breakpoints.read[Offset / 8] |= Mask;
+        
+        HKHubArchJITInvalidateBlocks(JIT, Offset, 1);
+    }
+    
+    else JIT->breakpoints.read[Offset / 8] &= ~Mask;
+    
+    if (Write) JIT->breakpoints.write[Offset / 8] |= Mask;
+    else JIT->breakpoints.write[Offset / 8] &= ~Mask;
+}
+
 #ifndef HK_HUB_ARCH_JIT
 void HKHubArchJITCall(HKHubArchJIT JIT, HKHubArchProcessor Processor)
 {
@@ -332,8 +814,12 @@ void HKHubArchJITCall(HKHubArchJIT JIT, HKHubArchProcessor Processor)
 typedef struct {
     union {
         CCArray(HKHubArchInstructionState) state;
-        CCLinkedList(HKHubArchExecutionGraphInstruction) graph;
+        struct {
+            const HKHubArchExecutionGraphInstruction *instructions;
+            size_t count;
+        } graph;
     };
+    HKHubArchJITOptions options;
     _Bool isState;
 } HKHubArchJITInstructionBlock;
 
@@ -344,6 +830,13 @@ static void HKHubArchJITInstructionBlockDestructor(HKHubArchJITInstructionBlock
     CCArrayDestroy(Instructions->state);
 }
 
+static const HKHubArchInstructionState *HKHubArchJITInstructionBlockGetState(const HKHubArchJITInstructionBlock *Instructions, size_t Index)
+{
+    if (Instructions->isState) return Index < CCArrayGetCount(Instructions->state) ? CCArrayGetElementAtIndex(Instructions->state, Index) : NULL;
+    
+    return Index < Instructions->graph.count ? &Instructions->graph.instructions[Index].state : NULL;
+}
+
 static uintmax_t HKHubArchJITInstructionBlockHasher(const HKHubArchJITInstructionBlock *Instructions)
 {
 #if UINTMAX_MAX < UINT64_MAX
@@ -354,17 +847,10 @@ static uintmax_t HKHubArchJITInstructionBlockHasher(const HKHubArchJITInstructio
     uintmax_t Hash = 0xcbf29ce484222325;
 #endif
     
-    CCEnumerable Enumerable;
-    
-    if (Instructions->isState) CCArrayGetEnumerable(Instructions->state, &Enumerable);
-    else CCLinkedListGetEnumerable(Instructions->graph, &Enumerable);
-    
-    
     size_t BitCount = 0, Loop = 0;
     uint8_t Current = 0;
-    for (const void *Instruction = CCEnumerableGetCurrent(&Enumerable); Instruction; Instruction = CCEnumerableNext(&Enumerable))
+    for (const HKHubArchInstructionState *State; (State = HKHubArchJITInstructionBlockGetState(Instructions, Loop)); )
     {
-        const HKHubArchInstructionState *State = Instructions->isState ? Instruction : &((const HKHubArchExecutionGraphInstruction*)Instruction)->state;
         const size_t FreeBits = 8 - (BitCount % 8);
         
         if (FreeBits <= 5)
@@ -395,20 +881,15 @@ static uintmax_t HKHubArchJITInstructionBlockHasher(const HKHubArchJITInstructio
 
 static CCComparisonResult HKHubArchJITInstructionBlockComparator(const HKHubArchJITInstructionBlock *a, const HKHubArchJITInstructionBlock *b)
 {
-    CCEnumerable EnumerableA, EnumerableB;
-    
-    if (a->isState) CCArrayGetEnumerable(a->state, &EnumerableA);
-    else CCLinkedListGetEnumerable(a->graph, &EnumerableA);
-    
-    if (b->isState) CCArrayGetEnumerable(b->state, &EnumerableB);
-    else CCLinkedListGetEnumerable(b->graph, &EnumerableB);
+    // The options change the code that is generated, other than whether it's cached
+    if ((a->options & ~HKHubArchJITOptionsCache) != (b->options & ~HKHubArchJITOptionsCache)) return CCComparisonResultInvalid;
     
-    for (const void *InstructionA = CCEnumerableGetCurrent(&EnumerableA), *InstructionB = CCEnumerableGetCurrent(&EnumerableB); InstructionA || InstructionB; InstructionA = CCEnumerableNext(&EnumerableA), InstructionB = CCEnumerableNext(&EnumerableB))
+    for (size_t Index = 0; ; Index++)
     {
-        if ((!InstructionA) || (!InstructionB)) return CCComparisonResultInvalid;
+        const HKHubArchInstructionState *StateA = HKHubArchJITInstructionBlockGetState(a, Index), *StateB = HKHubArchJITInstructionBlockGetState(b, Index);
         
-        const HKHubArchInstructionState *StateA = a->isState ? InstructionA : &((const HKHubArchExecutionGraphInstruction*)InstructionA)->state;
-        const HKHubArchInstructionState *StateB = b->isState ? InstructionB : &((const HKHubArchExecutionGraphInstruction*)InstructionB)->state;
+        if ((!StateA) && (!StateB)) break;
+        if ((!StateA) || (!StateB)) return CCComparisonResultInvalid;
         
         if (StateA->opcode != StateB->opcode) return CCComparisonResultInvalid;
         
@@ -478,18 +959,20 @@ const CCAssetManagerInterface HKHubArchJITBlockAssetInterface = {
 
 static CCAssetManager HKHubArchJITBlockManager = CC_ASSET_MANAGER_INIT(&HKHubArchJITBlockAssetInterface);
 
-static void HKHubArchJITBlockAssetRegister(CCArray(HKHubArchInstructionState) Instructions, HKHubArchJITBlock *Block)
+static void HKHubArchJITBlockAssetRegister(CCArray(HKHubArchInstructionState) Instructions, HKHubArchJITOptions Options, HKHubArchJITBlock *Block)
 {
     CCAssetManagerRegister(&HKHubArchJITBlockManager, &(HKHubArchJITInstructionBlock){
         .state = Instructions,
+        .options = Options,
         .isState = TRUE
     }, Block);
 }
 
-static HKHubArchJITBlock *HKHubArchJITBlockAssetCreate(CCLinkedList(HKHubArchExecutionGraphInstruction) Instructions)
+static HKHubArchJITBlock *HKHubArchJITBlockAssetCreate(const HKHubArchExecutionGraphInstruction *Instructions, size_t Count, HKHubArchJITOptions Options)
 {
     void *Asset = CCAssetManagerCreate(&HKHubArchJITBlockManager, &(HKHubArchJITInstructionBlock){
-        .graph = Instructions,
+        .graph = { .instructions = Instructions, .count = Count },
+        .options = Options,
         .isState = FALSE
     });
     
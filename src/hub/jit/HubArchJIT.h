@@ -33,7 +33,9 @@ typedef enum {
     /// Indicate that the jit block should watch for memory writes and invalidate them.
 	HKHubArchJITOptionsWatchMemory = (1 << 0),
     /// Indicate that the jit block should be cached.
-    HKHubArchJITOptionsCache = (1 << 1)
+    HKHubArchJITOptionsCache = (1 << 1),
+    /// Indicate that the jit block should exit before any breakpoints set with @b HKHubArchJITSetBreakpoint.
+    HKHubArchJITOptionsDebug = (1 << 2)
 } HKHubArchJITOptions;
 
 typedef struct {
@@ -41,9 +43,17 @@ typedef struct {
     size_t index;
 } HKHubArchJITBlockRelativeEntry;
 
+typedef struct {
+    size_t offset;
+    uint8_t pc;
+} HKHubArchJITBlockExit;
+
 typedef struct {
     CCArray(HKHubArchJITBlockRelativeEntry) map;
+    CCArray(HKHubArchJITBlockExit) exits;
+    CCArray(size_t) checks; //offsets of the budget check branches to the fast path
     uintptr_t code;
+    size_t size;
     _Bool cached;
 } HKHubArchJITBlock;
 
@@ -54,7 +64,27 @@ typedef struct {
 } HKHubArchJITBlockReferenceEntry;
 
 typedef struct {
-    CCDictionary(uint8_t, HKHubArchJITBlockReferenceEntry) map;
+    HKHubArchJITBlock *block;
+    size_t offset;
+    uint8_t pc;
+} HKHubArchJITLink;
+
+typedef struct {
+    /// A bit for each byte covered by an entry, so writes to memory only need to invalidate when they hit a set bit.
+    uint8_t code[256 / 8];
+    /// The entry points indexed by the PC of the instruction they start at. Unused entries have a NULL block.
+    HKHubArchJITBlockReferenceEntry entries[256];
+    /// The PC of the instruction covering each byte. A byte not covered by an instruction references itself.
+    uint8_t start[256];
+    /// The block exits that have been linked directly to another entry point.
+    CCArray(HKHubArchJITLink) links;
+    /// A bit for each byte that has a breakpoint, memory accesses are tested against these when generated for debugging.
+    struct {
+        uint8_t read[256 / 8];
+        uint8_t write[256 / 8];
+    } breakpoints;
+    /// The options the JIT was generated with.
+    HKHubArchJITOptions options;
 } HKHubArchJITInfo;
 
 /*!
@@ -87,4 +117,17 @@ void HKHubArchJITDestroy(HKHubArchJIT CC_DESTROY(JIT));
  */
 void HKHubArchJITInvalidateBlocks(HKHubArchJIT JIT, uint8_t Offset, size_t Size);
 
+/*!
+ * @brief Set a breakpoint the JIT should exit at.
+ * @description Only a JIT generated with @b HKHubArchJITOptionsDebug tests memory accesses against the
+ *              breakpoints. A read breakpoint also invalidates the blocks at the offset so instructions covering
+ *              it are left to the interpreter, these can't be restored so removing it requires a new JIT.
+ *
+ * @param JIT The JIT to set the breakpoint of.
+ * @param Offset The offset the breakpoint is located at.
+ * @param Read Whether reading the offset should exit.
+ * @param Write Whether writing to the offset should exit.
+ */
+void HKHubArchJITSetBreakpoint(HKHubArchJIT JIT, uint8_t Offset, _Bool Read, _Bool Write);
+
 #endif
@@ -242,6 +242,7 @@ enum {
     HKHubArchJIT0fPrefixOpcodeSetna = 0x96,
     HKHubArchJIT0fPrefixOpcodeSeta = 0x97,
     HKHubArchJIT0fPrefixOpcodeSets = 0x98,
+    HKHubArchJIT0fPrefixOpcodeBtMR = 0xa3,
     HKHubArchJIT0fPrefixOpcodeMovzxRM8 = 0xb6,
     HKHubArchJIT0fPrefixOpcodeMovsxRM8 = 0xbe
 };
@@ -522,20 +523,13 @@ static CC_FORCE_INLINE void HKHubArchJITAddInstructionArithmeticM8(uint8_t *Ptr,
 
 static CC_FORCE_INLINE void HKHubArchJITAddInstructionCall(uint8_t *Ptr, size_t *Index, uintptr_t Address, HKHubArchJITRegister Reg)
 {
-    ptrdiff_t Rel = (Address - (ptrdiff_t)(Ptr + *Index)) - 5;
-    if ((Rel < INT32_MIN) || (Rel > INT32_MAX))
-    {
-        HKHubArchJITAddInstructionMovOI64(Ptr, Index, Reg, Address);
-        Ptr[(*Index)++] = HKHubArchJITOpcodeOneOpBranchM;
-        Ptr[(*Index)++] = HKHubArchJITModRM(HKHubArchJITModRegister, HKHubArchJITOneOpBranchCall, Reg);
-    }
-    
-    else
-    {
-        Ptr[(*Index)++] = HKHubArchJITOpcodeCallD;
-        *(int32_t*)&Ptr[*Index] = (int32_t)Rel;
-        *Index += 4;
-    }
+    /*
+     Always use an absolute call so the generated code is position independent, blocks are generated into
+     a scratch buffer and then copied into executable memory.
+     */
+    HKHubArchJITAddInstructionMovOI64(Ptr, Index, Reg, Address);
+    Ptr[(*Index)++] = HKHubArchJITOpcodeOneOpBranchM;
+    Ptr[(*Index)++] = HKHubArchJITModRM(HKHubArchJITModRegister, HKHubArchJITOneOpBranchCall, Reg);
 }
 
 static CC_FORCE_INLINE void HKHubArchJITAddInstructionJumpRel8(uint8_t *Ptr, size_t *Index, HKHubArchJITJump Type, int8_t Rel8)
@@ -596,6 +590,15 @@ static void HKHubArchJITCopyFlags(uint8_t *Ptr, size_t *Index)
     HKHubArchJITCopyFlagsSCZPresetO(Ptr, Index);
 }
 
+static CC_FORCE_INLINE _Bool HKHubArchJITFlagsObservable(const HKHubArchExecutionGraphInstruction *Instruction)
+{
+    /*
+     The graph only leaves written flags out of the live set when the instructions that follow are fused and
+     overwrite them before they can be observed, so their materialisation can be skipped.
+     */
+    return Instruction->live & HKHubArchInstructionWriteFlags(&Instruction->state);
+}
+
 static void HKHubArchJITCheckCycles(uint8_t *Ptr, size_t *Index, size_t Cost, const HKHubArchExecutionGraphInstruction *Instruction)
 {
     size_t Cycles = Cost;
@@ -620,52 +623,200 @@ static void HKHubArchJITCheckCycles(uint8_t *Ptr, size_t *Index, size_t Cost, co
     HKHubArchJITAddInstructionReturn(Ptr, Index);
 }
 
-static void HKHubArchJITCheckMemoryAccess(uint8_t *Ptr, size_t *Index, const HKHubArchExecutionGraphInstruction *Instruction, HKHubArchJITRegister Offset)
+#define HK_HUB_ARCH_JIT_CHECK_CYCLES_SIZE 11
+#define HK_HUB_ARCH_JIT_CHECK_CYCLES_SUB_IMM8 3
+#define HK_HUB_ARCH_JIT_CHECK_CYCLES_ADD_IMM8 9
+
+/*!
+ * @brief Merge the cycle check of a fused instruction into the cycle check of its leader.
+ * @description The follower's check is removed, so if the combined check fails the block returns at the leader
+ *              and the interpreter executes the pair individually. This keeps the cycle semantics identical to
+ *              executing each instruction on its own.
+ *
+ * @param Leader The start of the leader's generated code.
+ * @param Follower The start of the follower's generated code.
+ * @param Size The size of the follower's generated code.
+ * @param Jumps The jump references, any references to the follower's code will be adjusted.
+ * @param JumpIndex The index of the first jump reference belonging to the follower.
+ * @return The new size of the follower's generated code.
+ */
+static size_t HKHubArchJITFuseCycles(uint8_t *Leader, uint8_t *Follower, size_t Size, CCArray(HKHubArchJITJumpRef) Jumps, size_t JumpIndex)
+{
+    const uint8_t Cycles = Follower[HK_HUB_ARCH_JIT_CHECK_CYCLES_SUB_IMM8];
+    
+    CCAssertLog((Leader[HK_HUB_ARCH_JIT_CHECK_CYCLES_SUB_IMM8] + Cycles) <= INT8_MAX, "Fused cycles must fit in the sign extended imm8");
+    
+    Leader[HK_HUB_ARCH_JIT_CHECK_CYCLES_SUB_IMM8] += Cycles;
+    Leader[HK_HUB_ARCH_JIT_CHECK_CYCLES_ADD_IMM8] += Cycles;
+    
+    memmove(Follower, Follower + HK_HUB_ARCH_JIT_CHECK_CYCLES_SIZE, Size - HK_HUB_ARCH_JIT_CHECK_CYCLES_SIZE);
+    
+    for (size_t Loop = JumpIndex, Count = CCArrayGetCount(Jumps); Loop < Count; Loop++)
+    {
+        HKHubArchJITJumpRef *Ref = CCArrayGetElementAtIndex(Jumps, Loop);
+        Ref->jump -= HK_HUB_ARCH_JIT_CHECK_CYCLES_SIZE;
+        Ref->rel = (int32_t*)((uint8_t*)Ref->rel - HK_HUB_ARCH_JIT_CHECK_CYCLES_SIZE);
+    }
+    
+    return Size - HK_HUB_ARCH_JIT_CHECK_CYCLES_SIZE;
+}
+
+#define HK_HUB_ARCH_JIT_CHECK_CYCLES_SUB_SIZE 4
+
+/*!
+ * @brief Strip the cycle check of an instruction down to the cycle subtraction.
+ * @description Used for the fast path where the budget has already been checked for the instruction.
+ * @param Ptr The start of the instruction's generated code.
+ * @param Size The size of the instruction's generated code.
+ * @param Jumps The jump references, any references to the instruction's code will be adjusted.
+ * @param JumpIndex The index of the first jump reference belonging to the instruction.
+ * @return The new size of the instruction's generated code.
+ */
+static size_t HKHubArchJITStripCycles(uint8_t *Ptr, size_t Size, CCArray(HKHubArchJITJumpRef) Jumps, size_t JumpIndex)
+{
+    const size_t Stripped = HK_HUB_ARCH_JIT_CHECK_CYCLES_SIZE - HK_HUB_ARCH_JIT_CHECK_CYCLES_SUB_SIZE;
+    
+    memmove(Ptr + HK_HUB_ARCH_JIT_CHECK_CYCLES_SUB_SIZE, Ptr + HK_HUB_ARCH_JIT_CHECK_CYCLES_SIZE, Size - HK_HUB_ARCH_JIT_CHECK_CYCLES_SIZE);
+    
+    for (size_t Loop = JumpIndex, Count = CCArrayGetCount(Jumps); Loop < Count; Loop++)
+    {
+        HKHubArchJITJumpRef *Ref = CCArrayGetElementAtIndex(Jumps, Loop);
+        Ref->jump -= Stripped;
+        Ref->rel = (int32_t*)((uint8_t*)Ref->rel - Stripped);
+    }
+    
+    return Size - Stripped;
+}
+
+static void HKHubArchJITCheckBudget(uint8_t *Ptr, size_t *Index)
+{
+    /*
+     cmp rsi, budget
+     jae fast
+     
+     The budget and the fast path location are patched in once the fast path has been generated.
+     */
+    Ptr[(*Index)++] = HKHubArchJITRexW;
+    HKHubArchJITAddInstructionArithmeticMIn(Ptr, Index, HKHubArchJITArithmeticCmp, HKHubArchJITRegisterCompatibilityCycles, 0);
+    HKHubArchJITAddInstructionJumpRel32(Ptr, Index, HKHubArchJITJumpAboveEqual, 0);
+}
+
+#define HK_HUB_ARCH_JIT_BUDGET_CHECK_SIZE 13
+#define HK_HUB_ARCH_JIT_BUDGET_CHECK_IMM32 3
+#define HK_HUB_ARCH_JIT_BUDGET_CHECK_JUMP 7
+#define HK_HUB_ARCH_JIT_BUDGET_CHECK_REL32 9
+
+void HKHubArchJITDisableFastPath(void *Check)
+{
+    // Replace the jae rel32 with a 6 byte nop so the budget check always falls through to the per-instruction code
+    memcpy(Check, (const uint8_t[6]){ 0x66, 0x0f, 0x1f, 0x44, 0x00, 0x00 }, 6);
+}
+
+static _Bool HKHubArchJITWritesMemory(const HKHubArchExecutionGraphInstruction *Instruction)
+{
+    // Stores to a literal address are excluded, as any code they may write to is invalidated when the JIT is created
+    const HKHubArchInstructionMemoryOperation MemoryOp = HKHubArchInstructionGetMemoryOperation(&Instruction->state);
+    for (size_t Loop = 0; Loop < 3; Loop++)
+    {
+        if ((((MemoryOp >> (Loop * 2)) & HKHubArchInstructionMemoryOperationDst)) && (Instruction->state.operand[Loop].type == HKHubArchInstructionOperandM) && (Instruction->state.operand[Loop].memory.type != HKHubArchInstructionMemoryOffset)) return TRUE;
+    }
+    
+    return FALSE;
+}
+
+static CC_FORCE_INLINE void HKHubArchJITAddModRMDisp(uint8_t *Ptr, size_t *Index, HKHubArchJITRegister Reg, HKHubArchJITRegister Rm, int32_t Disp)
+{
+    if ((!Disp) && (Rm != HKHubArchJITRegisterRBP)) Ptr[(*Index)++] = HKHubArchJITModRM(HKHubArchJITModAddress, Reg, Rm);
+    else if ((Disp < INT8_MIN) || (Disp > INT8_MAX))
+    {
+        Ptr[(*Index)++] = HKHubArchJITModRM(HKHubArchJITModAddressDisp32, Reg, Rm);
+        *(int32_t*)&Ptr[*Index] = Disp;
+        *Index += 4;
+    }
+    
+    else
+    {
+        Ptr[(*Index)++] = HKHubArchJITModRM(HKHubArchJITModAddressDisp8, Reg, Rm);
+        *(int8_t*)&Ptr[(*Index)++] = (int8_t)Disp;
+    }
+}
+
+static void HKHubArchJITLoadAddress(uint8_t *Ptr, size_t *Index, const typeof(((HKHubArchInstructionState*)NULL)->operand[0].memory) *Memory)
+{
+    // eax = address
+    switch (Memory->type)
+    {
+        case HKHubArchInstructionMemoryOffset:
+            HKHubArchJITAddInstructionMovOI(Ptr, Index, HKHubArchJITRegisterEAX, Memory->offset);
+            break;
+            
+        case HKHubArchInstructionMemoryRegister:
+            HKHubArchJITAddInstructionMovzxRM8(Ptr, Index, HKHubArchJITRegisterEAX, HKHubArchJITGetRegister(Memory->reg));
+            break;
+            
+        case HKHubArchInstructionMemoryRelativeOffset:
+            HKHubArchJITAddInstructionMovzxRM8(Ptr, Index, HKHubArchJITRegisterEAX, HKHubArchJITGetRegister(Memory->relativeOffset.reg));
+            HKHubArchJITAddInstructionArithmeticMI8(Ptr, Index, HKHubArchJITArithmeticAdd, HKHubArchJITRegisterAL, Memory->relativeOffset.offset);
+            break;
+            
+        case HKHubArchInstructionMemoryRelativeRegister:
+            HKHubArchJITAddInstructionMovzxRM8(Ptr, Index, HKHubArchJITRegisterEAX, HKHubArchJITGetRegister(Memory->relativeReg[0]));
+            Ptr[(*Index)++] = HKHubArchJITOpcodeAddMR8;
+            Ptr[(*Index)++] = HKHubArchJITModRM(HKHubArchJITModRegister, HKHubArchJITGetRegister(Memory->relativeReg[1]), HKHubArchJITRegisterAL);
+            break;
+    }
+}
+
+static void HKHubArchJITLoadJIT(uint8_t *Ptr, size_t *Index)
+{
+    // mov r8, [rdi + jit]
+    Ptr[(*Index)++] = HKHubArchJITRexW | HKHubArchJITRexR;
+    Ptr[(*Index)++] = HKHubArchJITOpcodeMovRM;
+    HKHubArchJITAddModRMDisp(Ptr, Index, HKHubArchJITRegisterR8, HKHubArchJITRegisterCompatibilityMemory, (int32_t)(offsetof(HKHubArchProcessorInfo, cache.jit) - offsetof(HKHubArchProcessorInfo, memory)));
+}
+
+static void HKHubArchJITAddInstructionBitTestJIT(uint8_t *Ptr, size_t *Index, size_t Bitmap)
+{
+    // bt [r8 + bitmap], eax
+    Ptr[(*Index)++] = HKHubArchJITRexB;
+    Ptr[(*Index)++] = 0x0f;
+    Ptr[(*Index)++] = HKHubArchJIT0fPrefixOpcodeBtMR;
+    HKHubArchJITAddModRMDisp(Ptr, Index, HKHubArchJITRegisterEAX, HKHubArchJITRegisterR8, (int32_t)Bitmap);
+}
+
+static void HKHubArchJITCheckMemoryAccess(uint8_t *Ptr, size_t *Index, const HKHubArchExecutionGraphInstruction *Instruction)
 {
     const HKHubArchInstructionMemoryOperation MemoryOp = HKHubArchInstructionGetMemoryOperation(&Instruction->state);
     for (size_t Loop = 0; Loop < 3; Loop++)
     {
         if ((((MemoryOp >> (Loop * 2)) & HKHubArchInstructionMemoryOperationDst)) && (Instruction->state.operand[Loop].type == HKHubArchInstructionOperandM))
         {
+            const typeof(Instruction->state.operand[Loop].memory) *Memory = &Instruction->state.operand[Loop].memory;
+            
             /*
-             TODO: If memory operand is a literal then it can avoid adding a check and instead add it to a list of invalidated memory addresses.
-             then after creation of the jit it invalidates all of those constant addresses.
+             Stores to a literal address are invalidated when the JIT is created, so they never need a check.
+             Otherwise the address is tested against the JIT's code bitmap and only calls out when it hits code.
+             This is done before the store so the flags it produces are left intact.
              */
+            if (Memory->type == HKHubArchInstructionMemoryOffset) continue;
+            
+            HKHubArchJITLoadAddress(Ptr, Index, Memory);
+            HKHubArchJITLoadJIT(Ptr, Index);
+            HKHubArchJITAddInstructionBitTestJIT(Ptr, Index, offsetof(HKHubArchJITInfo, code));
+            
+            HKHubArchJITAddInstructionJumpRel8(Ptr, Index, HKHubArchJITJumpNotCarry, 0);
+            const size_t Skip = *Index;
+            
             HKHubArchJITAddInstructionPushR(Ptr, Index, HKHubArchJITRegisterRBX);
             HKHubArchJITAddInstructionPushR(Ptr, Index, HKHubArchJITRegisterRCX);
             HKHubArchJITAddInstructionPushR(Ptr, Index, HKHubArchJITRegisterRDX);
             HKHubArchJITAddInstructionPushR(Ptr, Index, HKHubArchJITRegisterRSI);
             HKHubArchJITAddInstructionPushR(Ptr, Index, HKHubArchJITRegisterRDI);
             
-            if (Instruction->state.operand[Loop].memory.type == HKHubArchInstructionMemoryOffset)
-            {
-                Ptr[(*Index)++] = HKHubArchJITRexW;
-                HKHubArchJITAddInstructionXorMR(Ptr, Index, HKHubArchJITRegisterRSI, HKHubArchJITRegisterRSI);
-                Ptr[(*Index)++] = HKHubArchJITRex;
-                HKHubArchJITAddInstructionMovOI8(Ptr, Index, HKHubArchJITRegisterSIL, Instruction->state.operand[Loop].memory.offset);
-            }
-            
-            else
-            {
-                HKHubArchJITAddInstructionMovMR(Ptr, Index, HKHubArchJITRegisterRSI, Offset);
-            }
-            
-            const int32_t JitField = (int32_t)(offsetof(HKHubArchProcessorInfo, cache.jit) - offsetof(HKHubArchProcessorInfo, memory));
-            
-            Ptr[(*Index)++] = HKHubArchJITRexW;
-            Ptr[(*Index)++] = HKHubArchJITOpcodeMovRM;
-            if ((JitField < INT8_MIN) || (JitField > INT8_MAX))
-            {
-                Ptr[(*Index)++] = HKHubArchJITModRM(HKHubArchJITModAddressDisp32, HKHubArchJITRegisterRDI, HKHubArchJITRegisterCompatibilityMemory);
-                *(int32_t*)&Ptr[*Index] = JitField;
-                *Index += 4;
-            }
+            HKHubArchJITAddInstructionMovMR(Ptr, Index, HKHubArchJITRegisterRSI, HKHubArchJITRegisterRAX);
             
-            else
-            {
-                Ptr[(*Index)++] = HKHubArchJITModRM(HKHubArchJITModAddressDisp8, HKHubArchJITRegisterRDI, HKHubArchJITRegisterCompatibilityMemory);
-                *(int8_t*)&Ptr[(*Index)++] = (int8_t)JitField;
-            }
+            Ptr[(*Index)++] = HKHubArchJITRexW | HKHubArchJITRexR;
+            HKHubArchJITAddInstructionMovMR(Ptr, Index, HKHubArchJITRegisterRDI, HKHubArchJITRegisterR8);
             
             Ptr[(*Index)++] = HKHubArchJITRexW;
             HKHubArchJITAddInstructionXorMR(Ptr, Index, HKHubArchJITRegisterRDX, HKHubArchJITRegisterRDX);
@@ -679,8 +830,67 @@ static void HKHubArchJITCheckMemoryAccess(uint8_t *Ptr, size_t *Index, const HKH
             HKHubArchJITAddInstructionPopR(Ptr, Index, HKHubArchJITRegisterRDX);
             HKHubArchJITAddInstructionPopR(Ptr, Index, HKHubArchJITRegisterRCX);
             HKHubArchJITAddInstructionPopR(Ptr, Index, HKHubArchJITRegisterRBX);
+            
+            Ptr[Skip - 1] = (uint8_t)(*Index - Skip);
+        }
+    }
+}
+
+#define HK_HUB_ARCH_JIT_BREAKPOINT_GUARD_MAX 128
+
+/*!
+ * @brief Insert the breakpoint guards for the memory accesses of an instruction.
+ * @description The guards are placed after the instruction's cycle check, and exit the same way a failed cycle
+ *              check does so the interpreter executes the instruction and triggers the breakpoint.
+ *
+ * @param Ptr The start of the instruction's generated code.
+ * @param Size The size of the instruction's generated code.
+ * @param Instruction The instruction to guard.
+ * @return The new size of the instruction's generated code.
+ */
+static size_t HKHubArchJITGuardBreakpoints(uint8_t *Ptr, size_t Size, const HKHubArchExecutionGraphInstruction *Instruction)
+{
+    const uint8_t Cycles = Ptr[HK_HUB_ARCH_JIT_CHECK_CYCLES_SUB_IMM8];
+    
+    uint8_t Guard[HK_HUB_ARCH_JIT_BREAKPOINT_GUARD_MAX];
+    size_t Index = 0;
+    
+    const HKHubArchInstructionMemoryOperation MemoryOp = HKHubArchInstructionGetMemoryOperation(&Instruction->state);
+    for (size_t Loop = 0; Loop < 3; Loop++)
+    {
+        if (Instruction->state.operand[Loop].type != HKHubArchInstructionOperandM) continue;
+        
+        for (size_t Access = 0; Access < 2; Access++)
+        {
+            const HKHubArchInstructionMemoryOperation Operation = Access ? HKHubArchInstructionMemoryOperationDst : HKHubArchInstructionMemoryOperationSrc;
+            
+            if (!((MemoryOp >> (Loop * 2)) & Operation)) continue;
+            
+            /*
+             bt [jit + breakpoints], address
+             jnc +5
+             add rsi, cycles
+             ret
+             */
+            HKHubArchJITLoadAddress(Guard, &Index, &Instruction->state.operand[Loop].memory);
+            HKHubArchJITLoadJIT(Guard, &Index);
+            HKHubArchJITAddInstructionBitTestJIT(Guard, &Index, Access ? offsetof(HKHubArchJITInfo, breakpoints.write) : offsetof(HKHubArchJITInfo, breakpoints.read));
+            HKHubArchJITAddInstructionJumpRel8(Guard, &Index, HKHubArchJITJumpNotCarry, 5);
+            Guard[Index++] = HKHubArchJITRexW;
+            HKHubArchJITAddInstructionArithmeticMI(Guard, &Index, HKHubArchJITArithmeticAdd, HKHubArchJITRegisterCompatibilityCycles, Cycles);
+            HKHubArchJITAddInstructionReturn(Guard, &Index);
+            
+            CCAssertLog(Index <= HK_HUB_ARCH_JIT_BREAKPOINT_GUARD_MAX, "Breakpoint guards exceed the maximum size");
         }
     }
+    
+    if (!Index) return Size;
+    
+    // Instructions that access memory never jump, so there are no jump references to adjust
+    memmove(Ptr + HK_HUB_ARCH_JIT_CHECK_CYCLES_SIZE + Index, Ptr + HK_HUB_ARCH_JIT_CHECK_CYCLES_SIZE, Size - HK_HUB_ARCH_JIT_CHECK_CYCLES_SIZE);
+    memcpy(Ptr + HK_HUB_ARCH_JIT_CHECK_CYCLES_SIZE, Guard, Index);
+    
+    return Size + Index;
 }
 
 static size_t HKHubArchJITGenerate0OperandMutator(uint8_t *Ptr, const HKHubArchExecutionGraphInstruction *Instruction, uint8_t Type, size_t Cost, _Bool FlagsAffected)
@@ -709,6 +919,8 @@ static size_t HKHubArchJITGenerate1OperandMutator(uint8_t *Ptr, const HKHubArchE
     size_t Index = 0;
     HKHubArchJITCheckCycles(Ptr, &Index, Cost + (Size * HKHubArchProcessorSpeedMemoryRead), Instruction);
     
+    if (MemoryCheck) HKHubArchJITCheckMemoryAccess(Ptr, &Index, Instruction);
+    
     if (Instruction->state.operand[0].type == HKHubArchInstructionOperandR)
     {
         HKHubArchJITRegister Dst = HKHubArchJITGetRegister(Instruction->state.operand[0].reg);
@@ -772,13 +984,6 @@ static size_t HKHubArchJITGenerate1OperandMutator(uint8_t *Ptr, const HKHubArchE
                 break;
         }
         
-        if (MemoryCheck)
-        {
-            HKHubArchJITAddInstructionPushR(Ptr, &Index, HKHubArchJITRegisterRAX);
-            HKHubArchJITCheckMemoryAccess(Ptr, &Index, Instruction, HKHubArchJITRegisterRAX);
-            HKHubArchJITAddInstructionPopR(Ptr, &Index, HKHubArchJITRegisterRAX);
-        }
-        
         if (FlagsAffected)
         {
             if (ManualFlagTest)
@@ -836,6 +1041,8 @@ static size_t HKHubArchJITGenerate2OperandMutator(uint8_t *Ptr, const HKHubArchE
     size_t Index = 0;
     HKHubArchJITCheckCycles(Ptr, &Index, Cost + (Size * HKHubArchProcessorSpeedMemoryRead), Instruction);
     
+    if (MemoryCheck) HKHubArchJITCheckMemoryAccess(Ptr, &Index, Instruction);
+    
     if (Instruction->state.operand[0].type == HKHubArchInstructionOperandR)
     {
         if (Instruction->state.operand[1].type == HKHubArchInstructionOperandR)
@@ -931,8 +1138,6 @@ static size_t HKHubArchJITGenerate2OperandMutator(uint8_t *Ptr, const HKHubArchE
                     Ptr[Index++] = HKHubArchJITSIB(0, HKHubArchJITRegisterRAX, HKHubArchJITRegisterCompatibilityMemory);
                     break;
             }
-            
-            if (MemoryCheck) HKHubArchJITCheckMemoryAccess(Ptr, &Index, Instruction, HKHubArchJITRegisterRAX);
         }
         
         else if (Instruction->state.operand[1].type == HKHubArchInstructionOperandI)
@@ -974,8 +1179,6 @@ static size_t HKHubArchJITGenerate2OperandMutator(uint8_t *Ptr, const HKHubArchE
                     Ptr[Index++] = Instruction->state.operand[1].value;
                     break;
             }
-            
-            if (MemoryCheck) HKHubArchJITCheckMemoryAccess(Ptr, &Index, Instruction, HKHubArchJITRegisterRAX);
         }
         
         else if (Instruction->state.operand[1].type == HKHubArchInstructionOperandM)
@@ -1006,13 +1209,6 @@ static size_t HKHubArchJITGenerate2OperandMutator(uint8_t *Ptr, const HKHubArchE
                     break;
             }
             
-            if (MemoryCheck)
-            {
-                HKHubArchJITAddInstructionPushR(Ptr, &Index, HKHubArchJITRegisterRBP);
-                HKHubArchJITCheckMemoryAccess(Ptr, &Index, Instruction, HKHubArchJITRegisterRBP);
-                HKHubArchJITAddInstructionPopR(Ptr, &Index, HKHubArchJITRegisterRBP);
-            }
-            
             switch (Instruction->state.operand[1].memory.type)
             {
                 case HKHubArchInstructionMemoryOffset:
@@ -1214,6 +1410,8 @@ static size_t HKHubArchJITGenerate2OperandDivisionMutator(uint8_t *Ptr, const HK
     size_t Index = 0;
     HKHubArchJITCheckCycles(Ptr, &Index, Cost + (Size * HKHubArchProcessorSpeedMemoryRead), Instruction);
     
+    if (MemoryCheck) HKHubArchJITCheckMemoryAccess(Ptr, &Index, Instruction);
+    
     if (Instruction->state.operand[0].type == HKHubArchInstructionOperandR)
     {
         if (Instruction->state.operand[1].type == HKHubArchInstructionOperandR)
@@ -1751,13 +1949,6 @@ static size_t HKHubArchJITGenerate2OperandDivisionMutator(uint8_t *Ptr, const HK
                     break;
             }
             
-            if (MemoryCheck)
-            {
-                HKHubArchJITAddInstructionPushR(Ptr, &Index, HKHubArchJITRegisterRBP);
-                HKHubArchJITCheckMemoryAccess(Ptr, &Index, Instruction, HKHubArchJITRegisterRBP);
-                HKHubArchJITAddInstructionPopR(Ptr, &Index, HKHubArchJITRegisterRBP);
-            }
-            
             const HKHubArchJITRegister Src = HKHubArchJITGetRegister(Instruction->state.operand[1].reg);
             HKHubArchJITRegister Result, Flags;
             
@@ -1869,13 +2060,6 @@ static size_t HKHubArchJITGenerate2OperandDivisionMutator(uint8_t *Ptr, const HK
                     break;
             }
             
-            if (MemoryCheck)
-            {
-                HKHubArchJITAddInstructionPushR(Ptr, &Index, HKHubArchJITRegisterRBP);
-                HKHubArchJITCheckMemoryAccess(Ptr, &Index, Instruction, HKHubArchJITRegisterRBP);
-                HKHubArchJITAddInstructionPopR(Ptr, &Index, HKHubArchJITRegisterRBP);
-            }
-            
             if (Signed)
             {
                 if (Mod)
@@ -2298,13 +2482,6 @@ static size_t HKHubArchJITGenerate2OperandDivisionMutator(uint8_t *Ptr, const HK
                     break;
             }
             
-            if (MemoryCheck)
-            {
-                HKHubArchJITAddInstructionPushR(Ptr, &Index, HKHubArchJITRegisterRBP);
-                HKHubArchJITCheckMemoryAccess(Ptr, &Index, Instruction, HKHubArchJITRegisterRBP);
-                HKHubArchJITAddInstructionPopR(Ptr, &Index, HKHubArchJITRegisterRBP);
-            }
-            
             switch (Instruction->state.operand[1].memory.type)
             {
                 case HKHubArchInstructionMemoryOffset:
@@ -2589,12 +2766,12 @@ static size_t HKHubArchJITGenerate1OperandJump(uint8_t *Ptr, const HKHubArchExec
 
 static size_t HKHubArchJITGenerateAdd(uint8_t *Ptr, const HKHubArchExecutionGraphInstruction *Instruction, HKHubArchJITOptions Options)
 {
-    return HKHubArchJITGenerate2OperandMutator(Ptr, Instruction, HKHubArchJITArithmeticAdd, HKHubArchJITOpcodeAddMR8, HKHubArchJITOpcodeAddRM8, HKHubArchJITOpcodeArithmeticMI8, 2, TRUE, Options & HKHubArchJITOptionsWatchMemory);
+    return HKHubArchJITGenerate2OperandMutator(Ptr, Instruction, HKHubArchJITArithmeticAdd, HKHubArchJITOpcodeAddMR8, HKHubArchJITOpcodeAddRM8, HKHubArchJITOpcodeArithmeticMI8, 2, HKHubArchJITFlagsObservable(Instruction), Options & HKHubArchJITOptionsWatchMemory);
 }
 
 static size_t HKHubArchJITGenerateSub(uint8_t *Ptr, const HKHubArchExecutionGraphInstruction *Instruction, HKHubArchJITOptions Options)
 {
-    return HKHubArchJITGenerate2OperandMutator(Ptr, Instruction, HKHubArchJITArithmeticSub, HKHubArchJITOpcodeSubMR8, HKHubArchJITOpcodeSubRM8, HKHubArchJITOpcodeArithmeticMI8, 2, TRUE, Options & HKHubArchJITOptionsWatchMemory);
+    return HKHubArchJITGenerate2OperandMutator(Ptr, Instruction, HKHubArchJITArithmeticSub, HKHubArchJITOpcodeSubMR8, HKHubArchJITOpcodeSubRM8, HKHubArchJITOpcodeArithmeticMI8, 2, HKHubArchJITFlagsObservable(Instruction), Options & HKHubArchJITOptionsWatchMemory);
 }
 
 static size_t HKHubArchJITGenerateUdiv(uint8_t *Ptr, const HKHubArchExecutionGraphInstruction *Instruction, HKHubArchJITOptions Options)
@@ -2619,22 +2796,22 @@ static size_t HKHubArchJITGenerateSmod(uint8_t *Ptr, const HKHubArchExecutionGra
 
 static size_t HKHubArchJITGenerateOr(uint8_t *Ptr, const HKHubArchExecutionGraphInstruction *Instruction, HKHubArchJITOptions Options)
 {
-    return HKHubArchJITGenerate2OperandMutator(Ptr, Instruction, HKHubArchJITArithmeticOr, HKHubArchJITOpcodeOrMR8, HKHubArchJITOpcodeOrRM8, HKHubArchJITOpcodeArithmeticMI8, 1, TRUE, Options & HKHubArchJITOptionsWatchMemory);
+    return HKHubArchJITGenerate2OperandMutator(Ptr, Instruction, HKHubArchJITArithmeticOr, HKHubArchJITOpcodeOrMR8, HKHubArchJITOpcodeOrRM8, HKHubArchJITOpcodeArithmeticMI8, 1, HKHubArchJITFlagsObservable(Instruction), Options & HKHubArchJITOptionsWatchMemory);
 }
 
 static size_t HKHubArchJITGenerateXor(uint8_t *Ptr, const HKHubArchExecutionGraphInstruction *Instruction, HKHubArchJITOptions Options)
 {
-    return HKHubArchJITGenerate2OperandMutator(Ptr, Instruction, HKHubArchJITArithmeticXor, HKHubArchJITOpcodeXorMR8, HKHubArchJITOpcodeXorRM8, HKHubArchJITOpcodeArithmeticMI8, 1, TRUE, Options & HKHubArchJITOptionsWatchMemory);
+    return HKHubArchJITGenerate2OperandMutator(Ptr, Instruction, HKHubArchJITArithmeticXor, HKHubArchJITOpcodeXorMR8, HKHubArchJITOpcodeXorRM8, HKHubArchJITOpcodeArithmeticMI8, 1, HKHubArchJITFlagsObservable(Instruction), Options & HKHubArchJITOptionsWatchMemory);
 }
 
 static size_t HKHubArchJITGenerateAnd(uint8_t *Ptr, const HKHubArchExecutionGraphInstruction *Instruction, HKHubArchJITOptions Options)
 {
-    return HKHubArchJITGenerate2OperandMutator(Ptr, Instruction, HKHubArchJITArithmeticAnd, HKHubArchJITOpcodeAndMR8, HKHubArchJITOpcodeAndRM8, HKHubArchJITOpcodeArithmeticMI8, 1, TRUE, Options & HKHubArchJITOptionsWatchMemory);
+    return HKHubArchJITGenerate2OperandMutator(Ptr, Instruction, HKHubArchJITArithmeticAnd, HKHubArchJITOpcodeAndMR8, HKHubArchJITOpcodeAndRM8, HKHubArchJITOpcodeArithmeticMI8, 1, HKHubArchJITFlagsObservable(Instruction), Options & HKHubArchJITOptionsWatchMemory);
 }
 
 static size_t HKHubArchJITGenerateCmp(uint8_t *Ptr, const HKHubArchExecutionGraphInstruction *Instruction, HKHubArchJITOptions Options)
 {
-    return HKHubArchJITGenerate2OperandMutator(Ptr, Instruction, HKHubArchJITArithmeticCmp, HKHubArchJITOpcodeCmpMR8, HKHubArchJITOpcodeCmpRM8, HKHubArchJITOpcodeArithmeticMI8, 2, TRUE, Options & HKHubArchJITOptionsWatchMemory);
+    return HKHubArchJITGenerate2OperandMutator(Ptr, Instruction, HKHubArchJITArithmeticCmp, HKHubArchJITOpcodeCmpMR8, HKHubArchJITOpcodeCmpRM8, HKHubArchJITOpcodeArithmeticMI8, 2, HKHubArchJITFlagsObservable(Instruction), Options & HKHubArchJITOptionsWatchMemory);
 }
 
 static size_t HKHubArchJITGenerateMov(uint8_t *Ptr, const HKHubArchExecutionGraphInstruction *Instruction, HKHubArchJITOptions Options)
@@ -2742,7 +2919,156 @@ static size_t HKHubArchJITGenerateJmp(uint8_t *Ptr, const HKHubArchExecutionGrap
     return HKHubArchJITGenerate1OperandJump(Ptr, Instruction, HKHubArchJITJumpUnconditional, 1, Jumps);
 }
 
-_Bool HKHubArchJITGenerateBlock(HKHubArchJIT JIT, HKHubArchJITBlock *JITBlock, void *Ptr, CCLinkedList(HKHubArchExecutionGraphInstruction) Block, HKHubArchJITOptions Options)
+static size_t HKHubArchJITGenerateOperation(uint8_t *Ptr, const HKHubArchExecutionGraphInstruction *Instruction, CCArray(HKHubArchJITJumpRef) Jumps, HKHubArchJITOptions Options)
+{
+    switch (Instruction->state.opcode)
+    {
+        case 0:
+        case 1:
+            return HKHubArchJITGenerateAdd(Ptr, Instruction, Options);
+            
+        case 2:
+        case 6:
+            return HKHubArchJITGenerateMov(Ptr, Instruction, Options);
+            
+        case 4:
+        case 5:
+            return HKHubArchJITGenerateSub(Ptr, Instruction, Options);
+            
+        case 12:
+        case 13:
+            return HKHubArchJITGenerateSdiv(Ptr, Instruction, Options);
+            
+        case 16:
+        case 17:
+            return HKHubArchJITGenerateUdiv(Ptr, Instruction, Options);
+            
+        case 20:
+        case 21:
+            return HKHubArchJITGenerateSmod(Ptr, Instruction, Options);
+            
+        case 24:
+        case 25:
+            return HKHubArchJITGenerateUmod(Ptr, Instruction, Options);
+            
+        case 28:
+        case 29:
+            return HKHubArchJITGenerateCmp(Ptr, Instruction, Options);
+            
+        case 32:
+        case 33:
+            // TODO: Support memory destination
+            if (Instruction->state.operand[0].type == HKHubArchInstructionOperandM) break;
+            
+            return HKHubArchJITGenerateShl(Ptr, Instruction);
+            
+        case 36:
+        case 37:
+            // TODO: Support memory destination
+            if (Instruction->state.operand[0].type == HKHubArchInstructionOperandM) break;
+            
+            return HKHubArchJITGenerateShr(Ptr, Instruction);
+            
+        case 40:
+        case 41:
+            return HKHubArchJITGenerateXor(Ptr, Instruction, Options);
+            
+        case 44:
+        case 45:
+            return HKHubArchJITGenerateOr(Ptr, Instruction, Options);
+            
+        case 46:
+            return HKHubArchJITGenerateNeg(Ptr, Instruction, Options);
+            
+        case 48:
+        case 49:
+            return HKHubArchJITGenerateAnd(Ptr, Instruction, Options);
+            
+        case 50:
+            return HKHubArchJITGenerateNot(Ptr, Instruction, Options);
+            
+        case 62:
+            return HKHubArchJITGenerateNop(Ptr, Instruction);
+            
+        case 3:
+            return HKHubArchJITGenerateJz(Ptr, Instruction, Jumps);
+            
+        case 7:
+            return HKHubArchJITGenerateJnz(Ptr, Instruction, Jumps);
+            
+        case 11:
+            return HKHubArchJITGenerateJs(Ptr, Instruction, Jumps);
+            
+        case 15:
+            return HKHubArchJITGenerateJns(Ptr, Instruction, Jumps);
+            
+        case 19:
+            return HKHubArchJITGenerateJo(Ptr, Instruction, Jumps);
+            
+        case 23:
+            return HKHubArchJITGenerateJno(Ptr, Instruction, Jumps);
+            
+        case 52:
+            return HKHubArchJITGenerateJsl(Ptr, Instruction, Jumps);
+            
+        case 53:
+            return HKHubArchJITGenerateJsge(Ptr, Instruction, Jumps);
+            
+        case 54:
+            return HKHubArchJITGenerateJsle(Ptr, Instruction, Jumps);
+            
+        case 55:
+            return HKHubArchJITGenerateJsg(Ptr, Instruction, Jumps);
+            
+        case 56:
+            return HKHubArchJITGenerateJul(Ptr, Instruction, Jumps);
+            
+        case 57:
+            return HKHubArchJITGenerateJuge(Ptr, Instruction, Jumps);
+            
+        case 58:
+            return HKHubArchJITGenerateJule(Ptr, Instruction, Jumps);
+            
+        case 59:
+            return HKHubArchJITGenerateJug(Ptr, Instruction, Jumps);
+            
+        case 63:
+            return HKHubArchJITGenerateJmp(Ptr, Instruction, Jumps);
+            
+        default:
+            break;
+    }
+    
+    return 0;
+}
+
+/*
+ The largest code an operation may generate, and the largest code an instruction may generate once its breakpoint
+ guards have been added.
+ */
+#define HK_HUB_ARCH_JIT_MAX_OPERATION_SIZE 256
+#define HK_HUB_ARCH_JIT_MAX_INSTRUCTION_SIZE (HK_HUB_ARCH_JIT_MAX_OPERATION_SIZE + HK_HUB_ARCH_JIT_BREAKPOINT_GUARD_MAX)
+
+/*!
+ * @brief Generate the native code for an instruction.
+ * @param Ptr The location the code will be written to.
+ * @param Instruction The instruction to be generated.
+ * @param Jumps The jump references, any jumps the instruction makes will be added.
+ * @param Options The options to control how the code should be generated.
+ * @return The size of the generated code, or 0 if the instruction is not supported.
+ */
+static size_t HKHubArchJITGenerateInstruction(uint8_t *Ptr, const HKHubArchExecutionGraphInstruction *Instruction, CCArray(HKHubArchJITJumpRef) Jumps, HKHubArchJITOptions Options)
+{
+    const size_t Size = HKHubArchJITGenerateOperation(Ptr, Instruction, Jumps, Options);
+    
+    CCAssertLog(Size <= HK_HUB_ARCH_JIT_MAX_OPERATION_SIZE, "Operation exceeds the maximum size");
+    
+    if ((Size) && (Options & HKHubArchJITOptionsDebug)) return HKHubArchJITGuardBreakpoints(Ptr, Size, Instruction);
+    
+    return Size;
+}
+
+size_t HKHubArchJITGenerateBlock(HKHubArchJIT JIT, HKHubArchJITBlock *JITBlock, uint8_t *Ptr, size_t Capacity, const HKHubArchExecutionGraphInstruction *Block, size_t Count, HKHubArchJITOptions Options)
 {
     /*
      rax : reserved
@@ -2766,246 +3092,178 @@ _Bool HKHubArchJITGenerateBlock(HKHubArchJIT JIT, HKHubArchJITBlock *JITBlock, v
     CCArray(HKHubArchJITJumpRef) Jumps = CCArrayCreate(CC_STD_ALLOCATOR, sizeof(HKHubArchJITJumpRef), 8);
     CCDictionary(uint8_t, size_t) Offsets = CCDictionaryCreate(CC_STD_ALLOCATOR, CCDictionaryHintSizeMedium | CCDictionaryHintHeavyInserting, sizeof(uint8_t), sizeof(size_t), NULL);
     
-    CCEnumerable Enumerable;
-    CCLinkedListGetEnumerable(Block, &Enumerable);
+    CCAssertLog(Count <= 256, "Block must not contain more instructions than there are addresses");
     
-    size_t Index = 0, InstructionIndex = 0, ReturnIndex = 0;
-    for (const HKHubArchExecutionGraphInstruction *Instruction = CCEnumerableGetCurrent(&Enumerable); Instruction; Instruction = CCEnumerableNext(&Enumerable), InstructionIndex++)
+    /*
+     Blocks that watch memory may invalidate their own instructions while running, the per-instruction code
+     handles this by returning at the invalidated entry. The fast path has no entries to patch, so those blocks
+     only use the per-instruction code.
+     */
+    _Bool FastPath = TRUE;
+    uint8_t Targets[256 / 8] = {0};
+    for (size_t Loop = 0; Loop < Count; Loop++)
     {
-        switch (Instruction->state.opcode)
+        if (Block[Loop].jump != HK_HUB_ARCH_EXECUTION_GRAPH_INDEX_NONE)
         {
-            case 0:
-            case 1:
-                CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                Index += HKHubArchJITGenerateAdd(&Ptr[Index], Instruction, Options);
-                break;
-                
-            case 2:
-            case 6:
-                CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                Index += HKHubArchJITGenerateMov(&Ptr[Index], Instruction, Options);
-                break;
-                
-            case 4:
-            case 5:
-                CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                Index += HKHubArchJITGenerateSub(&Ptr[Index], Instruction, Options);
-                break;
-                
-            case 12:
-            case 13:
-                CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                Index += HKHubArchJITGenerateSdiv(&Ptr[Index], Instruction, Options);
-                break;
-                
-            case 16:
-            case 17:
-                CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                Index += HKHubArchJITGenerateUdiv(&Ptr[Index], Instruction, Options);
-                break;
-                
-            case 20:
-            case 21:
-                CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                Index += HKHubArchJITGenerateSmod(&Ptr[Index], Instruction, Options);
-                break;
+            const uint8_t Target = Block[Loop].offset + Block[Loop].state.operand[0].value;
+            Targets[Target / 8] |= 1 << (Target % 8);
+        }
+        
+        if ((Options & HKHubArchJITOptionsWatchMemory) && (HKHubArchJITWritesMemory(&Block[Loop]))) FastPath = FALSE;
+    }
+    
+    /*
+     The per-instruction code is generated first. Every point the block can be entered at with a full budget (the
+     start of the block, jump targets, and after an instruction that returns to the interpreter) begins with a
+     budget check that branches to the fast path when there are enough cycles for the instructions that follow.
+     */
+    size_t Checks[256];
+    _Bool Reentry = TRUE;
+    size_t Index = 0, ReturnIndex = 0, LeaderIndex = SIZE_MAX, CheckCount = 0;
+    for (size_t InstructionIndex = 0; InstructionIndex < Count; InstructionIndex++)
+    {
+        /*
+         Every instruction reserves room for the largest possible code (along with its check and the return that
+         ends the block), if that won't fit the block is ended here and the remaining instructions are left to
+         the interpreter.
+         */
+        if ((Index + HK_HUB_ARCH_JIT_BUDGET_CHECK_SIZE + HK_HUB_ARCH_JIT_MAX_INSTRUCTION_SIZE + 1) > Capacity)
+        {
+            Count = InstructionIndex;
+            break;
+        }
+        
+        const HKHubArchExecutionGraphInstruction *Instruction = &Block[InstructionIndex];
+        const _Bool Check = (FastPath) && ((Reentry) || (Targets[Instruction->offset / 8] & (1 << (Instruction->offset % 8))));
+        const size_t Entry = Index;
+        
+        Checks[InstructionIndex] = SIZE_MAX;
+        
+        if (Check) Index += HK_HUB_ARCH_JIT_BUDGET_CHECK_SIZE;
+        
+        const size_t InstructionStart = Index, JumpIndex = CCArrayGetCount(Jumps);
+        const size_t Size = HKHubArchJITGenerateInstruction(&Ptr[InstructionStart], Instruction, Jumps, Options);
+        
+        if (Size)
+        {
+            Index += Size;
+            
+            if (Check)
+            {
+                HKHubArchJITCheckBudget(Ptr, &(size_t){ Entry });
+                Checks[InstructionIndex] = Entry;
+                CheckCount++;
+            }
+            
+            const _Bool Fused = (Instruction->fusion & HKHubArchExecutionGraphFusionFollower) && (LeaderIndex != SIZE_MAX);
+            if (Fused) Index = InstructionStart + HKHubArchJITFuseCycles(&Ptr[LeaderIndex], &Ptr[InstructionStart], Size, Jumps, JumpIndex);
+            else
+            {
+                CCDictionarySetValue(Offsets, &Instruction->offset, &Entry);
+                CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Entry), .index = InstructionIndex });
+            }
+            
+            if (Instruction->fusion & HKHubArchExecutionGraphFusionLeader)
+            {
+                if (!Fused) LeaderIndex = InstructionStart;
+            }
+            
+            else LeaderIndex = SIZE_MAX;
+        }
+        
+        else
+        {
+            Index = Entry;
+            
+            if (Index != ReturnIndex)
+            {
+                HKHubArchJITAddInstructionReturn(Ptr, &Index);
+                ReturnIndex = Index;
+            }
+            
+            LeaderIndex = SIZE_MAX;
+        }
+        
+        Reentry = !Size;
+    }
+    
+    if (Index != ReturnIndex)
+    {
+        HKHubArchJITAddInstructionReturn(Ptr, &Index);
+        ReturnIndex = Index;
+    }
+    
+    if (CheckCount)
+    {
+        /*
+         The fast path is a copy of the instructions with only the cycle subtraction kept from their checks, so
+         nothing is fused. Each instruction is at most 4 bytes larger than its fused per-instruction code plus a
+         return, and is generated in full before its cycles are stripped, if that won't fit the checks are left
+         disabled.
+         */
+        if (((Index * 2) + (Count * 5) + 1 + HK_HUB_ARCH_JIT_MAX_INSTRUCTION_SIZE) <= Capacity)
+        {
+            size_t Fast[256];
+            uint8_t Cycles[256];
+            _Bool Active = FALSE;
+            for (size_t InstructionIndex = 0; InstructionIndex < Count; InstructionIndex++)
+            {
+                Fast[InstructionIndex] = SIZE_MAX;
                 
-            case 24:
-            case 25:
-                CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                Index += HKHubArchJITGenerateUmod(&Ptr[Index], Instruction, Options);
-                break;
+                if (Checks[InstructionIndex] != SIZE_MAX) Active = TRUE;
+                if (!Active) continue;
                 
-            case 28:
-            case 29:
-                CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                Index += HKHubArchJITGenerateCmp(&Ptr[Index], Instruction, Options);
-                break;
+                const size_t JumpIndex = CCArrayGetCount(Jumps);
+                const size_t Size = HKHubArchJITGenerateInstruction(&Ptr[Index], &Block[InstructionIndex], Jumps, Options);
                 
-            case 32:
-            case 33:
-                if (Instruction->state.operand[0].type == HKHubArchInstructionOperandM)
+                if (Size)
                 {
-                    // TODO: Support memory destination
-                    if (Index != ReturnIndex)
-                    {
-                        HKHubArchJITAddInstructionReturn(Ptr, &Index);
-                        ReturnIndex = Index;
-                    }
+                    Fast[InstructionIndex] = Index;
+                    Cycles[InstructionIndex] = Ptr[Index + HK_HUB_ARCH_JIT_CHECK_CYCLES_SUB_IMM8];
+                    Index += HKHubArchJITStripCycles(&Ptr[Index], Size, Jumps, JumpIndex);
                 }
                 
                 else
                 {
-                    CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                    CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                    Index += HKHubArchJITGenerateShl(&Ptr[Index], Instruction);
-                }
-                break;
-                
-            case 36:
-            case 37:
-                if (Instruction->state.operand[0].type == HKHubArchInstructionOperandM)
-                {
-                    // TODO: Support memory destination
                     if (Index != ReturnIndex)
                     {
                         HKHubArchJITAddInstructionReturn(Ptr, &Index);
                         ReturnIndex = Index;
                     }
+                    
+                    Active = FALSE;
                 }
+            }
+            
+            if (Index != ReturnIndex) HKHubArchJITAddInstructionReturn(Ptr, &Index);
+            
+            /*
+             Each check needs the cycles of every instruction it may fall through to, a taken jump leaves the
+             region early so this may overestimate but never underestimates.
+             */
+            size_t Budget = 0;
+            for (size_t InstructionIndex = Count; InstructionIndex--; )
+            {
+                Budget = Fast[InstructionIndex] != SIZE_MAX ? Budget + Cycles[InstructionIndex] : 0;
                 
-                else
-                {
-                    CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                    CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                    Index += HKHubArchJITGenerateShr(&Ptr[Index], Instruction);
-                }
-                break;
-                
-            case 40:
-            case 41:
-                CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                Index += HKHubArchJITGenerateXor(&Ptr[Index], Instruction, Options);
-                break;
-                
-            case 44:
-            case 45:
-                CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                Index += HKHubArchJITGenerateOr(&Ptr[Index], Instruction, Options);
-                break;
-                
-            case 46:
-                CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                Index += HKHubArchJITGenerateNeg(&Ptr[Index], Instruction, Options);
-                break;
-                
-            case 48:
-            case 49:
-                CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                Index += HKHubArchJITGenerateAnd(&Ptr[Index], Instruction, Options);
-                break;
-                
-            case 50:
-                CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                Index += HKHubArchJITGenerateNot(&Ptr[Index], Instruction, Options);
-                break;
-                
-            case 62:
-                CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                Index += HKHubArchJITGenerateNop(&Ptr[Index], Instruction);
-                break;
-                
-            case 3:
-                CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                Index += HKHubArchJITGenerateJz(&Ptr[Index], Instruction, Jumps);
-                break;
-                
-            case 7:
-                CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                Index += HKHubArchJITGenerateJnz(&Ptr[Index], Instruction, Jumps);
-                break;
-                
-            case 11:
-                CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                Index += HKHubArchJITGenerateJs(&Ptr[Index], Instruction, Jumps);
-                break;
-                
-            case 15:
-                CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                Index += HKHubArchJITGenerateJns(&Ptr[Index], Instruction, Jumps);
-                break;
-                
-            case 19:
-                CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                Index += HKHubArchJITGenerateJo(&Ptr[Index], Instruction, Jumps);
-                break;
-                
-            case 23:
-                CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                Index += HKHubArchJITGenerateJno(&Ptr[Index], Instruction, Jumps);
-                break;
-                
-            case 52:
-                CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                Index += HKHubArchJITGenerateJsl(&Ptr[Index], Instruction, Jumps);
-                break;
-                
-            case 53:
-                CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                Index += HKHubArchJITGenerateJsge(&Ptr[Index], Instruction, Jumps);
-                break;
-                
-            case 54:
-                CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                Index += HKHubArchJITGenerateJsle(&Ptr[Index], Instruction, Jumps);
-                break;
-                
-            case 55:
-                CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                Index += HKHubArchJITGenerateJsg(&Ptr[Index], Instruction, Jumps);
-                break;
-                
-            case 56:
-                CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                Index += HKHubArchJITGenerateJul(&Ptr[Index], Instruction, Jumps);
-                break;
-                
-            case 57:
-                CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                Index += HKHubArchJITGenerateJuge(&Ptr[Index], Instruction, Jumps);
-                break;
-                
-            case 58:
-                CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                Index += HKHubArchJITGenerateJule(&Ptr[Index], Instruction, Jumps);
-                break;
-                
-            case 59:
-                CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                Index += HKHubArchJITGenerateJug(&Ptr[Index], Instruction, Jumps);
-                break;
-                
-            case 63:
-                CCDictionarySetValue(Offsets, &Instruction->offset, &Index);
-                CCArrayAppendElement(JITBlock->map, &(HKHubArchJITBlockRelativeEntry){ .entry = (uintptr_t)(Ptr + Index), .index = InstructionIndex });
-                Index += HKHubArchJITGenerateJmp(&Ptr[Index], Instruction, Jumps);
-                break;
-                
-            default:
-                if (Index != ReturnIndex)
+                if (Checks[InstructionIndex] != SIZE_MAX)
                 {
-                    HKHubArchJITAddInstructionReturn(Ptr, &Index);
-                    ReturnIndex = Index;
+                    const size_t Check = Checks[InstructionIndex];
+                    
+                    *(uint32_t*)&Ptr[Check + HK_HUB_ARCH_JIT_BUDGET_CHECK_IMM32] = (uint32_t)Budget;
+                    *(int32_t*)&Ptr[Check + HK_HUB_ARCH_JIT_BUDGET_CHECK_REL32] = (int32_t)(Fast[InstructionIndex] - (Check + HK_HUB_ARCH_JIT_BUDGET_CHECK_SIZE));
+                    
+                    CCArrayAppendElement(JITBlock->checks, &(size_t){ Check + HK_HUB_ARCH_JIT_BUDGET_CHECK_JUMP });
                 }
-                break;
+            }
+        }
+        
+        else
+        {
+            for (size_t InstructionIndex = 0; InstructionIndex < Count; InstructionIndex++)
+            {
+                if (Checks[InstructionIndex] != SIZE_MAX) HKHubArchJITDisableFastPath(&Ptr[Checks[InstructionIndex] + HK_HUB_ARCH_JIT_BUDGET_CHECK_JUMP]);
+            }
         }
     }
     
@@ -3015,19 +3273,16 @@ _Bool HKHubArchJITGenerateBlock(HKHubArchJIT JIT, HKHubArchJITBlock *JITBlock, v
         size_t *Index = CCDictionaryGetValue(Offsets, &Ref->pc);
         
         if (Index) *Ref->rel = (int32_t)(*Index - ((ptrdiff_t)Ref->rel - (ptrdiff_t)Ptr) - 4);
-        else *Ref->jump = HKHubArchJITOpcodeRetn;
+        else
+        {
+            *Ref->jump = HKHubArchJITOpcodeRetn;
+            CCArrayAppendElement(JITBlock->exits, &(HKHubArchJITBlockExit){ .offset = Ref->jump - (uint8_t*)Ptr, .pc = Ref->pc });
+        }
     }
     
     CCDictionaryDestroy(Offsets);
     CCArrayDestroy(Jumps);
     
-    if (Index != ReturnIndex)
-    {
-        HKHubArchJITAddInstructionReturn(Ptr, &Index);
-        
-        return TRUE;
-    }
-    
     return Index;
 }
 
@@ -3036,19 +3291,39 @@ void HKHubArchJITRemoveEntry(void *Entry)
     HKHubArchJITAddInstructionReturn(Entry, &(size_t){ 0 });
 }
 
+_Bool HKHubArchJITLinkExit(void *Exit, uintptr_t Address, uintptr_t Target)
+{
+    const ptrdiff_t Rel = (ptrdiff_t)Target - (ptrdiff_t)(Address + 5);
+    if ((Rel < INT32_MIN) || (Rel > INT32_MAX)) return FALSE;
+    
+    /*
+     The exit is a retn followed by the unused rel32 of the original jump, so the displacement is written before
+     the opcode is restored.
+     */
+    *(int32_t*)((uint8_t*)Exit + 1) = (int32_t)Rel;
+    HKHubArchJITAddInstructionJumpRel32(Exit, &(size_t){ 0 }, HKHubArchJITJumpUnconditional, (int32_t)Rel);
+    
+    return TRUE;
+}
+
+void HKHubArchJITUnlinkExit(void *Exit)
+{
+    HKHubArchJITAddInstructionReturn(Exit, &(size_t){ 0 });
+}
+
 void HKHubArchJITCall(HKHubArchJIT JIT, HKHubArchProcessor Processor)
 {
-    const HKHubArchJITBlockReferenceEntry *Entry = CCDictionaryGetValue(JIT->map, &Processor->state.pc);
-    if (!Entry) return;
-    
-#define HK_HUB_ARCH_JIT_Processor_r0 56
-#define HK_HUB_ARCH_JIT_Processor_r1 57
-#define HK_HUB_ARCH_JIT_Processor_r2 58
-#define HK_HUB_ARCH_JIT_Processor_r3 59
-#define HK_HUB_ARCH_JIT_Processor_pc 60
-#define HK_HUB_ARCH_JIT_Processor_flags 61
-#define HK_HUB_ARCH_JIT_Processor_cycles 160
-#define HK_HUB_ARCH_JIT_Processor_memory 180
+    const HKHubArchJITBlockReferenceEntry *Entry = &JIT->entries[Processor->state.pc];
+    if (!Entry->block) return;
+    
+#define HK_HUB_ARCH_JIT_Processor_r0 16
+#define HK_HUB_ARCH_JIT_Processor_r1 17
+#define HK_HUB_ARCH_JIT_Processor_r2 18
+#define HK_HUB_ARCH_JIT_Processor_r3 19
+#define HK_HUB_ARCH_JIT_Processor_pc 20
+#define HK_HUB_ARCH_JIT_Processor_flags 21
+#define HK_HUB_ARCH_JIT_Processor_cycles 8
+#define HK_HUB_ARCH_JIT_Processor_memory 240
     
     _Static_assert(HK_HUB_ARCH_JIT_Processor_r0 == offsetof(typeof(*Processor), state.r[0]) &&
                    HK_HUB_ARCH_JIT_Processor_r1 == offsetof(typeof(*Processor), state.r[1]) &&
@@ -25,18 +25,15 @@
 
 #include "HubModule.h"
 
-static uintmax_t HKHubModulePortHasher(HKHubArchPortID *Key)
-{
-    return *Key;
-}
-
 static void HKHubModuleDestructor(HKHubModule Module)
 {
     if (Module->destructor) Module->destructor(Module->internal);
     if (Module->memory) CCDataDestroy(Module->memory);
     
-    CC_DICTIONARY_FOREACH_VALUE(HKHubArchPortConnection, Connection, Module->ports)
+    HK_HUB_ARCH_PORT_TABLE_FOREACH(Port, &Module->ports)
     {
+        HKHubArchPortConnection Connection = HKHubArchPortTableGetConnection(&Module->ports, Port);
+        
         for (int Loop = 0; Loop < 2; Loop++)
         {
             if (Connection->port[Loop].device == Module) Connection->port[Loop].disconnect = NULL;
@@ -45,7 +42,7 @@ static void HKHubModuleDestructor(HKHubModule Module)
         HKHubArchPortConnectionDisconnect(Connection);
     }
     
-    CCDictionaryDestroy(Module->ports);
+    HKHubArchPortTableClear(&Module->ports);
 }
 
 HKHubModule HKHubModuleCreate(CCAllocatorType Allocator, HKHubArchPortTransmit Send, HKHubArchPortTransmit Receive, void *Internal, HKHubModuleDataDestructor Destructor, CCData Memory)
@@ -54,10 +51,7 @@ HKHubModule HKHubModuleCreate(CCAllocatorType Allocator, HKHubArchPortTransmit S
     
     if (Module)
     {
-        Module->ports = CCDictionaryCreate(Allocator, CCDictionaryHintHeavyFinding, sizeof(HKHubArchPortID), sizeof(HKHubArchPortConnection), &(CCDictionaryCallbacks){
-            .getHash = (CCDictionaryKeyHasher)HKHubModulePortHasher,
-            .valueDestructor = HKHubArchPortConnectionDestructorForDictionary
-        });
+        HKHubArchPortTableInit(&Module->ports);
         
         Module->send = Send;
         Module->receive = Receive;
@@ -85,7 +79,7 @@ void HKHubModuleDestroy(HKHubModule Module)
 
 static void HKHubModuleDisconnectPort(HKHubModule Module, HKHubArchPortID Port)
 {
-    CCDictionaryRemoveValue(Module->ports, &Port);
+    HKHubArchPortTableSetConnection(&Module->ports, Port, NULL);
     
     if (Module->debug.portConnectionChange) Module->debug.portConnectionChange(Module, Port);
 }
@@ -106,18 +100,17 @@ void HKHubModuleConnect(HKHubModule Module, HKHubArchPortID Port, HKHubArchPortC
     CCAssertLog(Module, "Module must not be null");
     CCAssertLog(Connection, "Connection must not be null");
     
-    CCDictionaryEntry Entry = CCDictionaryEntryForKey(Module->ports, &Port);
+    HKHubArchPortConnection OldConnection = HKHubArchPortTableGetConnection(&Module->ports, Port);
     
-    if (CCDictionaryEntryIsInitialized(Module->ports, Entry))
+    if (OldConnection)
     {
-        HKHubArchPortConnection OldConnection = *(HKHubArchPortConnection*)CCDictionaryGetEntry(Module->ports, Entry);
         HKHubModuleSetConnectionDisconnectCallback(Module, Port, OldConnection, NULL);
         HKHubArchPortConnectionDisconnect(OldConnection);
     }
     
     HKHubModuleSetConnectionDisconnectCallback(Module, Port, Connection, (HKHubArchPortDisconnect)HKHubModuleDisconnectPort);
     
-    CCDictionarySetEntry(Module->ports, Entry, &(HKHubArchPortConnection){ CCRetain(Connection) });
+    HKHubArchPortTableSetConnection(&Module->ports, Port, CCRetain(Connection));
     
     if (Module->debug.portConnectionChange) Module->debug.portConnectionChange(Module, Port);
 }
@@ -126,9 +119,9 @@ void HKHubModuleDisconnect(HKHubModule Module, HKHubArchPortID Port)
 {
     CCAssertLog(Module, "Module must not be null");
     
-    HKHubArchPortConnection *Connection = CCDictionaryGetValue(Module->ports, &Port);
+    HKHubArchPortConnection Connection = HKHubArchPortTableGetConnection(&Module->ports, Port);
     
-    if (Connection) HKHubArchPortConnectionDisconnect(*Connection);
+    if (Connection) HKHubArchPortConnectionDisconnect(Connection);
 }
 
 HKHubArchPort HKHubModuleGetPort(HKHubModule Module, HKHubArchPortID Port)
@@ -141,7 +134,8 @@ HKHubArchPort HKHubModuleGetPort(HKHubModule Module, HKHubArchPortID Port)
         .disconnect = NULL,
         .sender = (HKHubArchPortTransmit)Module->send,
         .receiver = (HKHubArchPortTransmit)Module->receive,
-        .ready = NULL
+        .ready = NULL,
+        .ports = &Module->ports
     };
 }
 
@@ -149,7 +143,5 @@ HKHubArchPortConnection HKHubModuleGetPortConnection(HKHubModule Module, HKHubAr
 {
     CCAssertLog(Module, "Module must not be null");
     
-    HKHubArchPortConnection *Connection = CCDictionaryGetValue(Module->ports, &Port);
-    
-    return Connection ? *Connection : NULL;
+    return HKHubArchPortTableGetConnection(&Module->ports, Port);
 }
@@ -48,7 +48,6 @@ typedef void (*HKHubModuleDataDestructor)(void *Internal);
 
 typedef struct HKHubModuleInfo {
     void *internal;
-    CCDictionary(HKHubArchPortID, HKHubArchPortConnection) ports;
     HKHubArchPortTransmit send;
     HKHubArchPortTransmit receive;
     HKHubModuleDataDestructor destructor;
@@ -58,6 +57,7 @@ typedef struct HKHubModuleInfo {
         uintptr_t extra;
         HKHubModuleDebugPortConnectionChangeCallback portConnectionChange;
     } debug;
+    HKHubArchPortTable ports;
 } HKHubModuleInfo;
 
 
@@ -154,6 +154,13 @@ typedef struct {
     HKHubModuleDebugControllerDeviceEventBuffer events;
     size_t index;
     CCString name;
+    struct {
+        uint8_t r[4];
+        uint8_t flags;
+        uint8_t pc;
+        uint8_t memory[256];
+        _Bool running;
+    } snapshot;
 } HKHubModuleDebugControllerDevice;
 
 CC_ARRAY_DECLARE(HKHubModuleDebugControllerDevice);
@@ -596,13 +603,11 @@ static HKHubArchPortResponse HKHubModuleDebugControllerReceive(HKHubArchPortConn
                                     
                                     if (Message->size == 2)
                                     {
-                                        if (Device->processor->state.debug.breakpoints)
+                                        if (HKHubArchProcessorHasBreakpoints(Device->processor))
                                         {
                                             for (size_t Loop = 0, Count = 256; Loop < Count; Loop++)
                                             {
-                                                HKHubArchProcessorDebugBreakpoint CurrentBP = 0;
-                                                HKHubArchProcessorDebugBreakpoint *Breakpoint = CCDictionaryGetValue(Device->processor->state.debug.breakpoints, &(uint8_t){ Loop });
-                                                if (Breakpoint) CurrentBP = *Breakpoint;
+                                                const HKHubArchProcessorDebugBreakpoint CurrentBP = HKHubArchProcessorGetBreakpoint(Device->processor, (uint8_t)Loop);
                                                 
                                                 if (Index % 4 == 0) State->queryPortState[Port].message[Index / 4] = 0;
                                                 
@@ -620,15 +625,13 @@ static HKHubArchPortResponse HKHubModuleDebugControllerReceive(HKHubArchPortConn
                                     
                                     else
                                     {
-                                        if (Device->processor->state.debug.breakpoints)
+                                        if (HKHubArchProcessorHasBreakpoints(Device->processor))
                                         {
                                             for (size_t Loop = 2, Count = Message->size; Loop < Count; Loop++)
                                             {
                                                 const uint8_t Offset = HKHubModuleDebugControllerMessageGetU8(Message, Loop);
                                                 
-                                                HKHubArchProcessorDebugBreakpoint CurrentBP = 0;
-                                                HKHubArchProcessorDebugBreakpoint *Breakpoint = CCDictionaryGetValue(Device->processor->state.debug.breakpoints, &Offset);
-                                                if (Breakpoint) CurrentBP = *Breakpoint;
+                                                const HKHubArchProcessorDebugBreakpoint CurrentBP = HKHubArchProcessorGetBreakpoint(Device->processor, Offset);
                                                 
                                                 if (Index % 4 == 0) State->queryPortState[Port].message[Index] = 0;
                                                 
@@ -668,7 +671,7 @@ static HKHubArchPortResponse HKHubModuleDebugControllerReceive(HKHubArchPortConn
                                     memset(State->queryPortState[Port].message, 0, 32);
                                     State->queryPortState[Port].size = 32;
                                     
-                                    CC_DICTIONARY_FOREACH_KEY(HKHubArchPortID, PortID, Device->processor->ports)
+                                    HK_HUB_ARCH_PORT_TABLE_FOREACH(PortID, &Device->processor->ports)
                                     {
                                         const size_t Index = PortID / 8;
                                         State->queryPortState[Port].message[Index] |= 1 << (7 - (PortID - (Index * 8)));
@@ -749,12 +752,7 @@ static HKHubArchPortResponse HKHubModuleDebugControllerReceive(HKHubArchPortConn
                                     {
                                         const uint8_t Offset = HKHubModuleDebugControllerMessageGetU8(Message, Loop);
                                         
-                                        HKHubArchProcessorDebugBreakpoint CurrentBP = 0;
-                                        if (Device->processor->state.debug.breakpoints)
-                                        {
-                                            HKHubArchProcessorDebugBreakpoint *Breakpoint = CCDictionaryGetValue(Device->processor->state.debug.breakpoints, &Offset);
-                                            if (Breakpoint) CurrentBP = *Breakpoint;
-                                        }
+                                        const HKHubArchProcessorDebugBreakpoint CurrentBP = HKHubArchProcessorGetBreakpoint(Device->processor, Offset);
                                         
                                         HKHubArchProcessorSetBreakpoint(Device->processor, CurrentBP ^ HKHubModuleDebugControllerMessageGetU8(Message, Loop + 1), Offset);
                                     }
@@ -1214,15 +1212,16 @@ static void HKHubModuleDebugControllerStateDestructor(HKHubModuleDebugController
         switch (Device->type)
         {
             case HKHubModuleDebugControllerDeviceTypeProcessor:
-                Device->processor->state.debug.operation = NULL;
-                Device->processor->state.debug.portConnectionChange = NULL;
-                Device->processor->state.debug.breakpointChange = NULL;
-                Device->processor->state.debug.debugModeChange = NULL;
+                Device->processor->debug.trace = NULL;
+                Device->processor->debug.portConnectionChange = NULL;
+                Device->processor->debug.breakpointChange = NULL;
+                Device->processor->debug.debugModeChange = NULL;
                 
-                Device->processor->state.debug.context = NULL;
-                Device->processor->state.debug.extra = 0;
+                Device->processor->debug.context = NULL;
+                Device->processor->debug.extra = 0;
                 
                 HKHubArchProcessorSetDebugMode(Device->processor, HKHubArchProcessorDebugModeContinue);
+                HKHubArchProcessorCacheDebug(Device->processor, FALSE);
                 break;
                 
             case HKHubModuleDebugControllerDeviceTypeModule:
@@ -1290,28 +1289,93 @@ HKHubModule HKHubModuleDebugControllerCreate(CCAllocatorType Allocator)
     return NULL;
 }
 
-static void HKHubModuleDebugControllerInstructionHook(HKHubArchProcessor Processor, const HKHubArchInstructionState *Instruction, const uint8_t Encoding[5])
+static void HKHubModuleDebugControllerPushRegisterChange(HKHubModuleDebugControllerState *State, HKHubModuleDebugControllerDevice *Device, HKHubArchInstructionRegister Reg, uint8_t Value)
 {
-    HKHubModuleDebugControllerState *State = ((HKHubModule)Processor->state.debug.context)->internal;
-    HKHubModuleDebugControllerDevice *Device = CCArrayGetElementAtIndex(State->devices, Processor->state.debug.extra);
+    HKHubModuleDebugControllerPushEvent(State, &Device->events, &(HKHubModuleDebugControllerDeviceEvent){
+        .type = HKHubModuleDebugControllerDeviceEventTypeModifyRegister,
+        .device = (uint16_t)Device->index,
+        .reg = Reg
+    });
+    
+    HKHubModuleDebugControllerPushEvent(State, &Device->events, &(HKHubModuleDebugControllerDeviceEvent){
+        .type = HKHubModuleDebugControllerDeviceEventTypeChangedDataChunk,
+        .device = (uint16_t)Device->index,
+        .data = {
+            .small[0] = Value,
+            .size = 1
+        }
+    });
+}
+
+static void HKHubModuleDebugControllerPushMemoryChange(HKHubModuleDebugControllerState *State, HKHubModuleDebugControllerDevice *Device, uint8_t Offset, uint8_t Size)
+{
+    HKHubModuleDebugControllerPushEvent(State, &Device->events, &(HKHubModuleDebugControllerDeviceEvent){
+        .type = HKHubModuleDebugControllerDeviceEventTypeModifyMemory,
+        .device = (uint16_t)Device->index,
+        .memory = {
+            .offset = Offset,
+            .size = Size
+        }
+    });
+    
+    HKHubModuleDebugControllerDeviceEvent Event = {
+        .type = HKHubModuleDebugControllerDeviceEventTypeChangedDataChunk,
+        .device = (uint16_t)Device->index,
+        .data = {
+            .size = Size
+        }
+    };
+    
+    if (Size <= sizeof(Event.data.small))
+    {
+        CCMemoryRead(Device->processor->memory, sizeof(Device->processor->memory), Offset, Size, Event.data.small);
+    }
+    
+    else
+    {
+        uint8_t *Bytes;
+        CC_SAFE_Malloc(Bytes, Size,
+                       CC_LOG_ERROR("Failed to create event data chunk, due to allocation failure (%u)", Size);
+                       return;
+                       );
+        
+        CCMemoryRead(Device->processor->memory, sizeof(Device->processor->memory), Offset, Size, Bytes);
+        
+        Event.data.big = CCDataBufferCreate(CC_STD_ALLOCATOR, CCDataBufferHintFree | CCDataHintRead, Size, Bytes, NULL, NULL);
+    }
+    
+    HKHubModuleDebugControllerPushEvent(State, &Device->events, &Event);
+}
+
+static void HKHubModuleDebugControllerTraceHook(HKHubArchProcessor Processor, uint8_t Entry, uint8_t Exit, size_t Cycles)
+{
+    /*
+     Instructions are only reported as they're executed while stepping, as they're always traced individually by the
+     interpreter (so the modified state applies). Anything executed while running is reported as the changes to the
+     processor state once it's paused.
+     */
+    if (Processor->state.debug.mode != HKHubArchProcessorDebugModePause) return;
+    
+    HKHubModuleDebugControllerState *State = ((HKHubModule)Processor->debug.context)->internal;
+    HKHubModuleDebugControllerDevice *Device = CCArrayGetElementAtIndex(State->devices, Processor->debug.extra);
+    
+    HKHubArchInstructionState Instruction;
+    const uint8_t NextPC = HKHubArchInstructionDecode(Entry, Processor->memory, &Instruction);
+    
+    uint8_t Encoding[5] = { 0, 0, 0, 0, 0 };
+    for (uint8_t Loop = 0, Offset = Entry; (Offset != NextPC) && (Loop < sizeof(Encoding)); Offset++, Loop++) Encoding[Loop] = Processor->memory[Offset];
     
     HKHubModuleDebugControllerPushEvent(State, &Device->events, &(HKHubModuleDebugControllerDeviceEvent){
         .type = HKHubModuleDebugControllerDeviceEventTypeExecutedOperation,
         .device = (uint16_t)Device->index,
         .instruction = {
             .encoding = { Encoding[0], Encoding[1], Encoding[2], Encoding[3], Encoding[4] },
-            .size = HKHubArchInstructionSizeOfEncoding(Instruction)
+            .size = HKHubArchInstructionSizeOfEncoding(&Instruction)
         }
     });
     
     if (Processor->state.debug.modified.reg & (HKHubArchInstructionRegisterGeneralPurpose | HKHubArchInstructionRegisterSpecialPurpose))
     {
-        HKHubModuleDebugControllerPushEvent(State, &Device->events, &(HKHubModuleDebugControllerDeviceEvent){
-            .type = HKHubModuleDebugControllerDeviceEventTypeModifyRegister,
-            .device = (uint16_t)Device->index,
-            .reg = Processor->state.debug.modified.reg
-        });
-        
         uint8_t Value;
         switch (Processor->state.debug.modified.reg)
         {
@@ -1344,89 +1408,61 @@ static void HKHubModuleDebugControllerInstructionHook(HKHubArchProcessor Process
                 break;
         }
         
-        HKHubModuleDebugControllerPushEvent(State, &Device->events, &(HKHubModuleDebugControllerDeviceEvent){
-            .type = HKHubModuleDebugControllerDeviceEventTypeChangedDataChunk,
-            .device = (uint16_t)Device->index,
-            .data = {
-                .small[0] = Value,
-                .size = 1
-            }
-        });
+        HKHubModuleDebugControllerPushRegisterChange(State, Device, Processor->state.debug.modified.reg, Value);
     }
     
-    if (Processor->state.debug.modified.size)
+    if (Processor->state.debug.modified.size) HKHubModuleDebugControllerPushMemoryChange(State, Device, Processor->state.debug.modified.offset, Processor->state.debug.modified.size);
+    
+    if ((Processor->state.debug.modified.reg != HKHubArchInstructionRegisterFlags) && (HKHubArchInstructionGetModifiedFlags(&Instruction)))
     {
-        HKHubModuleDebugControllerPushEvent(State, &Device->events, &(HKHubModuleDebugControllerDeviceEvent){
-            .type = HKHubModuleDebugControllerDeviceEventTypeModifyMemory,
-            .device = (uint16_t)Device->index,
-            .memory = {
-                .offset = Processor->state.debug.modified.offset,
-                .size = Processor->state.debug.modified.size
-            }
-        });
-        
-        HKHubModuleDebugControllerDeviceEvent Event = {
-            .type = HKHubModuleDebugControllerDeviceEventTypeChangedDataChunk,
-            .device = (uint16_t)Device->index,
-            .data = {
-                .size = Processor->state.debug.modified.size
-            }
-        };
-        
-        if (Processor->state.debug.modified.size <= sizeof(Event.data.small))
-        {
-            CCMemoryRead(Processor->memory, sizeof(Processor->memory), Processor->state.debug.modified.offset, Processor->state.debug.modified.size, Event.data.small);
-        }
-        
-        else
-        {
-            uint8_t *Bytes;
-            CC_SAFE_Malloc(Bytes, Processor->state.debug.modified.size,
-                           CC_LOG_ERROR("Failed to create event data chunk, due to allocation failure (%u)", Processor->state.debug.modified.size);
-                           return;
-                           );
-            
-            Event.data.big = CCDataBufferCreate(CC_STD_ALLOCATOR, CCDataBufferHintFree | CCDataHintRead, Processor->state.debug.modified.size, Bytes, NULL, NULL);
-        }
-        
-        HKHubModuleDebugControllerPushEvent(State, &Device->events, &Event);
+        HKHubModuleDebugControllerPushRegisterChange(State, Device, HKHubArchInstructionRegisterFlags, Processor->state.flags);
     }
     
-    if ((Processor->state.debug.modified.reg != HKHubArchInstructionRegisterFlags) && (HKHubArchInstructionGetModifiedFlags(Instruction)))
+    if ((Processor->state.debug.modified.reg != HKHubArchInstructionRegisterPC) && (!(HKHubArchInstructionGetControlFlow(&Instruction) & HKHubArchInstructionControlFlowEffectPause)))
     {
-        HKHubModuleDebugControllerPushEvent(State, &Device->events, &(HKHubModuleDebugControllerDeviceEvent){
-            .type = HKHubModuleDebugControllerDeviceEventTypeModifyRegister,
-            .device = (uint16_t)Device->index,
-            .reg = HKHubArchInstructionRegisterFlags
-        });
-        
-        HKHubModuleDebugControllerPushEvent(State, &Device->events, &(HKHubModuleDebugControllerDeviceEvent){
-            .type = HKHubModuleDebugControllerDeviceEventTypeChangedDataChunk,
-            .device = (uint16_t)Device->index,
-            .data = {
-                .small[0] = Processor->state.flags,
-                .size = 1
-            }
-        });
+        HKHubModuleDebugControllerPushRegisterChange(State, Device, HKHubArchInstructionRegisterPC, Processor->state.pc);
     }
+}
+
+static void HKHubModuleDebugControllerSnapshotProcessor(HKHubModuleDebugControllerDevice *Device)
+{
+    memcpy(Device->snapshot.r, Device->processor->state.r, sizeof(Device->snapshot.r));
+    Device->snapshot.flags = Device->processor->state.flags;
+    Device->snapshot.pc = Device->processor->state.pc;
+    memcpy(Device->snapshot.memory, Device->processor->memory, sizeof(Device->snapshot.memory));
+    
+    Device->snapshot.running = TRUE;
+}
+
+static void HKHubModuleDebugControllerPushProcessorChanges(HKHubModuleDebugControllerState *State, HKHubModuleDebugControllerDevice *Device)
+{
+    const HKHubArchProcessor Processor = Device->processor;
     
-    if ((Processor->state.debug.modified.reg != HKHubArchInstructionRegisterPC) && (!(HKHubArchInstructionGetControlFlow(Instruction) & HKHubArchInstructionControlFlowEffectPause)))
+    for (size_t Loop = 0; Loop < 4; Loop++)
     {
-        HKHubModuleDebugControllerPushEvent(State, &Device->events, &(HKHubModuleDebugControllerDeviceEvent){
-            .type = HKHubModuleDebugControllerDeviceEventTypeModifyRegister,
-            .device = (uint16_t)Device->index,
-            .reg = HKHubArchInstructionRegisterPC
-        });
+        if (Device->snapshot.r[Loop] != Processor->state.r[Loop]) HKHubModuleDebugControllerPushRegisterChange(State, Device, (HKHubArchInstructionRegister)Loop | HKHubArchInstructionRegisterGeneralPurpose, Processor->state.r[Loop]);
+    }
+    
+    for (size_t Offset = 0; Offset < sizeof(Processor->memory); )
+    {
+        if (Device->snapshot.memory[Offset] == Processor->memory[Offset])
+        {
+            Offset++;
+            continue;
+        }
         
-        HKHubModuleDebugControllerPushEvent(State, &Device->events, &(HKHubModuleDebugControllerDeviceEvent){
-            .type = HKHubModuleDebugControllerDeviceEventTypeChangedDataChunk,
-            .device = (uint16_t)Device->index,
-            .data = {
-                .small[0] = Processor->state.pc,
-                .size = 1
-            }
-        });
+        size_t Size = 1;
+        while ((Offset + Size < sizeof(Processor->memory)) && (Size < UINT8_MAX) && (Device->snapshot.memory[Offset + Size] != Processor->memory[Offset + Size])) Size++;
+        
+        HKHubModuleDebugControllerPushMemoryChange(State, Device, (uint8_t)Offset, (uint8_t)Size);
+        
+        Offset += Size;
     }
+    
+    if (Device->snapshot.flags != Processor->state.flags) HKHubModuleDebugControllerPushRegisterChange(State, Device, HKHubArchInstructionRegisterFlags, Processor->state.flags);
+    if (Device->snapshot.pc != Processor->state.pc) HKHubModuleDebugControllerPushRegisterChange(State, Device, HKHubArchInstructionRegisterPC, Processor->state.pc);
+    
+    Device->snapshot.running = FALSE;
 }
 
 static void HKHubModuleDebugControllerPortConnectionChangeHook(void *DebuggedDevice, HKHubArchPortID Port, HKHubModuleDebugControllerState *State, size_t Index, HKHubArchPortConnection Conn)
@@ -1475,7 +1511,7 @@ static void HKHubModuleDebugControllerPortConnectionChangeHook(void *DebuggedDev
 
 static void HKHubModuleDebugControllerProcessorPortConnectionChangeHook(HKHubArchProcessor Processor, HKHubArchPortID Port)
 {
-    HKHubModuleDebugControllerPortConnectionChangeHook(Processor, Port, ((HKHubModule)Processor->state.debug.context)->internal, Processor->state.debug.extra, HKHubArchProcessorGetPortConnection(Processor, Port));
+    HKHubModuleDebugControllerPortConnectionChangeHook(Processor, Port, ((HKHubModule)Processor->debug.context)->internal, Processor->debug.extra, HKHubArchProcessorGetPortConnection(Processor, Port));
 }
 
 static void HKHubModuleDebugControllerModulePortConnectionChangeHook(HKHubModule Module, HKHubArchPortID Port)
@@ -1485,8 +1521,8 @@ static void HKHubModuleDebugControllerModulePortConnectionChangeHook(HKHubModule
 
 static void HKHubModuleDebugControllerBreakpointChangeHook(HKHubArchProcessor Processor, HKHubArchProcessorDebugBreakpoint Breakpoint, uint8_t Offset)
 {
-    HKHubModuleDebugControllerState *State = ((HKHubModule)Processor->state.debug.context)->internal;
-    HKHubModuleDebugControllerDevice *Device = CCArrayGetElementAtIndex(State->devices, Processor->state.debug.extra);
+    HKHubModuleDebugControllerState *State = ((HKHubModule)Processor->debug.context)->internal;
+    HKHubModuleDebugControllerDevice *Device = CCArrayGetElementAtIndex(State->devices, Processor->debug.extra);
     
     HKHubModuleDebugControllerPushEvent(State, &Device->events, &(HKHubModuleDebugControllerDeviceEvent){
         .type = HKHubModuleDebugControllerDeviceEventTypeChangeBreakpoint,
@@ -1500,12 +1536,15 @@ static void HKHubModuleDebugControllerBreakpointChangeHook(HKHubArchProcessor Pr
 
 static void HKHubModuleDebugControllerDebugModeChangeHook(HKHubArchProcessor Processor)
 {
-    HKHubModuleDebugControllerState *State = ((HKHubModule)Processor->state.debug.context)->internal;
-    HKHubModuleDebugControllerDevice *Device = CCArrayGetElementAtIndex(State->devices, Processor->state.debug.extra);
+    HKHubModuleDebugControllerState *State = ((HKHubModule)Processor->debug.context)->internal;
+    HKHubModuleDebugControllerDevice *Device = CCArrayGetElementAtIndex(State->devices, Processor->debug.extra);
     
     _Static_assert((HKHubArchProcessorDebugModePause == HKHubModuleDebugControllerDeviceEventTypePause) &&
                    (HKHubArchProcessorDebugModeContinue == HKHubModuleDebugControllerDeviceEventTypeRun), "Expects enums to match");
     
+    if (Processor->state.debug.mode == HKHubArchProcessorDebugModeContinue) HKHubModuleDebugControllerSnapshotProcessor(Device);
+    else if (Device->snapshot.running) HKHubModuleDebugControllerPushProcessorChanges(State, Device);
+    
     HKHubModuleDebugControllerPushEvent(State, &Device->events, &(HKHubModuleDebugControllerDeviceEvent){
         .type = (HKHubModuleDebugControllerDeviceEventType)Processor->state.debug.mode,
         .device = (uint16_t)Device->index
@@ -1516,7 +1555,7 @@ void HKHubModuleDebugControllerConnectProcessor(HKHubModule Controller, HKHubArc
 {
     CCAssertLog(Controller, "Controller must not be null");
     CCAssertLog(Processor, "Processor must not be null");
-    CCAssertLog(!Processor->state.debug.context, "Processor must not already be debugged");
+    CCAssertLog(!Processor->debug.context, "Processor must not already be debugged");
     
     HKHubModuleDebugControllerState *State = Controller->internal;
     const size_t Index = CCArrayAppendElement(State->devices, &(HKHubModuleDebugControllerDevice){
@@ -1530,16 +1569,17 @@ void HKHubModuleDebugControllerConnectProcessor(HKHubModule Controller, HKHubArc
     });
     
     HKHubArchProcessorSetDebugMode(Processor, HKHubArchProcessorDebugModePause);
+    HKHubArchProcessorCacheDebug(Processor, TRUE);
     
     HKHubModuleDebugControllerDevice * const Device = CCArrayGetElementAtIndex(State->devices, Index);
     
-    Processor->state.debug.context = Controller;
-    Processor->state.debug.extra = Index;
+    Processor->debug.context = Controller;
+    Processor->debug.extra = Index;
     
-    Processor->state.debug.operation = HKHubModuleDebugControllerInstructionHook;
-    Processor->state.debug.portConnectionChange = HKHubModuleDebugControllerProcessorPortConnectionChangeHook;
-    Processor->state.debug.breakpointChange = HKHubModuleDebugControllerBreakpointChangeHook;
-    Processor->state.debug.debugModeChange = HKHubModuleDebugControllerDebugModeChangeHook;
+    Processor->debug.trace = HKHubModuleDebugControllerTraceHook;
+    Processor->debug.portConnectionChange = HKHubModuleDebugControllerProcessorPortConnectionChangeHook;
+    Processor->debug.breakpointChange = HKHubModuleDebugControllerBreakpointChangeHook;
+    Processor->debug.debugModeChange = HKHubModuleDebugControllerDebugModeChangeHook;
     
     CCAssertLog(Index == (uint16_t)Index, "Too many devices connected");
     
@@ -1553,10 +1593,10 @@ void HKHubModuleDebugControllerDisconnectProcessor(HKHubModule Controller, HKHub
 {
     CCAssertLog(Controller, "Controller must not be null");
     CCAssertLog(Processor, "Processor must not be null");
-    CCAssertLog(Processor->state.debug.context == Controller, "Processor must be connected to the controller");
+    CCAssertLog(Processor->debug.context == Controller, "Processor must be connected to the controller");
     
-    HKHubModuleDebugControllerState *State = ((HKHubModule)Processor->state.debug.context)->internal;
-    HKHubModuleDebugControllerDevice *Device = CCArrayGetElementAtIndex(State->devices, Processor->state.debug.extra);
+    HKHubModuleDebugControllerState *State = ((HKHubModule)Processor->debug.context)->internal;
+    HKHubModuleDebugControllerDevice *Device = CCArrayGetElementAtIndex(State->devices, Processor->debug.extra);
     Device->type = HKHubModuleDebugControllerDeviceTypeNone;
     Device->processor = NULL;
     
@@ -1565,15 +1605,16 @@ void HKHubModuleDebugControllerDisconnectProcessor(HKHubModule Controller, HKHub
         .device = (uint16_t)Device->index
     });
     
-    Processor->state.debug.operation = NULL;
-    Processor->state.debug.portConnectionChange = NULL;
-    Processor->state.debug.breakpointChange = NULL;
-    Processor->state.debug.debugModeChange = NULL;
+    Processor->debug.trace = NULL;
+    Processor->debug.portConnectionChange = NULL;
+    Processor->debug.breakpointChange = NULL;
+    Processor->debug.debugModeChange = NULL;
     
-    Processor->state.debug.context = NULL;
-    Processor->state.debug.extra = 0;
+    Processor->debug.context = NULL;
+    Processor->debug.extra = 0;
     
     HKHubArchProcessorSetDebugMode(Processor, HKHubArchProcessorDebugModeContinue);
+    HKHubArchProcessorCacheDebug(Processor, FALSE);
 }
 
 void HKHubModuleDebugControllerConnectModule(HKHubModule Controller, HKHubModule Module, CCString Name)
@@ -163,8 +163,29 @@ typedef struct {
 
 _Static_assert(sizeof(HKHubModuleGraphicsAdapterMemory) == (sizeof(((HKHubModuleGraphicsAdapterMemory*)NULL)->glyphs) + sizeof(((HKHubModuleGraphicsAdapterMemory*)NULL)->palettes) + sizeof(((HKHubModuleGraphicsAdapterMemory*)NULL)->layers) + sizeof(((HKHubModuleGraphicsAdapterMemory*)NULL)->programs)), "Expects adapter memory to be packed");
 
+#define HK_HUB_MODULE_GRAPHICS_ADAPTER_TILE_CACHE_SIZE 256
+
+/*
+ A tile is a single cell of a glyph (for a given animation) expanded to one palette index per pixel. Tiles are only valid
+ for the blit (generation) they were decoded in, as the glyph memory and animation frame may change between blits.
+ */
+typedef struct {
+    uint32_t generation;
+    uint32_t character;
+    uint8_t animationOffset;
+    uint8_t animationFilter;
+    uint8_t s;
+    uint8_t t;
+    _Bool visible;
+    /// The number of cells high of the glyph
+    uint8_t height;
+    uint8_t pixels[HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL * HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL];
+} HKHubModuleGraphicsAdapterTile;
+
 typedef struct {
     uint8_t frame;
+    uint32_t tileGeneration;
+    HKHubModuleGraphicsAdapterTile tiles[HK_HUB_MODULE_GRAPHICS_ADAPTER_TILE_CACHE_SIZE];
     HKHubModuleGraphicsAdapterAttributes attributes[HK_HUB_MODULE_GRAPHICS_ADAPTER_LAYER_COUNT];
     HKHubModuleGraphicsAdapterViewport viewports[256];
     HKHubModuleGraphicsAdapterMemory memory;
@@ -944,6 +965,51 @@ _Bool HKHubModuleGraphicsAdapterSetGlyphBitmap(HKHubModule Adapter, CCChar Chara
     return FALSE;
 }
 
+static const HKHubModuleGraphicsAdapterTile *HKHubModuleGraphicsAdapterGetTile(HKHubModule Adapter, uint32_t Character, uint8_t AnimationOffset, uint8_t AnimationFilter, uint8_t S, uint8_t T)
+{
+    HKHubModuleGraphicsAdapterState *State = Adapter->internal;
+    HKHubModuleGraphicsAdapterTile *Tile = &State->tiles[(Character ^ (Character >> 8) ^ (S << 5) ^ (T << 3) ^ (AnimationOffset << 1) ^ AnimationFilter) % HK_HUB_MODULE_GRAPHICS_ADAPTER_TILE_CACHE_SIZE];
+    
+    if ((Tile->generation == State->tileGeneration) && (Tile->character == Character) && (Tile->animationOffset == AnimationOffset) && (Tile->animationFilter == AnimationFilter) && (Tile->s == S) && (Tile->t == T))
+    {
+        return Tile->visible ? Tile : NULL;
+    }
+    
+    *Tile = (HKHubModuleGraphicsAdapterTile){
+        .generation = State->tileGeneration,
+        .character = Character,
+        .animationOffset = AnimationOffset,
+        .animationFilter = AnimationFilter,
+        .s = S,
+        .t = T,
+        .visible = FALSE
+    };
+    
+    uint8_t Width, Height, PaletteSize;
+    const uint8_t *Bitmap = HKHubModuleGraphicsAdapterGetGlyphBitmap(Adapter, Character, AnimationOffset, AnimationFilter, &Width, &Height, &PaletteSize);
+    
+    if ((!Bitmap) || (S > Width) || (T > Height)) return NULL;
+    
+    Width++;
+    PaletteSize++;
+    
+    Tile->height = Height + 1;
+    
+    const uint8_t PaletteMask = CCBitSet(PaletteSize);
+    const size_t SampleBase = (HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL * HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL * T * PaletteSize * Width) + (HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL * HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL * S * PaletteSize);
+    
+    for (size_t Loop = 0, SampleIndex = SampleBase; Loop < (HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL * HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL); Loop++, SampleIndex += PaletteSize)
+    {
+        const size_t MSBIndex = SampleIndex / 8;
+        const uint16_t Sample = ((uint16_t)Bitmap[MSBIndex] << 8) | Bitmap[MSBIndex + 1];
+        Tile->pixels[Loop] = ((Sample << (SampleIndex % 8)) >> (8 + (8 - PaletteSize))) & PaletteMask;
+    }
+    
+    Tile->visible = TRUE;
+    
+    return Tile;
+}
+
 void HKHubModuleGraphicsAdapterBlit(HKHubModule Adapter, HKHubArchPortID Port, uint8_t *Framebuffer, size_t Size)
 {
     CCAssertLog(Adapter, "Adapter must not be null");
@@ -956,6 +1022,12 @@ void HKHubModuleGraphicsAdapterBlit(HKHubModule Adapter, HKHubArchPortID Port, u
     Size = CCMin(Size, sizeof(State->mask));
     memset(Mask, 0, Size);
     
+    if (!++State->tileGeneration)
+    {
+        memset(State->tiles, 0, sizeof(State->tiles));
+        State->tileGeneration = 1;
+    }
+    
     const uint8_t Layer = Port % HK_HUB_MODULE_GRAPHICS_ADAPTER_LAYER_COUNT;
     const size_t ViewportWidth = (size_t)State->viewports[Port].width + 1, ViewportHeight = (size_t)State->viewports[Port].height + 1;
     
@@ -969,19 +1041,14 @@ void HKHubModuleGraphicsAdapterBlit(HKHubModule Adapter, HKHubArchPortID Port, u
             
             if (Index != -1)
             {
-                uint8_t Width, Height, PaletteSize;
-                const uint8_t *Bitmap = HKHubModuleGraphicsAdapterGetGlyphBitmap(Adapter, Index, HKHubModuleGraphicsAdapterCellGetAnimationOffset(Glyph), HKHubModuleGraphicsAdapterCellGetAnimationFilter(Glyph), &Width, &Height, &PaletteSize);
+                const HKHubModuleGraphicsAdapterTile *Tile = HKHubModuleGraphicsAdapterGetTile(Adapter, Index, HKHubModuleGraphicsAdapterCellGetAnimationOffset(Glyph), HKHubModuleGraphicsAdapterCellGetAnimationFilter(Glyph), S, T);
                 
-                if ((Bitmap) && (S <= Width) && (T <= Height))
+                if (Tile)
                 {
-                    Width++;
-                    Height++;
-                    PaletteSize++;
+                    const uint8_t *Palette = Memory->palettes[HKHubModuleGraphicsAdapterCellGetPalettePage(Glyph)] + HKHubModuleGraphicsAdapterCellGetPaletteOffset(Glyph);
+                    const _Bool Bold = HKHubModuleGraphicsAdapterCellIsBold(Glyph);
                     
-                    uint8_t PaletteMask = CCBitSet(PaletteSize);
-                    size_t SampleBase = (HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL * HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL * T * PaletteSize * Width) + (HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL * HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL * S * PaletteSize);
-                    
-                    const size_t PixelHeight = Height * HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL;
+                    const size_t PixelHeight = Tile->height * HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL;
                     const size_t Slope = HKHubModuleGraphicsAdapterCellIsItalic(Glyph) && State->attributes[Layer].style.slope ? State->attributes[Layer].style.slope : PixelHeight;
                     const size_t HalfSlope = (PixelHeight / Slope) / 2;
                     const size_t CenterPad = (PixelHeight % Slope) + (Slope * (HalfSlope % 2));
@@ -991,7 +1058,24 @@ void HKHubModuleGraphicsAdapterBlit(HKHubModule Adapter, HKHubArchPortID Port, u
                         ptrdiff_t Adjust = HalfSlope - (RelY / Slope);
                         if (Adjust < 0) Adjust = HalfSlope - ((RelY - (CenterPad - Slope)) / Slope);
                         
-                        for (size_t FramebufferX = (X - State->viewports[Port].x) * HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL, MaxX = CCMin(ViewportWidth * HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL, FramebufferX + HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL); FramebufferX < MaxX; FramebufferX++, SampleIndex += PaletteSize)
+                        const size_t RowX = (X - State->viewports[Port].x) * HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL;
+                        const size_t RowPixel = (FramebufferY * ViewportWidth * HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL) + RowX;
+                        
+                        if ((!Adjust) && (!Bold) && ((RowPixel + HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL) <= Size))
+                        {
+                            //Upright rows that are entirely inside the framebuffer can be written straight from the tile
+                            const uint8_t *Row = &Tile->pixels[SampleIndex];
+                            for (size_t Loop = 0; Loop < HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL; Loop++)
+                            {
+                                Framebuffer[RowPixel + Loop] = Palette[Row[Loop]];
+                                Mask[RowPixel + Loop] = 0x80 | (_Bool)Row[Loop];
+                            }
+                            
+                            SampleIndex += HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL;
+                            continue;
+                        }
+                        
+                        for (size_t FramebufferX = RowX, MaxX = CCMin(ViewportWidth * HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL, FramebufferX + HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL); FramebufferX < MaxX; FramebufferX++, SampleIndex++)
                         {
                             const ptrdiff_t OffsetX = FramebufferX + Adjust;
                             
@@ -1001,18 +1085,16 @@ void HKHubModuleGraphicsAdapterBlit(HKHubModule Adapter, HKHubArchPortID Port, u
                                 
                                 if (Pixel < Size)
                                 {
-                                    const size_t MSBIndex = (SampleBase + SampleIndex) / 8;
-                                    const uint16_t Sample = ((uint16_t)Bitmap[MSBIndex] << 8) | Bitmap[MSBIndex + 1];
-                                    const uint8_t PaletteIndex = ((Sample << ((SampleBase + SampleIndex) % 8)) >> (8 + (8 - PaletteSize))) & PaletteMask;
+                                    const uint8_t PaletteIndex = Tile->pixels[SampleIndex];
                                     
-                                    Framebuffer[Pixel] = Memory->palettes[HKHubModuleGraphicsAdapterCellGetPalettePage(Glyph)][PaletteIndex + HKHubModuleGraphicsAdapterCellGetPaletteOffset(Glyph)];
+                                    Framebuffer[Pixel] = Palette[PaletteIndex];
                                     Mask[Pixel] = 0x80 | (_Bool)PaletteIndex;
                                     
-                                    if ((PaletteIndex) && (HKHubModuleGraphicsAdapterCellIsBold(Glyph)))
+                                    if ((PaletteIndex) && (Bold))
                                     {
                                         if ((OffsetX - 1) >= 0)
                                         {
-                                            Framebuffer[Pixel - 1] = Memory->palettes[HKHubModuleGraphicsAdapterCellGetPalettePage(Glyph)][PaletteIndex + HKHubModuleGraphicsAdapterCellGetPaletteOffset(Glyph)];
+                                            Framebuffer[Pixel - 1] = Palette[PaletteIndex];
                                             Mask[Pixel - 1] = 0x80 | (_Bool)PaletteIndex;
                                         }
                                     }
@@ -1044,21 +1126,20 @@ void HKHubModuleGraphicsAdapterBlit(HKHubModule Adapter, HKHubArchPortID Port, u
     const HKHubModuleGraphicsAdapterCursor *Cursor = &State->attributes[Layer].cursor;
     const HKHubModuleGraphicsAdapterCell Glyph = Cursor->visibility;
     
-    uint8_t Width, Height, PaletteSize;
-    const uint8_t *Bitmap = HKHubModuleGraphicsAdapterGetGlyphBitmap(Adapter, HKHubModuleGraphicsAdapterCellGetGlyphIndex(Glyph), HKHubModuleGraphicsAdapterCellGetAnimationOffset(Glyph), HKHubModuleGraphicsAdapterCellGetAnimationFilter(Glyph), &Width, &Height, &PaletteSize);
+    uint8_t Width, Height;
+    const uint8_t *Bitmap = HKHubModuleGraphicsAdapterGetGlyphBitmap(Adapter, HKHubModuleGraphicsAdapterCellGetGlyphIndex(Glyph), HKHubModuleGraphicsAdapterCellGetAnimationOffset(Glyph), HKHubModuleGraphicsAdapterCellGetAnimationFilter(Glyph), &Width, &Height, NULL);
     
     if (Bitmap)
     {
         Width++;
         Height++;
-        PaletteSize++;
         
         const int CursorMinX = (int)Cursor->x - (Cursor->render.mode.originX ? (Width - 1) : 0);
         const int CursorMinY = (int)Cursor->y - (Cursor->render.mode.originY ? (Height - 1) : 0);
         const int CursorMaxX = CursorMinX + Width;
         const int CursorMaxY = CursorMinY + Height;
         
-        uint8_t PaletteMask = CCBitSet(PaletteSize);
+        const uint8_t *Palette = Memory->palettes[HKHubModuleGraphicsAdapterCellGetPalettePage(Glyph)] + HKHubModuleGraphicsAdapterCellGetPaletteOffset(Glyph);
         const size_t PixelHeight = Height * HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL;
         const size_t Slope = HKHubModuleGraphicsAdapterCellIsItalic(Glyph) && State->attributes[Layer].style.slope ? State->attributes[Layer].style.slope : PixelHeight;
         const size_t HalfSlope = (PixelHeight / Slope) / 2;
@@ -1070,14 +1151,15 @@ void HKHubModuleGraphicsAdapterBlit(HKHubModule Adapter, HKHubArchPortID Port, u
             {
                 const size_t S = X - CursorMinX, T = Y - CursorMinY;
                 
-                size_t SampleBase = (HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL * HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL * T * PaletteSize * Width) + (HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL * HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL * S * PaletteSize);
+                const HKHubModuleGraphicsAdapterTile *Tile = HKHubModuleGraphicsAdapterGetTile(Adapter, HKHubModuleGraphicsAdapterCellGetGlyphIndex(Glyph), HKHubModuleGraphicsAdapterCellGetAnimationOffset(Glyph), HKHubModuleGraphicsAdapterCellGetAnimationFilter(Glyph), S, T);
+                if (!Tile) continue;
                 
                 for (size_t FramebufferY = (Y - State->viewports[Port].y) * HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL, RelY = T * HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL, MaxY = CCMin(ViewportHeight * HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL, FramebufferY + HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL), SampleIndex = 0; FramebufferY < MaxY; FramebufferY++, RelY++)
                 {
                     ptrdiff_t Adjust = HalfSlope - (RelY / Slope);
                     if (Adjust < 0) Adjust = HalfSlope - ((RelY - (CenterPad - Slope)) / Slope);
                     
-                    for (size_t FramebufferX = (X - State->viewports[Port].x) * HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL, MaxX = CCMin(ViewportWidth * HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL, FramebufferX + HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL); FramebufferX < MaxX; FramebufferX++, SampleIndex += PaletteSize)
+                    for (size_t FramebufferX = (X - State->viewports[Port].x) * HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL, MaxX = CCMin(ViewportWidth * HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL, FramebufferX + HK_HUB_MODULE_GRAPHICS_ADAPTER_CELL); FramebufferX < MaxX; FramebufferX++, SampleIndex++)
                     {
                         const ptrdiff_t OffsetX = FramebufferX + Adjust;
                         
@@ -1087,17 +1169,15 @@ void HKHubModuleGraphicsAdapterBlit(HKHubModule Adapter, HKHubArchPortID Port, u
                             
                             if (Pixel < Size)
                             {
-                                const size_t MSBIndex = (SampleBase + SampleIndex) / 8;
-                                const uint16_t Sample = ((uint16_t)Bitmap[MSBIndex] << 8) | Bitmap[MSBIndex + 1];
-                                const uint8_t PaletteIndex = ((Sample << ((SampleBase + SampleIndex) % 8)) >> (8 + (8 - PaletteSize))) & PaletteMask;
+                                const uint8_t PaletteIndex = Tile->pixels[SampleIndex];
                                 
-                                if (!(Mask[Pixel] & 1)) Framebuffer[Pixel] = Memory->palettes[HKHubModuleGraphicsAdapterCellGetPalettePage(Glyph)][PaletteIndex + HKHubModuleGraphicsAdapterCellGetPaletteOffset(Glyph)];
+                                if (!(Mask[Pixel] & 1)) Framebuffer[Pixel] = Palette[PaletteIndex];
                                 
                                 if ((PaletteIndex) && (HKHubModuleGraphicsAdapterCellIsBold(Glyph)))
                                 {
                                     if ((OffsetX - 1) >= 0)
                                     {
-                                        if (!(Mask[Pixel - 1] & 1)) Framebuffer[Pixel - 1] = Memory->palettes[HKHubModuleGraphicsAdapterCellGetPalettePage(Glyph)][PaletteIndex + HKHubModuleGraphicsAdapterCellGetPaletteOffset(Glyph)];
+                                        if (!(Mask[Pixel - 1] & 1)) Framebuffer[Pixel - 1] = Palette[PaletteIndex];
                                     }
                                 }
                             }
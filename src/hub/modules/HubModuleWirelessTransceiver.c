@@ -37,11 +37,180 @@ size_t HKHubModuleWirelessTransceiverPacketLifetime = HK_HUB_MODULE_WIRELESS_TRA
 #define HK_HUB_MODULE_WIRELESS_TRANSCEIVER_PACKET_LIFETIME HKHubModuleWirelessTransceiverPacketLifetime
 #endif
 
+#define HK_HUB_MODULE_WIRELESS_TRANSCEIVER_RING_CAPACITY 16
+
+/*
+ Packets are stored against an epoch (stored timestamp = timestamp + epoch), so shifting the timestamps of every packet
+ only requires moving the epoch back. The epoch starts high enough that it will not underflow. Packet lifetimes are
+ aligned to the epoch, so they only match the unshifted timestamp lifetimes when shifts are a multiple of the lifetime.
+ */
+#define HK_HUB_MODULE_WIRELESS_TRANSCEIVER_EPOCH_ORIGIN ((size_t)1 << ((sizeof(size_t) * 8) - 2))
+
+typedef struct {
+    size_t timestamp;
+    size_t count;
+    uint8_t data;
+} HKHubModuleWirelessTransceiverRingSlot;
+
+/*
+ A ring holds the packets of a single channel, indexed by the packet's lifetime (timestamp / packet lifetime). A slot is
+ empty when its count is 0. Live packets never share a slot; when two lifetimes map to the same slot, the ring is
+ grown instead of either packet being dropped.
+ */
+typedef struct {
+    HKHubModuleWirelessTransceiverRingSlot *slots;
+    size_t capacity;
+    size_t count;
+} HKHubModuleWirelessTransceiverRing;
+
+typedef struct HKHubModuleWirelessTransceiverBusInfo {
+    CCAllocatorType allocator;
+    size_t epoch;
+    HKHubModuleWirelessTransceiverRing channels[256];
+} HKHubModuleWirelessTransceiverBusInfo;
+
 typedef struct {
+    CCAllocatorType allocator;
     CCDictionary(HKHubModuleWirelessTransceiverPacketSignature, uint8_t) packets;
+    HKHubModuleWirelessTransceiverBus bus;
+    size_t epoch;
+    /// The packets this transceiver has added to the bus, so they can be excluded from what it receives. Keyed against the bus epoch.
+    HKHubModuleWirelessTransceiverRing transmitted[256];
+    /// The packets visible to the transceiver while it's attached to a bus, rebuilt whenever its memory is read
+    CCDictionary(HKHubModuleWirelessTransceiverPacketSignature, uint8_t) visible;
     size_t prevGlobalTimestamp;
+    uint8_t received;
 } HKHubModuleWirelessTransceiverState;
 
+static CC_FORCE_INLINE CC_CONSTANT_FUNCTION size_t HKHubModuleWirelessTransceiverPacketSignatureTimestampLifetime(size_t Timestamp)
+{
+    return Timestamp / HK_HUB_MODULE_WIRELESS_TRANSCEIVER_PACKET_LIFETIME;
+}
+
+static _Bool HKHubModuleWirelessTransceiverRingRebuild(CCAllocatorType Allocator, HKHubModuleWirelessTransceiverRing *Ring, size_t Capacity);
+
+static void HKHubModuleWirelessTransceiverRingInsert(CCAllocatorType Allocator, HKHubModuleWirelessTransceiverRing *Ring, size_t Timestamp, uint8_t Data, size_t Count)
+{
+    const size_t Lifetime = HKHubModuleWirelessTransceiverPacketSignatureTimestampLifetime(Timestamp);
+    
+    for ( ; ; )
+    {
+        if (Ring->capacity)
+        {
+            HKHubModuleWirelessTransceiverRingSlot *Slot = &Ring->slots[Lifetime & (Ring->capacity - 1)];
+            if (!Slot->count)
+            {
+                *Slot = (HKHubModuleWirelessTransceiverRingSlot){ .timestamp = Timestamp, .count = Count, .data = Data };
+                Ring->count++;
+                return;
+            }
+            
+            else if (HKHubModuleWirelessTransceiverPacketSignatureTimestampLifetime(Slot->timestamp) == Lifetime)
+            {
+                Slot->data ^= Data;
+                Slot->count += Count;
+                return;
+            }
+        }
+        
+        if (!HKHubModuleWirelessTransceiverRingRebuild(Allocator, Ring, Ring->capacity ? Ring->capacity * 2 : HK_HUB_MODULE_WIRELESS_TRANSCEIVER_RING_CAPACITY)) return;
+    }
+}
+
+static _Bool HKHubModuleWirelessTransceiverRingRebuild(CCAllocatorType Allocator, HKHubModuleWirelessTransceiverRing *Ring, size_t Capacity)
+{
+    HKHubModuleWirelessTransceiverRingSlot *Slots = CCMalloc(Allocator, sizeof(HKHubModuleWirelessTransceiverRingSlot) * Capacity, NULL, CC_DEFAULT_ERROR_CALLBACK);
+    if (!Slots)
+    {
+        CC_LOG_ERROR("Failed to grow wireless transceiver packet ring due to allocation failure: allocation of size (%zu)", sizeof(HKHubModuleWirelessTransceiverRingSlot) * Capacity);
+        return FALSE;
+    }
+    
+    memset(Slots, 0, sizeof(HKHubModuleWirelessTransceiverRingSlot) * Capacity);
+    
+    const HKHubModuleWirelessTransceiverRing Prev = *Ring;
+    *Ring = (HKHubModuleWirelessTransceiverRing){ .slots = Slots, .capacity = Capacity, .count = 0 };
+    
+    for (size_t Loop = 0; Loop < Prev.capacity; Loop++)
+    {
+        const HKHubModuleWirelessTransceiverRingSlot *Slot = &Prev.slots[Loop];
+        if (Slot->count) HKHubModuleWirelessTransceiverRingInsert(Allocator, Ring, Slot->timestamp, Slot->data, Slot->count);
+    }
+    
+    if (Prev.slots) CCFree(Prev.slots);
+    
+    return TRUE;
+}
+
+static CC_FORCE_INLINE const HKHubModuleWirelessTransceiverRingSlot *HKHubModuleWirelessTransceiverRingFind(const HKHubModuleWirelessTransceiverRing *Ring, size_t Timestamp)
+{
+    if (!Ring->capacity) return NULL;
+    
+    const size_t Lifetime = HKHubModuleWirelessTransceiverPacketSignatureTimestampLifetime(Timestamp);
+    const HKHubModuleWirelessTransceiverRingSlot *Slot = &Ring->slots[Lifetime & (Ring->capacity - 1)];
+    
+    return (Slot->count) && (HKHubModuleWirelessTransceiverPacketSignatureTimestampLifetime(Slot->timestamp) == Lifetime) ? Slot : NULL;
+}
+
+static void HKHubModuleWirelessTransceiverRingPurge(HKHubModuleWirelessTransceiverRing *Ring, size_t Timestamp)
+{
+    if (!Ring->count) return;
+    
+    const size_t Lifetime = HKHubModuleWirelessTransceiverPacketSignatureTimestampLifetime(Timestamp);
+    
+    for (size_t Loop = 0; Loop < Ring->capacity; Loop++)
+    {
+        HKHubModuleWirelessTransceiverRingSlot *Slot = &Ring->slots[Loop];
+        if ((Slot->count) && (HKHubModuleWirelessTransceiverPacketSignatureTimestampLifetime(Slot->timestamp) >= Lifetime))
+        {
+            Slot->count = 0;
+            Ring->count--;
+        }
+    }
+}
+
+static void HKHubModuleWirelessTransceiverRingDestroy(HKHubModuleWirelessTransceiverRing *Ring)
+{
+    if (Ring->slots) CCFree(Ring->slots);
+}
+
+static _Bool HKHubModuleWirelessTransceiverGetPacket(HKHubModuleWirelessTransceiverState *State, HKHubModuleWirelessTransceiverPacketSignature Sig, uint8_t *Data)
+{
+    _Bool Found = FALSE;
+    uint8_t Packet = 0;
+    
+    const uint8_t *Received = CCDictionaryGetValue(State->packets, &(HKHubModuleWirelessTransceiverPacketSignature){ .timestamp = Sig.timestamp + State->epoch, .channel = Sig.channel });
+    if (Received)
+    {
+        Packet = *Received;
+        Found = TRUE;
+    }
+    
+    if (State->bus)
+    {
+        const HKHubModuleWirelessTransceiverRingSlot *Broadcast = HKHubModuleWirelessTransceiverRingFind(&State->bus->channels[Sig.channel], Sig.timestamp + State->bus->epoch);
+        if (Broadcast)
+        {
+            const HKHubModuleWirelessTransceiverRingSlot *Transmitted = HKHubModuleWirelessTransceiverRingFind(&State->transmitted[Sig.channel], Sig.timestamp + State->bus->epoch);
+            if (!Transmitted)
+            {
+                Packet ^= Broadcast->data;
+                Found = TRUE;
+            }
+            
+            else if (Broadcast->count > Transmitted->count)
+            {
+                Packet ^= Broadcast->data ^ Transmitted->data;
+                Found = TRUE;
+            }
+        }
+    }
+    
+    if ((Found) && (Data)) *Data = Packet;
+    
+    return Found;
+}
+
 
 HKHubModuleWirelessTransceiverBroadcastCallback HKHubModuleWirelessTransceiverBroadcast = NULL;
 HKHubModuleWirelessTransceiverGetSchedulerCallback HKHubModuleWirelessTransceiverGetScheduler = NULL;
@@ -54,10 +223,19 @@ static HKHubArchPortResponse HKHubModuleWirelessTransceiverTransmit(HKHubArchPor
     {
         if (Message->size >= 1)
         {
-            HKHubModuleWirelessTransceiverBroadcast(Device, (HKHubModuleWirelessTransceiverPacket){
+            const HKHubModuleWirelessTransceiverPacket Packet = {
                 .sig = { .channel = Port, .timestamp = Timestamp - ((Message->size * HKHubArchProcessorSpeedMemoryRead) + (Message->size * HKHubArchProcessorSpeedPortTransmission)) },
                 .data = Message->memory[Message->offset]
-            });
+            };
+            
+            HKHubModuleWirelessTransceiverState *State = Device->internal;
+            if (State->bus)
+            {
+                HKHubModuleWirelessTransceiverRingInsert(State->bus->allocator, &State->bus->channels[Port], Packet.sig.timestamp + State->bus->epoch, Packet.data, 1);
+                HKHubModuleWirelessTransceiverRingInsert(State->allocator, &State->transmitted[Port], Packet.sig.timestamp + State->bus->epoch, Packet.data, 1);
+            }
+            
+            else if (HKHubModuleWirelessTransceiverBroadcast) HKHubModuleWirelessTransceiverBroadcast(Device, Packet);
         }
     }
     
@@ -80,15 +258,13 @@ static HKHubArchPortResponse HKHubModuleWirelessTransceiverReceive(HKHubArchPort
         return HKHubArchPortResponseRetry;
     }
     
-    CCDictionary(HKHubModuleWirelessTransceiverPacketSignature, uint8_t) Packets = ((HKHubModuleWirelessTransceiverState*)Device->internal)->packets;
+    HKHubModuleWirelessTransceiverState *State = Device->internal;
     for (size_t Loop = 0; Loop < HK_HUB_MODULE_WIRELESS_TRANSCEIVER_RECEIVE_WAIT; Loop++)
     {
-        uint8_t *Data = CCDictionaryGetValue(Packets, &(HKHubModuleWirelessTransceiverPacketSignature){ .timestamp = Timestamp - Loop, .channel = Port });
-        
-        if (Data)
+        if (HKHubModuleWirelessTransceiverGetPacket(State, (HKHubModuleWirelessTransceiverPacketSignature){ .timestamp = Timestamp - Loop, .channel = Port }, &State->received))
         {
             *Message = (HKHubArchPortMessage){
-                .memory = Data,
+                .memory = &State->received,
                 .offset = 0,
                 .size = 1
             };
@@ -102,11 +278,6 @@ static HKHubArchPortResponse HKHubModuleWirelessTransceiverReceive(HKHubArchPort
     return HKHubArchPortResponseTimeout;
 }
 
-static CC_FORCE_INLINE CC_CONSTANT_FUNCTION size_t HKHubModuleWirelessTransceiverPacketSignatureTimestampLifetime(size_t Timestamp)
-{
-    return Timestamp / HK_HUB_MODULE_WIRELESS_TRANSCEIVER_PACKET_LIFETIME;
-}
-
 static uintmax_t HKHubModuleWirelessTransceiverPacketSignatureHasher(const HKHubModuleWirelessTransceiverPacketSignature *Sig)
 {
     return HKHubModuleWirelessTransceiverPacketSignatureTimestampLifetime(Sig->timestamp) ^ ((uintmax_t)Sig->channel << ((sizeof(uintmax_t) * 8) - 8));
@@ -117,8 +288,87 @@ static CCComparisonResult HKHubModuleWirelessTransceiverPacketSignatureComparato
     return (left->channel == right->channel) && (HKHubModuleWirelessTransceiverPacketSignatureTimestampLifetime(left->timestamp) == HKHubModuleWirelessTransceiverPacketSignatureTimestampLifetime(right->timestamp)) ? CCComparisonResultEqual : CCComparisonResultInvalid;
 }
 
+static CCDictionary(HKHubModuleWirelessTransceiverPacketSignature, uint8_t) HKHubModuleWirelessTransceiverPacketsCreate(CCAllocatorType Allocator)
+{
+    return CCDictionaryCreate(Allocator, CCDictionaryHintHeavyFinding | CCDictionaryHintHeavyInserting | CCDictionaryHintHeavyDeleting, sizeof(HKHubModuleWirelessTransceiverPacketSignature), sizeof(uint8_t), &(CCDictionaryCallbacks){
+        .getHash = (CCDictionaryKeyHasher)HKHubModuleWirelessTransceiverPacketSignatureHasher,
+        .compareKeys = (CCComparator)HKHubModuleWirelessTransceiverPacketSignatureComparator
+    });
+}
+
+static void HKHubModuleWirelessTransceiverPacketsAdd(CCDictionary(HKHubModuleWirelessTransceiverPacketSignature, uint8_t) Packets, HKHubModuleWirelessTransceiverPacket Packet)
+{
+    CCDictionaryEntry Entry = CCDictionaryEntryForKey(Packets, &Packet.sig);
+    
+    if (CCDictionaryEntryIsInitialized(Packets, Entry))
+    {
+        Packet.data ^= *(uint8_t*)CCDictionaryGetEntry(Packets, Entry);
+    }
+    
+    CCDictionarySetEntry(Packets, Entry, &Packet.data);
+}
+
+/*
+ Transceivers attached to a bus don't store the packets they receive from it, so their memory is instead the packets
+ they've received combined with the packets on the bus (excluding their own transmissions).
+ */
+static CCDictionary(HKHubModuleWirelessTransceiverPacketSignature, uint8_t) HKHubModuleWirelessTransceiverVisiblePackets(HKHubModuleWirelessTransceiverState *State)
+{
+    if (!State->bus) return State->packets;
+    
+    if (State->visible) CCDictionaryDestroy(State->visible);
+    State->visible = HKHubModuleWirelessTransceiverPacketsCreate(State->allocator);
+    
+    if (CCDictionaryGetCount(State->packets))
+    {
+        CCOrderedCollection(HKHubModuleWirelessTransceiverPacketSignature) Keys = CCDictionaryGetKeys(State->packets);
+        
+        CC_COLLECTION_FOREACH_PTR(HKHubModuleWirelessTransceiverPacketSignature, Sig, Keys)
+        {
+            CCDictionarySetValue(State->visible, Sig, CCDictionaryGetValue(State->packets, Sig));
+        }
+        
+        CCCollectionDestroy(Keys);
+    }
+    
+    for (size_t Channel = 0; Channel < 256; Channel++)
+    {
+        const HKHubModuleWirelessTransceiverRing *Ring = &State->bus->channels[Channel];
+        for (size_t Loop = 0; Loop < Ring->capacity; Loop++)
+        {
+            const HKHubModuleWirelessTransceiverRingSlot *Broadcast = &Ring->slots[Loop];
+            if (!Broadcast->count) continue;
+            
+            const HKHubModuleWirelessTransceiverRingSlot *Transmitted = HKHubModuleWirelessTransceiverRingFind(&State->transmitted[Channel], Broadcast->timestamp);
+            if ((Transmitted) && (Broadcast->count == Transmitted->count)) continue;
+            
+            HKHubModuleWirelessTransceiverPacketsAdd(State->visible, (HKHubModuleWirelessTransceiverPacket){
+                .sig = { .timestamp = (Broadcast->timestamp - State->bus->epoch) + State->epoch, .channel = (uint8_t)Channel },
+                .data = Broadcast->data ^ (Transmitted ? Transmitted->data : 0)
+            });
+        }
+    }
+    
+    return State->visible;
+}
+
+static size_t HKHubModuleWirelessTransceiverMemoryCount(HKHubModuleWirelessTransceiverState *State)
+{
+    return CCDictionaryGetCount(HKHubModuleWirelessTransceiverVisiblePackets(State));
+}
+
+static void HKHubModuleWirelessTransceiverMemoryEnumerable(HKHubModuleWirelessTransceiverState *State, CCEnumerable *Enumerable)
+{
+    CCDictionaryGetValueEnumerable(HKHubModuleWirelessTransceiverVisiblePackets(State), Enumerable);
+}
+
 static void HKHubModuleWirelessTransceiverStateDestructor(HKHubModuleWirelessTransceiverState *State)
 {
+    if (State->bus) HKHubModuleWirelessTransceiverBusDestroy(State->bus);
+    
+    for (size_t Loop = 0; Loop < 256; Loop++) HKHubModuleWirelessTransceiverRingDestroy(&State->transmitted[Loop]);
+    
+    if (State->visible) CCDictionaryDestroy(State->visible);
     CCDictionaryDestroy(State->packets);
     CCFree(State);
 }
@@ -129,14 +379,16 @@ HKHubModule HKHubModuleWirelessTransceiverCreate(CCAllocatorType Allocator)
     if (State)
     {
         *State = (HKHubModuleWirelessTransceiverState){
-            .packets = CCDictionaryCreate(Allocator, CCDictionaryHintHeavyFinding | CCDictionaryHintHeavyInserting | CCDictionaryHintHeavyDeleting, sizeof(HKHubModuleWirelessTransceiverPacketSignature), sizeof(uint8_t), &(CCDictionaryCallbacks){
-                .getHash = (CCDictionaryKeyHasher)HKHubModuleWirelessTransceiverPacketSignatureHasher,
-                .compareKeys = (CCComparator)HKHubModuleWirelessTransceiverPacketSignatureComparator
-            }),
-            .prevGlobalTimestamp = 0
+            .allocator = Allocator,
+            .packets = HKHubModuleWirelessTransceiverPacketsCreate(Allocator),
+            .bus = NULL,
+            .visible = NULL,
+            .epoch = HK_HUB_MODULE_WIRELESS_TRANSCEIVER_EPOCH_ORIGIN,
+            .prevGlobalTimestamp = 0,
+            .received = 0
         };
         
-        return HKHubModuleCreate(Allocator, (HKHubArchPortTransmit)HKHubModuleWirelessTransceiverReceive, (HKHubArchPortTransmit)HKHubModuleWirelessTransceiverTransmit, State, (HKHubModuleDataDestructor)HKHubModuleWirelessTransceiverStateDestructor, CCDataContainerCreate(Allocator, CCDataHintReadWrite, sizeof(uint8_t), (CCDataContainerCount)CCDictionaryGetCount, (CCDataContainerEnumerable)CCDictionaryGetValueEnumerable, State->packets, NULL, NULL));
+        return HKHubModuleCreate(Allocator, (HKHubArchPortTransmit)HKHubModuleWirelessTransceiverReceive, (HKHubArchPortTransmit)HKHubModuleWirelessTransceiverTransmit, State, (HKHubModuleDataDestructor)HKHubModuleWirelessTransceiverStateDestructor, CCDataContainerCreate(Allocator, CCDataHintReadWrite, sizeof(uint8_t), (CCDataContainerCount)HKHubModuleWirelessTransceiverMemoryCount, (CCDataContainerEnumerable)HKHubModuleWirelessTransceiverMemoryEnumerable, State, NULL, NULL));
     }
     
     else CC_LOG_ERROR("Failed to create wireless transceiver module due to allocation failure: allocation of size (%zu)", sizeof(HKHubModuleWirelessTransceiverState));
@@ -148,36 +400,35 @@ void HKHubModuleWirelessTransceiverReceivePacket(HKHubModule Module, HKHubModule
 {
     CCAssertLog(Module, "Module must not be null");
     
-    CCDictionary(HKHubModuleWirelessTransceiverPacketSignature, uint8_t) Packets = ((HKHubModuleWirelessTransceiverState*)Module->internal)->packets;
-    CCDictionaryEntry Entry = CCDictionaryEntryForKey(Packets, &Packet.sig);
+    Packet.sig.timestamp += ((HKHubModuleWirelessTransceiverState*)Module->internal)->epoch;
     
-    if (CCDictionaryEntryIsInitialized(Packets, Entry))
-    {
-        Packet.data ^= *(uint8_t*)CCDictionaryGetEntry(Packets, Entry);
-    }
-    
-    CCDictionarySetEntry(Packets, Entry, &Packet.data);
+    HKHubModuleWirelessTransceiverPacketsAdd(((HKHubModuleWirelessTransceiverState*)Module->internal)->packets, Packet);
 }
 
 _Bool HKHubModuleWirelessTransceiverInspectPacket(HKHubModule Module, HKHubModuleWirelessTransceiverPacketSignature Sig, uint8_t *Data)
 {
     CCAssertLog(Module, "Module must not be null");
     
-    CCDictionary(HKHubModuleWirelessTransceiverPacketSignature, uint8_t) Packets = ((HKHubModuleWirelessTransceiverState*)Module->internal)->packets;
-    CCDictionaryEntry Entry = CCDictionaryFindKey(Packets, &Sig);
-    
-    if ((Entry) && (Data)) *Data = *(uint8_t*)CCDictionaryGetEntry(Packets, Entry);
-    
-    return Entry;
+    return HKHubModuleWirelessTransceiverGetPacket(Module->internal, Sig, Data);
 }
 
 void HKHubModuleWirelessTransceiverPacketPurge(HKHubModule Module, size_t Timestamp)
 {
     CCAssertLog(Module, "Module must not be null");
     
-    ((HKHubModuleWirelessTransceiverState*)Module->internal)->prevGlobalTimestamp = 0;
+    HKHubModuleWirelessTransceiverState *State = Module->internal;
+    State->prevGlobalTimestamp = 0;
+    
+    if (State->bus)
+    {
+        for (size_t Loop = 0; Loop < 256; Loop++) HKHubModuleWirelessTransceiverRingPurge(&State->transmitted[Loop], Timestamp + State->bus->epoch);
+    }
+    
+    Timestamp += State->epoch;
+    
+    CCDictionary(HKHubModuleWirelessTransceiverPacketSignature, uint8_t) Packets = State->packets;
+    if (!CCDictionaryGetCount(Packets)) return;
     
-    CCDictionary(HKHubModuleWirelessTransceiverPacketSignature, uint8_t) Packets = ((HKHubModuleWirelessTransceiverState*)Module->internal)->packets;
     CCOrderedCollection(HKHubModuleWirelessTransceiverPacketSignature) Keys = CCDictionaryGetKeys(Packets);
     
     CC_COLLECTION_FOREACH_PTR(HKHubModuleWirelessTransceiverPacketSignature, Sig, Keys)
@@ -192,25 +443,70 @@ void HKHubModuleWirelessTransceiverShiftTimestamps(HKHubModule Module, size_t Sh
 {
     CCAssertLog(Module, "Module must not be null");
     
-    CCDictionary(HKHubModuleWirelessTransceiverPacketSignature, uint8_t) Packets = ((HKHubModuleWirelessTransceiverState*)Module->internal)->packets;
-    CCDictionary(HKHubModuleWirelessTransceiverPacketSignature, uint8_t) ShiftedPackets = CCDictionaryCreate(Packets->allocator, CCDictionaryHintHeavyFinding | CCDictionaryHintHeavyInserting | CCDictionaryHintHeavyDeleting, Packets->keySize, Packets->valueSize, &Packets->callbacks);
+    ((HKHubModuleWirelessTransceiverState*)Module->internal)->epoch -= Shift;
+}
+
+void HKHubModuleWirelessTransceiverSetBus(HKHubModule Module, HKHubModuleWirelessTransceiverBus Bus)
+{
+    CCAssertLog(Module, "Module must not be null");
+    
+    HKHubModuleWirelessTransceiverState *State = Module->internal;
     
-    CCOrderedCollection(HKHubModuleWirelessTransceiverPacketSignature) Keys = CCDictionaryGetKeys(Packets);
+    if (State->bus == Bus) return;
+    
+    if (State->bus) HKHubModuleWirelessTransceiverBusDestroy(State->bus);
     
-    CC_COLLECTION_FOREACH(HKHubModuleWirelessTransceiverPacketSignature, Sig, Keys)
+    State->bus = Bus ? CCRetain(Bus) : NULL;
+    
+    //The transmitted packets are keyed against the epoch of the previous bus
+    for (size_t Loop = 0; Loop < 256; Loop++)
     {
-        uint8_t *Value = CCDictionaryGetValue(Packets, &Sig);
-        Sig.timestamp += Shift;
-        CCDictionarySetValue(ShiftedPackets, &Sig, Value);
+        HKHubModuleWirelessTransceiverRingDestroy(&State->transmitted[Loop]);
+        State->transmitted[Loop] = (HKHubModuleWirelessTransceiverRing){ .slots = NULL, .capacity = 0, .count = 0 };
+    }
+}
+
+static void HKHubModuleWirelessTransceiverBusDestructor(HKHubModuleWirelessTransceiverBus Bus)
+{
+    for (size_t Loop = 0; Loop < 256; Loop++) HKHubModuleWirelessTransceiverRingDestroy(&Bus->channels[Loop]);
+}
+
+HKHubModuleWirelessTransceiverBus HKHubModuleWirelessTransceiverBusCreate(CCAllocatorType Allocator)
+{
+    HKHubModuleWirelessTransceiverBus Bus = CCMalloc(Allocator, sizeof(HKHubModuleWirelessTransceiverBusInfo), NULL, CC_DEFAULT_ERROR_CALLBACK);
+    if (Bus)
+    {
+        memset(Bus, 0, sizeof(HKHubModuleWirelessTransceiverBusInfo));
+        Bus->allocator = Allocator;
+        Bus->epoch = HK_HUB_MODULE_WIRELESS_TRANSCEIVER_EPOCH_ORIGIN;
+        
+        CCMemorySetDestructor(Bus, (CCMemoryDestructorCallback)HKHubModuleWirelessTransceiverBusDestructor);
     }
     
-    CCCollectionDestroy(Keys);
+    else CC_LOG_ERROR("Failed to create wireless transceiver bus due to allocation failure: allocation of size (%zu)", sizeof(HKHubModuleWirelessTransceiverBusInfo));
+    
+    return Bus;
+}
+
+void HKHubModuleWirelessTransceiverBusDestroy(HKHubModuleWirelessTransceiverBus Bus)
+{
+    CCAssertLog(Bus, "Bus must not be null");
+    
+    CCFree(Bus);
+}
+
+void HKHubModuleWirelessTransceiverBusPacketPurge(HKHubModuleWirelessTransceiverBus Bus, size_t Timestamp)
+{
+    CCAssertLog(Bus, "Bus must not be null");
     
-    CCDictionaryDestroy(Packets);
+    Timestamp += Bus->epoch;
     
-    ((HKHubModuleWirelessTransceiverState*)Module->internal)->packets = ShiftedPackets;
+    for (size_t Loop = 0; Loop < 256; Loop++) HKHubModuleWirelessTransceiverRingPurge(&Bus->channels[Loop], Timestamp);
+}
+
+void HKHubModuleWirelessTransceiverBusShiftTimestamps(HKHubModuleWirelessTransceiverBus Bus, size_t Shift)
+{
+    CCAssertLog(Bus, "Bus must not be null");
     
-    CCData Memory = HKHubModuleGetMemory(Module);
-    Module->memory = CCDataContainerCreate(Memory->allocator, CCDataGetHints(Memory), sizeof(uint8_t), (CCDataContainerCount)CCDictionaryGetCount, (CCDataContainerEnumerable)CCDictionaryGetValueEnumerable, ShiftedPackets, NULL, NULL);
-    CCDataDestroy(Memory);
+    Bus->epoch -= Shift;
 }
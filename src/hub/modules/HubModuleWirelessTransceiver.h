@@ -39,6 +39,13 @@ typedef struct {
     uint8_t data;
 } HKHubModuleWirelessTransceiverPacket;
 
+/*!
+ * @brief A broadcast bus shared by wireless transceivers.
+ * @description Transmitted packets are stored once in per-channel rings indexed by timestamp, which
+ *              every transceiver attached to the bus reads from.
+ */
+typedef struct HKHubModuleWirelessTransceiverBusInfo *HKHubModuleWirelessTransceiverBus;
+
 /*!
  * @brief Callback to handle broadcasting of packets.
  * @description Handle the sharing of trasmitted packet to other transceivers.
@@ -76,6 +83,50 @@ extern size_t HKHubModuleWirelessTransceiverPacketLifetime;
  */
 CC_NEW HKHubModule HKHubModuleWirelessTransceiverCreate(CCAllocatorType Allocator);
 
+/*!
+ * @brief Set the bus the transceiver transmits to and receives from.
+ * @description When a transceiver is attached to a bus its transmissions are added to the bus rather
+ *              than passed to @b HKHubModuleWirelessTransceiverBroadcast. A transceiver does not
+ *              receive its own transmissions while it remains attached to that bus, changing
+ *              the bus forgets which packets it has transmitted.
+ *
+ *              The packets on the bus are not copied into the transceiver, instead its memory combines
+ *              the packets it has received with the packets on the bus it can receive. While attached,
+ *              writes to its memory are not applied to the packets.
+ *
+ * @param Module The wireless transceiver.
+ * @param Bus The bus to attach to, this is retained. Or NULL to detach from the current bus.
+ */
+void HKHubModuleWirelessTransceiverSetBus(HKHubModule Module, HKHubModuleWirelessTransceiverBus Bus);
+
+/*!
+ * @brief Create a wireless transceiver bus.
+ * @param Allocator The allocator to be used.
+ * @return The bus. Must be destroyed to free memory.
+ */
+CC_NEW HKHubModuleWirelessTransceiverBus HKHubModuleWirelessTransceiverBusCreate(CCAllocatorType Allocator);
+
+/*!
+ * @brief Destroy a wireless transceiver bus.
+ * @param Bus The bus to be destroyed.
+ */
+void HKHubModuleWirelessTransceiverBusDestroy(HKHubModuleWirelessTransceiverBus CC_DESTROY(Bus));
+
+/*!
+ * @brief Purge the transmitted packets on the bus at the timestamp and older.
+ * @param Bus The wireless transceiver bus.
+ * @param Timestamp The timestamp to purge up to (and including). To purge every packet, 0 can be
+ *        used to guarantee that.
+ */
+void HKHubModuleWirelessTransceiverBusPacketPurge(HKHubModuleWirelessTransceiverBus Bus, size_t Timestamp);
+
+/*!
+ * @brief Shift the current timestamps of the transmitted packets on the bus by a certain amount.
+ * @param Bus The wireless transceiver bus.
+ * @param Shift The amount to shift the timestamps by.
+ */
+void HKHubModuleWirelessTransceiverBusShiftTimestamps(HKHubModuleWirelessTransceiverBus Bus, size_t Shift);
+
 /*!
  * @brief Add a packet to the transceiver.
  * @param Module The wireless transceiver.
@@ -46,17 +46,7 @@ static HKHubArchScheduler HKHubSystemGetSchedulerForModule(HKHubModule Module)
 }
 
 static CCCollection(CCComponent) Transceivers = NULL;
-static void HKHubSystemPacketBroadcaster(HKHubModule Transmitter, HKHubModuleWirelessTransceiverPacket Packet)
-{
-    CC_COLLECTION_FOREACH(CCComponent, Transceiver, Transceivers)
-    {
-        HKHubModule Receiver = HKHubModuleComponentGetModule(Transceiver);
-        if (Receiver != Transmitter)
-        {
-            HKHubModuleWirelessTransceiverReceivePacket(Receiver, Packet);
-        }
-    }
-}
+static HKHubModuleWirelessTransceiverBus TransceiverBus = NULL;
 
 static HKHubArchScheduler Scheduler;
 static mtx_t Lock;
@@ -70,13 +60,21 @@ void HKHubSystemRegister(void)
         exit(EXIT_FAILURE); //TODO: How should we handle this?
     }
     
+    /*
+     Debugged processors (whose hooks take the GUI lock) and processors connected to transceivers (which share the
+     bus) are put in the scheduler's shared group, which parallel mode only runs on this thread. Every other group
+     of connected hubs is independent so can run on the workers. Hubs are commonly running the same programs, so
+     they're run using the batch strategy.
+     */
     Scheduler = HKHubArchSchedulerCreate(CC_STD_ALLOCATOR);
+    HKHubArchSchedulerSetMode(Scheduler, HKHubArchSchedulerModeParallel);
+    HKHubArchSchedulerSetStrategy(Scheduler, HKHubArchSchedulerStrategyBatch);
     
     CCComponentSystemRegister(HK_HUB_SYSTEM_ID, CCComponentSystemExecutionTypeUpdate, (CCComponentSystemUpdateCallback)HKHubSystemUpdate, NULL, HKHubSystemHandlesComponent, NULL, NULL, HKHubSystemTryLock, HKHubSystemLock, HKHubSystemUnlock);
     
     HKHubModuleWirelessTransceiverGetScheduler = HKHubSystemGetSchedulerForModule;
-    HKHubModuleWirelessTransceiverBroadcast = HKHubSystemPacketBroadcaster;
     
+    TransceiverBus = HKHubModuleWirelessTransceiverBusCreate(CC_STD_ALLOCATOR);
     Transceivers = CCCollectionCreate(CC_STD_ALLOCATOR, CCCollectionHintSizeMedium, sizeof(CCComponent), NULL);
     Schematics = CCCollectionCreate(CC_STD_ALLOCATOR, CCCollectionHintSizeMedium, sizeof(CCComponent), NULL);
 }
@@ -172,17 +170,17 @@ static void HKHubSystemInitDebugger(GUIObject Debugger, HKHubArchProcessor Proce
     
     
     CCExpression Breakpoints = CCExpressionCreateList(CC_STD_ALLOCATOR);
-    if (Processor->state.debug.breakpoints)
+    if (HKHubArchProcessorHasBreakpoints(Processor))
     {
-        CC_DICTIONARY_FOREACH_KEY(uint8_t, Offset, Processor->state.debug.breakpoints)
+        for (size_t Offset = 0; Offset < 256; Offset++)
         {
-            HKHubArchProcessorDebugBreakpoint *Bp = CCDictionaryGetValue(Processor->state.debug.breakpoints, &Offset);
+            const HKHubArchProcessorDebugBreakpoint Bp = HKHubArchProcessorGetBreakpoint(Processor, (uint8_t)Offset);
             
-            if (BreakpointType[*Bp])
+            if (BreakpointType[Bp])
             {
                 CCExpression Breakpoint = CCExpressionCreateList(CC_STD_ALLOCATOR);
                 CCOrderedCollectionAppendElement(CCExpressionGetList(Breakpoint), &(CCExpression){ CCExpressionCreateInteger(CC_STD_ALLOCATOR, Offset) });
-                CCOrderedCollectionAppendElement(CCExpressionGetList(Breakpoint), &(CCExpression){ CCExpressionCreateAtom(CC_STD_ALLOCATOR, BreakpointType[*Bp], TRUE) });
+                CCOrderedCollectionAppendElement(CCExpressionGetList(Breakpoint), &(CCExpression){ CCExpressionCreateAtom(CC_STD_ALLOCATOR, BreakpointType[Bp], TRUE) });
                 
                 CCOrderedCollectionAppendElement(CCExpressionGetList(Breakpoints), &Breakpoint);
             }
@@ -195,10 +193,8 @@ static void HKHubSystemInitDebugger(GUIObject Debugger, HKHubArchProcessor Proce
     
     CCExpression Ports = CCExpressionCreateList(CC_STD_ALLOCATOR);
     
-    CC_DICTIONARY_FOREACH_VALUE(HKHubArchPortConnection, Connection, Processor->ports)
+    HK_HUB_ARCH_PORT_TABLE_FOREACH(PortID, &Processor->ports)
     {
-        HKHubArchPortID PortID = (Connection->port[0].device == Processor ? &Connection->port[0] : &Connection->port[1])->id;
-        
         CCExpression Port = CCExpressionCreateList(CC_STD_ALLOCATOR);
         CCOrderedCollectionAppendElement(CCExpressionGetList(Port), &(CCExpression){ CCExpressionCreateInteger(CC_STD_ALLOCATOR, PortID) });
         CCOrderedCollectionAppendElement(CCExpressionGetList(Port), &(CCExpression){ CCExpressionCreateAtom(CC_STD_ALLOCATOR, CC_STRING(":connected"), TRUE) });
@@ -208,18 +204,22 @@ static void HKHubSystemInitDebugger(GUIObject Debugger, HKHubArchProcessor Proce
     
     CCExpressionSetState(State, CC_STRING(".ports"), Ports, FALSE);
     CCExpressionSetState(State, CC_STRING(".ports-changed"), CCExpressionCreateInteger(CC_STD_ALLOCATOR, TRUE), FALSE);
-    
-    HKRapServerUpdate(Processor);
 }
 
-static void HKHubSystemDebuggerInstructionHook(HKHubArchProcessor Processor, const HKHubArchInstructionState *Instruction, const uint8_t Encoding[5])
+static void HKHubSystemDebuggerTraceHook(HKHubArchProcessor Processor, uint8_t Entry, uint8_t Exit, size_t Cycles)
 {
+    /*
+     Only stepped instructions are shown as they're executed (these are always traced individually by the interpreter,
+     so the modified state applies). While running the state is instead refreshed once the processor is paused.
+     */
+    if (Processor->state.debug.mode != HKHubArchProcessorDebugModePause) return;
+    
     //TODO: Send update message (instead of update here/avoid locking UI)
     GUIManagerLock();
     
-    GUIObjectInvalidateCache(Processor->state.debug.context);
+    GUIObjectInvalidateCache(Processor->debug.context);
     
-    CCExpression State = GUIObjectGetExpressionState(Processor->state.debug.context);
+    CCExpression State = GUIObjectGetExpressionState(Processor->debug.context);
     
     CCExpressionSetState(State, CC_STRING(".r0-modified"), CCExpressionCreateInteger(CC_STD_ALLOCATOR, FALSE), FALSE);
     CCExpressionSetState(State, CC_STRING(".r1-modified"), CCExpressionCreateInteger(CC_STD_ALLOCATOR, FALSE), FALSE);
@@ -296,16 +296,14 @@ static void HKHubSystemDebuggerPortConnectionChangeHook(HKHubArchProcessor Proce
 {
     GUIManagerLock();
     
-    GUIObjectInvalidateCache(Processor->state.debug.context);
+    GUIObjectInvalidateCache(Processor->debug.context);
     
-    CCExpression State = GUIObjectGetExpressionState(Processor->state.debug.context);
+    CCExpression State = GUIObjectGetExpressionState(Processor->debug.context);
     
     CCExpression Ports = CCExpressionCreateList(CC_STD_ALLOCATOR);
     
-    CC_DICTIONARY_FOREACH_VALUE(HKHubArchPortConnection, Connection, Processor->ports)
+    HK_HUB_ARCH_PORT_TABLE_FOREACH(PortID, &Processor->ports)
     {
-        HKHubArchPortID PortID = (Connection->port[0].device == Processor ? &Connection->port[0] : &Connection->port[1])->id;
-        
         CCExpression Port = CCExpressionCreateList(CC_STD_ALLOCATOR);
         CCOrderedCollectionAppendElement(CCExpressionGetList(Port), &(CCExpression){ CCExpressionCreateInteger(CC_STD_ALLOCATOR, PortID) });
         CCOrderedCollectionAppendElement(CCExpressionGetList(Port), &(CCExpression){ CCExpressionCreateAtom(CC_STD_ALLOCATOR, CC_STRING(":connected"), TRUE) });
@@ -326,22 +324,22 @@ static void HKHubSystemDebuggerBreakpointChangeHook(HKHubArchProcessor Processor
     //TODO: Send update message (instead of update here/avoid locking UI)
     GUIManagerLock();
     
-    GUIObjectInvalidateCache(Processor->state.debug.context);
+    GUIObjectInvalidateCache(Processor->debug.context);
     
-    CCExpression State = GUIObjectGetExpressionState(Processor->state.debug.context);
+    CCExpression State = GUIObjectGetExpressionState(Processor->debug.context);
     
     CCExpression Breakpoints = CCExpressionCreateList(CC_STD_ALLOCATOR);
-    if (Processor->state.debug.breakpoints)
+    if (HKHubArchProcessorHasBreakpoints(Processor))
     {
-        CC_DICTIONARY_FOREACH_KEY(uint8_t, Offset, Processor->state.debug.breakpoints)
+        for (size_t Offset = 0; Offset < 256; Offset++)
         {
-            HKHubArchProcessorDebugBreakpoint *Bp = CCDictionaryGetValue(Processor->state.debug.breakpoints, &Offset);
+            const HKHubArchProcessorDebugBreakpoint Bp = HKHubArchProcessorGetBreakpoint(Processor, (uint8_t)Offset);
             
-            if (BreakpointType[*Bp])
+            if (BreakpointType[Bp])
             {
                 CCExpression Breakpoint = CCExpressionCreateList(CC_STD_ALLOCATOR);
                 CCOrderedCollectionAppendElement(CCExpressionGetList(Breakpoint), &(CCExpression){ CCExpressionCreateInteger(CC_STD_ALLOCATOR, Offset) });
-                CCOrderedCollectionAppendElement(CCExpressionGetList(Breakpoint), &(CCExpression){ CCExpressionCreateAtom(CC_STD_ALLOCATOR, BreakpointType[*Bp], TRUE) });
+                CCOrderedCollectionAppendElement(CCExpressionGetList(Breakpoint), &(CCExpression){ CCExpressionCreateAtom(CC_STD_ALLOCATOR, BreakpointType[Bp], TRUE) });
                 
                 CCOrderedCollectionAppendElement(CCExpressionGetList(Breakpoints), &Breakpoint);
             }
@@ -361,16 +359,22 @@ static void HKHubSystemDebuggerDebugModeChangeHook(HKHubArchProcessor Processor)
     //TODO: Send update message (instead of update here/avoid locking UI)
     GUIManagerLock();
     
-    GUIObjectInvalidateCache(Processor->state.debug.context);
+    GUIObjectInvalidateCache(Processor->debug.context);
     
-    CCExpression State = GUIObjectGetExpressionState(Processor->state.debug.context);
+    CCExpression State = GUIObjectGetExpressionState(Processor->debug.context);
     
     CCExpressionSetState(State, CC_STRING(".debug-mode"), CCExpressionCreateAtom(CC_STD_ALLOCATOR, (CCString[2]){
         CC_STRING(":continue"),
         CC_STRING(":pause")
     }[Processor->state.debug.mode], TRUE), FALSE);
     
+    //Anything executed while running isn't traced by the debugger, so refresh the entire state once paused
+    const _Bool Paused = Processor->state.debug.mode == HKHubArchProcessorDebugModePause;
+    if (Paused) HKHubSystemInitDebugger(Processor->debug.context, Processor);
+    
     GUIManagerUnlock();
+    
+    if (Paused) HKRapServerUpdate(Processor);
 }
 
 static void HKHubSystemAttachDebugger(CCComponent Debugger)
@@ -382,24 +386,26 @@ static void HKHubSystemAttachDebugger(CCComponent Debugger)
         {
             HKHubArchProcessor Target = HKHubProcessorComponentGetProcessor(Component);
             HKHubArchProcessorSetDebugMode(Target, HKHubArchProcessorDebugModePause);
+            HKHubArchProcessorCacheDebug(Target, TRUE);
             
-            Target->state.debug.operation = HKHubSystemDebuggerInstructionHook;
-            Target->state.debug.portConnectionChange = HKHubSystemDebuggerPortConnectionChangeHook;
-            Target->state.debug.breakpointChange = HKHubSystemDebuggerBreakpointChangeHook;
-            Target->state.debug.debugModeChange = HKHubSystemDebuggerDebugModeChangeHook;
+            Target->debug.trace = HKHubSystemDebuggerTraceHook;
+            Target->debug.portConnectionChange = HKHubSystemDebuggerPortConnectionChangeHook;
+            Target->debug.breakpointChange = HKHubSystemDebuggerBreakpointChangeHook;
+            Target->debug.debugModeChange = HKHubSystemDebuggerDebugModeChangeHook;
             
             CCExpression Expr = CCExpressionCreateFromSource("(gui-debugger)");
             CCExpression Result = CCExpressionEvaluate(Expr);
             if (CCExpressionGetType(Result) == GUIExpressionValueTypeGUIObject)
             {
                 CCExpressionChangeOwnership(Result, NULL, NULL);
-                Target->state.debug.context = CCExpressionGetData(Result);
-                HKHubSystemInitDebugger(Target->state.debug.context, Target);
-                CCExpressionSetState(GUIObjectGetExpressionState(Target->state.debug.context), CC_STRING(".entity"), CCExpressionCreateCustomType(CC_STD_ALLOCATOR, CCEntityExpressionValueTypeEntity, CCRetain(Entity), CCExpressionRetainedValueCopy, (CCExpressionValueDestructor)CCEntityDestroy), FALSE);
+                Target->debug.context = CCExpressionGetData(Result);
+                HKHubSystemInitDebugger(Target->debug.context, Target);
+                HKRapServerUpdate(Target);
+                CCExpressionSetState(GUIObjectGetExpressionState(Target->debug.context), CC_STRING(".entity"), CCExpressionCreateCustomType(CC_STD_ALLOCATOR, CCEntityExpressionValueTypeEntity, CCRetain(Entity), CCExpressionRetainedValueCopy, (CCExpressionValueDestructor)CCEntityDestroy), FALSE);
                 
-                GUIObjectSetCacheStrategy(Target->state.debug.context, GUIObjectCacheStrategyInvalidateOnRequest | GUIObjectCacheStrategyInvalidateOnMove | GUIObjectCacheStrategyInvalidateOnResize);
-                GUIObjectSetEnabled(Target->state.debug.context, TRUE);
-                GUIManagerAddObject(Target->state.debug.context);
+                GUIObjectSetCacheStrategy(Target->debug.context, GUIObjectCacheStrategyInvalidateOnRequest | GUIObjectCacheStrategyInvalidateOnMove | GUIObjectCacheStrategyInvalidateOnResize);
+                GUIObjectSetEnabled(Target->debug.context, TRUE);
+                GUIManagerAddObject(Target->debug.context);
             }
             
             CCExpressionDestroy(Expr);
@@ -441,11 +447,13 @@ static void HKHubSystemDetachDebugger(CCComponent Debugger)
             HKHubArchProcessor Target = HKHubProcessorComponentGetProcessor(Component);
             HKHubArchProcessorSetDebugMode(Target, HKHubArchProcessorDebugModeContinue);
             
-            GUIObjectSetEnabled(Target->state.debug.context, FALSE);
-            GUIManagerRemoveObject(Target->state.debug.context);
+            GUIObjectSetEnabled(Target->debug.context, FALSE);
+            GUIManagerRemoveObject(Target->debug.context);
+            
+            Target->debug.context = NULL;
+            Target->debug.trace = NULL;
             
-            Target->state.debug.context = NULL;
-            Target->state.debug.operation = NULL;
+            HKHubArchProcessorCacheDebug(Target, FALSE);
             
             break;
         }
@@ -530,11 +538,15 @@ static void HKHubSystemDisconnectPorts(CCComponent Connection)
 static void HKHubSystemAddTransceiver(CCComponent Transceiver)
 {
     CCCollectionInsertElement(Transceivers, &Transceiver);
+    HKHubModuleWirelessTransceiverSetBus(HKHubModuleComponentGetModule(Transceiver), TransceiverBus);
+    HKHubArchSchedulerAddSharedDevice(Scheduler, HKHubModuleComponentGetModule(Transceiver));
 }
 
 static void HKHubSystemRemoveTransceiver(CCComponent Transceiver)
 {
     CCCollectionRemoveElement(Transceivers, CCCollectionFindElement(Transceivers, &Transceiver, NULL));
+    HKHubModuleWirelessTransceiverSetBus(HKHubModuleComponentGetModule(Transceiver), NULL);
+    HKHubArchSchedulerRemoveSharedDevice(Scheduler, HKHubModuleComponentGetModule(Transceiver));
 }
 
 static void HKHubSystemAddSchematic(CCComponent Schematic)
@@ -576,7 +588,7 @@ static void HKHubSystemUpdateScheduler(CCCollection(CCComponent) Components, HKH
                 break;
                 
             case HKHubTypeModule:
-                if (ID & HKHubTypeModuleWirelessTransceiver)
+                if ((ID & HKHubTypeModuleMask) == HKHubTypeModuleWirelessTransceiver)
                 {
                     Update.transceiver(Component);
                 }
@@ -613,6 +625,7 @@ static void HKHubSystemUpdate(CCComponentSystemHandle *Handle, double DeltaTime,
     });
     
     const size_t TimestampShift = DeltaTime * HKHubArchProcessorHertz;
+    HKHubModuleWirelessTransceiverBusShiftTimestamps(TransceiverBus, TimestampShift);
     CC_COLLECTION_FOREACH(CCComponent, Transceiver, Transceivers)
     {
         HKHubModuleWirelessTransceiverShiftTimestamps(HKHubModuleComponentGetModule(Transceiver), TimestampShift);
@@ -621,6 +634,7 @@ static void HKHubSystemUpdate(CCComponentSystemHandle *Handle, double DeltaTime,
     HKHubArchSchedulerRun(Scheduler, DeltaTime);
     
     const size_t Timestamp = HKHubArchSchedulerGetTimestamp(Scheduler);
+    HKHubModuleWirelessTransceiverBusPacketPurge(TransceiverBus, Timestamp);
     CC_COLLECTION_FOREACH(CCComponent, Transceiver, Transceivers)
     {
         HKHubModuleWirelessTransceiverPacketPurge(HKHubModuleComponentGetModule(Transceiver), Timestamp);
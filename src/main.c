@@ -26,6 +26,7 @@
 #include "Base.h"
 #include "HubArchExpressions.h"
 #include "HubArchAssembly.h"
+#include "HubArchBinaryCache.h"
 #include "RapServer.h"
 #include "HubSystem.h"
 #include "HubProcessorComponent.h"
@@ -62,6 +63,30 @@ static void PreSetup(void)
     HKRapServerStart();
 }
 
+/*
+ Caches are kept in the user's cache directory, as the asset directory is bundled with the game and may not be
+ writable (or may be shared between users).
+ */
+static FSPath CreateCachePath(void)
+{
+    char Path[PATH_MAX];
+    const char *Base;
+    
+#if CC_PLATFORM_OS_X || CC_PLATFORM_IOS
+    if ((Base = getenv("HOME"))) snprintf(Path, sizeof(Path), "%s/Library/Caches/io.scrimpycat.HackingGame/", Base);
+#else
+    if ((Base = getenv("XDG_CACHE_HOME"))) snprintf(Path, sizeof(Path), "%s/HackingGame/", Base);
+    else if ((Base = getenv("HOME"))) snprintf(Path, sizeof(Path), "%s/.cache/HackingGame/", Base);
+#endif
+    else
+    {
+        CC_LOG_ERROR("Could not find the user's cache directory, caches will not be persisted");
+        return NULL;
+    }
+    
+    return FSPathCreateFromSystemPath(Path);
+}
+
 static void Setup(void)
 {
     HKHubSystemRegister();
@@ -89,6 +114,20 @@ static void Setup(void)
     FSPathSetComponentAtIndex(IncludeSearchPath, FSPathComponentCreate(FSPathComponentTypeDirectory, "procedures"), FSPathGetComponentCount(IncludeSearchPath) - 1);
     
     CCOrderedCollectionAppendElement(HKHubArchAssemblyIncludeSearchPaths, &IncludeSearchPath);
+    
+    HKHubArchBinaryCachePath = CreateCachePath();
+    
+    if (HKHubArchBinaryCachePath)
+    {
+        FSPathAppendComponent(HKHubArchBinaryCachePath, FSPathComponentCreate(FSPathComponentTypeFile, "binaries"));
+        FSPathAppendComponent(HKHubArchBinaryCachePath, FSPathComponentCreate(FSPathComponentTypeExtension, "hkbin"));
+    }
+    
+    //Programs are assembled as the hub components are loaded, so the cache is mapped before any are
+    HKHubArchBinaryCacheLoad();
+    
+    //New binaries are only written once on exit rather than rewriting the cache every time a program is assembled
+    atexit(HKHubArchBinaryCacheSave);
 }
 
 int main(int argc, const char *argv[])